@@ -46,35 +46,26 @@ class ChannelBuffer {
       : data_(new T[num_frames * num_channels]()),
         channels_(new T*[num_channels * num_bands]),
         bands_(new T*[num_channels * num_bands]),
-        num_frames_(num_frames),
-        num_frames_per_band_(num_frames / num_bands),
-        num_allocated_channels_(num_channels),
-        num_channels_(num_channels),
-        num_bands_(num_bands),
-        bands_view_(num_allocated_channels_,
-                    std::vector<rtc::ArrayView<T>>(num_bands_)),
-        channels_view_(
-            num_bands_,
-            std::vector<rtc::ArrayView<T>>(num_allocated_channels_)) {
-    // Temporarily cast away const_ness to allow populating the array views.
-    auto* bands_view =
-        const_cast<std::vector<std::vector<rtc::ArrayView<T>>>*>(&bands_view_);
-    auto* channels_view =
-        const_cast<std::vector<std::vector<rtc::ArrayView<T>>>*>(
-            &channels_view_);
+        max_num_frames_(num_frames),
+        max_num_channels_(num_channels),
+        max_num_bands_(num_bands),
+        bands_view_(max_num_channels_,
+                    std::vector<rtc::ArrayView<T>>(max_num_bands_)),
+        channels_view_(max_num_bands_,
+                       std::vector<rtc::ArrayView<T>>(max_num_channels_)) {
+    SetLayout(num_frames, num_channels, num_bands);
+  }
 
-    for (size_t ch = 0; ch < num_allocated_channels_; ++ch) {
-      for (size_t band = 0; band < num_bands_; ++band) {
-        (*channels_view)[band][ch] = rtc::ArrayView<T>(
-            &data_[ch * num_frames_ + band * num_frames_per_band_],
-            num_frames_per_band_);
-        (*bands_view)[ch][band] = channels_view_[band][ch];
-        channels_[band * num_allocated_channels_ + ch] =
-            channels_view_[band][ch].data();
-        bands_[ch * num_bands_ + band] =
-            channels_[band * num_allocated_channels_ + ch];
-      }
-    }
+  // Changes the layout of the buffer to |num_frames| frames for |num_channels|
+  // channels split into |num_bands| bands, without reallocating. None of the
+  // dimensions may exceed the ones the buffer was created with. As at
+  // creation, the buffer is zeroed.
+  void Reconfigure(size_t num_frames, size_t num_channels, size_t num_bands) {
+    RTC_DCHECK_LE(num_frames, max_num_frames_);
+    RTC_DCHECK_LE(num_channels, max_num_channels_);
+    RTC_DCHECK_LE(num_bands, max_num_bands_);
+    SetLayout(num_frames, num_channels, num_bands);
+    memset(data_.get(), 0, size() * sizeof(T));
   }
 
   // Returns a pointer array to the channels.
@@ -99,10 +90,12 @@ class ChannelBuffer {
     return const_cast<T* const*>(t->channels(band));
   }
   rtc::ArrayView<const rtc::ArrayView<T>> channels_view(size_t band = 0) {
-    return channels_view_[band];
+    return rtc::ArrayView<const rtc::ArrayView<T>>(
+        channels_view_[band].data(), num_allocated_channels_);
   }
   rtc::ArrayView<const rtc::ArrayView<T>> channels_view(size_t band = 0) const {
-    return channels_view_[band];
+    return rtc::ArrayView<const rtc::ArrayView<T>>(
+        channels_view_[band].data(), num_allocated_channels_);
   }
 
   // Returns a pointer array to the bands for a specific channel.
@@ -123,10 +116,12 @@ class ChannelBuffer {
   }
 
   rtc::ArrayView<const rtc::ArrayView<T>> bands_view(size_t channel) {
-    return bands_view_[channel];
+    return rtc::ArrayView<const rtc::ArrayView<T>>(bands_view_[channel].data(),
+                                                   num_bands_);
   }
   rtc::ArrayView<const rtc::ArrayView<T>> bands_view(size_t channel) const {
-    return bands_view_[channel];
+    return rtc::ArrayView<const rtc::ArrayView<T>>(bands_view_[channel].data(),
+                                                   num_bands_);
   }
 
   // Sets the |slice| pointers to the |start_frame| position for each channel.
@@ -159,18 +154,43 @@ class ChannelBuffer {
   }
 
  private:
+  // Populates the pointer arrays and array views for the given layout.
+  void SetLayout(size_t num_frames, size_t num_channels, size_t num_bands) {
+    num_frames_ = num_frames;
+    num_frames_per_band_ = num_frames / num_bands;
+    num_allocated_channels_ = num_channels;
+    num_channels_ = num_channels;
+    num_bands_ = num_bands;
+    for (size_t ch = 0; ch < num_allocated_channels_; ++ch) {
+      for (size_t band = 0; band < num_bands_; ++band) {
+        channels_view_[band][ch] = rtc::ArrayView<T>(
+            &data_[ch * num_frames_ + band * num_frames_per_band_],
+            num_frames_per_band_);
+        bands_view_[ch][band] = channels_view_[band][ch];
+        channels_[band * num_allocated_channels_ + ch] =
+            channels_view_[band][ch].data();
+        bands_[ch * num_bands_ + band] =
+            channels_[band * num_allocated_channels_ + ch];
+      }
+    }
+  }
+
   std::unique_ptr<T[]> data_;
   std::unique_ptr<T*[]> channels_;
   std::unique_ptr<T*[]> bands_;
-  const size_t num_frames_;
-  const size_t num_frames_per_band_;
+  // Dimensions the storage has been allocated for.
+  const size_t max_num_frames_;
+  const size_t max_num_channels_;
+  const size_t max_num_bands_;
+  size_t num_frames_;
+  size_t num_frames_per_band_;
   // Number of channels the internal buffer holds.
-  const size_t num_allocated_channels_;
+  size_t num_allocated_channels_;
   // Number of channels the user sees.
   size_t num_channels_;
-  const size_t num_bands_;
-  const std::vector<std::vector<rtc::ArrayView<T>>> bands_view_;
-  const std::vector<std::vector<rtc::ArrayView<T>>> channels_view_;
+  size_t num_bands_;
+  std::vector<std::vector<rtc::ArrayView<T>>> bands_view_;
+  std::vector<std::vector<rtc::ArrayView<T>>> channels_view_;
 };
 
 // One int16_t and one float ChannelBuffer that are kept in sync. The sync is
@@ -16,9 +16,11 @@
 
 namespace webrtc {
 
+class PushPolyphaseResampler;
 class PushSincResampler;
 
-// Wraps PushSincResampler to provide stereo support.
+// Wraps PushSincResampler to provide stereo support. Ratios for which a
+// PushPolyphaseResampler exists are resampled with that one instead.
 // TODO(ajm): add support for an arbitrary number of channels.
 template <typename T>
 class PushResampler {
@@ -47,6 +49,7 @@ class PushResampler {
   std::vector<T*> channel_data_array_;
 
   struct ChannelResampler {
+    std::unique_ptr<PushPolyphaseResampler> polyphase_resampler;
     std::unique_ptr<PushSincResampler> resampler;
     std::vector<T> source;
     std::vector<T> destination;
@@ -0,0 +1,202 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// MSVC++ requires this to be set before any other includes to get M_PI.
+#define _USE_MATH_DEFINES
+
+#include "common_audio/resampler/low_latency_resampler.h"
+
+#include <math.h>
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/system/arch.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
+namespace webrtc {
+namespace {
+
+float DotProduct_C(const float* x, const float* h, size_t length) {
+  float sum = 0.f;
+  for (size_t i = 0; i < length; ++i) {
+    sum += x[i] * h[i];
+  }
+  return sum;
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+float DotProduct_SSE(const float* x, const float* h, size_t length) {
+  __m128 sums = _mm_setzero_ps();
+  for (size_t i = 0; i < length; i += 4) {
+    sums = _mm_add_ps(sums,
+                      _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(h + i)));
+  }
+  sums = _mm_add_ps(sums, _mm_movehl_ps(sums, sums));
+  sums = _mm_add_ss(sums, _mm_shuffle_ps(sums, sums, 1));
+  return _mm_cvtss_f32(sums);
+}
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+float DotProduct_NEON(const float* x, const float* h, size_t length) {
+  float32x4_t sums = vdupq_n_f32(0.f);
+  for (size_t i = 0; i < length; i += 4) {
+    sums = vmlaq_f32(sums, vld1q_f32(x + i), vld1q_f32(h + i));
+  }
+  float32x2_t sums_2 = vadd_f32(vget_low_f32(sums), vget_high_f32(sums));
+  sums_2 = vpadd_f32(sums_2, sums_2);
+  return vget_lane_f32(sums_2, 0);
+}
+#endif
+
+// If we know the minimum architecture at compile time, avoid CPU detection.
+float (*SelectDotProduct())(const float*, const float*, size_t) {
+#if defined(WEBRTC_HAS_NEON)
+  return DotProduct_NEON;
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+  return GetCPUInfo(kSSE2) ? DotProduct_SSE : DotProduct_C;
+#else
+  return DotProduct_C;
+#endif
+}
+
+size_t GreatestCommonDivisor(size_t a, size_t b) {
+  while (b != 0) {
+    const size_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+}  // namespace
+
+const size_t LowLatencyResampler::kMinKernelSize;
+const size_t LowLatencyResampler::kMaxKernelSize;
+
+LowLatencyResampler::LowLatencyResampler(size_t source_frames,
+                                         size_t destination_frames,
+                                         size_t kernel_size)
+    : kernel_size_(kernel_size),
+      up_factor_(destination_frames /
+                 GreatestCommonDivisor(source_frames, destination_frames)),
+      down_factor_(source_frames /
+                   GreatestCommonDivisor(source_frames, destination_frames)),
+      dot_product_(SelectDotProduct()),
+      filter_phases_(up_factor_ * kernel_size_),
+      input_buffer_(kernel_size_ - 1 + source_frames, 0.f),
+      next_output_position_(0) {
+  RTC_CHECK_GT(source_frames, 0);
+  RTC_CHECK_GT(destination_frames, 0);
+  RTC_CHECK_GE(kernel_size_, kMinKernelSize);
+  RTC_CHECK_LE(kernel_size_, kMaxKernelSize);
+  RTC_CHECK_EQ(kernel_size_ % 4, 0);
+
+  // Blackman window parameters.
+  static const double kAlpha = 0.16;
+  static const double kA0 = 0.5 * (1.0 - kAlpha);
+  static const double kA1 = 0.5;
+  static const double kA2 = 0.5 * kAlpha;
+
+  // Normalized cutoff frequency, slightly below the lower Nyquist frequency.
+  const double sinc_scale_factor =
+      0.9 * std::min(1.0, static_cast<double>(up_factor_) / down_factor_);
+
+  // Generates the windowed sinc() filter at the resolution of the
+  // |up_factor_| sub-sample output positions and distributes its taps over the
+  // polyphase components.
+  const size_t filter_length = filter_phases_.size();
+  for (size_t n = 0; n < filter_length; ++n) {
+    const double offset = static_cast<double>(n) / up_factor_ -
+                          static_cast<double>(kernel_size_ / 2);
+    const float pre_sinc = static_cast<float>(M_PI * offset);
+    const double x = static_cast<double>(n) / filter_length;
+    const float window = static_cast<float>(kA0 - kA1 * cos(2.0 * M_PI * x) +
+                                            kA2 * cos(4.0 * M_PI * x));
+    const size_t phase = n % up_factor_;
+    const size_t age = n / up_factor_;
+    filter_phases_[phase * kernel_size_ + kernel_size_ - 1 - age] =
+        static_cast<float>(
+            window * ((pre_sinc == 0)
+                          ? sinc_scale_factor
+                          : (sin(sinc_scale_factor * pre_sinc) / pre_sinc)));
+  }
+
+  // A short kernel truncates the sinc() well before it has decayed, which
+  // leaves each phase with a different gain. Normalize all phases to unity gain
+  // at DC so that the pass band is flat across the sub-sample positions.
+  for (size_t phase = 0; phase < up_factor_; ++phase) {
+    float* taps = &filter_phases_[phase * kernel_size_];
+    float sum = 0.f;
+    for (size_t i = 0; i < kernel_size_; ++i) {
+      sum += taps[i];
+    }
+    for (size_t i = 0; i < kernel_size_; ++i) {
+      taps[i] /= sum;
+    }
+  }
+}
+
+LowLatencyResampler::~LowLatencyResampler() = default;
+
+size_t LowLatencyResampler::MaxDestinationFrames(size_t source_frames) const {
+  return (source_frames * up_factor_ + down_factor_ - 1) / down_factor_;
+}
+
+void LowLatencyResampler::Reset() {
+  std::fill(input_buffer_.begin(), input_buffer_.end(), 0.f);
+  next_output_position_ = 0;
+}
+
+size_t LowLatencyResampler::Resample(const float* source,
+                                     size_t source_frames,
+                                     float* destination,
+                                     size_t destination_capacity) {
+  RTC_CHECK_GE(destination_capacity, MaxDestinationFrames(source_frames));
+  if (source_frames == 0) {
+    return 0;
+  }
+
+  const size_t history_size = kernel_size_ - 1;
+  RTC_CHECK_LE(history_size + source_frames, input_buffer_.size());
+  std::copy(source, source + source_frames,
+            input_buffer_.begin() + history_size);
+
+  // Produce all the output samples whose newest input sample is available.
+  // The input of an output sample ends with its newest input sample, which is
+  // placed |history_size| samples into |input_buffer_|.
+  const size_t end_position = source_frames * up_factor_;
+  size_t num_output_frames = 0;
+  for (; next_output_position_ < end_position;
+       next_output_position_ += down_factor_) {
+    const size_t newest_input = next_output_position_ / up_factor_;
+    const size_t phase = next_output_position_ % up_factor_;
+    destination[num_output_frames++] =
+        dot_product_(&input_buffer_[newest_input],
+                     &filter_phases_[phase * kernel_size_], kernel_size_);
+  }
+  next_output_position_ -= end_position;
+
+  // Keep the history needed by the next call.
+  std::copy(input_buffer_.begin() + source_frames,
+            input_buffer_.begin() + source_frames + history_size,
+            input_buffer_.begin());
+  return num_output_frames;
+}
+
+}  // namespace webrtc
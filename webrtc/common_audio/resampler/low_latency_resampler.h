@@ -0,0 +1,86 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef COMMON_AUDIO_RESAMPLER_LOW_LATENCY_RESAMPLER_H_
+#define COMMON_AUDIO_RESAMPLER_LOW_LATENCY_RESAMPLER_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "rtc_base/constructor_magic.h"
+
+namespace webrtc {
+
+// Single-channel resampler with a short, configurable windowed sinc() kernel
+// and no buffering beyond the kernel history. Unlike PushSincResampler, each
+// output sample is produced as soon as the input samples it depends on have
+// been pushed, so the input may be pushed in blocks of any size up to the
+// |source_frames| given at construction and the only delay is
+// |kernel_size| / 2 input samples. The sample rate ratio is handled
+// exactly, with one precomputed filter phase per sub-sample output position.
+class LowLatencyResampler {
+ public:
+  static const size_t kMinKernelSize = 4;
+  static const size_t kMaxKernelSize = 32;
+
+  // |source_frames| and |destination_frames| are the number of samples in the
+  // same time duration (typically 10 ms) at the source and destination rates.
+  // |kernel_size| is the number of filter taps, in source samples, and must be
+  // a multiple of 4 between kMinKernelSize and kMaxKernelSize.
+  LowLatencyResampler(size_t source_frames,
+                      size_t destination_frames,
+                      size_t kernel_size);
+  ~LowLatencyResampler();
+
+  // Resamples the |source_frames| samples in |source| into |destination| and
+  // returns the number of samples produced. |source_frames| must not exceed
+  // the |source_frames| given at construction, and |destination_capacity|
+  // must be at least MaxDestinationFrames(|source_frames|). When the two
+  // |source_frames| are equal, exactly |destination_frames| samples are
+  // produced.
+  size_t Resample(const float* source,
+                  size_t source_frames,
+                  float* destination,
+                  size_t destination_capacity);
+
+  // Maximum number of samples produced when pushing |source_frames| samples.
+  size_t MaxDestinationFrames(size_t source_frames) const;
+
+  // Returns the resampler to its initial state.
+  void Reset();
+
+  size_t kernel_size() const { return kernel_size_; }
+
+ private:
+  typedef float (*DotProductProc)(const float*, const float*, size_t);
+
+  const size_t kernel_size_;
+  // The ratio of the destination and source rates is |up_factor_| /
+  // |down_factor_|.
+  const size_t up_factor_;
+  const size_t down_factor_;
+  const DotProductProc dot_product_;
+  // The |up_factor_| polyphase components of the filter, each time reversed.
+  std::vector<float> filter_phases_;
+  // The last |kernel_size_| - 1 input samples of the previous call, followed by
+  // the input samples of the current call. Sized at construction for the
+  // largest allowed call.
+  std::vector<float> input_buffer_;
+  // Position of the next output sample, in units of 1 / |up_factor_| source
+  // samples relative to the first sample of the next call.
+  size_t next_output_position_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(LowLatencyResampler);
+};
+
+}  // namespace webrtc
+
+#endif  // COMMON_AUDIO_RESAMPLER_LOW_LATENCY_RESAMPLER_H_
@@ -0,0 +1,269 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// MSVC++ requires this to be set before any other includes to get M_PI.
+#define _USE_MATH_DEFINES
+
+#include "common_audio/resampler/polyphase_resampler.h"
+
+#include <math.h>
+
+#include <algorithm>
+
+#include "common_audio/include/audio_util.h"
+#include "common_audio/resampler/sinc_resampler.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/system/arch.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kTapsPerPhase = PushPolyphaseResampler::kTapsPerPhase;
+static_assert(kTapsPerPhase == SincResampler::kKernelSize,
+              "The polyphase filter must have the SincResampler delay");
+static_assert(kTapsPerPhase % 4 == 0,
+              "The number of taps must be a multiple of the SIMD width");
+
+float DotProduct_C(const float* x, const float* h) {
+  float sum = 0.f;
+  for (size_t i = 0; i < kTapsPerPhase; ++i) {
+    sum += x[i] * h[i];
+  }
+  return sum;
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+float DotProduct_SSE(const float* x, const float* h) {
+  __m128 sums = _mm_setzero_ps();
+  for (size_t i = 0; i < kTapsPerPhase; i += 4) {
+    sums = _mm_add_ps(sums,
+                      _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(h + i)));
+  }
+  sums = _mm_add_ps(sums, _mm_movehl_ps(sums, sums));
+  sums = _mm_add_ss(sums, _mm_shuffle_ps(sums, sums, 1));
+  return _mm_cvtss_f32(sums);
+}
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+float DotProduct_NEON(const float* x, const float* h) {
+  float32x4_t sums = vdupq_n_f32(0.f);
+  for (size_t i = 0; i < kTapsPerPhase; i += 4) {
+    sums = vmlaq_f32(sums, vld1q_f32(x + i), vld1q_f32(h + i));
+  }
+  float32x2_t sums_2 = vadd_f32(vget_low_f32(sums), vget_high_f32(sums));
+  sums_2 = vpadd_f32(sums_2, sums_2);
+  return vget_lane_f32(sums_2, 0);
+}
+#endif
+
+// If we know the minimum architecture at compile time, avoid CPU detection.
+float (*SelectDotProduct())(const float*, const float*) {
+#if defined(WEBRTC_HAS_NEON)
+  return DotProduct_NEON;
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+  return GetCPUInfo(kSSE2) ? DotProduct_SSE : DotProduct_C;
+#else
+  return DotProduct_C;
+#endif
+}
+
+// Computes the |up_factor| polyphase components of the low-pass filter used for
+// the ratio |up_factor| / |down_factor|, each time reversed. The prototype is
+// the windowed sinc() of SincResampler, evaluated at the sub-sample offsets
+// k / |up_factor| rather than interpolated between a fixed set of offsets.
+std::vector<float> ComputeFilterPhases(int up_factor, int down_factor) {
+  // Blackman window parameters.
+  static const double kAlpha = 0.16;
+  static const double kA0 = 0.5 * (1.0 - kAlpha);
+  static const double kA1 = 0.5;
+  static const double kA2 = 0.5 * kAlpha;
+
+  // Normalized cutoff frequency, slightly below the lower Nyquist frequency.
+  const double sinc_scale_factor =
+      0.9 * std::min(1.0, static_cast<double>(up_factor) / down_factor);
+
+  const size_t filter_length = kTapsPerPhase * up_factor;
+  std::vector<float> phases(filter_length);
+  for (size_t n = 0; n < filter_length; ++n) {
+    // Offset of the filter tap from the center of the filter, in source
+    // samples.
+    const double offset = static_cast<double>(n) / up_factor -
+                          static_cast<double>(kTapsPerPhase / 2);
+    const float pre_sinc = static_cast<float>(M_PI * offset);
+    const double x = static_cast<double>(n) / filter_length;
+    const float window = static_cast<float>(kA0 - kA1 * cos(2.0 * M_PI * x) +
+                                            kA2 * cos(4.0 * M_PI * x));
+    const float tap = static_cast<float>(
+        window * ((pre_sinc == 0)
+                      ? sinc_scale_factor
+                      : (sin(sinc_scale_factor * pre_sinc) / pre_sinc)));
+
+    // Tap n belongs to the phase n % up_factor, where it multiplies the input
+    // sample n / up_factor samples before the newest one.
+    const size_t phase = n % up_factor;
+    const size_t age = n / up_factor;
+    phases[phase * kTapsPerPhase + kTapsPerPhase - 1 - age] = tap;
+  }
+  return phases;
+}
+
+template <int kUpFactor, int kDownFactor>
+const float* GetFilterPhases() {
+  static const std::vector<float>* const phases =
+      new std::vector<float>(ComputeFilterPhases(kUpFactor, kDownFactor));
+  return phases->data();
+}
+
+size_t GreatestCommonDivisor(size_t a, size_t b) {
+  while (b != 0) {
+    const size_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+}  // namespace
+
+const size_t PushPolyphaseResampler::kTapsPerPhase;
+
+std::unique_ptr<PushPolyphaseResampler> PushPolyphaseResampler::Create(
+    size_t source_frames,
+    size_t destination_frames) {
+  if (source_frames == 0 || destination_frames == 0) {
+    return nullptr;
+  }
+  const size_t gcd = GreatestCommonDivisor(source_frames, destination_frames);
+  const size_t up = destination_frames / gcd;
+  const size_t down = source_frames / gcd;
+
+#define POLYPHASE_RESAMPLER_CASE(kUp, kDown)                        \
+  if (up == kUp && down == kDown) {                                 \
+    return std::make_unique<PolyphaseResampler<kUp, kDown>>(        \
+        source_frames, destination_frames);                         \
+  }
+  POLYPHASE_RESAMPLER_CASE(1, 2)
+  POLYPHASE_RESAMPLER_CASE(2, 1)
+  POLYPHASE_RESAMPLER_CASE(1, 3)
+  POLYPHASE_RESAMPLER_CASE(3, 1)
+  POLYPHASE_RESAMPLER_CASE(1, 6)
+  POLYPHASE_RESAMPLER_CASE(6, 1)
+  POLYPHASE_RESAMPLER_CASE(2, 3)
+  POLYPHASE_RESAMPLER_CASE(3, 2)
+  POLYPHASE_RESAMPLER_CASE(3, 4)
+  POLYPHASE_RESAMPLER_CASE(4, 3)
+#undef POLYPHASE_RESAMPLER_CASE
+
+  return nullptr;
+}
+
+PushPolyphaseResampler::PushPolyphaseResampler(size_t source_frames,
+                                               size_t destination_frames)
+    : source_frames_(source_frames),
+      destination_frames_(destination_frames),
+      float_source_(source_frames),
+      float_destination_(destination_frames) {}
+
+PushPolyphaseResampler::~PushPolyphaseResampler() = default;
+
+size_t PushPolyphaseResampler::Resample(const int16_t* source,
+                                        size_t source_frames,
+                                        int16_t* destination,
+                                        size_t destination_capacity) {
+  RTC_CHECK_EQ(source_frames, source_frames_);
+  RTC_CHECK_GE(destination_capacity, destination_frames_);
+  for (size_t i = 0; i < source_frames_; ++i) {
+    float_source_[i] = static_cast<float>(source[i]);
+  }
+  Resample(float_source_.data(), source_frames_, float_destination_.data(),
+           destination_frames_);
+  FloatS16ToS16(float_destination_.data(), destination_frames_, destination);
+  return destination_frames_;
+}
+
+template <int kUpFactor, int kDownFactor>
+PolyphaseResampler<kUpFactor, kDownFactor>::PolyphaseResampler(
+    size_t source_frames,
+    size_t destination_frames)
+    : PushPolyphaseResampler(source_frames, destination_frames),
+      dot_product_(SelectDotProduct()),
+      filter_phases_(GetFilterPhases<kUpFactor, kDownFactor>()),
+      input_buffer_(kTapsPerPhase - 1 + source_frames, 0.f) {
+  RTC_CHECK_EQ(source_frames % kDownFactor, 0);
+  RTC_CHECK_EQ(source_frames / kDownFactor * kUpFactor, destination_frames);
+
+  for (int k = 0; k < kUpFactor; ++k) {
+    output_phases_[k].phase = (k * kDownFactor) % kUpFactor;
+    output_phases_[k].input_offset = (k * kDownFactor) / kUpFactor;
+  }
+}
+
+template <int kUpFactor, int kDownFactor>
+PolyphaseResampler<kUpFactor, kDownFactor>::~PolyphaseResampler() = default;
+
+template <int kUpFactor, int kDownFactor>
+void PolyphaseResampler<kUpFactor, kDownFactor>::Reset() {
+  std::fill(input_buffer_.begin(), input_buffer_.end(), 0.f);
+}
+
+template <int kUpFactor, int kDownFactor>
+size_t PolyphaseResampler<kUpFactor, kDownFactor>::Resample(
+    const float* source,
+    size_t source_frames,
+    float* destination,
+    size_t destination_capacity) {
+  RTC_CHECK_EQ(source_frames, source_frames_);
+  RTC_CHECK_GE(destination_capacity, destination_frames_);
+  std::copy(source, source + source_frames_,
+            input_buffer_.begin() + kTapsPerPhase - 1);
+
+  // Each group of kDownFactor input samples produces kUpFactor output samples,
+  // which use the filter phases in the same order for every group. The input
+  // of an output sample ends with its newest input sample, which is placed
+  // kTapsPerPhase - 1 samples into |input_buffer_|.
+  const size_t num_groups = source_frames_ / kDownFactor;
+  float* output = destination;
+  for (size_t g = 0; g < num_groups; ++g) {
+    const float* input = &input_buffer_[g * kDownFactor];
+    for (const OutputPhase& output_phase : output_phases_) {
+      *output++ =
+          dot_product_(input + output_phase.input_offset,
+                       &filter_phases_[output_phase.phase * kTapsPerPhase]);
+    }
+  }
+
+  // Keep the history needed by the next call.
+  std::copy(input_buffer_.end() - (kTapsPerPhase - 1), input_buffer_.end(),
+            input_buffer_.begin());
+  return destination_frames_;
+}
+
+// Explictly generate the supported ratios.
+template class PolyphaseResampler<1, 2>;
+template class PolyphaseResampler<2, 1>;
+template class PolyphaseResampler<1, 3>;
+template class PolyphaseResampler<3, 1>;
+template class PolyphaseResampler<1, 6>;
+template class PolyphaseResampler<6, 1>;
+template class PolyphaseResampler<2, 3>;
+template class PolyphaseResampler<3, 2>;
+template class PolyphaseResampler<3, 4>;
+template class PolyphaseResampler<4, 3>;
+
+}  // namespace webrtc
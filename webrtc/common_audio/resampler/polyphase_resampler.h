@@ -0,0 +1,116 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef COMMON_AUDIO_RESAMPLER_POLYPHASE_RESAMPLER_H_
+#define COMMON_AUDIO_RESAMPLER_POLYPHASE_RESAMPLER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "rtc_base/constructor_magic.h"
+
+namespace webrtc {
+
+// Push-based resampler for a small set of rational sample rate ratios, which
+// uses a polyphase FIR filter instead of the interpolated kernels of
+// SincResampler. Each output sample is a single dot product with one of the
+// precomputed filter phases, which halves the number of multiplies per output
+// sample. The filter has the same windowed sinc() prototype as SincResampler
+// and the same delay of SincResampler::kKernelSize / 2 input samples.
+class PushPolyphaseResampler {
+ public:
+  // Number of filter taps per output sample.
+  static const size_t kTapsPerPhase = 32;
+
+  // Creates a resampler converting blocks of |source_frames| samples into
+  // blocks of |destination_frames| samples. Returns nullptr if there is no
+  // polyphase resampler for that ratio, in which case PushSincResampler should
+  // be used instead.
+  static std::unique_ptr<PushPolyphaseResampler> Create(
+      size_t source_frames,
+      size_t destination_frames);
+
+  virtual ~PushPolyphaseResampler();
+
+  // Perform the resampling, with the same contract as
+  // PushSincResampler::Resample().
+  size_t Resample(const int16_t* source,
+                  size_t source_frames,
+                  int16_t* destination,
+                  size_t destination_capacity);
+  virtual size_t Resample(const float* source,
+                          size_t source_frames,
+                          float* destination,
+                          size_t destination_capacity) = 0;
+
+  // Returns the resampler to its initial state.
+  virtual void Reset() = 0;
+
+ protected:
+  PushPolyphaseResampler(size_t source_frames, size_t destination_frames);
+
+  const size_t source_frames_;
+  const size_t destination_frames_;
+
+ private:
+  std::vector<float> float_source_;
+  std::vector<float> float_destination_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(PushPolyphaseResampler);
+};
+
+// Polyphase resampler for the ratio |kUpFactor| / |kDownFactor| between the
+// destination and the source sample rates. The factors must not have any
+// common divisor. Only the ratios instantiated in polyphase_resampler.cc are
+// available.
+template <int kUpFactor, int kDownFactor>
+class PolyphaseResampler final : public PushPolyphaseResampler {
+ public:
+  PolyphaseResampler(size_t source_frames, size_t destination_frames);
+  ~PolyphaseResampler() override;
+
+  using PushPolyphaseResampler::Resample;
+  size_t Resample(const float* source,
+                  size_t source_frames,
+                  float* destination,
+                  size_t destination_capacity) override;
+
+  void Reset() override;
+
+ private:
+  // Filter phase and position of the newest input sample, relative to the
+  // first input sample of a group of |kDownFactor| input samples, for each of
+  // the |kUpFactor| output samples produced from such a group.
+  struct OutputPhase {
+    size_t phase;
+    size_t input_offset;
+  };
+
+  typedef float (*DotProductProc)(const float*, const float*);
+
+  const DotProductProc dot_product_;
+  std::array<OutputPhase, kUpFactor> output_phases_;
+  // Polyphase components of the filter, time reversed so that each output
+  // sample is a dot product over contiguous input samples.
+  const float* const filter_phases_;
+  // The last kTapsPerPhase - 1 input samples of the previous call, followed by
+  // the input samples of the current call.
+  std::vector<float> input_buffer_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(PolyphaseResampler);
+};
+
+}  // namespace webrtc
+
+#endif  // COMMON_AUDIO_RESAMPLER_POLYPHASE_RESAMPLER_H_
@@ -16,6 +16,7 @@
 #include <memory>
 
 #include "common_audio/include/audio_util.h"
+#include "common_audio/resampler/polyphase_resampler.h"
 #include "common_audio/resampler/push_sinc_resampler.h"
 #include "rtc_base/checks.h"
 
@@ -93,8 +94,12 @@ int PushResampler<T>::InitializeIfNeeded(int src_sample_rate_hz,
   for (size_t i = 0; i < num_channels; ++i) {
     channel_resamplers_.push_back(ChannelResampler());
     auto channel_resampler = channel_resamplers_.rbegin();
-    channel_resampler->resampler = std::make_unique<PushSincResampler>(
-        src_size_10ms_mono, dst_size_10ms_mono);
+    channel_resampler->polyphase_resampler =
+        PushPolyphaseResampler::Create(src_size_10ms_mono, dst_size_10ms_mono);
+    if (!channel_resampler->polyphase_resampler) {
+      channel_resampler->resampler = std::make_unique<PushSincResampler>(
+          src_size_10ms_mono, dst_size_10ms_mono);
+    }
     channel_resampler->source.resize(src_size_10ms_mono);
     channel_resampler->destination.resize(dst_size_10ms_mono);
   }
@@ -131,9 +136,15 @@ int PushResampler<T>::Resample(const T* src,
   size_t dst_length_mono = 0;
 
   for (auto& resampler : channel_resamplers_) {
-    dst_length_mono = resampler.resampler->Resample(
-        resampler.source.data(), src_length_mono, resampler.destination.data(),
-        dst_capacity_mono);
+    if (resampler.polyphase_resampler) {
+      dst_length_mono = resampler.polyphase_resampler->Resample(
+          resampler.source.data(), src_length_mono,
+          resampler.destination.data(), dst_capacity_mono);
+    } else {
+      dst_length_mono = resampler.resampler->Resample(
+          resampler.source.data(), src_length_mono,
+          resampler.destination.data(), dst_capacity_mono);
+    }
   }
 
   for (size_t ch = 0; ch < num_channels_; ++ch) {
@@ -30,6 +30,14 @@ PushSincResampler::PushSincResampler(size_t source_frames,
 
 PushSincResampler::~PushSincResampler() {}
 
+void PushSincResampler::Reset() {
+  resampler_->Flush();
+  source_ptr_ = nullptr;
+  source_ptr_int_ = nullptr;
+  first_pass_ = true;
+  source_available_ = 0;
+}
+
 size_t PushSincResampler::Resample(const int16_t* source,
                                    size_t source_length,
                                    int16_t* destination,
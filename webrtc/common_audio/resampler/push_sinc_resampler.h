@@ -47,6 +47,10 @@ class PushSincResampler : public SincResamplerCallback {
                   float* destination,
                   size_t destination_capacity);
 
+  // Returns the resampler to its initial state, as if it had just been
+  // constructed, without reallocating the filter kernel.
+  void Reset();
+
   // Delay due to the filter kernel. Essentially, the time after which an input
   // sample will appear in the resampled output.
   static float AlgorithmicDelaySeconds(int source_rate_hz) {
@@ -92,9 +92,12 @@
 #include <string.h>
 
 #include <limits>
+#include <map>
 
 #include "rtc_base/checks.h"
+#include "rtc_base/synchronization/mutex.h"
 #include "rtc_base/system/arch.h"
+#include "rtc_base/thread_annotations.h"
 #include "system_wrappers/include/cpu_features_wrapper.h"  // kSSE2, WebRtc_G...
 
 namespace webrtc {
@@ -117,6 +120,99 @@ double SincScaleFactor(double io_ratio) {
   return sinc_scale_factor;
 }
 
+// The parts of the windowed sinc() kernels which are independent of the
+// sample rate ratio, for each sub-sample offset from 0.0 to 1.0.
+struct KernelTerms {
+  KernelTerms() {
+    // Blackman window parameters.
+    static const double kAlpha = 0.16;
+    static const double kA0 = 0.5 * (1.0 - kAlpha);
+    static const double kA1 = 0.5;
+    static const double kA2 = 0.5 * kAlpha;
+
+    for (size_t offset_idx = 0; offset_idx <= SincResampler::kKernelOffsetCount;
+         ++offset_idx) {
+      const float subsample_offset =
+          static_cast<float>(offset_idx) / SincResampler::kKernelOffsetCount;
+
+      for (size_t i = 0; i < SincResampler::kKernelSize; ++i) {
+        const size_t idx = i + offset_idx * SincResampler::kKernelSize;
+        pre_sinc[idx] = static_cast<float>(
+            M_PI *
+            (static_cast<int>(i) -
+             static_cast<int>(SincResampler::kKernelSize / 2) -
+             subsample_offset));
+
+        // Compute Blackman window, matching the offset of the sinc().
+        const float x = (i - subsample_offset) / SincResampler::kKernelSize;
+        window[idx] = static_cast<float>(kA0 - kA1 * cos(2.0 * M_PI * x) +
+                                         kA2 * cos(4.0 * M_PI * x));
+      }
+    }
+  }
+
+  float pre_sinc[SincResampler::kKernelStorageSize];
+  float window[SincResampler::kKernelStorageSize];
+};
+
+// Generates a set of windowed sinc() kernels for |sinc_scale_factor|.
+std::shared_ptr<const float> ComputeKernel(double sinc_scale_factor) {
+  static const KernelTerms* const terms = new KernelTerms();
+
+  // Create the kernel with a 64-byte alignment for SIMD optimizations.
+  float* kernel = static_cast<float*>(
+      AlignedMalloc(sizeof(float) * SincResampler::kKernelStorageSize, 64));
+  for (size_t idx = 0; idx < SincResampler::kKernelStorageSize; ++idx) {
+    const float window = terms->window[idx];
+    const float pre_sinc = terms->pre_sinc[idx];
+
+    // Window the sinc() function with offset.
+    kernel[idx] = static_cast<float>(
+        window * ((pre_sinc == 0)
+                      ? sinc_scale_factor
+                      : (sin(sinc_scale_factor * pre_sinc) / pre_sinc)));
+  }
+  return std::shared_ptr<const float>(kernel, AlignedFreeDeleter());
+}
+
+// Keeps track of the kernels in use, so that resamplers converting between the
+// same sample rates share their kernels instead of each computing and storing
+// their own.
+class KernelCache {
+ public:
+  std::shared_ptr<const float> GetKernel(double io_sample_rate_ratio) {
+    // The kernels only depend on the ratio through the sinc scale factor,
+    // which is the same for all upsampling ratios.
+    const double sinc_scale_factor = SincScaleFactor(io_sample_rate_ratio);
+
+    MutexLock lock(&mutex_);
+    std::shared_ptr<const float> kernel = kernels_[sinc_scale_factor].lock();
+    if (!kernel) {
+      kernel = ComputeKernel(sinc_scale_factor);
+      kernels_[sinc_scale_factor] = kernel;
+    }
+
+    // Forget about the kernels which are no longer used by any resampler.
+    for (auto it = kernels_.begin(); it != kernels_.end();) {
+      if (it->second.expired()) {
+        it = kernels_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    return kernel;
+  }
+
+ private:
+  Mutex mutex_;
+  std::map<double, std::weak_ptr<const float>> kernels_ RTC_GUARDED_BY(mutex_);
+};
+
+KernelCache* GetKernelCache() {
+  static KernelCache* const cache = new KernelCache();
+  return cache;
+}
+
 }  // namespace
 
 const size_t SincResampler::kKernelSize;
@@ -126,7 +222,13 @@ void SincResampler::InitializeCPUSpecificFeatures() {
 #if defined(WEBRTC_HAS_NEON)
   convolve_proc_ = Convolve_NEON;
 #elif defined(WEBRTC_ARCH_X86_FAMILY)
-  // Using AVX2 instead of SSE2 when AVX2 supported.
+  // Use the widest vector instructions supported.
+#if defined(WEBRTC_ENABLE_AVX512)
+  if (GetCPUInfo(kAVX512)) {
+    convolve_proc_ = Convolve_AVX512;
+    return;
+  }
+#endif
   if (GetCPUInfo(kAVX2))
     convolve_proc_ = Convolve_AVX2;
   else if (GetCPUInfo(kSSE2))
@@ -146,13 +248,8 @@ SincResampler::SincResampler(double io_sample_rate_ratio,
       read_cb_(read_cb),
       request_frames_(request_frames),
       input_buffer_size_(request_frames_ + kKernelSize),
+      kernel_(GetKernelCache()->GetKernel(io_sample_rate_ratio_)),
       // Create input buffers with a 32-byte alignment for SIMD optimizations.
-      kernel_storage_(static_cast<float*>(
-          AlignedMalloc(sizeof(float) * kKernelStorageSize, 32))),
-      kernel_pre_sinc_storage_(static_cast<float*>(
-          AlignedMalloc(sizeof(float) * kKernelStorageSize, 32))),
-      kernel_window_storage_(static_cast<float*>(
-          AlignedMalloc(sizeof(float) * kKernelStorageSize, 32))),
       input_buffer_(static_cast<float*>(
           AlignedMalloc(sizeof(float) * input_buffer_size_, 32))),
       convolve_proc_(nullptr),
@@ -163,15 +260,6 @@ SincResampler::SincResampler(double io_sample_rate_ratio,
   RTC_DCHECK_GT(request_frames_, 0);
   Flush();
   RTC_DCHECK_GT(block_size_, kKernelSize);
-
-  memset(kernel_storage_.get(), 0,
-         sizeof(*kernel_storage_.get()) * kKernelStorageSize);
-  memset(kernel_pre_sinc_storage_.get(), 0,
-         sizeof(*kernel_pre_sinc_storage_.get()) * kKernelStorageSize);
-  memset(kernel_window_storage_.get(), 0,
-         sizeof(*kernel_window_storage_.get()) * kKernelStorageSize);
-
-  InitializeKernel();
 }
 
 SincResampler::~SincResampler() {}
@@ -192,43 +280,6 @@ void SincResampler::UpdateRegions(bool second_load) {
   RTC_DCHECK_LT(r2_, r3_);
 }
 
-void SincResampler::InitializeKernel() {
-  // Blackman window parameters.
-  static const double kAlpha = 0.16;
-  static const double kA0 = 0.5 * (1.0 - kAlpha);
-  static const double kA1 = 0.5;
-  static const double kA2 = 0.5 * kAlpha;
-
-  // Generates a set of windowed sinc() kernels.
-  // We generate a range of sub-sample offsets from 0.0 to 1.0.
-  const double sinc_scale_factor = SincScaleFactor(io_sample_rate_ratio_);
-  for (size_t offset_idx = 0; offset_idx <= kKernelOffsetCount; ++offset_idx) {
-    const float subsample_offset =
-        static_cast<float>(offset_idx) / kKernelOffsetCount;
-
-    for (size_t i = 0; i < kKernelSize; ++i) {
-      const size_t idx = i + offset_idx * kKernelSize;
-      const float pre_sinc = static_cast<float>(
-          M_PI * (static_cast<int>(i) - static_cast<int>(kKernelSize / 2) -
-                  subsample_offset));
-      kernel_pre_sinc_storage_[idx] = pre_sinc;
-
-      // Compute Blackman window, matching the offset of the sinc().
-      const float x = (i - subsample_offset) / kKernelSize;
-      const float window = static_cast<float>(kA0 - kA1 * cos(2.0 * M_PI * x) +
-                                              kA2 * cos(4.0 * M_PI * x));
-      kernel_window_storage_[idx] = window;
-
-      // Compute the sinc with offset, then window the sinc() function and store
-      // at the correct offset.
-      kernel_storage_[idx] = static_cast<float>(
-          window * ((pre_sinc == 0)
-                        ? sinc_scale_factor
-                        : (sin(sinc_scale_factor * pre_sinc) / pre_sinc)));
-    }
-  }
-}
-
 void SincResampler::SetRatio(double io_sample_rate_ratio) {
   if (fabs(io_sample_rate_ratio_ - io_sample_rate_ratio) <
       std::numeric_limits<double>::epsilon()) {
@@ -236,22 +287,7 @@ void SincResampler::SetRatio(double io_sample_rate_ratio) {
   }
 
   io_sample_rate_ratio_ = io_sample_rate_ratio;
-
-  // Optimize reinitialization by reusing values which are independent of
-  // |sinc_scale_factor|.  Provides a 3x speedup.
-  const double sinc_scale_factor = SincScaleFactor(io_sample_rate_ratio_);
-  for (size_t offset_idx = 0; offset_idx <= kKernelOffsetCount; ++offset_idx) {
-    for (size_t i = 0; i < kKernelSize; ++i) {
-      const size_t idx = i + offset_idx * kKernelSize;
-      const float window = kernel_window_storage_[idx];
-      const float pre_sinc = kernel_pre_sinc_storage_[idx];
-
-      kernel_storage_[idx] = static_cast<float>(
-          window * ((pre_sinc == 0)
-                        ? sinc_scale_factor
-                        : (sin(sinc_scale_factor * pre_sinc) / pre_sinc)));
-    }
-  }
+  kernel_ = GetKernelCache()->GetKernel(io_sample_rate_ratio_);
 }
 
 void SincResampler::Resample(size_t frames, float* destination) {
@@ -266,7 +302,7 @@ void SincResampler::Resample(size_t frames, float* destination) {
   // Step (2) -- Resample!  const what we can outside of the loop for speed.  It
   // actually has an impact on ARM performance.  See inner loop comment below.
   const double current_io_ratio = io_sample_rate_ratio_;
-  const float* const kernel_ptr = kernel_storage_.get();
+  const float* const kernel_ptr = kernel_.get();
   while (remaining_frames) {
     // |i| may be negative if the last Resample() call ended on an iteration
     // that put |virtual_source_idx_| over the limit.
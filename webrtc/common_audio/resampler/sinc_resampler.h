@@ -85,13 +85,12 @@ class SincResampler {
   // SincResampler.  We would also need a way to update |request_frames_|.
   void SetRatio(double io_sample_rate_ratio);
 
-  float* get_kernel_for_testing() { return kernel_storage_.get(); }
+  const float* get_kernel_for_testing() { return kernel_.get(); }
 
  private:
   FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, Convolve);
   FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, ConvolveBenchmark);
 
-  void InitializeKernel();
   void UpdateRegions(bool second_load);
 
   // Selects runtime specific CPU features like SSE.  Must be called before
@@ -116,6 +115,12 @@ class SincResampler {
                              const float* k1,
                              const float* k2,
                              double kernel_interpolation_factor);
+#if defined(WEBRTC_ENABLE_AVX512)
+  static float Convolve_AVX512(const float* input_ptr,
+                               const float* k1,
+                               const float* k2,
+                               double kernel_interpolation_factor);
+#endif
 #elif defined(WEBRTC_HAS_NEON)
   static float Convolve_NEON(const float* input_ptr,
                              const float* k1,
@@ -147,10 +152,9 @@ class SincResampler {
 
   // Contains kKernelOffsetCount kernels back-to-back, each of size kKernelSize.
   // The kernel offsets are sub-sample shifts of a windowed sinc shifted from
-  // 0.0 to 1.0 sample.
-  std::unique_ptr<float[], AlignedFreeDeleter> kernel_storage_;
-  std::unique_ptr<float[], AlignedFreeDeleter> kernel_pre_sinc_storage_;
-  std::unique_ptr<float[], AlignedFreeDeleter> kernel_window_storage_;
+  // 0.0 to 1.0 sample. The kernels only depend on the sample rate ratio and
+  // are shared by all resamplers using the same ratio.
+  std::shared_ptr<const float> kernel_;
 
   // Data from the source is copied into this buffer for each processing pass.
   std::unique_ptr<float[], AlignedFreeDeleter> input_buffer_;
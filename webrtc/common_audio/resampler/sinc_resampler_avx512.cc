@@ -0,0 +1,60 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common_audio/resampler/sinc_resampler.h"
+
+namespace webrtc {
+
+static_assert(SincResampler::kKernelSize % 16 == 0,
+              "The kernel size must be a multiple of the AVX-512 width");
+
+float SincResampler::Convolve_AVX512(const float* input_ptr,
+                                     const float* k1,
+                                     const float* k2,
+                                     double kernel_interpolation_factor) {
+  __m512 m_sums1 = _mm512_setzero_ps();
+  __m512 m_sums2 = _mm512_setzero_ps();
+
+  // The kernels are 64-byte aligned, while |input_ptr| in general is not.
+  for (size_t i = 0; i < kKernelSize; i += 16) {
+    const __m512 m_input = _mm512_loadu_ps(input_ptr + i);
+    m_sums1 = _mm512_fmadd_ps(m_input, _mm512_load_ps(k1 + i), m_sums1);
+    m_sums2 = _mm512_fmadd_ps(m_input, _mm512_load_ps(k2 + i), m_sums2);
+  }
+
+  // Linearly interpolate the two "convolutions".
+  m_sums1 = _mm512_mul_ps(
+      m_sums1,
+      _mm512_set1_ps(static_cast<float>(1.0 - kernel_interpolation_factor)));
+  m_sums1 = _mm512_fmadd_ps(
+      m_sums2, _mm512_set1_ps(static_cast<float>(kernel_interpolation_factor)),
+      m_sums1);
+
+  // Sum components together. GCC warns about an uninitialized variable in
+  // _mm512_reduce_add_ps() and in the unmasked 512-bit extracts, so the four
+  // 128-bit lanes are extracted with the masked variant and a full mask.
+  const __m128 m_zero = _mm_setzero_ps();
+  __m128 m128_sums = _mm_add_ps(
+      _mm_add_ps(_mm512_mask_extractf32x4_ps(m_zero, 0xF, m_sums1, 0),
+                 _mm512_mask_extractf32x4_ps(m_zero, 0xF, m_sums1, 1)),
+      _mm_add_ps(_mm512_mask_extractf32x4_ps(m_zero, 0xF, m_sums1, 2),
+                 _mm512_mask_extractf32x4_ps(m_zero, 0xF, m_sums1, 3)));
+  m128_sums = _mm_add_ps(_mm_movehl_ps(m128_sums, m128_sums), m128_sums);
+  float result;
+  _mm_store_ss(&result,
+               _mm_add_ss(m128_sums, _mm_shuffle_ps(m128_sums, m128_sums, 1)));
+  return result;
+}
+
+}  // namespace webrtc
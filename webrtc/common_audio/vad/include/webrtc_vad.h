@@ -20,6 +20,7 @@
 #include <stdint.h>
 
 typedef struct WebRtcVadInst VadInst;
+typedef struct WebRtcVadBatchInst VadBatchInst;
 
 #ifdef __cplusplus
 extern "C" {
@@ -80,6 +81,61 @@ int WebRtcVad_Process(VadInst* handle,
 // returns            : 0 - (valid combination), -1 - (invalid combination)
 int WebRtcVad_ValidRateAndFrameLength(int rate, size_t frame_length);
 
+// Creates an instance of the batched VAD, which runs |num_streams| independent
+// VADs in a single call to WebRtcVad_ProcessBatch(). Every stream behaves
+// exactly as a VadInst fed with the same frames, but the filter banks of the
+// streams are run together, several streams per SIMD vector.
+//
+// - num_streams [i] : Number of streams, larger than zero.
+//
+// returns           : Pointer to the instance, or NULL at failure.
+VadBatchInst* WebRtcVad_CreateBatch(size_t num_streams);
+
+// Frees the dynamic memory of a specified batched VAD instance.
+//
+// - handle [i] : Pointer to the instance that should be freed.
+void WebRtcVad_FreeBatch(VadBatchInst* handle);
+
+// Initializes all streams of a batched VAD instance.
+//
+// - handle [i/o] : Instance that should be initialized.
+//
+// returns        : 0 - (OK),
+//                 -1 - (null pointer or Default mode could not be set).
+int WebRtcVad_InitBatch(VadBatchInst* handle);
+
+// Sets the operating mode of one stream of a batched VAD instance. See
+// WebRtcVad_set_mode() for the meaning of |mode|.
+//
+// - handle [i/o] : Batched VAD instance.
+// - stream [i]   : Index of the stream.
+// - mode   [i]   : Aggressiveness mode (0, 1, 2, or 3).
+//
+// returns        : 0 - (OK),
+//                 -1 - (null pointer, invalid stream, mode could not be set or
+//                       the instance has not been initialized).
+int WebRtcVad_set_mode_batch(VadBatchInst* handle, size_t stream, int mode);
+
+// Calculates a VAD decision for one frame of every stream. All frames share
+// the sampling frequency and frame length, see
+// WebRtcVad_ValidRateAndFrameLength() for the valid combinations.
+//
+// - handle        [i/o] : Batched VAD instance. Needs to be initialized by
+//                         WebRtcVad_InitBatch() before call.
+// - fs            [i]   : Sampling frequency (Hz): 8000, 16000, 32000 or 48000
+// - audio_frames  [i]   : One audio frame buffer per stream.
+// - frame_length  [i]   : Length of each audio frame buffer in number of
+//                         samples.
+// - vad_decisions [o]   : One decision per stream, 1 - (Active Voice),
+//                         0 - (Non-active Voice).
+//
+// returns               : 0 - (OK), -1 - (Error)
+int WebRtcVad_ProcessBatch(VadBatchInst* handle,
+                           int fs,
+                           const int16_t* const* audio_frames,
+                           size_t frame_length,
+                           int* vad_decisions);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,185 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_audio/vad/vad_batch.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "rtc_base/checks.h"
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "common_audio/vad/vad_sp.h"
+
+static const int kInitCheck = 42;
+// Maximum frame length, 30 ms in 32 kHz. 48 kHz frames are resampled per
+// stream and never interleaved at the input rate.
+static const size_t kMaxInterleavedLength = 960;
+
+// Interleaves |length| samples of the |num_lanes| frames in |frames| into
+// |lanes|. Lanes beyond |num_lanes| are set to zero.
+static void InterleaveLanes(const int16_t* const* frames, int num_lanes,
+                            size_t length, int16_t* lanes) {
+  size_t i;
+  int lane;
+
+  if (num_lanes < kVadBatchLanes) {
+    memset(lanes, 0, sizeof(*lanes) * length * kVadBatchLanes);
+  }
+  for (lane = 0; lane < num_lanes; lane++) {
+    const int16_t* frame = frames[lane];
+    for (i = 0; i < length; i++) {
+      lanes[i * kVadBatchLanes + lane] = frame[i];
+    }
+  }
+}
+
+// Downsamples the 48 kHz frames of one stream group to 8 kHz, one stream at a
+// time as in WebRtcVad_CalcVad48khz(), and interleaves the result into
+// |speech_nb|.
+static void Downsample48khzLanes(VadInstT* streams,
+                                 const int16_t* const* frames, int num_lanes,
+                                 size_t frame_length, int16_t* speech_nb) {
+  // |tmp_mem| is a temporary memory used by resample function, length is
+  // frame length in 10 ms (480 samples) + 256 extra.
+  int32_t tmp_mem[480 + 256] = { 0 };
+  int16_t lane_nb[240];  // 30 ms in 8 kHz.
+  const size_t kFrameLen10ms48khz = 480;
+  const size_t kFrameLen10ms8khz = 80;
+  size_t i;
+  int lane;
+
+  if (num_lanes < kVadBatchLanes) {
+    memset(speech_nb, 0, sizeof(*speech_nb) * 240 * kVadBatchLanes);
+  }
+  for (lane = 0; lane < num_lanes; lane++) {
+    // Like WebRtcVad_CalcVad48khz(), every 10 ms block is resampled from the
+    // start of the frame, which keeps the decisions identical.
+    for (i = 0; i < frame_length / kFrameLen10ms48khz; i++) {
+      WebRtcSpl_Resample48khzTo8khz(frames[lane],
+                                    &lane_nb[i * kFrameLen10ms8khz],
+                                    &streams[lane].state_48_to_8, tmp_mem);
+    }
+    for (i = 0; i < frame_length / 6; i++) {
+      speech_nb[i * kVadBatchLanes + lane] = lane_nb[i];
+    }
+  }
+}
+
+VadBatchT* WebRtcVad_CreateBatchCore(size_t num_streams) {
+  VadBatchT* self;
+  size_t num_groups;
+
+  if (num_streams == 0) {
+    return NULL;
+  }
+  num_groups = (num_streams + kVadBatchLanes - 1) / kVadBatchLanes;
+
+  // One allocation holds the header, followed by the stream groups, the per
+  // stream instances and the scratch buffers.
+  self = (VadBatchT*)malloc(
+      sizeof(VadBatchT) + num_groups * sizeof(VadBatchGroup) +
+      num_streams * sizeof(VadInstT) +
+      (kMaxInterleavedLength * 3 / 2) * kVadBatchLanes * sizeof(int16_t));
+  if (self == NULL) {
+    return NULL;
+  }
+
+  self->num_streams = num_streams;
+  self->num_groups = num_groups;
+  self->groups = (VadBatchGroup*)(self + 1);
+  self->streams = (VadInstT*)(self->groups + num_groups);
+  self->scratch_in = (int16_t*)(self->streams + num_streams);
+  self->scratch_wb = self->scratch_in + kMaxInterleavedLength * kVadBatchLanes;
+  self->init_flag = 0;
+
+  return self;
+}
+
+void WebRtcVad_FreeBatchCore(VadBatchT* self) {
+  free(self);
+}
+
+int WebRtcVad_InitBatchCore(VadBatchT* self) {
+  size_t i;
+
+  if (self == NULL) {
+    return -1;
+  }
+
+  for (i = 0; i < self->num_streams; i++) {
+    if (WebRtcVad_InitCore(&self->streams[i]) != 0) {
+      return -1;
+    }
+  }
+  memset(self->groups, 0, self->num_groups * sizeof(VadBatchGroup));
+
+  self->init_flag = kInitCheck;
+
+  return 0;
+}
+
+void WebRtcVad_CalcVadBatch(VadBatchT* self,
+                            int fs,
+                            const int16_t* const* audio_frames,
+                            size_t frame_length,
+                            int* vad_decisions) {
+  // Downsampled frames of one stream group, lane interleaved.
+  int16_t speech_nb[240 * kVadBatchLanes];  // 30 ms in 8 kHz.
+  int16_t features[kVadBatchLanes * kNumChannels];
+  int16_t total_power[kVadBatchLanes];
+  const size_t length = frame_length / (size_t)(fs / 8000);
+  size_t group;
+  int lane;
+
+  RTC_DCHECK_EQ(self->init_flag, kInitCheck);
+
+  for (group = 0; group < self->num_groups; group++) {
+    const size_t first_stream = group * kVadBatchLanes;
+    const int16_t* const* frames = &audio_frames[first_stream];
+    VadBatchGroup* states = &self->groups[group];
+    int num_lanes = kVadBatchLanes;
+    if (self->num_streams - first_stream < kVadBatchLanes) {
+      // Unused lanes run on silence; their results are discarded.
+      num_lanes = (int)(self->num_streams - first_stream);
+    }
+
+    // Downsample to 8 kHz.
+    if (fs == 48000) {
+      Downsample48khzLanes(&self->streams[first_stream], frames, num_lanes,
+                           frame_length, speech_nb);
+    } else if (fs == 32000) {
+      InterleaveLanes(frames, num_lanes, frame_length, self->scratch_in);
+      WebRtcVad_DownsamplingLanes(self->scratch_in, self->scratch_wb,
+                                  states->downsampling_filter_states[2],
+                                  frame_length);
+      WebRtcVad_DownsamplingLanes(self->scratch_wb, speech_nb,
+                                  states->downsampling_filter_states[0],
+                                  frame_length / 2);
+    } else if (fs == 16000) {
+      InterleaveLanes(frames, num_lanes, frame_length, self->scratch_in);
+      WebRtcVad_DownsamplingLanes(self->scratch_in, speech_nb,
+                                  states->downsampling_filter_states[0],
+                                  frame_length);
+    } else {
+      InterleaveLanes(frames, num_lanes, frame_length, speech_nb);
+    }
+
+    WebRtcVad_CalculateFeaturesBatch(&states->filterbank, speech_nb, length,
+                                     features, total_power);
+
+    for (lane = 0; lane < num_lanes; lane++) {
+      VadInstT* inst = &self->streams[first_stream + lane];
+      inst->vad = WebRtcVad_GmmProbability(inst,
+                                           &features[lane * kNumChannels],
+                                           total_power[lane], length);
+      vad_decisions[first_stream + lane] = inst->vad > 0 ? 1 : 0;
+    }
+  }
+}
@@ -0,0 +1,76 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * This header file includes the descriptions of the core calls of the batched
+ * VAD, which runs many independent VADs in one call.
+ */
+
+#ifndef COMMON_AUDIO_VAD_VAD_BATCH_H_
+#define COMMON_AUDIO_VAD_VAD_BATCH_H_
+
+#include "common_audio/vad/vad_core.h"
+#include "common_audio/vad/vad_filterbank.h"
+
+// Lane interleaved resampler and filter bank states of |kVadBatchLanes|
+// streams.
+typedef struct {
+  int32_t downsampling_filter_states[4][kVadBatchLanes];
+  VadFilterbankLanes filterbank;
+} VadBatchGroup;
+
+typedef struct VadBatchT_ {
+  size_t num_streams;
+  // Number of stream groups, the last one possibly only partially used.
+  size_t num_groups;
+  // Per stream GMM, hysteresis and 48 kHz resampler states. The 16 and 32 kHz
+  // downsampling and filter bank states of these instances are unused; they
+  // live in |groups| instead.
+  VadInstT* streams;
+  VadBatchGroup* groups;
+  // Lane interleaved frames of one group, at the input rate and at 16 kHz.
+  int16_t* scratch_in;
+  int16_t* scratch_wb;
+
+  int init_flag;
+} VadBatchT;
+
+// Allocates a batched VAD for |num_streams| streams. All state is carved out
+// of a single allocation, to be released with WebRtcVad_FreeBatchCore().
+//
+// returns : Pointer to the instance, or NULL if |num_streams| is zero or the
+//           allocation failed.
+VadBatchT* WebRtcVad_CreateBatchCore(size_t num_streams);
+
+// Frees the memory of |self|.
+void WebRtcVad_FreeBatchCore(VadBatchT* self);
+
+// Initializes every stream of |self| as WebRtcVad_InitCore() does.
+//
+// returns : 0 (OK), -1 (null pointer in or if the default mode can't be set)
+int WebRtcVad_InitBatchCore(VadBatchT* self);
+
+// Calculates the VAD decision of every stream for one frame each. All streams
+// share the sampling frequency |fs| and |frame_length|, which have to be a
+// valid combination for WebRtcVad_ValidRateAndFrameLength().
+//
+// - self          [i/o] : Initialized batched VAD.
+// - fs            [i]   : Sampling frequency (Hz): 8000, 16000, 32000 or 48000.
+// - audio_frames  [i]   : One frame per stream, |self->num_streams| pointers.
+// - frame_length  [i]   : Length of each frame in number of samples.
+// - vad_decisions [o]   : VAD decision per stream, 0 - No active speech,
+//                         1 - Active speech.
+void WebRtcVad_CalcVadBatch(VadBatchT* self,
+                            int fs,
+                            const int16_t* const* audio_frames,
+                            size_t frame_length,
+                            int* vad_decisions);
+
+#endif  // COMMON_AUDIO_VAD_VAD_BATCH_H_
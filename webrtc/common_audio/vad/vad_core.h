@@ -21,6 +21,9 @@ enum { kNumChannels = 6 };   // Number of frequency bands (named channels).
 enum { kNumGaussians = 2 };  // Number of Gaussians per channel in the GMM.
 enum { kTableSize = kNumChannels * kNumGaussians };
 enum { kMinEnergy = 10 };  // Minimum energy required to trigger audio signal.
+// Number of streams filtered in lock step by the batched VAD, i.e., one
+// 128-bit vector of int16_t.
+enum { kVadBatchLanes = 8 };
 
 typedef struct VadInstT_ {
   int vad;
@@ -78,6 +81,23 @@ int WebRtcVad_InitCore(VadInstT* self);
 
 int WebRtcVad_set_mode_core(VadInstT* self, int mode);
 
+// Calculates the probabilities for both speech and background noise using
+// Gaussian Mixture Models (GMM). A hypothesis-test is performed to decide which
+// type of signal is most probable. The models of |self| are updated w.r.t. the
+// decision made.
+//
+// - self           [i/o] : Pointer to VAD instance
+// - features       [i]   : Feature vector of length |kNumChannels|
+//                          = log10(energy in frequency band)
+// - total_power    [i]   : Total power in audio frame.
+// - frame_length   [i]   : Number of input samples
+//
+// - returns              : the VAD decision (0 - noise, >0 - speech).
+int16_t WebRtcVad_GmmProbability(VadInstT* self,
+                                 int16_t* features,
+                                 int16_t total_power,
+                                 size_t frame_length);
+
 /****************************************************************************
  * WebRtcVad_CalcVad48khz(...)
  * WebRtcVad_CalcVad32khz(...)
@@ -10,6 +10,16 @@
 
 #include "common_audio/vad/vad_filterbank.h"
 
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
 #include "rtc_base/checks.h"
 #include "common_audio/signal_processing/include/signal_processing_library.h"
 
@@ -138,6 +148,283 @@ static void SplitFilter(const int16_t* data_in, size_t data_length,
   }
 }
 
+// Same as HighPassFilter() for |kVadBatchLanes| lane interleaved streams.
+// |filter_state| holds the four states of every lane, state major.
+static void HighPassFilterLanes(const int16_t* data_in, size_t data_length,
+                                int16_t* filter_state, int16_t* data_out) {
+  size_t i;
+#if defined(WEBRTC_HAS_NEON)
+  int16x8_t state0 = vld1q_s16(&filter_state[0 * kVadBatchLanes]);
+  int16x8_t state1 = vld1q_s16(&filter_state[1 * kVadBatchLanes]);
+  int16x8_t state2 = vld1q_s16(&filter_state[2 * kVadBatchLanes]);
+  int16x8_t state3 = vld1q_s16(&filter_state[3 * kVadBatchLanes]);
+
+  for (i = 0; i < data_length; i++) {
+    const int16x8_t in = vld1q_s16(data_in);
+    int32x4_t tmp_low = vmull_n_s16(vget_low_s16(in), kHpZeroCoefs[0]);
+    int32x4_t tmp_high = vmull_n_s16(vget_high_s16(in), kHpZeroCoefs[0]);
+    tmp_low = vmlal_n_s16(tmp_low, vget_low_s16(state0), kHpZeroCoefs[1]);
+    tmp_high = vmlal_n_s16(tmp_high, vget_high_s16(state0), kHpZeroCoefs[1]);
+    tmp_low = vmlal_n_s16(tmp_low, vget_low_s16(state1), kHpZeroCoefs[2]);
+    tmp_high = vmlal_n_s16(tmp_high, vget_high_s16(state1), kHpZeroCoefs[2]);
+    tmp_low = vmlsl_n_s16(tmp_low, vget_low_s16(state2), kHpPoleCoefs[1]);
+    tmp_high = vmlsl_n_s16(tmp_high, vget_high_s16(state2), kHpPoleCoefs[1]);
+    tmp_low = vmlsl_n_s16(tmp_low, vget_low_s16(state3), kHpPoleCoefs[2]);
+    tmp_high = vmlsl_n_s16(tmp_high, vget_high_s16(state3), kHpPoleCoefs[2]);
+    state1 = state0;
+    state0 = in;
+    state3 = state2;
+    // The narrowing shift truncates like the (int16_t) cast in the C version.
+    state2 = vcombine_s16(vshrn_n_s32(tmp_low, 14), vshrn_n_s32(tmp_high, 14));
+    vst1q_s16(data_out, state2);
+    data_in += kVadBatchLanes;
+    data_out += kVadBatchLanes;
+  }
+
+  vst1q_s16(&filter_state[0 * kVadBatchLanes], state0);
+  vst1q_s16(&filter_state[1 * kVadBatchLanes], state1);
+  vst1q_s16(&filter_state[2 * kVadBatchLanes], state2);
+  vst1q_s16(&filter_state[3 * kVadBatchLanes], state3);
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+  // Coefficient pairs for _mm_madd_epi16(), matching the interleaving of
+  // (input, state0), (state1, state2) and (state3, 0) below.
+  const __m128i coefs_in_state0 = _mm_setr_epi16(
+      kHpZeroCoefs[0], kHpZeroCoefs[1], kHpZeroCoefs[0], kHpZeroCoefs[1],
+      kHpZeroCoefs[0], kHpZeroCoefs[1], kHpZeroCoefs[0], kHpZeroCoefs[1]);
+  const __m128i coefs_state1_state2 = _mm_setr_epi16(
+      kHpZeroCoefs[2], -kHpPoleCoefs[1], kHpZeroCoefs[2], -kHpPoleCoefs[1],
+      kHpZeroCoefs[2], -kHpPoleCoefs[1], kHpZeroCoefs[2], -kHpPoleCoefs[1]);
+  const __m128i coefs_state3 = _mm_setr_epi16(
+      -kHpPoleCoefs[2], 0, -kHpPoleCoefs[2], 0,
+      -kHpPoleCoefs[2], 0, -kHpPoleCoefs[2], 0);
+  const __m128i zero = _mm_setzero_si128();
+  __m128i state0 =
+      _mm_loadu_si128((const __m128i*)&filter_state[0 * kVadBatchLanes]);
+  __m128i state1 =
+      _mm_loadu_si128((const __m128i*)&filter_state[1 * kVadBatchLanes]);
+  __m128i state2 =
+      _mm_loadu_si128((const __m128i*)&filter_state[2 * kVadBatchLanes]);
+  __m128i state3 =
+      _mm_loadu_si128((const __m128i*)&filter_state[3 * kVadBatchLanes]);
+
+  for (i = 0; i < data_length; i++) {
+    const __m128i in = _mm_loadu_si128((const __m128i*)data_in);
+    __m128i tmp_low = _mm_add_epi32(
+        _mm_madd_epi16(_mm_unpacklo_epi16(in, state0), coefs_in_state0),
+        _mm_madd_epi16(_mm_unpacklo_epi16(state1, state2),
+                       coefs_state1_state2));
+    __m128i tmp_high = _mm_add_epi32(
+        _mm_madd_epi16(_mm_unpackhi_epi16(in, state0), coefs_in_state0),
+        _mm_madd_epi16(_mm_unpackhi_epi16(state1, state2),
+                       coefs_state1_state2));
+    tmp_low = _mm_add_epi32(
+        tmp_low, _mm_madd_epi16(_mm_unpacklo_epi16(state3, zero),
+                                coefs_state3));
+    tmp_high = _mm_add_epi32(
+        tmp_high, _mm_madd_epi16(_mm_unpackhi_epi16(state3, zero),
+                                 coefs_state3));
+    // (int16_t) (tmp32 >> 14) equals the upper half of (tmp32 << 2), which
+    // makes the saturating pack exact.
+    tmp_low = _mm_srai_epi32(_mm_slli_epi32(tmp_low, 2), 16);
+    tmp_high = _mm_srai_epi32(_mm_slli_epi32(tmp_high, 2), 16);
+    state1 = state0;
+    state0 = in;
+    state3 = state2;
+    state2 = _mm_packs_epi32(tmp_low, tmp_high);
+    _mm_storeu_si128((__m128i*)data_out, state2);
+    data_in += kVadBatchLanes;
+    data_out += kVadBatchLanes;
+  }
+
+  _mm_storeu_si128((__m128i*)&filter_state[0 * kVadBatchLanes], state0);
+  _mm_storeu_si128((__m128i*)&filter_state[1 * kVadBatchLanes], state1);
+  _mm_storeu_si128((__m128i*)&filter_state[2 * kVadBatchLanes], state2);
+  _mm_storeu_si128((__m128i*)&filter_state[3 * kVadBatchLanes], state3);
+#else
+  int16_t* state0 = &filter_state[0 * kVadBatchLanes];
+  int16_t* state1 = &filter_state[1 * kVadBatchLanes];
+  int16_t* state2 = &filter_state[2 * kVadBatchLanes];
+  int16_t* state3 = &filter_state[3 * kVadBatchLanes];
+  int lane;
+
+  for (i = 0; i < data_length; i++) {
+    for (lane = 0; lane < kVadBatchLanes; lane++) {
+      int32_t tmp32 = kHpZeroCoefs[0] * data_in[lane];
+      tmp32 += kHpZeroCoefs[1] * state0[lane];
+      tmp32 += kHpZeroCoefs[2] * state1[lane];
+      state1[lane] = state0[lane];
+      state0[lane] = data_in[lane];
+      tmp32 -= kHpPoleCoefs[1] * state2[lane];
+      tmp32 -= kHpPoleCoefs[2] * state3[lane];
+      state3[lane] = state2[lane];
+      state2[lane] = (int16_t) (tmp32 >> 14);
+      data_out[lane] = state2[lane];
+    }
+    data_in += kVadBatchLanes;
+    data_out += kVadBatchLanes;
+  }
+#endif
+}
+
+#if defined(WEBRTC_HAS_NEON)
+// One sample of AllPassFilter() for |kVadBatchLanes| streams. |state_low| and
+// |state_high| hold the Q15 states of lanes 0-3 and 4-7.
+static inline int16x8_t AllPassStepNeon(int16x8_t in,
+                                        int16_t filter_coefficient,
+                                        int32x4_t* state_low,
+                                        int32x4_t* state_high) {
+  const int32x4_t tmp_low =
+      vmlal_n_s16(*state_low, vget_low_s16(in), filter_coefficient);
+  const int32x4_t tmp_high =
+      vmlal_n_s16(*state_high, vget_high_s16(in), filter_coefficient);
+  const int16x8_t out = vcombine_s16(vshrn_n_s32(tmp_low, 16),
+                                     vshrn_n_s32(tmp_high, 16));  // Q(-1)
+  const int32x4_t state14_low = vmlsl_n_s16(
+      vshll_n_s16(vget_low_s16(in), 14), vget_low_s16(out),
+      filter_coefficient);  // Q14
+  const int32x4_t state14_high = vmlsl_n_s16(
+      vshll_n_s16(vget_high_s16(in), 14), vget_high_s16(out),
+      filter_coefficient);
+  *state_low = vshlq_n_s32(state14_low, 1);  // Q15.
+  *state_high = vshlq_n_s32(state14_high, 1);
+  return out;
+}
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+// One sample of AllPassFilter() for |kVadBatchLanes| streams. |state_low| and
+// |state_high| hold the Q15 states of lanes 0-3 and 4-7.
+static inline __m128i AllPassStepSse2(__m128i in, __m128i filter_coefficient,
+                                      __m128i* state_low,
+                                      __m128i* state_high) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i product_low = _mm_mullo_epi16(in, filter_coefficient);
+  __m128i product_high = _mm_mulhi_epi16(in, filter_coefficient);
+  const __m128i tmp_low = _mm_add_epi32(
+      *state_low, _mm_unpacklo_epi16(product_low, product_high));
+  const __m128i tmp_high = _mm_add_epi32(
+      *state_high, _mm_unpackhi_epi16(product_low, product_high));
+  // An arithmetic shift by 16 always fits an int16_t, so the pack is exact.
+  const __m128i out = _mm_packs_epi32(_mm_srai_epi32(tmp_low, 16),
+                                      _mm_srai_epi32(tmp_high, 16));  // Q(-1)
+  product_low = _mm_mullo_epi16(out, filter_coefficient);
+  product_high = _mm_mulhi_epi16(out, filter_coefficient);
+  // (in << 16) >> 2 sign extends |in| to Q14.
+  *state_low = _mm_slli_epi32(
+      _mm_sub_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(zero, in), 2),
+                    _mm_unpacklo_epi16(product_low, product_high)),
+      1);  // Q15.
+  *state_high = _mm_slli_epi32(
+      _mm_sub_epi32(_mm_srai_epi32(_mm_unpackhi_epi16(zero, in), 2),
+                    _mm_unpackhi_epi16(product_low, product_high)),
+      1);
+  return out;
+}
+#endif
+
+// Same as SplitFilter() for |kVadBatchLanes| lane interleaved streams. The
+// upper and lower all-pass branches are run in the same loop, which keeps two
+// independent dependency chains in flight.
+static void SplitFilterLanes(const int16_t* data_in, size_t data_length,
+                             int16_t* upper_state, int16_t* lower_state,
+                             int16_t* hp_data_out, int16_t* lp_data_out) {
+  size_t i;
+  size_t half_length = data_length >> 1;  // Downsampling by 2.
+#if defined(WEBRTC_HAS_NEON)
+  const int16x8_t upper16 = vld1q_s16(upper_state);
+  const int16x8_t lower16 = vld1q_s16(lower_state);
+  int32x4_t upper_low = vshll_n_s16(vget_low_s16(upper16), 16);  // Q15
+  int32x4_t upper_high = vshll_n_s16(vget_high_s16(upper16), 16);
+  int32x4_t lower_low = vshll_n_s16(vget_low_s16(lower16), 16);
+  int32x4_t lower_high = vshll_n_s16(vget_high_s16(lower16), 16);
+
+  for (i = 0; i < half_length; i++) {
+    const int16x8_t hp = AllPassStepNeon(vld1q_s16(data_in),
+                                         kAllPassCoefsQ15[0], &upper_low,
+                                         &upper_high);
+    const int16x8_t lp = AllPassStepNeon(vld1q_s16(data_in + kVadBatchLanes),
+                                         kAllPassCoefsQ15[1], &lower_low,
+                                         &lower_high);
+    // Make LP and HP signals.
+    vst1q_s16(hp_data_out, vsubq_s16(hp, lp));
+    vst1q_s16(lp_data_out, vaddq_s16(lp, hp));
+    data_in += 2 * kVadBatchLanes;
+    hp_data_out += kVadBatchLanes;
+    lp_data_out += kVadBatchLanes;
+  }
+
+  vst1q_s16(upper_state, vcombine_s16(vshrn_n_s32(upper_low, 16),
+                                      vshrn_n_s32(upper_high, 16)));
+  vst1q_s16(lower_state, vcombine_s16(vshrn_n_s32(lower_low, 16),
+                                      vshrn_n_s32(lower_high, 16)));
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+  const __m128i upper_coefficient = _mm_set1_epi16(kAllPassCoefsQ15[0]);
+  const __m128i lower_coefficient = _mm_set1_epi16(kAllPassCoefsQ15[1]);
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i upper16 = _mm_loadu_si128((const __m128i*)upper_state);
+  const __m128i lower16 = _mm_loadu_si128((const __m128i*)lower_state);
+  // Interleaving zeros below the states multiplies them by 2^16, Q15.
+  __m128i upper_low = _mm_unpacklo_epi16(zero, upper16);
+  __m128i upper_high = _mm_unpackhi_epi16(zero, upper16);
+  __m128i lower_low = _mm_unpacklo_epi16(zero, lower16);
+  __m128i lower_high = _mm_unpackhi_epi16(zero, lower16);
+
+  for (i = 0; i < half_length; i++) {
+    const __m128i hp = AllPassStepSse2(
+        _mm_loadu_si128((const __m128i*)data_in), upper_coefficient,
+        &upper_low, &upper_high);
+    const __m128i lp = AllPassStepSse2(
+        _mm_loadu_si128((const __m128i*)(data_in + kVadBatchLanes)),
+        lower_coefficient, &lower_low, &lower_high);
+    // Make LP and HP signals.
+    _mm_storeu_si128((__m128i*)hp_data_out, _mm_sub_epi16(hp, lp));
+    _mm_storeu_si128((__m128i*)lp_data_out, _mm_add_epi16(lp, hp));
+    data_in += 2 * kVadBatchLanes;
+    hp_data_out += kVadBatchLanes;
+    lp_data_out += kVadBatchLanes;
+  }
+
+  _mm_storeu_si128((__m128i*)upper_state,
+                   _mm_packs_epi32(_mm_srai_epi32(upper_low, 16),
+                                   _mm_srai_epi32(upper_high, 16)));
+  _mm_storeu_si128((__m128i*)lower_state,
+                   _mm_packs_epi32(_mm_srai_epi32(lower_low, 16),
+                                   _mm_srai_epi32(lower_high, 16)));
+#else
+  int32_t upper32[kVadBatchLanes], lower32[kVadBatchLanes];
+  int lane;
+
+  for (lane = 0; lane < kVadBatchLanes; lane++) {
+    upper32[lane] = ((int32_t) upper_state[lane] * (1 << 16));  // Q15
+    lower32[lane] = ((int32_t) lower_state[lane] * (1 << 16));
+  }
+
+  for (i = 0; i < half_length; i++) {
+    for (lane = 0; lane < kVadBatchLanes; lane++) {
+      const int16_t upper_in = data_in[lane];
+      const int16_t lower_in = data_in[kVadBatchLanes + lane];
+      const int16_t hp = (int16_t) ((upper32[lane] +
+          kAllPassCoefsQ15[0] * upper_in) >> 16);  // Q(-1)
+      const int16_t lp = (int16_t) ((lower32[lane] +
+          kAllPassCoefsQ15[1] * lower_in) >> 16);
+      upper32[lane] = (upper_in * (1 << 14)) - kAllPassCoefsQ15[0] * hp;
+      upper32[lane] *= 2;  // Q15.
+      lower32[lane] = (lower_in * (1 << 14)) - kAllPassCoefsQ15[1] * lp;
+      lower32[lane] *= 2;
+      // Make LP and HP signals.
+      hp_data_out[lane] = hp - lp;
+      lp_data_out[lane] = lp + hp;
+    }
+    data_in += 2 * kVadBatchLanes;
+    hp_data_out += kVadBatchLanes;
+    lp_data_out += kVadBatchLanes;
+  }
+
+  for (lane = 0; lane < kVadBatchLanes; lane++) {
+    upper_state[lane] = (int16_t) (upper32[lane] >> 16);  // Q(-1)
+    lower_state[lane] = (int16_t) (lower32[lane] >> 16);
+  }
+#endif
+}
+
 // Calculates the energy of |data_in| in dB, and also updates an overall
 // |total_energy| if necessary.
 //
@@ -327,3 +614,84 @@ int16_t WebRtcVad_CalculateFeatures(VadInstT* self, const int16_t* data_in,
 
   return total_energy;
 }
+
+// Runs LogOfEnergy() on each stream of the lane interleaved |data_in|, updating
+// |features[lane * kNumChannels + band]| and |total_energy[lane]|.
+static void LogOfEnergyLanes(const int16_t* data_in, size_t data_length,
+                             int band, int16_t* total_energy,
+                             int16_t* features) {
+  int16_t lane_data[60];
+  size_t i;
+  int lane;
+
+  RTC_DCHECK_LE(data_length, 60);
+
+  for (lane = 0; lane < kVadBatchLanes; lane++) {
+    for (i = 0; i < data_length; i++) {
+      lane_data[i] = data_in[i * kVadBatchLanes + lane];
+    }
+    LogOfEnergy(lane_data, data_length, kOffsetVector[band],
+                &total_energy[lane], &features[lane * kNumChannels + band]);
+  }
+}
+
+void WebRtcVad_CalculateFeaturesBatch(VadFilterbankLanes* self,
+                                      const int16_t* data_in,
+                                      size_t data_length,
+                                      int16_t* features,
+                                      int16_t* total_energy) {
+  // Same band split as in WebRtcVad_CalculateFeatures(), with every buffer
+  // holding |kVadBatchLanes| interleaved streams.
+  int16_t hp_120[120 * kVadBatchLanes], lp_120[120 * kVadBatchLanes];
+  int16_t hp_60[60 * kVadBatchLanes], lp_60[60 * kVadBatchLanes];
+  const size_t half_data_length = data_length >> 1;
+  size_t length = half_data_length;
+
+  RTC_DCHECK_LE(data_length, 240);
+
+  memset(total_energy, 0, sizeof(*total_energy) * kVadBatchLanes);
+
+  // Split at 2000 Hz and downsample.
+  SplitFilterLanes(data_in, data_length, self->upper_state[0],
+                   self->lower_state[0], hp_120, lp_120);
+
+  // For the upper band (2000 Hz - 4000 Hz) split at 3000 Hz and downsample.
+  SplitFilterLanes(hp_120, length, self->upper_state[1], self->lower_state[1],
+                   hp_60, lp_60);
+
+  // Energy in 3000 Hz - 4000 Hz and 2000 Hz - 3000 Hz.
+  length >>= 1;
+  LogOfEnergyLanes(hp_60, length, 5, total_energy, features);
+  LogOfEnergyLanes(lp_60, length, 4, total_energy, features);
+
+  // For the lower band (0 Hz - 2000 Hz) split at 1000 Hz and downsample.
+  length = half_data_length;
+  SplitFilterLanes(lp_120, length, self->upper_state[2], self->lower_state[2],
+                   hp_60, lp_60);
+
+  // Energy in 1000 Hz - 2000 Hz.
+  length >>= 1;
+  LogOfEnergyLanes(hp_60, length, 3, total_energy, features);
+
+  // For the lower band (0 Hz - 1000 Hz) split at 500 Hz and downsample.
+  SplitFilterLanes(lp_60, length, self->upper_state[3], self->lower_state[3],
+                   hp_120, lp_120);
+
+  // Energy in 500 Hz - 1000 Hz.
+  length >>= 1;
+  LogOfEnergyLanes(hp_120, length, 2, total_energy, features);
+
+  // For the lower band (0 Hz - 500 Hz) split at 250 Hz and downsample.
+  SplitFilterLanes(lp_120, length, self->upper_state[4], self->lower_state[4],
+                   hp_60, lp_60);
+
+  // Energy in 250 Hz - 500 Hz.
+  length >>= 1;
+  LogOfEnergyLanes(hp_60, length, 1, total_energy, features);
+
+  // Remove 0 Hz - 80 Hz, by high pass filtering the lower band.
+  HighPassFilterLanes(lp_60, length, self->hp_filter_state[0], hp_120);
+
+  // Energy in 80 Hz - 250 Hz.
+  LogOfEnergyLanes(hp_120, length, 0, total_energy, features);
+}
@@ -42,4 +42,34 @@ int16_t WebRtcVad_CalculateFeatures(VadInstT* self,
                                     size_t data_length,
                                     int16_t* features);
 
+// Filter bank states of |kVadBatchLanes| streams. The states are stored lane
+// interleaved, e.g., |upper_state[band][lane]|, so that a single vector load
+// fetches the same state of every stream.
+typedef struct {
+  int16_t upper_state[5][kVadBatchLanes];
+  int16_t lower_state[5][kVadBatchLanes];
+  int16_t hp_filter_state[4][kVadBatchLanes];
+} VadFilterbankLanes;
+
+// Same as WebRtcVad_CalculateFeatures(), but for |kVadBatchLanes| independent
+// streams at once. The result for each lane is bit exact with running
+// WebRtcVad_CalculateFeatures() on that stream alone.
+//
+// - self         [i/o] : Filter bank states of the streams.
+// - data_in      [i]   : Lane interleaved input audio data, where sample |i|
+//                        of stream |lane| is |data_in[i * kVadBatchLanes +
+//                        lane]|.
+// - data_length  [i]   : Audio data size per stream, in number of samples.
+// - features     [o]   : 10 * log10(energy in each frequency band), Q4, of
+//                        length |kVadBatchLanes| * |kNumChannels|. The
+//                        features of stream |lane| start at
+//                        |features[lane * kNumChannels]|.
+// - total_energy [o]   : Total energy of each stream, of length
+//                        |kVadBatchLanes|.
+void WebRtcVad_CalculateFeaturesBatch(VadFilterbankLanes* self,
+                                      const int16_t* data_in,
+                                      size_t data_length,
+                                      int16_t* features,
+                                      int16_t* total_energy);
+
 #endif  // COMMON_AUDIO_VAD_VAD_FILTERBANK_H_
@@ -10,6 +10,16 @@
 
 #include "common_audio/vad/vad_sp.h"
 
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
 #include "rtc_base/checks.h"
 #include "common_audio/signal_processing/include/signal_processing_library.h"
 #include "common_audio/vad/vad_core.h"
@@ -52,6 +62,144 @@ void WebRtcVad_Downsampling(const int16_t* signal_in,
   filter_state[1] = tmp32_2;
 }
 
+#if defined(WEBRTC_HAS_NEON)
+// One all-pass branch of WebRtcVad_DownsamplingLanes(). Returns the branch
+// output of all lanes and updates the states, lanes 0-3 and 4-7.
+static inline int16x8_t AllPassBranchNeon(int16x8_t in, int16_t coefficient,
+                                          int32x4_t* state_low,
+                                          int32x4_t* state_high) {
+  const int32x4_t sum_low = vaddq_s32(
+      vshrq_n_s32(*state_low, 1),
+      vshrq_n_s32(vmull_n_s16(vget_low_s16(in), coefficient), 14));
+  const int32x4_t sum_high = vaddq_s32(
+      vshrq_n_s32(*state_high, 1),
+      vshrq_n_s32(vmull_n_s16(vget_high_s16(in), coefficient), 14));
+  // The narrowing move truncates like the (int16_t) cast in the C version.
+  const int16x8_t out = vcombine_s16(vmovn_s32(sum_low), vmovn_s32(sum_high));
+
+  *state_low = vsubq_s32(
+      vmovl_s16(vget_low_s16(in)),
+      vshrq_n_s32(vmull_n_s16(vget_low_s16(out), coefficient), 12));
+  *state_high = vsubq_s32(
+      vmovl_s16(vget_high_s16(in)),
+      vshrq_n_s32(vmull_n_s16(vget_high_s16(out), coefficient), 12));
+  return out;
+}
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+// One all-pass branch of WebRtcVad_DownsamplingLanes(). Returns the branch
+// output of all lanes and updates the states, lanes 0-3 and 4-7.
+static inline __m128i AllPassBranchSse2(__m128i in, __m128i coefficient,
+                                        __m128i* state_low,
+                                        __m128i* state_high) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i product_low = _mm_mullo_epi16(in, coefficient);
+  __m128i product_high = _mm_mulhi_epi16(in, coefficient);
+  __m128i sum_low = _mm_add_epi32(
+      _mm_srai_epi32(*state_low, 1),
+      _mm_srai_epi32(_mm_unpacklo_epi16(product_low, product_high), 14));
+  __m128i sum_high = _mm_add_epi32(
+      _mm_srai_epi32(*state_high, 1),
+      _mm_srai_epi32(_mm_unpackhi_epi16(product_low, product_high), 14));
+  __m128i out;
+
+  // Truncate to 16 bits like the (int16_t) cast in the C version, which makes
+  // the saturating pack exact.
+  sum_low = _mm_srai_epi32(_mm_slli_epi32(sum_low, 16), 16);
+  sum_high = _mm_srai_epi32(_mm_slli_epi32(sum_high, 16), 16);
+  out = _mm_packs_epi32(sum_low, sum_high);
+
+  product_low = _mm_mullo_epi16(out, coefficient);
+  product_high = _mm_mulhi_epi16(out, coefficient);
+  *state_low = _mm_sub_epi32(
+      _mm_srai_epi32(_mm_unpacklo_epi16(zero, in), 16),
+      _mm_srai_epi32(_mm_unpacklo_epi16(product_low, product_high), 12));
+  *state_high = _mm_sub_epi32(
+      _mm_srai_epi32(_mm_unpackhi_epi16(zero, in), 16),
+      _mm_srai_epi32(_mm_unpackhi_epi16(product_low, product_high), 12));
+  return out;
+}
+#endif
+
+void WebRtcVad_DownsamplingLanes(const int16_t* signal_in,
+                                 int16_t* signal_out,
+                                 int32_t* filter_state,
+                                 size_t in_length) {
+  size_t n = 0;
+  // Downsampling by 2 gives half length.
+  size_t half_length = (in_length >> 1);
+#if defined(WEBRTC_HAS_NEON)
+  int32x4_t upper_low = vld1q_s32(&filter_state[0]);
+  int32x4_t upper_high = vld1q_s32(&filter_state[4]);
+  int32x4_t lower_low = vld1q_s32(&filter_state[kVadBatchLanes]);
+  int32x4_t lower_high = vld1q_s32(&filter_state[kVadBatchLanes + 4]);
+
+  for (n = 0; n < half_length; n++) {
+    const int16x8_t upper = AllPassBranchNeon(
+        vld1q_s16(signal_in), kAllPassCoefsQ13[0], &upper_low, &upper_high);
+    const int16x8_t lower =
+        AllPassBranchNeon(vld1q_s16(signal_in + kVadBatchLanes),
+                          kAllPassCoefsQ13[1], &lower_low, &lower_high);
+    vst1q_s16(signal_out, vaddq_s16(upper, lower));
+    signal_in += 2 * kVadBatchLanes;
+    signal_out += kVadBatchLanes;
+  }
+
+  vst1q_s32(&filter_state[0], upper_low);
+  vst1q_s32(&filter_state[4], upper_high);
+  vst1q_s32(&filter_state[kVadBatchLanes], lower_low);
+  vst1q_s32(&filter_state[kVadBatchLanes + 4], lower_high);
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+  const __m128i upper_coefficient = _mm_set1_epi16(kAllPassCoefsQ13[0]);
+  const __m128i lower_coefficient = _mm_set1_epi16(kAllPassCoefsQ13[1]);
+  __m128i upper_low = _mm_loadu_si128((const __m128i*)&filter_state[0]);
+  __m128i upper_high = _mm_loadu_si128((const __m128i*)&filter_state[4]);
+  __m128i lower_low =
+      _mm_loadu_si128((const __m128i*)&filter_state[kVadBatchLanes]);
+  __m128i lower_high =
+      _mm_loadu_si128((const __m128i*)&filter_state[kVadBatchLanes + 4]);
+
+  for (n = 0; n < half_length; n++) {
+    const __m128i upper =
+        AllPassBranchSse2(_mm_loadu_si128((const __m128i*)signal_in),
+                          upper_coefficient, &upper_low, &upper_high);
+    const __m128i lower = AllPassBranchSse2(
+        _mm_loadu_si128((const __m128i*)(signal_in + kVadBatchLanes)),
+        lower_coefficient, &lower_low, &lower_high);
+    _mm_storeu_si128((__m128i*)signal_out, _mm_add_epi16(upper, lower));
+    signal_in += 2 * kVadBatchLanes;
+    signal_out += kVadBatchLanes;
+  }
+
+  _mm_storeu_si128((__m128i*)&filter_state[0], upper_low);
+  _mm_storeu_si128((__m128i*)&filter_state[4], upper_high);
+  _mm_storeu_si128((__m128i*)&filter_state[kVadBatchLanes], lower_low);
+  _mm_storeu_si128((__m128i*)&filter_state[kVadBatchLanes + 4], lower_high);
+#else
+  int32_t* upper_state = &filter_state[0];
+  int32_t* lower_state = &filter_state[kVadBatchLanes];
+  int lane;
+
+  for (n = 0; n < half_length; n++) {
+    for (lane = 0; lane < kVadBatchLanes; lane++) {
+      const int16_t upper_in = signal_in[lane];
+      const int16_t lower_in = signal_in[kVadBatchLanes + lane];
+      int16_t tmp16_1 = (int16_t) ((upper_state[lane] >> 1) +
+          ((kAllPassCoefsQ13[0] * upper_in) >> 14));
+      int16_t tmp16_2 = (int16_t) ((lower_state[lane] >> 1) +
+          ((kAllPassCoefsQ13[1] * lower_in) >> 14));
+      upper_state[lane] =
+          (int32_t) upper_in - ((kAllPassCoefsQ13[0] * tmp16_1) >> 12);
+      lower_state[lane] =
+          (int32_t) lower_in - ((kAllPassCoefsQ13[1] * tmp16_2) >> 12);
+      signal_out[lane] = tmp16_1;
+      signal_out[lane] += tmp16_2;
+    }
+    signal_in += 2 * kVadBatchLanes;
+    signal_out += kVadBatchLanes;
+  }
+#endif
+}
+
 // Inserts |feature_value| into |low_value_vector|, if it is one of the 16
 // smallest values the last 100 frames. Then calculates and returns the median
 // of the five smallest values.
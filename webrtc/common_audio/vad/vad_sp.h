@@ -33,6 +33,26 @@ void WebRtcVad_Downsampling(const int16_t* signal_in,
                             int32_t* filter_state,
                             size_t in_length);
 
+// Same as WebRtcVad_Downsampling() for |kVadBatchLanes| streams, with
+// |signal_in| and |signal_out| lane interleaved, i.e., sample |i| of stream
+// |lane| is at |i * kVadBatchLanes + lane|. The result for each lane is bit
+// exact with running WebRtcVad_Downsampling() on that stream alone.
+//
+// Inputs:
+//      - signal_in     : Lane interleaved input signal.
+//      - in_length     : Length of the input signal of each lane in samples.
+//
+// Input & Output:
+//      - filter_state  : Filter states of the two all-pass filters, of length
+//                        2 * |kVadBatchLanes|, upper branch states first.
+//
+// Output:
+//      - signal_out    : Lane interleaved downsampled signal.
+void WebRtcVad_DownsamplingLanes(const int16_t* signal_in,
+                                 int16_t* signal_out,
+                                 int32_t* filter_state,
+                                 size_t in_length);
+
 // Updates and returns the smoothed feature minimum. As minimum we use the
 // median of the five smallest feature values in a 100 frames long window.
 // As long as |handle->frame_counter| is zero, that is, we haven't received any
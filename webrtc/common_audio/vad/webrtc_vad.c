@@ -14,6 +14,7 @@
 #include <string.h>
 
 #include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "common_audio/vad/vad_batch.h"
 #include "common_audio/vad/vad_core.h"
 
 static const int kInitCheck = 42;
@@ -112,3 +113,62 @@ int WebRtcVad_ValidRateAndFrameLength(int rate, size_t frame_length) {
 
   return return_value;
 }
+
+VadBatchInst* WebRtcVad_CreateBatch(size_t num_streams) {
+  return (VadBatchInst*)WebRtcVad_CreateBatchCore(num_streams);
+}
+
+void WebRtcVad_FreeBatch(VadBatchInst* handle) {
+  WebRtcVad_FreeBatchCore((VadBatchT*) handle);
+}
+
+int WebRtcVad_InitBatch(VadBatchInst* handle) {
+  return WebRtcVad_InitBatchCore((VadBatchT*) handle);
+}
+
+int WebRtcVad_set_mode_batch(VadBatchInst* handle, size_t stream, int mode) {
+  VadBatchT* self = (VadBatchT*) handle;
+
+  if (handle == NULL) {
+    return -1;
+  }
+  if (self->init_flag != kInitCheck) {
+    return -1;
+  }
+  if (stream >= self->num_streams) {
+    return -1;
+  }
+
+  return WebRtcVad_set_mode_core(&self->streams[stream], mode);
+}
+
+int WebRtcVad_ProcessBatch(VadBatchInst* handle,
+                           int fs,
+                           const int16_t* const* audio_frames,
+                           size_t frame_length,
+                           int* vad_decisions) {
+  VadBatchT* self = (VadBatchT*) handle;
+  size_t i;
+
+  if (handle == NULL) {
+    return -1;
+  }
+  if (self->init_flag != kInitCheck) {
+    return -1;
+  }
+  if (audio_frames == NULL || vad_decisions == NULL) {
+    return -1;
+  }
+  for (i = 0; i < self->num_streams; i++) {
+    if (audio_frames[i] == NULL) {
+      return -1;
+    }
+  }
+  if (WebRtcVad_ValidRateAndFrameLength(fs, frame_length) != 0) {
+    return -1;
+  }
+
+  WebRtcVad_CalcVadBatch(self, fs, audio_frames, frame_length, vad_decisions);
+
+  return 0;
+}
@@ -0,0 +1,161 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_audio/vector_math.h"
+
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+#include <math.h>
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+namespace webrtc {
+
+VectorMathOptimization DetectVectorMathOptimization() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (GetCPUInfo(kAVX2) != 0) {
+    return VectorMathOptimization::kAvx2;
+  } else if (GetCPUInfo(kSSE2) != 0) {
+    return VectorMathOptimization::kSse2;
+  }
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+  return VectorMathOptimization::kNeon;
+#endif
+
+  return VectorMathOptimization::kNone;
+}
+
+float VectorMaxAbs(VectorMathOptimization optimization,
+                   rtc::ArrayView<const float> x) {
+  const int size = static_cast<int>(x.size());
+  int j = 0;
+  float max_abs = 0.f;
+  switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case VectorMathOptimization::kAvx2:
+    case VectorMathOptimization::kSse2: {
+      const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+      __m128 max_v = _mm_setzero_ps();
+      for (; j + 4 <= size; j += 4) {
+        max_v = _mm_max_ps(max_v, _mm_and_ps(_mm_loadu_ps(&x[j]), abs_mask));
+      }
+      max_v = _mm_max_ps(max_v, _mm_movehl_ps(max_v, max_v));
+      max_v = _mm_max_ss(max_v,
+                         _mm_shuffle_ps(max_v, max_v, _MM_SHUFFLE(1, 1, 1, 1)));
+      max_abs = _mm_cvtss_f32(max_v);
+    } break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case VectorMathOptimization::kNeon: {
+      float32x4_t max_v = vdupq_n_f32(0.f);
+      for (; j + 4 <= size; j += 4) {
+        max_v = vmaxq_f32(max_v, vabsq_f32(vld1q_f32(&x[j])));
+      }
+      float32x2_t tmp = vmax_f32(vget_high_f32(max_v), vget_low_f32(max_v));
+      tmp = vpmax_f32(tmp, tmp);
+      max_abs = vget_lane_f32(tmp, 0);
+    } break;
+#endif
+    default:
+      break;
+  }
+
+  for (; j < size; ++j) {
+    max_abs = std::max(max_abs, fabsf(x[j]));
+  }
+  return max_abs;
+}
+
+void VectorScale(VectorMathOptimization optimization,
+                 float gain,
+                 rtc::ArrayView<const float> x,
+                 rtc::ArrayView<float> y) {
+  RTC_DCHECK_EQ(y.size(), x.size());
+  const int size = static_cast<int>(y.size());
+  int j = 0;
+  switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case VectorMathOptimization::kAvx2:
+    case VectorMathOptimization::kSse2: {
+      const __m128 gain_v = _mm_set1_ps(gain);
+      for (; j + 4 <= size; j += 4) {
+        const __m128 x_j = _mm_loadu_ps(&x[j]);
+        _mm_storeu_ps(&y[j], _mm_mul_ps(gain_v, x_j));
+      }
+    } break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case VectorMathOptimization::kNeon: {
+      const float32x4_t gain_v = vdupq_n_f32(gain);
+      for (; j + 4 <= size; j += 4) {
+        const float32x4_t x_j = vld1q_f32(&x[j]);
+        vst1q_f32(&y[j], vmulq_f32(gain_v, x_j));
+      }
+    } break;
+#endif
+    default:
+      break;
+  }
+
+  for (; j < size; ++j) {
+    y[j] = gain * x[j];
+  }
+}
+
+void VectorClamp(VectorMathOptimization optimization,
+                 float min_value,
+                 float max_value,
+                 rtc::ArrayView<float> x) {
+  const int size = static_cast<int>(x.size());
+  int j = 0;
+  switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case VectorMathOptimization::kAvx2:
+    case VectorMathOptimization::kSse2: {
+      const __m128 min_v = _mm_set1_ps(min_value);
+      const __m128 max_v = _mm_set1_ps(max_value);
+      for (; j + 4 <= size; j += 4) {
+        const __m128 x_j = _mm_loadu_ps(&x[j]);
+        _mm_storeu_ps(&x[j], _mm_min_ps(_mm_max_ps(x_j, min_v), max_v));
+      }
+    } break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case VectorMathOptimization::kNeon: {
+      const float32x4_t min_v = vdupq_n_f32(min_value);
+      const float32x4_t max_v = vdupq_n_f32(max_value);
+      for (; j + 4 <= size; j += 4) {
+        const float32x4_t x_j = vld1q_f32(&x[j]);
+        vst1q_f32(&x[j], vminq_f32(vmaxq_f32(x_j, min_v), max_v));
+      }
+    } break;
+#endif
+    default:
+      break;
+  }
+
+  for (; j < size; ++j) {
+    x[j] = std::min(std::max(x[j], min_value), max_value);
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,43 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef COMMON_AUDIO_VECTOR_MATH_H_
+#define COMMON_AUDIO_VECTOR_MATH_H_
+
+#include "api/array_view.h"
+
+namespace webrtc {
+
+// Instruction sets of the vector kernels of the audio processing components.
+// Kernels without an AVX2 version use their SSE2 version for kAvx2.
+enum class VectorMathOptimization { kNone, kSse2, kAvx2, kNeon };
+
+// Detects the instruction set to use for the vector kernels.
+VectorMathOptimization DetectVectorMathOptimization();
+
+// Returns the maximum absolute value of the elements of x.
+float VectorMaxAbs(VectorMathOptimization optimization,
+                   rtc::ArrayView<const float> x);
+
+// Elementwise scaling y = gain * x. May be applied in-place.
+void VectorScale(VectorMathOptimization optimization,
+                 float gain,
+                 rtc::ArrayView<const float> x,
+                 rtc::ArrayView<float> y);
+
+// Elementwise clamping of x to the range [min_value, max_value].
+void VectorClamp(VectorMathOptimization optimization,
+                 float min_value,
+                 float max_value,
+                 rtc::ArrayView<float> x);
+
+}  // namespace webrtc
+
+#endif  // COMMON_AUDIO_VECTOR_MATH_H_
@@ -23,6 +23,7 @@ extern "C" {
 #include "modules/audio_processing/utility/delay_estimator_wrapper.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/numerics/safe_conversions.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
 
 namespace webrtc {
 
@@ -135,16 +136,17 @@ const int16_t WebRtcAecm_kSinTable[] = {
 void WebRtcAecm_UpdateFarHistory(AecmCore* self,
                                  uint16_t* far_spectrum,
                                  int far_q) {
+  AecmFarEnd* far_end = self->far_end;
   // Get new buffer position
-  self->far_history_pos++;
-  if (self->far_history_pos >= MAX_DELAY) {
-    self->far_history_pos = 0;
+  far_end->far_history_pos++;
+  if (far_end->far_history_pos >= far_end->far_history_size) {
+    far_end->far_history_pos = 0;
   }
   // Update Q-domain buffer
-  self->far_q_domains[self->far_history_pos] = far_q;
+  far_end->far_q_domains[far_end->far_history_pos] = far_q;
   // Update far end spectrum buffer
-  memcpy(&(self->far_history[self->far_history_pos * PART_LEN1]), far_spectrum,
-         sizeof(uint16_t) * PART_LEN1);
+  memcpy(&(far_end->far_history[far_end->far_history_pos * PART_LEN1]),
+         far_spectrum, sizeof(uint16_t) * PART_LEN1);
 }
 
 // Returns a pointer to the far end spectrum aligned to current near end
@@ -169,16 +171,16 @@ const uint16_t* WebRtcAecm_AlignedFarend(AecmCore* self,
                                          int delay) {
   int buffer_position = 0;
   RTC_DCHECK(self);
-  buffer_position = self->far_history_pos - delay;
+  buffer_position = self->far_end->far_history_pos - delay;
 
   // Check buffer position
   if (buffer_position < 0) {
-    buffer_position += MAX_DELAY;
+    buffer_position += self->far_end->far_history_size;
   }
   // Get Q-domain
-  *far_q = self->far_q_domains[buffer_position];
+  *far_q = self->far_end->far_q_domains[buffer_position];
   // Return far end spectrum
-  return &(self->far_history[buffer_position * PART_LEN1]);
+  return &(self->far_end->far_history[buffer_position * PART_LEN1]);
 }
 
 // Declare function pointers.
@@ -186,17 +188,81 @@ CalcLinearEnergies WebRtcAecm_CalcLinearEnergies;
 StoreAdaptiveChannel WebRtcAecm_StoreAdaptiveChannel;
 ResetAdaptiveChannel WebRtcAecm_ResetAdaptiveChannel;
 
-AecmCore* WebRtcAecm_CreateCore() {
+AecmFarEnd* WebRtcAecm_CreateFarEndCore(int far_history_size) {
   // Allocate zero-filled memory.
-  AecmCore* aecm = static_cast<AecmCore*>(calloc(1, sizeof(AecmCore)));
+  AecmFarEnd* far_end = static_cast<AecmFarEnd*>(calloc(1, sizeof(AecmFarEnd)));
+  far_end->far_history_size = far_history_size;
 
-  aecm->farFrameBuf =
+  far_end->farFrameBuf =
       WebRtc_CreateBuffer(FRAME_LEN + PART_LEN, sizeof(int16_t));
-  if (!aecm->farFrameBuf) {
-    WebRtcAecm_FreeCore(aecm);
+  if (!far_end->farFrameBuf) {
+    WebRtcAecm_FreeFarEndCore(far_end);
+    return NULL;
+  }
+
+  far_end->delay_estimator_farend =
+      WebRtc_CreateDelayEstimatorFarend(PART_LEN1, far_history_size);
+  if (far_end->delay_estimator_farend == NULL) {
+    WebRtcAecm_FreeFarEndCore(far_end);
     return NULL;
   }
 
+  far_end->far_history = static_cast<uint16_t*>(
+      malloc(sizeof(uint16_t) * PART_LEN1 * far_history_size));
+  far_end->far_q_domains =
+      static_cast<int*>(malloc(sizeof(int) * far_history_size));
+  if (far_end->far_history == NULL || far_end->far_q_domains == NULL) {
+    WebRtcAecm_FreeFarEndCore(far_end);
+    return NULL;
+  }
+
+  // 32 byte alignment is only necessary for Neon code currently.
+  far_end->xBuf = (int16_t*)(((uintptr_t)far_end->xBuf_buf + 31) & ~31);
+
+  return far_end;
+}
+
+int WebRtcAecm_InitFarEndCore(AecmFarEnd* const far_end) {
+  far_end->farBufWritePos = 0;
+  far_end->farBufReadPos = 0;
+  far_end->knownDelay = 0;
+  far_end->lastKnownDelay = 0;
+
+  WebRtc_InitBuffer(far_end->farFrameBuf);
+
+  memset(far_end->xBuf_buf, 0, sizeof(far_end->xBuf_buf));
+
+  if (WebRtc_InitDelayEstimatorFarend(far_end->delay_estimator_farend) != 0) {
+    return -1;
+  }
+  // Set far end histories to zero
+  memset(far_end->far_history, 0,
+         sizeof(uint16_t) * PART_LEN1 * far_end->far_history_size);
+  memset(far_end->far_q_domains, 0, sizeof(int) * far_end->far_history_size);
+  far_end->far_history_pos = far_end->far_history_size;
+
+  return 0;
+}
+
+void WebRtcAecm_FreeFarEndCore(AecmFarEnd* far_end) {
+  if (far_end == NULL) {
+    return;
+  }
+
+  WebRtc_FreeBuffer(far_end->farFrameBuf);
+  WebRtc_FreeDelayEstimatorFarend(far_end->delay_estimator_farend);
+  free(far_end->far_history);
+  free(far_end->far_q_domains);
+
+  free(far_end);
+}
+
+AecmCore* WebRtcAecm_CreateCore(AecmFarEnd* far_end) {
+  RTC_DCHECK(far_end);
+  // Allocate zero-filled memory.
+  AecmCore* aecm = static_cast<AecmCore*>(calloc(1, sizeof(AecmCore)));
+  aecm->far_end = far_end;
+
   aecm->nearNoisyFrameBuf =
       WebRtc_CreateBuffer(FRAME_LEN + PART_LEN, sizeof(int16_t));
   if (!aecm->nearNoisyFrameBuf) {
@@ -218,14 +284,8 @@ AecmCore* WebRtcAecm_CreateCore() {
     return NULL;
   }
 
-  aecm->delay_estimator_farend =
-      WebRtc_CreateDelayEstimatorFarend(PART_LEN1, MAX_DELAY);
-  if (aecm->delay_estimator_farend == NULL) {
-    WebRtcAecm_FreeCore(aecm);
-    return NULL;
-  }
   aecm->delay_estimator =
-      WebRtc_CreateDelayEstimator(aecm->delay_estimator_farend, 0);
+      WebRtc_CreateDelayEstimator(far_end->delay_estimator_farend, 0);
   if (aecm->delay_estimator == NULL) {
     WebRtcAecm_FreeCore(aecm);
     return NULL;
@@ -242,7 +302,6 @@ AecmCore* WebRtcAecm_CreateCore() {
 
   // Init some aecm pointers. 16 and 32 byte alignment is only necessary
   // for Neon code currently.
-  aecm->xBuf = (int16_t*)(((uintptr_t)aecm->xBuf_buf + 31) & ~31);
   aecm->dBufClean = (int16_t*)(((uintptr_t)aecm->dBufClean_buf + 31) & ~31);
   aecm->dBufNoisy = (int16_t*)(((uintptr_t)aecm->dBufNoisy_buf + 31) & ~31);
   aecm->outBuf = (int16_t*)(((uintptr_t)aecm->outBuf_buf + 15) & ~15);
@@ -341,6 +400,22 @@ static void WebRtcAecm_InitNeon(void) {
 }
 #endif
 
+// Initialize function pointers for x86 platforms, using the widest instruction
+// set supported by the CPU.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+static void WebRtcAecm_InitX86(void) {
+  if (GetCPUInfo(kAVX2) != 0) {
+    WebRtcAecm_StoreAdaptiveChannel = WebRtcAecm_StoreAdaptiveChannelAvx2;
+    WebRtcAecm_ResetAdaptiveChannel = WebRtcAecm_ResetAdaptiveChannelAvx2;
+    WebRtcAecm_CalcLinearEnergies = WebRtcAecm_CalcLinearEnergiesAvx2;
+  } else if (GetCPUInfo(kSSE2) != 0) {
+    WebRtcAecm_StoreAdaptiveChannel = WebRtcAecm_StoreAdaptiveChannelSse2;
+    WebRtcAecm_ResetAdaptiveChannel = WebRtcAecm_ResetAdaptiveChannelSse2;
+    WebRtcAecm_CalcLinearEnergies = WebRtcAecm_CalcLinearEnergiesSse2;
+  }
+}
+#endif
+
 // Initialize function pointers for MIPS platform.
 #if defined(MIPS32_LE)
 static void WebRtcAecm_InitMips(void) {
@@ -377,17 +452,10 @@ int WebRtcAecm_InitCore(AecmCore* const aecm, int samplingFreq) {
   // sanity check of sampling frequency
   aecm->mult = (int16_t)samplingFreq / 8000;
 
-  aecm->farBufWritePos = 0;
-  aecm->farBufReadPos = 0;
-  aecm->knownDelay = 0;
-  aecm->lastKnownDelay = 0;
-
-  WebRtc_InitBuffer(aecm->farFrameBuf);
   WebRtc_InitBuffer(aecm->nearNoisyFrameBuf);
   WebRtc_InitBuffer(aecm->nearCleanFrameBuf);
   WebRtc_InitBuffer(aecm->outFrameBuf);
 
-  memset(aecm->xBuf_buf, 0, sizeof(aecm->xBuf_buf));
   memset(aecm->dBufClean_buf, 0, sizeof(aecm->dBufClean_buf));
   memset(aecm->dBufNoisy_buf, 0, sizeof(aecm->dBufNoisy_buf));
   memset(aecm->outBuf_buf, 0, sizeof(aecm->outBuf_buf));
@@ -395,16 +463,9 @@ int WebRtcAecm_InitCore(AecmCore* const aecm, int samplingFreq) {
   aecm->seed = 666;
   aecm->totCount = 0;
 
-  if (WebRtc_InitDelayEstimatorFarend(aecm->delay_estimator_farend) != 0) {
-    return -1;
-  }
   if (WebRtc_InitDelayEstimator(aecm->delay_estimator) != 0) {
     return -1;
   }
-  // Set far end histories to zero
-  memset(aecm->far_history, 0, sizeof(uint16_t) * PART_LEN1 * MAX_DELAY);
-  memset(aecm->far_q_domains, 0, sizeof(int) * MAX_DELAY);
-  aecm->far_history_pos = MAX_DELAY;
 
   aecm->nlpFlag = 1;
   aecm->fixedDelay = -1;
@@ -463,6 +524,8 @@ int WebRtcAecm_InitCore(AecmCore* const aecm, int samplingFreq) {
   aecm->supGainErrParamDiffAB = SUPGAIN_ERROR_PARAM_A - SUPGAIN_ERROR_PARAM_B;
   aecm->supGainErrParamDiffBD = SUPGAIN_ERROR_PARAM_B - SUPGAIN_ERROR_PARAM_D;
 
+  aecm->upperBandGain = ONE_Q14;
+
   // Assert a preprocessor definition at compile-time. It's an assumption
   // used in assembly code, so check the assembly files before any change.
   static_assert(PART_LEN % 16 == 0, "PART_LEN is not a multiple of 16");
@@ -476,6 +539,10 @@ int WebRtcAecm_InitCore(AecmCore* const aecm, int samplingFreq) {
   WebRtcAecm_InitNeon();
 #endif
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  WebRtcAecm_InitX86();
+#endif
+
 #if defined(MIPS32_LE)
   WebRtcAecm_InitMips();
 #endif
@@ -496,13 +563,11 @@ void WebRtcAecm_FreeCore(AecmCore* aecm) {
     return;
   }
 
-  WebRtc_FreeBuffer(aecm->farFrameBuf);
   WebRtc_FreeBuffer(aecm->nearNoisyFrameBuf);
   WebRtc_FreeBuffer(aecm->nearCleanFrameBuf);
   WebRtc_FreeBuffer(aecm->outFrameBuf);
 
   WebRtc_FreeDelayEstimator(aecm->delay_estimator);
-  WebRtc_FreeDelayEstimatorFarend(aecm->delay_estimator_farend);
   WebRtcSpl_FreeRealFFT(aecm->real_fft);
 
   free(aecm);
@@ -513,69 +578,101 @@ int WebRtcAecm_ProcessFrame(AecmCore* aecm,
                             const int16_t* nearendNoisy,
                             const int16_t* nearendClean,
                             int16_t* out) {
+  return WebRtcAecm_ProcessFrames(&aecm, 1, farend, &nearendNoisy,
+                                  nearendClean ? &nearendClean : NULL, &out);
+}
+
+int WebRtcAecm_ProcessFrames(AecmCore* const* aecm,
+                             size_t num_channels,
+                             const int16_t* farend,
+                             const int16_t* const* nearendNoisy,
+                             const int16_t* const* nearendClean,
+                             int16_t* const* out) {
   int16_t outBlock_buf[PART_LEN + 8];  // Align buffer to 8-byte boundary.
   int16_t* outBlock = (int16_t*)(((uintptr_t)outBlock_buf + 15) & ~15);
 
   int16_t farFrame[FRAME_LEN];
-  const int16_t* out_ptr = NULL;
-  int size = 0;
+  size_t ch;
+
+  RTC_DCHECK_GT(num_channels, 0);
+  AecmFarEnd* const far_end = aecm[0]->far_end;
 
   // Buffer the current frame.
   // Fetch an older one corresponding to the delay.
-  WebRtcAecm_BufferFarFrame(aecm, farend, FRAME_LEN);
-  WebRtcAecm_FetchFarFrame(aecm, farFrame, FRAME_LEN, aecm->knownDelay);
+  WebRtcAecm_BufferFarFrame(aecm[0], farend, FRAME_LEN);
+  WebRtcAecm_FetchFarFrame(aecm[0], farFrame, FRAME_LEN, far_end->knownDelay);
 
   // Buffer the synchronized far and near frames,
   // to pass the smaller blocks individually.
-  WebRtc_WriteBuffer(aecm->farFrameBuf, farFrame, FRAME_LEN);
-  WebRtc_WriteBuffer(aecm->nearNoisyFrameBuf, nearendNoisy, FRAME_LEN);
-  if (nearendClean != NULL) {
-    WebRtc_WriteBuffer(aecm->nearCleanFrameBuf, nearendClean, FRAME_LEN);
+  WebRtc_WriteBuffer(far_end->farFrameBuf, farFrame, FRAME_LEN);
+  for (ch = 0; ch < num_channels; ++ch) {
+    RTC_DCHECK_EQ(aecm[ch]->far_end, far_end);
+    WebRtc_WriteBuffer(aecm[ch]->nearNoisyFrameBuf, nearendNoisy[ch],
+                       FRAME_LEN);
+    if (nearendClean != NULL) {
+      WebRtc_WriteBuffer(aecm[ch]->nearCleanFrameBuf, nearendClean[ch],
+                         FRAME_LEN);
+    }
   }
 
   // Process as many blocks as possible.
-  while (WebRtc_available_read(aecm->farFrameBuf) >= PART_LEN) {
+  while (WebRtc_available_read(far_end->farFrameBuf) >= PART_LEN) {
     int16_t far_block[PART_LEN];
     const int16_t* far_block_ptr = NULL;
-    int16_t near_noisy_block[PART_LEN];
-    const int16_t* near_noisy_block_ptr = NULL;
 
-    WebRtc_ReadBuffer(aecm->farFrameBuf, (void**)&far_block_ptr, far_block,
+    WebRtc_ReadBuffer(far_end->farFrameBuf, (void**)&far_block_ptr, far_block,
                       PART_LEN);
-    WebRtc_ReadBuffer(aecm->nearNoisyFrameBuf, (void**)&near_noisy_block_ptr,
-                      near_noisy_block, PART_LEN);
-    if (nearendClean != NULL) {
-      int16_t near_clean_block[PART_LEN];
-      const int16_t* near_clean_block_ptr = NULL;
-
-      WebRtc_ReadBuffer(aecm->nearCleanFrameBuf, (void**)&near_clean_block_ptr,
-                        near_clean_block, PART_LEN);
-      if (WebRtcAecm_ProcessBlock(aecm, far_block_ptr, near_noisy_block_ptr,
-                                  near_clean_block_ptr, outBlock) == -1) {
-        return -1;
-      }
-    } else {
-      if (WebRtcAecm_ProcessBlock(aecm, far_block_ptr, near_noisy_block_ptr,
-                                  NULL, outBlock) == -1) {
-        return -1;
-      }
+    if (WebRtcAecm_ProcessFarEndBlock(aecm[0], far_block_ptr) == -1) {
+      return -1;
     }
 
-    WebRtc_WriteBuffer(aecm->outFrameBuf, outBlock, PART_LEN);
-  }
+    for (ch = 0; ch < num_channels; ++ch) {
+      int16_t near_noisy_block[PART_LEN];
+      const int16_t* near_noisy_block_ptr = NULL;
+
+      WebRtc_ReadBuffer(aecm[ch]->nearNoisyFrameBuf,
+                        (void**)&near_noisy_block_ptr, near_noisy_block,
+                        PART_LEN);
+      if (nearendClean != NULL) {
+        int16_t near_clean_block[PART_LEN];
+        const int16_t* near_clean_block_ptr = NULL;
+
+        WebRtc_ReadBuffer(aecm[ch]->nearCleanFrameBuf,
+                          (void**)&near_clean_block_ptr, near_clean_block,
+                          PART_LEN);
+        if (WebRtcAecm_ProcessBlock(aecm[ch], near_noisy_block_ptr,
+                                    near_clean_block_ptr, outBlock) == -1) {
+          return -1;
+        }
+      } else {
+        if (WebRtcAecm_ProcessBlock(aecm[ch], near_noisy_block_ptr, NULL,
+                                    outBlock) == -1) {
+          return -1;
+        }
+      }
 
-  // Stuff the out buffer if we have less than a frame to output.
-  // This should only happen for the first frame.
-  size = (int)WebRtc_available_read(aecm->outFrameBuf);
-  if (size < FRAME_LEN) {
-    WebRtc_MoveReadPtr(aecm->outFrameBuf, size - FRAME_LEN);
+      WebRtc_WriteBuffer(aecm[ch]->outFrameBuf, outBlock, PART_LEN);
+    }
   }
 
-  // Obtain an output frame.
-  WebRtc_ReadBuffer(aecm->outFrameBuf, (void**)&out_ptr, out, FRAME_LEN);
-  if (out_ptr != out) {
-    // ReadBuffer() hasn't copied to |out| in this case.
-    memcpy(out, out_ptr, FRAME_LEN * sizeof(int16_t));
+  for (ch = 0; ch < num_channels; ++ch) {
+    const int16_t* out_ptr = NULL;
+    int size = 0;
+
+    // Stuff the out buffer if we have less than a frame to output.
+    // This should only happen for the first frame.
+    size = (int)WebRtc_available_read(aecm[ch]->outFrameBuf);
+    if (size < FRAME_LEN) {
+      WebRtc_MoveReadPtr(aecm[ch]->outFrameBuf, size - FRAME_LEN);
+    }
+
+    // Obtain an output frame.
+    WebRtc_ReadBuffer(aecm[ch]->outFrameBuf, (void**)&out_ptr, out[ch],
+                      FRAME_LEN);
+    if (out_ptr != out[ch]) {
+      // ReadBuffer() hasn't copied to |out| in this case.
+      memcpy(out[ch], out_ptr, FRAME_LEN * sizeof(int16_t));
+    }
   }
 
   return 0;
@@ -996,6 +1093,21 @@ void WebRtcAecm_UpdateChannel(AecmCore* aecm,
   // END: Determine if we should store or reset channel estimate.
 }
 
+void WebRtcAecm_UpdateUpperBandGain(AecmCore* aecm, const int16_t* hnl) {
+  // The gains are averaged over the bins from 6 kHz to the 8 kHz band edge of
+  // 16 kHz processing, where PART_LEN bins span the band.
+  const int kBandEdgeHz = 8000;
+  const int kMinUpperFreqHz = 6000;
+  const int kMinUpperBin = kMinUpperFreqHz * PART_LEN / kBandEdgeHz;
+  int32_t avgHnl32 = 0;
+  int i;
+
+  for (i = kMinUpperBin; i < PART_LEN1; i++) {
+    avgHnl32 += (int32_t)hnl[i];
+  }
+  aecm->upperBandGain = (int16_t)(avgHnl32 / (PART_LEN1 - kMinUpperBin));
+}
+
 // CalcSuppressionGain(...)
 //
 // This function calculates the suppression gain that is used in the Wiener
@@ -1069,57 +1181,59 @@ int16_t WebRtcAecm_CalcSuppressionGain(AecmCore* const aecm) {
 void WebRtcAecm_BufferFarFrame(AecmCore* const aecm,
                                const int16_t* const farend,
                                const int farLen) {
+  AecmFarEnd* const far_end = aecm->far_end;
   int writeLen = farLen, writePos = 0;
 
   // Check if the write position must be wrapped
-  while (aecm->farBufWritePos + writeLen > FAR_BUF_LEN) {
+  while (far_end->farBufWritePos + writeLen > FAR_BUF_LEN) {
     // Write to remaining buffer space before wrapping
-    writeLen = FAR_BUF_LEN - aecm->farBufWritePos;
-    memcpy(aecm->farBuf + aecm->farBufWritePos, farend + writePos,
+    writeLen = FAR_BUF_LEN - far_end->farBufWritePos;
+    memcpy(far_end->farBuf + far_end->farBufWritePos, farend + writePos,
            sizeof(int16_t) * writeLen);
-    aecm->farBufWritePos = 0;
+    far_end->farBufWritePos = 0;
     writePos = writeLen;
     writeLen = farLen - writeLen;
   }
 
-  memcpy(aecm->farBuf + aecm->farBufWritePos, farend + writePos,
+  memcpy(far_end->farBuf + far_end->farBufWritePos, farend + writePos,
          sizeof(int16_t) * writeLen);
-  aecm->farBufWritePos += writeLen;
+  far_end->farBufWritePos += writeLen;
 }
 
 void WebRtcAecm_FetchFarFrame(AecmCore* const aecm,
                               int16_t* const farend,
                               const int farLen,
                               const int knownDelay) {
+  AecmFarEnd* const far_end = aecm->far_end;
   int readLen = farLen;
   int readPos = 0;
-  int delayChange = knownDelay - aecm->lastKnownDelay;
+  int delayChange = knownDelay - far_end->lastKnownDelay;
 
-  aecm->farBufReadPos -= delayChange;
+  far_end->farBufReadPos -= delayChange;
 
   // Check if delay forces a read position wrap
-  while (aecm->farBufReadPos < 0) {
-    aecm->farBufReadPos += FAR_BUF_LEN;
+  while (far_end->farBufReadPos < 0) {
+    far_end->farBufReadPos += FAR_BUF_LEN;
   }
-  while (aecm->farBufReadPos > FAR_BUF_LEN - 1) {
-    aecm->farBufReadPos -= FAR_BUF_LEN;
+  while (far_end->farBufReadPos > FAR_BUF_LEN - 1) {
+    far_end->farBufReadPos -= FAR_BUF_LEN;
   }
 
-  aecm->lastKnownDelay = knownDelay;
+  far_end->lastKnownDelay = knownDelay;
 
   // Check if read position must be wrapped
-  while (aecm->farBufReadPos + readLen > FAR_BUF_LEN) {
+  while (far_end->farBufReadPos + readLen > FAR_BUF_LEN) {
     // Read from remaining buffer space before wrapping
-    readLen = FAR_BUF_LEN - aecm->farBufReadPos;
-    memcpy(farend + readPos, aecm->farBuf + aecm->farBufReadPos,
+    readLen = FAR_BUF_LEN - far_end->farBufReadPos;
+    memcpy(farend + readPos, far_end->farBuf + far_end->farBufReadPos,
            sizeof(int16_t) * readLen);
-    aecm->farBufReadPos = 0;
+    far_end->farBufReadPos = 0;
     readPos = readLen;
     readLen = farLen - readLen;
   }
-  memcpy(farend + readPos, aecm->farBuf + aecm->farBufReadPos,
+  memcpy(farend + readPos, far_end->farBuf + far_end->farBufReadPos,
          sizeof(int16_t) * readLen);
-  aecm->farBufReadPos += readLen;
+  far_end->farBufReadPos += readLen;
 }
 
 }  // namespace webrtc
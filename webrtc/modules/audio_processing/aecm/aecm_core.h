@@ -18,6 +18,8 @@ extern "C" {
 #include "common_audio/signal_processing/include/signal_processing_library.h"
 }
 #include "modules/audio_processing/aecm/aecm_defines.h"
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
 
 struct RealFFT;
 
@@ -36,32 +38,50 @@ typedef struct {
   int16_t imag;
 } ComplexInt16;
 
+// The far end state of the AECM. It only depends on the far end signal, and is
+// shared by the AECM instances of all capture channels echoing the same render
+// channel, which then process their blocks in lockstep.
 typedef struct {
   int farBufWritePos;
   int farBufReadPos;
   int knownDelay;
   int lastKnownDelay;
-  int firstVAD;  // Parameter to control poorly initialized channels
 
   RingBuffer* farFrameBuf;
+
+  int16_t farBuf[FAR_BUF_LEN];
+
+  // Delay estimation variables
+  void* delay_estimator_farend;
+  // Far end history variables, holding the spectra of the last
+  // |far_history_size| blocks.
+  // TODO(bjornv): Replace |far_history| with ring_buffer.
+  int far_history_size;
+  uint16_t* far_history;
+  int far_history_pos;
+  int* far_q_domains;
+
+  // The extra 16 bytes are for alignment, see AecmCore.
+  int16_t xBuf_buf[PART_LEN2 + 16];  // farend
+  int16_t* xBuf;
+} AecmFarEnd;
+
+typedef struct {
+  int firstVAD;  // Parameter to control poorly initialized channels
+
   RingBuffer* nearNoisyFrameBuf;
   RingBuffer* nearCleanFrameBuf;
   RingBuffer* outFrameBuf;
 
-  int16_t farBuf[FAR_BUF_LEN];
-
   int16_t mult;
   uint32_t seed;
 
+  // Far end state, not owned.
+  AecmFarEnd* far_end;
+
   // Delay estimation variables
-  void* delay_estimator_farend;
   void* delay_estimator;
   uint16_t currentDelay;
-  // Far end history variables
-  // TODO(bjornv): Replace |far_history| with ring_buffer.
-  uint16_t far_history[PART_LEN1 * MAX_DELAY];
-  int far_history_pos;
-  int far_q_domains[MAX_DELAY];
 
   int16_t nlpFlag;
   int16_t fixedDelay;
@@ -85,7 +105,6 @@ typedef struct {
   int16_t channelStored_buf[PART_LEN1 + 8];
   int16_t channelAdapt16_buf[PART_LEN1 + 8];
   int32_t channelAdapt32_buf[PART_LEN1 + 8];
-  int16_t xBuf_buf[PART_LEN2 + 16];       // farend
   int16_t dBufClean_buf[PART_LEN2 + 16];  // nearend
   int16_t dBufNoisy_buf[PART_LEN2 + 16];  // nearend
   int16_t outBuf_buf[PART_LEN + 8];
@@ -94,7 +113,6 @@ typedef struct {
   int16_t* channelStored;
   int16_t* channelAdapt16;
   int32_t* channelAdapt32;
-  int16_t* xBuf;
   int16_t* dBufClean;
   int16_t* dBufNoisy;
   int16_t* outBuf;
@@ -129,6 +147,10 @@ typedef struct {
   int16_t supGainErrParamDiffAB;
   int16_t supGainErrParamDiffBD;
 
+  // Suppression gain of the last block for the bands above the one processed,
+  // in Q14.
+  int16_t upperBandGain;
+
   struct RealFFT* real_fft;
 
 #ifdef AEC_DEBUG
@@ -139,12 +161,49 @@ typedef struct {
 } AecmCore;
 
 ////////////////////////////////////////////////////////////////////////////////
-// WebRtcAecm_CreateCore()
+// WebRtcAecm_CreateFarEndCore()
+//
+// Allocates the memory needed by the far end state of the AECM, with a history
+// of |far_history_size| far end blocks over which the delay is estimated. The
+// memory needs to be initialized separately using the
+// WebRtcAecm_InitFarEndCore() function.
+// Returns a pointer to the instance and a nullptr at failure.
+AecmFarEnd* WebRtcAecm_CreateFarEndCore(int far_history_size);
+
+////////////////////////////////////////////////////////////////////////////////
+// WebRtcAecm_InitFarEndCore(...)
+//
+// This function initializes the far end state created with
+// WebRtcAecm_CreateFarEndCore()
+// Input:
+//      - far_end       : Pointer to the far end state
+//
+// Return value         :  0 - Ok
+//                        -1 - Error
+//
+int WebRtcAecm_InitFarEndCore(AecmFarEnd* const far_end);
+
+////////////////////////////////////////////////////////////////////////////////
+// WebRtcAecm_FreeFarEndCore(...)
+//
+// This function releases the memory allocated by WebRtcAecm_CreateFarEndCore()
+// Input:
+//      - far_end       : Pointer to the far end state
+//
+void WebRtcAecm_FreeFarEndCore(AecmFarEnd* far_end);
+
+////////////////////////////////////////////////////////////////////////////////
+// WebRtcAecm_CreateCore(...)
 //
 // Allocates the memory needed by the AECM. The memory needs to be
 // initialized separately using the WebRtcAecm_InitCore() function.
+// Input:
+//      - far_end       : Pointer to the far end state used by the instance. It
+//                        must outlive the instance, and is initialized
+//                        separately.
+//
 // Returns a pointer to the instance and a nullptr at failure.
-AecmCore* WebRtcAecm_CreateCore();
+AecmCore* WebRtcAecm_CreateCore(AecmFarEnd* far_end);
 
 ////////////////////////////////////////////////////////////////////////////////
 // WebRtcAecm_InitCore(...)
@@ -212,15 +271,60 @@ int WebRtcAecm_ProcessFrame(AecmCore* aecm,
                             const int16_t* nearendClean,
                             int16_t* out);
 
+////////////////////////////////////////////////////////////////////////////////
+// WebRtcAecm_ProcessFrames(...)
+//
+// Same as WebRtcAecm_ProcessFrame(...), for the frames of several AECM
+// instances sharing the same far end state. The far end frame is buffered and
+// transformed once, and each of its blocks is used by all the instances.
+//
+// Inputs:
+//      - aecm          : Pointers to the AECM instances
+//      - num_channels  : Number of AECM instances
+//      - farend        : In buffer containing one frame of echo signal
+//      - nearendNoisy  : In buffers containing one frame of nearend+echo
+//                        signal without NS, one per instance
+//      - nearendClean  : In buffers containing one frame of nearend+echo
+//                        signal with NS, one per instance, or NULL
+//
+// Output:
+//      - out           : Out buffers, one frame of nearend signal per
+//                        instance
+//
+int WebRtcAecm_ProcessFrames(AecmCore* const* aecm,
+                             size_t num_channels,
+                             const int16_t* farend,
+                             const int16_t* const* nearendNoisy,
+                             const int16_t* const* nearendClean,
+                             int16_t* const* out);
+
+////////////////////////////////////////////////////////////////////////////////
+// WebRtcAecm_ProcessFarEndBlock(...)
+//
+// This function is called for every far end block within one frame, before
+// the calls to WebRtcAecm_ProcessBlock(...) of the AECM instances sharing the
+// far end state. It updates the far end spectrum history and the far end part
+// of the delay estimator.
+//
+// Inputs:
+//      - aecm          : Pointer to one of the AECM instances using the far
+//                        end state
+//      - farend        : In buffer containing one block of echo signal
+//
+// Return value         :  0 - Ok
+//                        -1 - Error
+//
+int WebRtcAecm_ProcessFarEndBlock(AecmCore* aecm, const int16_t* farend);
+
 ////////////////////////////////////////////////////////////////////////////////
 // WebRtcAecm_ProcessBlock(...)
 //
 // This function is called for every block within one frame
-// This function is called by WebRtcAecm_ProcessFrame(...)
+// This function is called by WebRtcAecm_ProcessFrames(...), after
+// WebRtcAecm_ProcessFarEndBlock(...) for the corresponding far end block.
 //
 // Inputs:
 //      - aecm          : Pointer to the AECM instance
-//      - farend        : In buffer containing one block of echo signal
 //      - nearendNoisy  : In buffer containing one frame of nearend+echo signal
 //                        without NS
 //      - nearendClean  : In buffer containing one frame of nearend+echo signal
@@ -231,7 +335,6 @@ int WebRtcAecm_ProcessFrame(AecmCore* aecm,
 //
 //
 int WebRtcAecm_ProcessBlock(AecmCore* aecm,
-                            const int16_t* farend,
                             const int16_t* nearendNoisy,
                             const int16_t* noisyClean,
                             int16_t* out);
@@ -305,6 +408,18 @@ void WebRtcAecm_UpdateFarHistory(AecmCore* self,
 //
 const uint16_t* WebRtcAecm_AlignedFarend(AecmCore* self, int* far_q, int delay);
 
+///////////////////////////////////////////////////////////////////////////////
+// WebRtcAecm_UpdateUpperBandGain()
+//
+// Sets the suppression gain for the bands above the one processed, as the
+// average of the Wiener filter gains of the highest frequencies of the block.
+//
+// Inputs:
+//      - aecm              : Pointer to the AECM instance.
+//      - hnl               : Wiener filter gains of the block (Q14).
+//
+void WebRtcAecm_UpdateUpperBandGain(AecmCore* aecm, const int16_t* hnl);
+
 ///////////////////////////////////////////////////////////////////////////////
 // WebRtcAecm_CalcSuppressionGain()
 //
@@ -403,8 +518,9 @@ typedef void (*ResetAdaptiveChannel)(AecmCore* aecm);
 extern ResetAdaptiveChannel WebRtcAecm_ResetAdaptiveChannel;
 
 // For the above function pointers, functions for generic platforms are declared
-// and defined as static in file aecm_core.c, while those for ARM Neon platforms
-// are declared below and defined in file aecm_core_neon.c.
+// and defined as static in file aecm_core.c, while those for ARM Neon and x86
+// platforms are declared below and defined in files aecm_core_neon.c,
+// aecm_core_sse2.cc and aecm_core_avx2.cc.
 #if defined(WEBRTC_HAS_NEON)
 void WebRtcAecm_CalcLinearEnergiesNeon(AecmCore* aecm,
                                        const uint16_t* far_spectrum,
@@ -420,6 +536,34 @@ void WebRtcAecm_StoreAdaptiveChannelNeon(AecmCore* aecm,
 void WebRtcAecm_ResetAdaptiveChannelNeon(AecmCore* aecm);
 #endif
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcAecm_CalcLinearEnergiesSse2(AecmCore* aecm,
+                                       const uint16_t* far_spectrum,
+                                       int32_t* echo_est,
+                                       uint32_t* far_energy,
+                                       uint32_t* echo_energy_adapt,
+                                       uint32_t* echo_energy_stored);
+
+void WebRtcAecm_StoreAdaptiveChannelSse2(AecmCore* aecm,
+                                         const uint16_t* far_spectrum,
+                                         int32_t* echo_est);
+
+void WebRtcAecm_ResetAdaptiveChannelSse2(AecmCore* aecm);
+
+void WebRtcAecm_CalcLinearEnergiesAvx2(AecmCore* aecm,
+                                       const uint16_t* far_spectrum,
+                                       int32_t* echo_est,
+                                       uint32_t* far_energy,
+                                       uint32_t* echo_energy_adapt,
+                                       uint32_t* echo_energy_stored);
+
+void WebRtcAecm_StoreAdaptiveChannelAvx2(AecmCore* aecm,
+                                         const uint16_t* far_spectrum,
+                                         int32_t* echo_est);
+
+void WebRtcAecm_ResetAdaptiveChannelAvx2(AecmCore* aecm);
+#endif
+
 #if defined(MIPS32_LE)
 void WebRtcAecm_CalcLinearEnergies_mips(AecmCore* aecm,
                                         const uint16_t* far_spectrum,
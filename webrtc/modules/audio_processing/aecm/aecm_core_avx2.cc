@@ -0,0 +1,118 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+
+#include "modules/audio_processing/aecm/aecm_core.h"
+
+namespace webrtc {
+
+namespace {
+
+// Loads 8 signed 16 bit values, widened to 32 bits.
+inline __m256i LoadS16(const int16_t* p) {
+  return _mm256_cvtepi16_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+// Loads 8 unsigned 16 bit values, widened to 32 bits.
+inline __m256i LoadU16(const uint16_t* p) {
+  return _mm256_cvtepu16_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+inline uint32_t AddLanes(__m256i v) {
+  __m128i v128 = _mm_add_epi32(_mm256_castsi256_si128(v),
+                               _mm256_extracti128_si256(v, 1));
+  v128 = _mm_add_epi32(v128, _mm_shuffle_epi32(v128, _MM_SHUFFLE(1, 0, 3, 2)));
+  v128 = _mm_add_epi32(v128, _mm_shuffle_epi32(v128, _MM_SHUFFLE(2, 3, 0, 1)));
+  return static_cast<uint32_t>(_mm_cvtsi128_si32(v128));
+}
+
+}  // namespace
+
+// The products of the 16 bit values are computed on their 32 bit widenings,
+// which is exact as the products of a signed and an unsigned 16 bit value fit
+// in 32 bits.
+void WebRtcAecm_CalcLinearEnergiesAvx2(AecmCore* aecm,
+                                       const uint16_t* far_spectrum,
+                                       int32_t* echo_est,
+                                       uint32_t* far_energy,
+                                       uint32_t* echo_energy_adapt,
+                                       uint32_t* echo_energy_stored) {
+  __m256i far_energy_v = _mm256_setzero_si256();
+  __m256i echo_adapt_v = _mm256_setzero_si256();
+  __m256i echo_stored_v = _mm256_setzero_si256();
+
+  // Get energy for the delayed far end signal and estimated
+  // echo using both stored and adapted channels.
+  for (int i = 0; i < PART_LEN; i += 8) {
+    const __m256i spectrum_v = LoadU16(&far_spectrum[i]);
+    const __m256i echo_est_v =
+        _mm256_mullo_epi32(LoadS16(&aecm->channelStored[i]), spectrum_v);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(&echo_est[i]), echo_est_v);
+
+    far_energy_v = _mm256_add_epi32(far_energy_v, spectrum_v);
+    echo_stored_v = _mm256_add_epi32(echo_stored_v, echo_est_v);
+    echo_adapt_v = _mm256_add_epi32(
+        echo_adapt_v,
+        _mm256_mullo_epi32(LoadS16(&aecm->channelAdapt16[i]), spectrum_v));
+  }
+
+  *far_energy += AddLanes(far_energy_v);
+  *echo_energy_stored += AddLanes(echo_stored_v);
+  *echo_energy_adapt += AddLanes(echo_adapt_v);
+
+  echo_est[PART_LEN] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[PART_LEN],
+                                             far_spectrum[PART_LEN]);
+  *echo_energy_stored += (uint32_t)echo_est[PART_LEN];
+  *far_energy += (uint32_t)far_spectrum[PART_LEN];
+  *echo_energy_adapt += aecm->channelAdapt16[PART_LEN] * far_spectrum[PART_LEN];
+}
+
+void WebRtcAecm_StoreAdaptiveChannelAvx2(AecmCore* aecm,
+                                         const uint16_t* far_spectrum,
+                                         int32_t* echo_est) {
+  // During startup we store the channel every block, and recalculate the echo
+  // estimate.
+  for (int i = 0; i < PART_LEN; i += 16) {
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(&aecm->channelStored[i]),
+        _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(&aecm->channelAdapt16[i])));
+  }
+  for (int i = 0; i < PART_LEN; i += 8) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(&echo_est[i]),
+                        _mm256_mullo_epi32(LoadS16(&aecm->channelStored[i]),
+                                           LoadU16(&far_spectrum[i])));
+  }
+  aecm->channelStored[PART_LEN] = aecm->channelAdapt16[PART_LEN];
+  echo_est[PART_LEN] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[PART_LEN],
+                                             far_spectrum[PART_LEN]);
+}
+
+void WebRtcAecm_ResetAdaptiveChannelAvx2(AecmCore* aecm) {
+  // Reset the adaptive channel to the stored one, and restore the W32 channel.
+  for (int i = 0; i < PART_LEN; i += 16) {
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(&aecm->channelAdapt16[i]),
+        _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(&aecm->channelStored[i])));
+  }
+  for (int i = 0; i < PART_LEN; i += 8) {
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(&aecm->channelAdapt32[i]),
+        _mm256_slli_epi32(LoadS16(&aecm->channelStored[i]), 16));
+  }
+  aecm->channelAdapt16[PART_LEN] = aecm->channelStored[PART_LEN];
+  aecm->channelAdapt32[PART_LEN] = (int32_t)aecm->channelStored[PART_LEN] << 16;
+}
+
+}  // namespace webrtc
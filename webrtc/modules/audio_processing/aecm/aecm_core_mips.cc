@@ -575,7 +575,6 @@ static void InverseFFTAndWindow(AecmCore* aecm,
 
   // Copy the current block to the old position
   // (aecm->outBuf is shifted elsewhere)
-  memcpy(aecm->xBuf, aecm->xBuf + PART_LEN, sizeof(int16_t) * PART_LEN);
   memcpy(aecm->dBufNoisy, aecm->dBufNoisy + PART_LEN,
          sizeof(int16_t) * PART_LEN);
   if (nearendClean != NULL) {
@@ -927,20 +926,43 @@ static int TimeToFrequencyDomain(AecmCore* aecm,
   return time_signal_scaling;
 }
 
+int WebRtcAecm_ProcessFarEndBlock(AecmCore* aecm, const int16_t* farend) {
+  AecmFarEnd* const far_end = aecm->far_end;
+  uint32_t xfaSum;
+  uint16_t xfa[PART_LEN1];
+  int32_t dfw_buf[PART_LEN2 + 8];
+  ComplexInt16* dfw = (ComplexInt16*)(((uint32_t)dfw_buf + 31) & ~31);
+  int far_q;
+
+  // Buffer far end signal
+  memcpy(far_end->xBuf + PART_LEN, farend, sizeof(int16_t) * PART_LEN);
+
+  // Transform far end signal from time domain to frequency domain.
+  far_q = TimeToFrequencyDomain(aecm, far_end->xBuf, dfw, xfa, &xfaSum);
+
+  // Copy the current block to the old position
+  memcpy(far_end->xBuf, far_end->xBuf + PART_LEN, sizeof(int16_t) * PART_LEN);
+
+  // Save far-end history and update the far end part of the delay estimator
+  WebRtcAecm_UpdateFarHistory(aecm, xfa, far_q);
+  if (WebRtc_AddFarSpectrumFix(far_end->delay_estimator_farend, xfa, PART_LEN1,
+                               far_q) == -1) {
+    return -1;
+  }
+  return 0;
+}
+
 int WebRtcAecm_ProcessBlock(AecmCore* aecm,
-                            const int16_t* farend,
                             const int16_t* nearendNoisy,
                             const int16_t* nearendClean,
                             int16_t* output) {
   int i;
-  uint32_t xfaSum;
   uint32_t dfaNoisySum;
   uint32_t dfaCleanSum;
   uint32_t echoEst32Gained;
   uint32_t tmpU32;
   int32_t tmp32no1;
 
-  uint16_t xfa[PART_LEN1];
   uint16_t dfaNoisy[PART_LEN1];
   uint16_t dfaClean[PART_LEN1];
   uint16_t* ptrDfaClean = dfaClean;
@@ -995,17 +1017,13 @@ int WebRtcAecm_ProcessBlock(AecmCore* aecm,
   }
   // END: Determine startup state
 
-  // Buffer near and far end signals
-  memcpy(aecm->xBuf + PART_LEN, farend, sizeof(int16_t) * PART_LEN);
+  // Buffer near end signals
   memcpy(aecm->dBufNoisy + PART_LEN, nearendNoisy, sizeof(int16_t) * PART_LEN);
   if (nearendClean != NULL) {
     memcpy(aecm->dBufClean + PART_LEN, nearendClean,
            sizeof(int16_t) * PART_LEN);
   }
 
-  // Transform far end signal from time domain to frequency domain.
-  far_q = TimeToFrequencyDomain(aecm, aecm->xBuf, dfw, xfa, &xfaSum);
-
   // Transform noisy near end signal from time domain to frequency domain.
   zerosDBufNoisy =
       TimeToFrequencyDomain(aecm, aecm->dBufNoisy, dfw, dfaNoisy, &dfaNoisySum);
@@ -1025,14 +1043,8 @@ int WebRtcAecm_ProcessBlock(AecmCore* aecm,
     aecm->dfaCleanQDomain = (int16_t)zerosDBufClean;
   }
 
-  // Get the delay
-  // Save far-end history and estimate delay
-  WebRtcAecm_UpdateFarHistory(aecm, xfa, far_q);
-
-  if (WebRtc_AddFarSpectrumFix(aecm->delay_estimator_farend, xfa, PART_LEN1,
-                               far_q) == -1) {
-    return -1;
-  }
+  // Get the delay, the far end spectrum of the block has been added to the
+  // far end history by WebRtcAecm_ProcessFarEndBlock().
   delay = WebRtc_DelayEstimatorProcessFix(aecm->delay_estimator, dfaNoisy,
                                           PART_LEN1, zerosDBufNoisy);
   if (delay == -1) {
@@ -1341,6 +1353,8 @@ int WebRtcAecm_ProcessBlock(AecmCore* aecm,
     }
   }
 
+  WebRtcAecm_UpdateUpperBandGain(aecm, hnl);
+
   if (aecm->cngMode == AecmTrue) {
     ComfortNoise(aecm, ptrDfaClean, efw, hnl);
   }
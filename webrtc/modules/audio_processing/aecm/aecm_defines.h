@@ -23,7 +23,12 @@
 #define PART_LEN2 (PART_LEN << 1) /* Length of partition * 2. */
 #define PART_LEN4 (PART_LEN << 2) /* Length of partition * 4. */
 #define FAR_BUF_LEN PART_LEN4     /* Length of buffers. */
-#define MAX_DELAY 100
+#define MAX_DELAY 100 /* Default far end history size, in blocks. */
+
+/* Delay of the processed output, in samples: PART_LEN from the overlap-add
+   of the blocks, and FRAME_LEN - PART_LEN from the stuffing of the output
+   buffer before the first frame. */
+#define PROCESS_DELAY_LEN FRAME_LEN
 
 /* Counter parameters */
 #define CONV_LEN 512              /* Convergence length used at startup. */
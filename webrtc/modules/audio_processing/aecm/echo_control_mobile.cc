@@ -76,7 +76,14 @@ typedef struct {
   // Structures
   RingBuffer* farendBuf;
 
-  AecmCore* aecmCore;
+  // Far end state shared by the cores, one core per capture channel.
+  AecmFarEnd* farEndCore;
+  size_t num_channels;
+  AecmCore** aecmCores;
+  // Pointers to the frames of the channels passed to the cores.
+  const int16_t** nearNoisyFrames;
+  const int16_t** nearCleanFrames;
+  int16_t** outFrames;
 } AecMobile;
 
 }  // namespace
@@ -89,15 +96,42 @@ static int WebRtcAecm_EstBufDelay(AecMobile* aecm, short msInSndCardBuf);
 static int WebRtcAecm_DelayComp(AecMobile* aecm);
 
 void* WebRtcAecm_Create() {
+  return WebRtcAecm_CreateMultiChannel(1, MAX_DELAY);
+}
+
+void* WebRtcAecm_CreateMultiChannel(size_t num_channels, int far_history_size) {
+  size_t ch;
+
+  if (num_channels == 0) {
+    return NULL;
+  }
+
   // Allocate zero-filled memory.
   AecMobile* aecm = static_cast<AecMobile*>(calloc(1, sizeof(AecMobile)));
 
-  aecm->aecmCore = WebRtcAecm_CreateCore();
-  if (!aecm->aecmCore) {
+  aecm->farEndCore = WebRtcAecm_CreateFarEndCore(far_history_size);
+  if (!aecm->farEndCore) {
     WebRtcAecm_Free(aecm);
     return NULL;
   }
 
+  aecm->aecmCores =
+      static_cast<AecmCore**>(calloc(num_channels, sizeof(AecmCore*)));
+  aecm->nearNoisyFrames = static_cast<const int16_t**>(
+      calloc(num_channels, sizeof(const int16_t*)));
+  aecm->nearCleanFrames = static_cast<const int16_t**>(
+      calloc(num_channels, sizeof(const int16_t*)));
+  aecm->outFrames =
+      static_cast<int16_t**>(calloc(num_channels, sizeof(int16_t*)));
+  aecm->num_channels = num_channels;
+  for (ch = 0; ch < num_channels; ++ch) {
+    aecm->aecmCores[ch] = WebRtcAecm_CreateCore(aecm->farEndCore);
+    if (!aecm->aecmCores[ch]) {
+      WebRtcAecm_Free(aecm);
+      return NULL;
+    }
+  }
+
   aecm->farendBuf = WebRtc_CreateBuffer(kBufSizeSamp, sizeof(int16_t));
   if (!aecm->farendBuf) {
     WebRtcAecm_Free(aecm);
@@ -105,10 +139,10 @@ void* WebRtcAecm_Create() {
   }
 
 #ifdef AEC_DEBUG
-  aecm->aecmCore->farFile = fopen("aecFar.pcm", "wb");
-  aecm->aecmCore->nearFile = fopen("aecNear.pcm", "wb");
-  aecm->aecmCore->outFile = fopen("aecOut.pcm", "wb");
-  // aecm->aecmCore->outLpFile = fopen("aecOutLp.pcm","wb");
+  aecm->aecmCores[0]->farFile = fopen("aecFar.pcm", "wb");
+  aecm->aecmCores[0]->nearFile = fopen("aecNear.pcm", "wb");
+  aecm->aecmCores[0]->outFile = fopen("aecOut.pcm", "wb");
+  // aecm->aecmCores[0]->outLpFile = fopen("aecOutLp.pcm","wb");
 
   aecm->bufFile = fopen("aecBuf.dat", "wb");
   aecm->delayFile = fopen("aecDelay.dat", "wb");
@@ -120,23 +154,33 @@ void* WebRtcAecm_Create() {
 
 void WebRtcAecm_Free(void* aecmInst) {
   AecMobile* aecm = static_cast<AecMobile*>(aecmInst);
+  size_t ch;
 
   if (aecm == NULL) {
     return;
   }
 
 #ifdef AEC_DEBUG
-  fclose(aecm->aecmCore->farFile);
-  fclose(aecm->aecmCore->nearFile);
-  fclose(aecm->aecmCore->outFile);
-  // fclose(aecm->aecmCore->outLpFile);
+  fclose(aecm->aecmCores[0]->farFile);
+  fclose(aecm->aecmCores[0]->nearFile);
+  fclose(aecm->aecmCores[0]->outFile);
+  // fclose(aecm->aecmCores[0]->outLpFile);
 
   fclose(aecm->bufFile);
   fclose(aecm->delayFile);
   fclose(aecm->preCompFile);
   fclose(aecm->postCompFile);
 #endif  // AEC_DEBUG
-  WebRtcAecm_FreeCore(aecm->aecmCore);
+  if (aecm->aecmCores != NULL) {
+    for (ch = 0; ch < aecm->num_channels; ++ch) {
+      WebRtcAecm_FreeCore(aecm->aecmCores[ch]);
+    }
+    free(aecm->aecmCores);
+  }
+  free(aecm->nearNoisyFrames);
+  free(aecm->nearCleanFrames);
+  free(aecm->outFrames);
+  WebRtcAecm_FreeFarEndCore(aecm->farEndCore);
   WebRtc_FreeBuffer(aecm->farendBuf);
   free(aecm);
 }
@@ -144,6 +188,7 @@ void WebRtcAecm_Free(void* aecmInst) {
 int32_t WebRtcAecm_Init(void* aecmInst, int32_t sampFreq) {
   AecMobile* aecm = static_cast<AecMobile*>(aecmInst);
   AecmConfig aecConfig;
+  size_t ch;
 
   if (aecm == NULL) {
     return -1;
@@ -154,10 +199,15 @@ int32_t WebRtcAecm_Init(void* aecmInst, int32_t sampFreq) {
   }
   aecm->sampFreq = sampFreq;
 
-  // Initialize AECM core
-  if (WebRtcAecm_InitCore(aecm->aecmCore, aecm->sampFreq) == -1) {
+  // Initialize AECM cores
+  if (WebRtcAecm_InitFarEndCore(aecm->farEndCore) == -1) {
     return AECM_UNSPECIFIED_ERROR;
   }
+  for (ch = 0; ch < aecm->num_channels; ++ch) {
+    if (WebRtcAecm_InitCore(aecm->aecmCores[ch], aecm->sampFreq) == -1) {
+      return AECM_UNSPECIFIED_ERROR;
+    }
+  }
 
   // Initialize farend buffer
   WebRtc_InitBuffer(aecm->farendBuf);
@@ -242,8 +292,26 @@ int32_t WebRtcAecm_Process(void* aecmInst,
                            size_t nrOfSamples,
                            int16_t msInSndCardBuf) {
   AecMobile* aecm = static_cast<AecMobile*>(aecmInst);
+
+  if (aecm != NULL && aecm->num_channels != 1) {
+    return AECM_BAD_PARAMETER_ERROR;
+  }
+
+  return WebRtcAecm_ProcessMultiChannel(
+      aecmInst, &nearendNoisy, nearendClean ? &nearendClean : NULL, &out,
+      nrOfSamples, msInSndCardBuf);
+}
+
+int32_t WebRtcAecm_ProcessMultiChannel(void* aecmInst,
+                                       const int16_t* const* nearendNoisy,
+                                       const int16_t* const* nearendClean,
+                                       int16_t* const* out,
+                                       size_t nrOfSamples,
+                                       int16_t msInSndCardBuf) {
+  AecMobile* aecm = static_cast<AecMobile*>(aecmInst);
   int32_t retVal = 0;
   size_t i;
+  size_t ch;
   short nmbrOfFilledBuffers;
   size_t nBlocks10ms;
   size_t nFrames;
@@ -263,6 +331,12 @@ int32_t WebRtcAecm_Process(void* aecmInst,
     return AECM_NULL_POINTER_ERROR;
   }
 
+  for (ch = 0; ch < aecm->num_channels; ++ch) {
+    if (nearendNoisy[ch] == NULL || out[ch] == NULL) {
+      return AECM_NULL_POINTER_ERROR;
+    }
+  }
+
   if (aecm->initFlag != kInitCheck) {
     return AECM_UNINITIALIZED_ERROR;
   }
@@ -282,15 +356,17 @@ int32_t WebRtcAecm_Process(void* aecmInst,
   aecm->msInSndCardBuf = msInSndCardBuf;
 
   nFrames = nrOfSamples / FRAME_LEN;
-  nBlocks10ms = nFrames / aecm->aecmCore->mult;
+  nBlocks10ms = nFrames / aecm->aecmCores[0]->mult;
 
   if (aecm->ECstartup) {
-    if (nearendClean == NULL) {
-      if (out != nearendNoisy) {
-        memcpy(out, nearendNoisy, sizeof(short) * nrOfSamples);
+    for (ch = 0; ch < aecm->num_channels; ++ch) {
+      if (nearendClean == NULL) {
+        if (out[ch] != nearendNoisy[ch]) {
+          memcpy(out[ch], nearendNoisy[ch], sizeof(short) * nrOfSamples);
+        }
+      } else if (out[ch] != nearendClean[ch]) {
+        memcpy(out[ch], nearendClean[ch], sizeof(short) * nrOfSamples);
       }
-    } else if (out != nearendClean) {
-      memcpy(out, nearendClean, sizeof(short) * nrOfSamples);
     }
 
     nmbrOfFilledBuffers =
@@ -323,7 +399,7 @@ int32_t WebRtcAecm_Process(void* aecmInst,
         // The farend buffer size is determined in blocks of 80 samples
         // Use 75% of the average value of the soundcard buffer
         aecm->bufSizeStart = WEBRTC_SPL_MIN(
-            (3 * aecm->sum * aecm->aecmCore->mult) / (aecm->counter * 40),
+            (3 * aecm->sum * aecm->aecmCores[0]->mult) / (aecm->counter * 40),
             BUF_SIZE_FRAMES);
         // buffersize has now been determined
         aecm->checkBuffSize = 0;
@@ -333,7 +409,7 @@ int32_t WebRtcAecm_Process(void* aecmInst,
         // for really bad sound cards, don't disable echocanceller for more than
         // 0.5 sec
         aecm->bufSizeStart = WEBRTC_SPL_MIN(
-            (3 * aecm->msInSndCardBuf * aecm->aecmCore->mult) / 40,
+            (3 * aecm->msInSndCardBuf * aecm->aecmCores[0]->mult) / 40,
             BUF_SIZE_FRAMES);
         aecm->checkBuffSize = 0;
       }
@@ -388,20 +464,25 @@ int32_t WebRtcAecm_Process(void* aecmInst,
         WebRtcAecm_EstBufDelay(aecm, aecm->msInSndCardBuf);
       }
 
-      // Call the AECM
-      /*WebRtcAecm_ProcessFrame(aecm->aecmCore, farend, &nearend[FRAME_LEN * i],
-       &out[FRAME_LEN * i], aecm->knownDelay);*/
-      if (WebRtcAecm_ProcessFrame(
-              aecm->aecmCore, farend_ptr, &nearendNoisy[FRAME_LEN * i],
-              (nearendClean ? &nearendClean[FRAME_LEN * i] : NULL),
-              &out[FRAME_LEN * i]) == -1)
+      for (ch = 0; ch < aecm->num_channels; ++ch) {
+        aecm->nearNoisyFrames[ch] = &nearendNoisy[ch][FRAME_LEN * i];
+        aecm->nearCleanFrames[ch] =
+            nearendClean ? &nearendClean[ch][FRAME_LEN * i] : NULL;
+        aecm->outFrames[ch] = &out[ch][FRAME_LEN * i];
+      }
+
+      // Call the AECM, once for all the channels
+      if (WebRtcAecm_ProcessFrames(aecm->aecmCores, aecm->num_channels,
+                                   farend_ptr, aecm->nearNoisyFrames,
+                                   nearendClean ? aecm->nearCleanFrames : NULL,
+                                   aecm->outFrames) == -1)
         return -1;
     }
   }
 
 #ifdef AEC_DEBUG
   msInAECBuf = (short)WebRtc_available_read(aecm->farendBuf) /
-               (kSampMsNb * aecm->aecmCore->mult);
+               (kSampMsNb * aecm->aecmCores[0]->mult);
   fwrite(&msInAECBuf, 2, 1, aecm->bufFile);
   fwrite(&(aecm->knownDelay), sizeof(aecm->knownDelay), 1, aecm->delayFile);
 #endif
@@ -411,6 +492,7 @@ int32_t WebRtcAecm_Process(void* aecmInst,
 
 int32_t WebRtcAecm_set_config(void* aecmInst, AecmConfig config) {
   AecMobile* aecm = static_cast<AecMobile*>(aecmInst);
+  size_t ch;
 
   if (aecm == NULL) {
     return -1;
@@ -423,58 +505,64 @@ int32_t WebRtcAecm_set_config(void* aecmInst, AecmConfig config) {
   if (config.cngMode != AecmFalse && config.cngMode != AecmTrue) {
     return AECM_BAD_PARAMETER_ERROR;
   }
-  aecm->aecmCore->cngMode = config.cngMode;
 
   if (config.echoMode < 0 || config.echoMode > 4) {
     return AECM_BAD_PARAMETER_ERROR;
   }
   aecm->echoMode = config.echoMode;
 
-  if (aecm->echoMode == 0) {
-    aecm->aecmCore->supGain = SUPGAIN_DEFAULT >> 3;
-    aecm->aecmCore->supGainOld = SUPGAIN_DEFAULT >> 3;
-    aecm->aecmCore->supGainErrParamA = SUPGAIN_ERROR_PARAM_A >> 3;
-    aecm->aecmCore->supGainErrParamD = SUPGAIN_ERROR_PARAM_D >> 3;
-    aecm->aecmCore->supGainErrParamDiffAB =
-        (SUPGAIN_ERROR_PARAM_A >> 3) - (SUPGAIN_ERROR_PARAM_B >> 3);
-    aecm->aecmCore->supGainErrParamDiffBD =
-        (SUPGAIN_ERROR_PARAM_B >> 3) - (SUPGAIN_ERROR_PARAM_D >> 3);
-  } else if (aecm->echoMode == 1) {
-    aecm->aecmCore->supGain = SUPGAIN_DEFAULT >> 2;
-    aecm->aecmCore->supGainOld = SUPGAIN_DEFAULT >> 2;
-    aecm->aecmCore->supGainErrParamA = SUPGAIN_ERROR_PARAM_A >> 2;
-    aecm->aecmCore->supGainErrParamD = SUPGAIN_ERROR_PARAM_D >> 2;
-    aecm->aecmCore->supGainErrParamDiffAB =
-        (SUPGAIN_ERROR_PARAM_A >> 2) - (SUPGAIN_ERROR_PARAM_B >> 2);
-    aecm->aecmCore->supGainErrParamDiffBD =
-        (SUPGAIN_ERROR_PARAM_B >> 2) - (SUPGAIN_ERROR_PARAM_D >> 2);
-  } else if (aecm->echoMode == 2) {
-    aecm->aecmCore->supGain = SUPGAIN_DEFAULT >> 1;
-    aecm->aecmCore->supGainOld = SUPGAIN_DEFAULT >> 1;
-    aecm->aecmCore->supGainErrParamA = SUPGAIN_ERROR_PARAM_A >> 1;
-    aecm->aecmCore->supGainErrParamD = SUPGAIN_ERROR_PARAM_D >> 1;
-    aecm->aecmCore->supGainErrParamDiffAB =
-        (SUPGAIN_ERROR_PARAM_A >> 1) - (SUPGAIN_ERROR_PARAM_B >> 1);
-    aecm->aecmCore->supGainErrParamDiffBD =
-        (SUPGAIN_ERROR_PARAM_B >> 1) - (SUPGAIN_ERROR_PARAM_D >> 1);
-  } else if (aecm->echoMode == 3) {
-    aecm->aecmCore->supGain = SUPGAIN_DEFAULT;
-    aecm->aecmCore->supGainOld = SUPGAIN_DEFAULT;
-    aecm->aecmCore->supGainErrParamA = SUPGAIN_ERROR_PARAM_A;
-    aecm->aecmCore->supGainErrParamD = SUPGAIN_ERROR_PARAM_D;
-    aecm->aecmCore->supGainErrParamDiffAB =
-        SUPGAIN_ERROR_PARAM_A - SUPGAIN_ERROR_PARAM_B;
-    aecm->aecmCore->supGainErrParamDiffBD =
-        SUPGAIN_ERROR_PARAM_B - SUPGAIN_ERROR_PARAM_D;
-  } else if (aecm->echoMode == 4) {
-    aecm->aecmCore->supGain = SUPGAIN_DEFAULT << 1;
-    aecm->aecmCore->supGainOld = SUPGAIN_DEFAULT << 1;
-    aecm->aecmCore->supGainErrParamA = SUPGAIN_ERROR_PARAM_A << 1;
-    aecm->aecmCore->supGainErrParamD = SUPGAIN_ERROR_PARAM_D << 1;
-    aecm->aecmCore->supGainErrParamDiffAB =
-        (SUPGAIN_ERROR_PARAM_A << 1) - (SUPGAIN_ERROR_PARAM_B << 1);
-    aecm->aecmCore->supGainErrParamDiffBD =
-        (SUPGAIN_ERROR_PARAM_B << 1) - (SUPGAIN_ERROR_PARAM_D << 1);
+  for (ch = 0; ch < aecm->num_channels; ++ch) {
+    AecmCore* core = aecm->aecmCores[ch];
+    const int16_t echoMode = aecm->echoMode;
+
+    core->cngMode = config.cngMode;
+
+    if (echoMode == 0) {
+      core->supGain = SUPGAIN_DEFAULT >> 3;
+      core->supGainOld = SUPGAIN_DEFAULT >> 3;
+      core->supGainErrParamA = SUPGAIN_ERROR_PARAM_A >> 3;
+      core->supGainErrParamD = SUPGAIN_ERROR_PARAM_D >> 3;
+      core->supGainErrParamDiffAB =
+          (SUPGAIN_ERROR_PARAM_A >> 3) - (SUPGAIN_ERROR_PARAM_B >> 3);
+      core->supGainErrParamDiffBD =
+          (SUPGAIN_ERROR_PARAM_B >> 3) - (SUPGAIN_ERROR_PARAM_D >> 3);
+    } else if (echoMode == 1) {
+      core->supGain = SUPGAIN_DEFAULT >> 2;
+      core->supGainOld = SUPGAIN_DEFAULT >> 2;
+      core->supGainErrParamA = SUPGAIN_ERROR_PARAM_A >> 2;
+      core->supGainErrParamD = SUPGAIN_ERROR_PARAM_D >> 2;
+      core->supGainErrParamDiffAB =
+          (SUPGAIN_ERROR_PARAM_A >> 2) - (SUPGAIN_ERROR_PARAM_B >> 2);
+      core->supGainErrParamDiffBD =
+          (SUPGAIN_ERROR_PARAM_B >> 2) - (SUPGAIN_ERROR_PARAM_D >> 2);
+    } else if (echoMode == 2) {
+      core->supGain = SUPGAIN_DEFAULT >> 1;
+      core->supGainOld = SUPGAIN_DEFAULT >> 1;
+      core->supGainErrParamA = SUPGAIN_ERROR_PARAM_A >> 1;
+      core->supGainErrParamD = SUPGAIN_ERROR_PARAM_D >> 1;
+      core->supGainErrParamDiffAB =
+          (SUPGAIN_ERROR_PARAM_A >> 1) - (SUPGAIN_ERROR_PARAM_B >> 1);
+      core->supGainErrParamDiffBD =
+          (SUPGAIN_ERROR_PARAM_B >> 1) - (SUPGAIN_ERROR_PARAM_D >> 1);
+    } else if (echoMode == 3) {
+      core->supGain = SUPGAIN_DEFAULT;
+      core->supGainOld = SUPGAIN_DEFAULT;
+      core->supGainErrParamA = SUPGAIN_ERROR_PARAM_A;
+      core->supGainErrParamD = SUPGAIN_ERROR_PARAM_D;
+      core->supGainErrParamDiffAB =
+          SUPGAIN_ERROR_PARAM_A - SUPGAIN_ERROR_PARAM_B;
+      core->supGainErrParamDiffBD =
+          SUPGAIN_ERROR_PARAM_B - SUPGAIN_ERROR_PARAM_D;
+    } else if (echoMode == 4) {
+      core->supGain = SUPGAIN_DEFAULT << 1;
+      core->supGainOld = SUPGAIN_DEFAULT << 1;
+      core->supGainErrParamA = SUPGAIN_ERROR_PARAM_A << 1;
+      core->supGainErrParamD = SUPGAIN_ERROR_PARAM_D << 1;
+      core->supGainErrParamDiffAB =
+          (SUPGAIN_ERROR_PARAM_A << 1) - (SUPGAIN_ERROR_PARAM_B << 1);
+      core->supGainErrParamDiffBD =
+          (SUPGAIN_ERROR_PARAM_B << 1) - (SUPGAIN_ERROR_PARAM_D << 1);
+    }
   }
 
   return 0;
@@ -485,6 +573,7 @@ int32_t WebRtcAecm_InitEchoPath(void* aecmInst,
                                 size_t size_bytes) {
   AecMobile* aecm = static_cast<AecMobile*>(aecmInst);
   const int16_t* echo_path_ptr = static_cast<const int16_t*>(echo_path);
+  size_t ch;
 
   if (aecmInst == NULL) {
     return -1;
@@ -500,7 +589,9 @@ int32_t WebRtcAecm_InitEchoPath(void* aecmInst,
     return AECM_UNINITIALIZED_ERROR;
   }
 
-  WebRtcAecm_InitEchoPathCore(aecm->aecmCore, echo_path_ptr);
+  for (ch = 0; ch < aecm->num_channels; ++ch) {
+    WebRtcAecm_InitEchoPathCore(aecm->aecmCores[ch], echo_path_ptr);
+  }
 
   return 0;
 }
@@ -525,10 +616,22 @@ int32_t WebRtcAecm_GetEchoPath(void* aecmInst,
     return AECM_UNINITIALIZED_ERROR;
   }
 
-  memcpy(echo_path_ptr, aecm->aecmCore->channelStored, size_bytes);
+  // The echo path of the first channel is reported.
+  memcpy(echo_path_ptr, aecm->aecmCores[0]->channelStored, size_bytes);
   return 0;
 }
 
+int16_t WebRtcAecm_GetUpperBandGain(void* aecmInst, size_t channel) {
+  AecMobile* aecm = static_cast<AecMobile*>(aecmInst);
+
+  if (aecm == NULL || channel >= aecm->num_channels ||
+      aecm->initFlag != kInitCheck) {
+    return ONE_Q14;
+  }
+
+  return aecm->aecmCores[channel]->upperBandGain;
+}
+
 size_t WebRtcAecm_echo_path_size_bytes() {
   return (PART_LEN1 * sizeof(int16_t));
 }
@@ -538,7 +641,7 @@ static int WebRtcAecm_EstBufDelay(AecMobile* aecm, short msInSndCardBuf) {
   short nSampFar = (short)WebRtc_available_read(aecm->farendBuf);
   short diff;
 
-  nSampSndCard = msInSndCardBuf * kSampMsNb * aecm->aecmCore->mult;
+  nSampSndCard = msInSndCardBuf * kSampMsNb * aecm->aecmCores[0]->mult;
 
   delayNew = nSampSndCard - nSampFar;
 
@@ -579,10 +682,10 @@ static int WebRtcAecm_DelayComp(AecMobile* aecm) {
   int nSampSndCard, delayNew, nSampAdd;
   const int maxStuffSamp = 10 * FRAME_LEN;
 
-  nSampSndCard = aecm->msInSndCardBuf * kSampMsNb * aecm->aecmCore->mult;
+  nSampSndCard = aecm->msInSndCardBuf * kSampMsNb * aecm->aecmCores[0]->mult;
   delayNew = nSampSndCard - nSampFar;
 
-  if (delayNew > FAR_BUF_LEN - FRAME_LEN * aecm->aecmCore->mult) {
+  if (delayNew > FAR_BUF_LEN - FRAME_LEN * aecm->aecmCores[0]->mult) {
     // The difference of the buffer sizes is larger than the maximum
     // allowed known delay. Compensate by stuffing the buffer.
     nSampAdd =
@@ -44,6 +44,17 @@ extern "C" {
  */
 void* WebRtcAecm_Create();
 
+/*
+ * Allocates the memory needed by an AECM processing |num_channels| nearend
+ * channels echoing the same farend signal. The farend buffering and delay
+ * estimation is shared by the channels, the delay being searched over the last
+ * |far_history_size| farend blocks of 64 samples. WebRtcAecm_Create() uses
+ * 100 blocks. The memory needs to be initialized separately using the
+ * WebRtcAecm_Init() function.
+ * Returns a pointer to the instance and a nullptr at failure.
+ */
+void* WebRtcAecm_CreateMultiChannel(size_t num_channels, int far_history_size);
+
 /*
  * This function releases the memory allocated by WebRtcAecm_Create()
  *
@@ -138,6 +149,34 @@ int32_t WebRtcAecm_Process(void* aecmInst,
                            size_t nrOfSamples,
                            int16_t msInSndCardBuf);
 
+/*
+ * Same as WebRtcAecm_Process(), for an instance created with
+ * WebRtcAecm_CreateMultiChannel(). Each of the buffers points to the frame of
+ * one nearend channel.
+ *
+ * Inputs                        Description
+ * -------------------------------------------------------------------
+ * void*          aecmInst       Pointer to the AECM instance
+ * int16_t**      nearendNoisy   In buffers, one per channel
+ * int16_t**      nearendClean   In buffers, one per channel, or a NULL
+ *                               pointer
+ * int16_t        nrOfSamples    Number of samples in each nearend buffer
+ * int16_t        msInSndCardBuf Delay estimate for sound card and
+ *                               system buffers
+ *
+ * Outputs                       Description
+ * -------------------------------------------------------------------
+ * int16_t**      out            Out buffers, one per channel
+ * int32_t        return         0: OK
+ *                               1200-12004,12100: error/warning
+ */
+int32_t WebRtcAecm_ProcessMultiChannel(void* aecmInst,
+                                       const int16_t* const* nearendNoisy,
+                                       const int16_t* const* nearendClean,
+                                       int16_t* const* out,
+                                       size_t nrOfSamples,
+                                       int16_t msInSndCardBuf);
+
 /*
  * This function enables the user to set certain parameters on-the-fly
  *
@@ -174,7 +213,8 @@ int32_t WebRtcAecm_InitEchoPath(void* aecmInst,
 
 /*
  * This function enables the user to get the currently used echo path
- * on-the-fly
+ * on-the-fly. For a multi-channel instance, the echo path of the first
+ * channel is returned.
  *
  * Inputs                       Description
  * -------------------------------------------------------------------
@@ -191,6 +231,21 @@ int32_t WebRtcAecm_GetEchoPath(void* aecmInst,
                                void* echo_path,
                                size_t size_bytes);
 
+/*
+ * Returns the suppression gain of the last processed frame of a channel, to
+ * be applied to the bands above the processed one.
+ *
+ * Inputs                       Description
+ * -------------------------------------------------------------------
+ * void*        aecmInst        Pointer to the AECM instance
+ * size_t       channel         Index of the nearend channel
+ *
+ * Outputs                      Description
+ * -------------------------------------------------------------------
+ * int16_t      return          Gain in Q14
+ */
+int16_t WebRtcAecm_GetUpperBandGain(void* aecmInst, size_t channel);
+
 /*
  * This function enables the user to get the echo path size in bytes
  *
@@ -932,6 +932,51 @@ int32_t WebRtcAgc_ProcessAnalog(void* state,
   return 0;
 }
 
+namespace {
+
+// Checks that a frame of |samples| samples is 10 ms long at the rate of |stt|.
+bool ValidFrameLength(const LegacyAgc* stt, size_t samples) {
+  if (stt->fs == 8000) {
+    return samples == 80;
+  } else if (stt->fs == 16000 || stt->fs == 32000 || stt->fs == 48000) {
+    return samples == 160;
+  }
+  return false;
+}
+
+// Updates the analog AGC and the queue of envelope and energy values produced
+// by WebRtcAgc_AddMic(), once the digital gains have been computed.
+int AnalyzeAnalog(void* agcInst,
+                  int32_t inMicLevel,
+                  int32_t* outMicLevel,
+                  int16_t echo,
+                  uint8_t* saturationWarning) {
+  LegacyAgc* stt = reinterpret_cast<LegacyAgc*>(agcInst);
+
+  if (stt->agcMode < kAgcModeFixedDigital &&
+      (stt->lowLevelSignal == 0 || stt->agcMode != kAgcModeAdaptiveDigital)) {
+    if (WebRtcAgc_ProcessAnalog(agcInst, inMicLevel, outMicLevel,
+                                stt->vadMic.logRatio, echo,
+                                saturationWarning) == -1) {
+      return -1;
+    }
+  }
+
+  /* update queue */
+  if (stt->inQueue > 1) {
+    memcpy(stt->env[0], stt->env[1], 10 * sizeof(int32_t));
+    memcpy(stt->Rxx16w32_array[0], stt->Rxx16w32_array[1], 5 * sizeof(int32_t));
+  }
+
+  if (stt->inQueue > 0) {
+    stt->inQueue--;
+  }
+
+  return 0;
+}
+
+}  // namespace
+
 int WebRtcAgc_Analyze(void* agcInst,
                       const int16_t* const* in_near,
                       size_t num_bands,
@@ -943,19 +988,7 @@ int WebRtcAgc_Analyze(void* agcInst,
                       int32_t gains[11]) {
   LegacyAgc* stt = reinterpret_cast<LegacyAgc*>(agcInst);
 
-  if (stt == NULL) {
-    return -1;
-  }
-
-  if (stt->fs == 8000) {
-    if (samples != 80) {
-      return -1;
-    }
-  } else if (stt->fs == 16000 || stt->fs == 32000 || stt->fs == 48000) {
-    if (samples != 160) {
-      return -1;
-    }
-  } else {
+  if (stt == NULL || !ValidFrameLength(stt, samples)) {
     return -1;
   }
 
@@ -970,26 +1003,35 @@ int WebRtcAgc_Analyze(void* agcInst,
     return -1;
   }
 
-  if (stt->agcMode < kAgcModeFixedDigital &&
-      (stt->lowLevelSignal == 0 || stt->agcMode != kAgcModeAdaptiveDigital)) {
-    if (WebRtcAgc_ProcessAnalog(agcInst, inMicLevel, outMicLevel,
-                                stt->vadMic.logRatio, echo,
-                                saturationWarning) == -1) {
-      return -1;
-    }
-  }
+  return AnalyzeAnalog(agcInst, inMicLevel, outMicLevel, echo,
+                       saturationWarning);
+}
 
-  /* update queue */
-  if (stt->inQueue > 1) {
-    memcpy(stt->env[0], stt->env[1], 10 * sizeof(int32_t));
-    memcpy(stt->Rxx16w32_array[0], stt->Rxx16w32_array[1], 5 * sizeof(int32_t));
+int WebRtcAgc_AnalyzeFloat(void* agcInst,
+                           const float* in_near,
+                           size_t samples,
+                           int32_t inMicLevel,
+                           int32_t* outMicLevel,
+                           int16_t echo,
+                           uint8_t* saturationWarning,
+                           float gains[11]) {
+  LegacyAgc* stt = reinterpret_cast<LegacyAgc*>(agcInst);
+
+  if (stt == NULL || !ValidFrameLength(stt, samples)) {
+    return -1;
   }
 
-  if (stt->inQueue > 0) {
-    stt->inQueue--;
+  *saturationWarning = 0;
+  *outMicLevel = inMicLevel;
+
+  int32_t error = WebRtcAgc_ComputeDigitalGainsFloat(
+      &stt->digitalAgc, in_near, stt->fs, stt->lowLevelSignal, gains);
+  if (error == -1) {
+    return -1;
   }
 
-  return 0;
+  return AnalyzeAnalog(agcInst, inMicLevel, outMicLevel, echo,
+                       saturationWarning);
 }
 
 int WebRtcAgc_Process(const void* agcInst,
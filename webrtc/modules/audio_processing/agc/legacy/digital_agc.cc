@@ -10,8 +10,14 @@
 
 #include "modules/audio_processing/agc/legacy/digital_agc.h"
 
+#include <math.h>
 #include <string.h>
 
+#include <algorithm>
+
+#include "api/array_view.h"
+#include "common_audio/include/audio_util.h"
+#include "common_audio/vector_math.h"
 #include "modules/audio_processing/agc/legacy/gain_control.h"
 #include "rtc_base/checks.h"
 
@@ -61,6 +67,93 @@ static const int16_t kAvgDecayTime = 250;  // frames; < 3000
 #define AGC_SCALEDIFF32(A, B, C) \
   ((C) + ((B) >> 16) * (A) + (((0x0000FFFF & (B)) * (A)) >> 16))
 
+// Computes the decay factor (Q16) of the slow envelope follower from the
+// near-end voice activity.
+int16_t ComputeDecay(const DigitalAgc* stt,
+                     int16_t logratio,
+                     int16_t lowlevelSignal) {
+  int32_t tmp32;
+  int16_t lower_thr, upper_thr;
+  int16_t decay;
+
+  // Account for far end VAD
+  if (stt->vadFarend.counter > 10) {
+    tmp32 = 3 * logratio;
+    logratio = (int16_t)((tmp32 - stt->vadFarend.logRatio) >> 2);
+  }
+
+  // Determine decay factor depending on VAD
+  //  upper_thr = 1.0f;
+  //  lower_thr = 0.25f;
+  upper_thr = 1024;  // Q10
+  lower_thr = 0;     // Q10
+  if (logratio > upper_thr) {
+    // decay = -2^17 / DecayTime;  ->  -65
+    decay = -65;
+  } else if (logratio < lower_thr) {
+    decay = 0;
+  } else {
+    // decay = (int16_t)(((lower_thr - logratio)
+    //       * (2^27/(DecayTime*(upper_thr-lower_thr)))) >> 10);
+    // SUBSTITUTED: 2^27/(DecayTime*(upper_thr-lower_thr))  ->  65
+    tmp32 = (lower_thr - logratio) * 65;
+    decay = (int16_t)(tmp32 >> 10);
+  }
+
+  // adjust decay factor for long silence (detected as low standard deviation)
+  // This is only done in the adaptive modes
+  if (stt->agcMode != kAgcModeFixedDigital) {
+    if (stt->vadNearend.stdLongTerm < 4000) {
+      decay = 0;
+    } else if (stt->vadNearend.stdLongTerm < 8096) {
+      // decay = (int16_t)(((stt->vadNearend.stdLongTerm - 4000) * decay) >>
+      // 12);
+      tmp32 = (stt->vadNearend.stdLongTerm - 4000) * decay;
+      decay = (int16_t)(tmp32 >> 12);
+    }
+
+    if (lowlevelSignal != 0) {
+      decay = 0;
+    }
+  }
+
+  return decay;
+}
+
+// Returns the optimization to use for the envelope computation. The CPU
+// features are only detected once.
+VectorMathOptimization GetOptimization() {
+  static const VectorMathOptimization optimization =
+      DetectVectorMathOptimization();
+  return optimization;
+}
+
+// Computes the maximum energy of each of the 10 sub frames of |x|, with the
+// amplitudes limited to the S16 range.
+void ComputeEnvelope(const float* x, size_t L, float env[10]) {
+  for (size_t k = 0; k < 10; ++k) {
+    const float max_abs = VectorMaxAbs(
+        GetOptimization(), rtc::ArrayView<const float>(&x[k * L], L));
+    const float amplitude = std::min(max_abs, 32768.f);
+    env[k] = amplitude * amplitude;
+  }
+}
+
+// Splits |level| into the number of leading zeros of its 32 bit integer
+// representation, as given by WebRtcSpl_NormU32(), and the fractional part of
+// the normalized level.
+void NormalizeLevel(float level, int* zeros, float* frac) {
+  if (level < 1.f) {
+    *zeros = 31;
+    *frac = 0.f;
+    return;
+  }
+  int exponent;
+  const float mantissa = frexpf(level, &exponent);
+  *zeros = std::max(32 - exponent, 1);
+  *frac = 2.f * mantissa - 1.f;
+}
+
 }  // namespace
 
 int32_t WebRtcAgc_CalculateGainTable(int32_t* gainTable,       // Q16
@@ -258,6 +351,11 @@ int32_t WebRtcAgc_InitDigital(DigitalAgc* stt, int16_t agcMode) {
   stt->gatePrevious = 0;
   stt->agcMode = agcMode;
 
+  stt->capacitorSlowFloat = stt->capacitorSlow;
+  stt->capacitorFastFloat = 0.f;
+  stt->gainFloat = 1.f;
+  stt->gatePreviousFloat = 0.f;
+
   // initialize VADs
   WebRtcAgc_InitVad(&stt->vadNearend);
   WebRtcAgc_InitVad(&stt->vadFarend);
@@ -288,7 +386,6 @@ int32_t WebRtcAgc_ComputeDigitalGains(DigitalAgc* stt,
   int32_t cur_level;
   int32_t gain32;
   int16_t logratio;
-  int16_t lower_thr, upper_thr;
   int16_t zeros = 0, zeros_fast, frac = 0;
   int16_t decay;
   int16_t gate, gain_adj;
@@ -310,46 +407,8 @@ int32_t WebRtcAgc_ComputeDigitalGains(DigitalAgc* stt,
   // VAD for near end
   logratio = WebRtcAgc_ProcessVad(&stt->vadNearend, in_near[0], L * 10);
 
-  // Account for far end VAD
-  if (stt->vadFarend.counter > 10) {
-    tmp32 = 3 * logratio;
-    logratio = (int16_t)((tmp32 - stt->vadFarend.logRatio) >> 2);
-  }
+  decay = ComputeDecay(stt, logratio, lowlevelSignal);
 
-  // Determine decay factor depending on VAD
-  //  upper_thr = 1.0f;
-  //  lower_thr = 0.25f;
-  upper_thr = 1024;  // Q10
-  lower_thr = 0;     // Q10
-  if (logratio > upper_thr) {
-    // decay = -2^17 / DecayTime;  ->  -65
-    decay = -65;
-  } else if (logratio < lower_thr) {
-    decay = 0;
-  } else {
-    // decay = (int16_t)(((lower_thr - logratio)
-    //       * (2^27/(DecayTime*(upper_thr-lower_thr)))) >> 10);
-    // SUBSTITUTED: 2^27/(DecayTime*(upper_thr-lower_thr))  ->  65
-    tmp32 = (lower_thr - logratio) * 65;
-    decay = (int16_t)(tmp32 >> 10);
-  }
-
-  // adjust decay factor for long silence (detected as low standard deviation)
-  // This is only done in the adaptive modes
-  if (stt->agcMode != kAgcModeFixedDigital) {
-    if (stt->vadNearend.stdLongTerm < 4000) {
-      decay = 0;
-    } else if (stt->vadNearend.stdLongTerm < 8096) {
-      // decay = (int16_t)(((stt->vadNearend.stdLongTerm - 4000) * decay) >>
-      // 12);
-      tmp32 = (stt->vadNearend.stdLongTerm - 4000) * decay;
-      decay = (int16_t)(tmp32 >> 12);
-    }
-
-    if (lowlevelSignal != 0) {
-      decay = 0;
-    }
-  }
   // Find max amplitude per sub frame
   // iterate over sub frames
   for (k = 0; k < 10; k++) {
@@ -483,6 +542,103 @@ int32_t WebRtcAgc_ComputeDigitalGains(DigitalAgc* stt,
   return 0;
 }
 
+int32_t WebRtcAgc_ComputeDigitalGainsFloat(DigitalAgc* stt,
+                                           const float* in_near,
+                                           uint32_t FS,
+                                           int16_t lowlevelSignal,
+                                           float gains[11]) {
+  constexpr float kScaling = 1.f / 65536.f;
+  // Fast envelope follower decay time = -131000 / -1000 = 131 (ms).
+  constexpr float kFastDecay = 1.f - 1000.f * kScaling;
+  constexpr float kSlowAttack = 500.f * kScaling;
+  // Maximum energy of the output, corresponding to full scale.
+  constexpr float kMaxEnergy = 32767.f * 32768.f;
+  size_t L;  // samples/subframe
+
+  // determine number of samples per ms
+  if (FS == 8000) {
+    L = 8;
+  } else if (FS == 16000 || FS == 32000 || FS == 48000) {
+    L = 16;
+  } else {
+    return -1;
+  }
+
+  // VAD for near end, operating on the fixed point representation.
+  int16_t in_near_s16[160];
+  FloatS16ToS16(in_near, L * 10, in_near_s16);
+  const int16_t logratio =
+      WebRtcAgc_ProcessVad(&stt->vadNearend, in_near_s16, L * 10);
+  const float slow_decay =
+      1.f + ComputeDecay(stt, logratio, lowlevelSignal) * kScaling;
+
+  float env[10];
+  ComputeEnvelope(in_near, L, env);
+
+  // Calculate gain per sub frame
+  int zeros = 31;
+  float frac = 0.f;
+  gains[0] = stt->gainFloat;
+  for (int k = 0; k < 10; k++) {
+    stt->capacitorFastFloat =
+        std::max(stt->capacitorFastFloat * kFastDecay, env[k]);
+    if (env[k] > stt->capacitorSlowFloat) {
+      stt->capacitorSlowFloat +=
+          kSlowAttack * (env[k] - stt->capacitorSlowFloat);
+    } else {
+      stt->capacitorSlowFloat *= slow_decay;
+    }
+
+    // Interpolate between gainTable[zeros] and gainTable[zeros-1].
+    NormalizeLevel(std::max(stt->capacitorFastFloat, stt->capacitorSlowFloat),
+                   &zeros, &frac);
+    gains[k + 1] =
+        (stt->gainTable[zeros] +
+         (stt->gainTable[zeros - 1] - stt->gainTable[zeros]) * frac) *
+        kScaling;
+  }
+
+  // Gate processing (lower gain during absence of speech), with the levels
+  // expressed as leading zeros in Q9.
+  int zeros_fast;
+  float frac_fast;
+  NormalizeLevel(stt->capacitorFastFloat, &zeros_fast, &frac_fast);
+  float gate = 1000.f + 512.f * (zeros_fast - frac_fast) -
+               512.f * (zeros - frac) - stt->vadNearend.stdShortTerm;
+  if (gate < 0.f) {
+    stt->gatePreviousFloat = 0.f;
+  } else {
+    gate = (gate + 7.f * stt->gatePreviousFloat) * (1.f / 8.f);
+    stt->gatePreviousFloat = gate;
+  }
+  // gate < 0     -> no gate
+  // gate > 2500  -> max gate
+  if (gate > 0.f) {
+    const float gain_adj = gate < 2500.f ? (2500.f - gate) * (1.f / 32.f) : 0.f;
+    const float factor = (178.f + gain_adj) * (1.f / 256.f);
+    const float min_gain = stt->gainTable[0] * kScaling;
+    for (int k = 0; k < 10; k++) {
+      gains[k + 1] = min_gain + (gains[k + 1] - min_gain) * factor;
+    }
+  }
+
+  // Limit gain to avoid overload distortion
+  for (int k = 0; k < 10; k++) {
+    while (env[k] * gains[k + 1] * gains[k + 1] > kMaxEnergy) {
+      // multiply by 253/256 ==> -0.1 dB
+      gains[k + 1] *= 253.f / 256.f;
+    }
+  }
+  // gain reductions should be done 1 ms earlier than gain increases
+  for (int k = 1; k < 10; k++) {
+    gains[k] = std::min(gains[k], gains[k + 1]);
+  }
+  // save start gain for next frame
+  stt->gainFloat = gains[10];
+
+  return 0;
+}
+
 int32_t WebRtcAgc_ApplyDigitalGains(const int32_t gains[11],
                                     size_t num_bands,
                                     uint32_t FS,
@@ -37,6 +37,12 @@ typedef struct {
   int16_t agcMode;
   AgcVad vadNearend;
   AgcVad vadFarend;
+  // State of the floating point gain computation, in the same units as the
+  // fixed point state above but with the gain being linear.
+  float capacitorSlowFloat;
+  float capacitorFastFloat;
+  float gainFloat;
+  float gatePreviousFloat;
 } DigitalAgc;
 
 int32_t WebRtcAgc_InitDigital(DigitalAgc* digitalAgcInst, int16_t agcMode);
@@ -48,6 +54,15 @@ int32_t WebRtcAgc_ComputeDigitalGains(DigitalAgc* digitalAgcInst,
                                       int16_t lowLevelSignal,
                                       int32_t gains[11]);
 
+// Floating point variant of WebRtcAgc_ComputeDigitalGains. Only the lowest
+// band is analyzed, and it is passed in the FloatS16 format. The resulting
+// gains are linear.
+int32_t WebRtcAgc_ComputeDigitalGainsFloat(DigitalAgc* digitalAgcInst,
+                                           const float* inNear,
+                                           uint32_t FS,
+                                           int16_t lowLevelSignal,
+                                           float gains[11]);
+
 int32_t WebRtcAgc_ApplyDigitalGains(const int32_t gains[11],
                                     size_t num_bands,
                                     uint32_t FS,
@@ -157,6 +157,20 @@ int WebRtcAgc_Analyze(void* agcInst,
                       uint8_t* saturationWarning,
                       int32_t gains[11]);
 
+/*
+ * Floating point variant of WebRtcAgc_Analyze. Only the lowest band of the
+ * near-end signal is needed for the analysis, and it is passed in the FloatS16
+ * format. The produced gains are linear rather than in Q16.
+ */
+int WebRtcAgc_AnalyzeFloat(void* agcInst,
+                           const float* inNear,
+                           size_t samples,
+                           int32_t inMicLevel,
+                           int32_t* outMicLevel,
+                           int16_t echo,
+                           uint8_t* saturationWarning,
+                           float gains[11]);
+
 /*
  * This function processes a 10 ms frame by applying precomputed digital gains.
  *
@@ -0,0 +1,168 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/agc2/agc2_vector_math.h"
+
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+float Agc2VectorMath::MaxAbs(rtc::ArrayView<const float> x) const {
+  return VectorMaxAbs(optimization_, x);
+}
+
+void Agc2VectorMath::Ramp(float start,
+                          float increment,
+                          rtc::ArrayView<float> y) const {
+  const int size = static_cast<int>(y.size());
+  int j = 0;
+  switch (optimization_) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case VectorMathOptimization::kAvx2:
+    case VectorMathOptimization::kSse2: {
+      const __m128 start_v = _mm_set1_ps(start);
+      const __m128 increment_v = _mm_set1_ps(increment);
+      __m128 index_v = _mm_set_ps(3.f, 2.f, 1.f, 0.f);
+      const __m128 four_v = _mm_set1_ps(4.f);
+      for (; j + 4 <= size; j += 4) {
+        _mm_storeu_ps(&y[j],
+                      _mm_add_ps(start_v, _mm_mul_ps(increment_v, index_v)));
+        index_v = _mm_add_ps(index_v, four_v);
+      }
+    } break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case VectorMathOptimization::kNeon: {
+      const float32x4_t start_v = vdupq_n_f32(start);
+      const float32x4_t increment_v = vdupq_n_f32(increment);
+      const float kIndices[4] = {0.f, 1.f, 2.f, 3.f};
+      float32x4_t index_v = vld1q_f32(kIndices);
+      const float32x4_t four_v = vdupq_n_f32(4.f);
+      for (; j + 4 <= size; j += 4) {
+        vst1q_f32(&y[j], vaddq_f32(start_v, vmulq_f32(increment_v, index_v)));
+        index_v = vaddq_f32(index_v, four_v);
+      }
+    } break;
+#endif
+    default:
+      break;
+  }
+
+  for (; j < size; ++j) {
+    y[j] = start + increment * j;
+  }
+}
+
+void Agc2VectorMath::MultiplyAndClamp(rtc::ArrayView<const float> x,
+                                      float min_value,
+                                      float max_value,
+                                      rtc::ArrayView<float> y) const {
+  RTC_DCHECK_EQ(y.size(), x.size());
+  const int size = static_cast<int>(y.size());
+  int j = 0;
+  switch (optimization_) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case VectorMathOptimization::kAvx2:
+    case VectorMathOptimization::kSse2: {
+      const __m128 min_v = _mm_set1_ps(min_value);
+      const __m128 max_v = _mm_set1_ps(max_value);
+      for (; j + 4 <= size; j += 4) {
+        const __m128 p = _mm_mul_ps(_mm_loadu_ps(&x[j]), _mm_loadu_ps(&y[j]));
+        _mm_storeu_ps(&y[j], _mm_min_ps(_mm_max_ps(p, min_v), max_v));
+      }
+    } break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case VectorMathOptimization::kNeon: {
+      const float32x4_t min_v = vdupq_n_f32(min_value);
+      const float32x4_t max_v = vdupq_n_f32(max_value);
+      for (; j + 4 <= size; j += 4) {
+        const float32x4_t p = vmulq_f32(vld1q_f32(&x[j]), vld1q_f32(&y[j]));
+        vst1q_f32(&y[j], vminq_f32(vmaxq_f32(p, min_v), max_v));
+      }
+    } break;
+#endif
+    default:
+      break;
+  }
+
+  for (; j < size; ++j) {
+    y[j] = std::min(std::max(x[j] * y[j], min_value), max_value);
+  }
+}
+
+void Agc2VectorMath::Scale(float gain, rtc::ArrayView<float> y) const {
+  VectorScale(optimization_, gain, y, y);
+}
+
+void Agc2VectorMath::ScaleWithRamp(float start,
+                                   float increment,
+                                   rtc::ArrayView<float> y) const {
+  const int size = static_cast<int>(y.size());
+  int j = 0;
+  switch (optimization_) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case VectorMathOptimization::kAvx2:
+    case VectorMathOptimization::kSse2: {
+      const __m128 start_v = _mm_set1_ps(start);
+      const __m128 increment_v = _mm_set1_ps(increment);
+      __m128 index_v = _mm_set_ps(3.f, 2.f, 1.f, 0.f);
+      const __m128 four_v = _mm_set1_ps(4.f);
+      for (; j + 4 <= size; j += 4) {
+        const __m128 gain_v =
+            _mm_add_ps(start_v, _mm_mul_ps(increment_v, index_v));
+        _mm_storeu_ps(&y[j], _mm_mul_ps(gain_v, _mm_loadu_ps(&y[j])));
+        index_v = _mm_add_ps(index_v, four_v);
+      }
+    } break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case VectorMathOptimization::kNeon: {
+      const float32x4_t start_v = vdupq_n_f32(start);
+      const float32x4_t increment_v = vdupq_n_f32(increment);
+      const float kIndices[4] = {0.f, 1.f, 2.f, 3.f};
+      float32x4_t index_v = vld1q_f32(kIndices);
+      const float32x4_t four_v = vdupq_n_f32(4.f);
+      for (; j + 4 <= size; j += 4) {
+        const float32x4_t gain_v =
+            vaddq_f32(start_v, vmulq_f32(increment_v, index_v));
+        vst1q_f32(&y[j], vmulq_f32(gain_v, vld1q_f32(&y[j])));
+        index_v = vaddq_f32(index_v, four_v);
+      }
+    } break;
+#endif
+    default:
+      break;
+  }
+
+  for (; j < size; ++j) {
+    y[j] *= start + increment * j;
+  }
+}
+
+void Agc2VectorMath::Clamp(float min_value,
+                           float max_value,
+                           rtc::ArrayView<float> x) const {
+  VectorClamp(optimization_, min_value, max_value, x);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,58 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AGC2_AGC2_VECTOR_MATH_H_
+#define MODULES_AUDIO_PROCESSING_AGC2_AGC2_VECTOR_MATH_H_
+
+#include "api/array_view.h"
+#include "common_audio/vector_math.h"
+
+namespace webrtc {
+
+// Provides optimizations for the per-sample operations used to estimate the
+// signal envelope and to apply gains in AGC2. The operations are applied to
+// one channel at a time.
+class Agc2VectorMath {
+ public:
+  explicit Agc2VectorMath(VectorMathOptimization optimization)
+      : optimization_(optimization) {}
+
+  // Returns the maximum absolute value of the elements of x.
+  float MaxAbs(rtc::ArrayView<const float> x) const;
+
+  // Computes the linear ramp y[j] = start + increment * j.
+  void Ramp(float start, float increment, rtc::ArrayView<float> y) const;
+
+  // Elementwise multiplication y = x * y, with the result clamped to the range
+  // [min_value, max_value].
+  void MultiplyAndClamp(rtc::ArrayView<const float> x,
+                        float min_value,
+                        float max_value,
+                        rtc::ArrayView<float> y) const;
+
+  // Elementwise scaling y = gain * y.
+  void Scale(float gain, rtc::ArrayView<float> y) const;
+
+  // Elementwise scaling with a linear ramp y[j] = (start + increment * j) *
+  // y[j].
+  void ScaleWithRamp(float start,
+                     float increment,
+                     rtc::ArrayView<float> y) const;
+
+  // Elementwise clamping of x to the range [min_value, max_value].
+  void Clamp(float min_value, float max_value, rtc::ArrayView<float> x) const;
+
+ private:
+  const VectorMathOptimization optimization_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AGC2_AGC2_VECTOR_MATH_H_
@@ -14,6 +14,7 @@
 #include <cmath>
 
 #include "api/array_view.h"
+#include "common_audio/vector_math.h"
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 #include "rtc_base/checks.h"
 
@@ -28,6 +29,7 @@ FixedDigitalLevelEstimator::FixedDigitalLevelEstimator(
     size_t sample_rate_hz,
     ApmDataDumper* apm_data_dumper)
     : apm_data_dumper_(apm_data_dumper),
+      vector_math_(DetectVectorMathOptimization()),
       filter_state_level_(kInitialFilterStateLevel) {
   SetSampleRate(sample_rate_hz);
   CheckParameterCombination();
@@ -53,13 +55,10 @@ std::array<float, kSubFramesInFrame> FixedDigitalLevelEstimator::ComputeLevel(
        ++channel_idx) {
     const auto channel = float_frame.channel(channel_idx);
     for (size_t sub_frame = 0; sub_frame < kSubFramesInFrame; ++sub_frame) {
-      for (size_t sample_in_sub_frame = 0;
-           sample_in_sub_frame < samples_in_sub_frame_; ++sample_in_sub_frame) {
-        envelope[sub_frame] =
-            std::max(envelope[sub_frame],
-                     std::abs(channel[sub_frame * samples_in_sub_frame_ +
-                                      sample_in_sub_frame]));
-      }
+      envelope[sub_frame] = std::max(
+          envelope[sub_frame],
+          vector_math_.MaxAbs(channel.subview(
+              sub_frame * samples_in_sub_frame_, samples_in_sub_frame_)));
     }
   }
 
@@ -15,6 +15,7 @@
 #include <vector>
 
 #include "modules/audio_processing/agc2/agc2_common.h"
+#include "modules/audio_processing/agc2/agc2_vector_math.h"
 #include "modules/audio_processing/include/audio_frame_view.h"
 #include "rtc_base/constructor_magic.h"
 
@@ -54,6 +55,7 @@ class FixedDigitalLevelEstimator {
   void CheckParameterCombination();
 
   ApmDataDumper* const apm_data_dumper_ = nullptr;
+  const Agc2VectorMath vector_math_;
   float filter_state_level_;
   size_t samples_in_frame_;
   size_t samples_in_sub_frame_;
@@ -11,8 +11,8 @@
 #include "modules/audio_processing/agc2/gain_applier.h"
 
 #include "api/array_view.h"
+#include "common_audio/vector_math.h"
 #include "modules/audio_processing/agc2/agc2_common.h"
-#include "rtc_base/numerics/safe_minmax.h"
 
 namespace webrtc {
 namespace {
@@ -24,18 +24,17 @@ bool GainCloseToOne(float gain_factor) {
          gain_factor <= 1.f + 1.f / kMaxFloatS16Value;
 }
 
-void ClipSignal(AudioFrameView<float> signal) {
+void ClipSignal(const Agc2VectorMath& vector_math,
+                AudioFrameView<float> signal) {
   for (size_t k = 0; k < signal.num_channels(); ++k) {
-    rtc::ArrayView<float> channel_view = signal.channel(k);
-    for (auto& sample : channel_view) {
-      sample = rtc::SafeClamp(sample, kMinFloatS16Value, kMaxFloatS16Value);
-    }
+    vector_math.Clamp(kMinFloatS16Value, kMaxFloatS16Value, signal.channel(k));
   }
 }
 
 void ApplyGainWithRamping(float last_gain_linear,
                           float gain_at_end_of_frame_linear,
                           float inverse_samples_per_channel,
+                          const Agc2VectorMath& vector_math,
                           AudioFrameView<float> float_frame) {
   // Do not modify the signal.
   if (last_gain_linear == gain_at_end_of_frame_linear &&
@@ -46,10 +45,7 @@ void ApplyGainWithRamping(float last_gain_linear,
   // Gain is constant and different from 1.
   if (last_gain_linear == gain_at_end_of_frame_linear) {
     for (size_t k = 0; k < float_frame.num_channels(); ++k) {
-      rtc::ArrayView<float> channel_view = float_frame.channel(k);
-      for (auto& sample : channel_view) {
-        sample *= gain_at_end_of_frame_linear;
-      }
+      vector_math.Scale(gain_at_end_of_frame_linear, float_frame.channel(k));
     }
     return;
   }
@@ -57,12 +53,9 @@ void ApplyGainWithRamping(float last_gain_linear,
   // The gain changes. We have to change slowly to avoid discontinuities.
   const float increment = (gain_at_end_of_frame_linear - last_gain_linear) *
                           inverse_samples_per_channel;
-  float gain = last_gain_linear;
-  for (size_t i = 0; i < float_frame.samples_per_channel(); ++i) {
-    for (size_t ch = 0; ch < float_frame.num_channels(); ++ch) {
-      float_frame.channel(ch)[i] *= gain;
-    }
-    gain += increment;
+  for (size_t ch = 0; ch < float_frame.num_channels(); ++ch) {
+    vector_math.ScaleWithRamp(last_gain_linear, increment,
+                              float_frame.channel(ch));
   }
 }
 
@@ -71,7 +64,8 @@ void ApplyGainWithRamping(float last_gain_linear,
 GainApplier::GainApplier(bool hard_clip_samples, float initial_gain_factor)
     : hard_clip_samples_(hard_clip_samples),
       last_gain_factor_(initial_gain_factor),
-      current_gain_factor_(initial_gain_factor) {}
+      current_gain_factor_(initial_gain_factor),
+      vector_math_(DetectVectorMathOptimization()) {}
 
 void GainApplier::ApplyGain(AudioFrameView<float> signal) {
   if (static_cast<int>(signal.samples_per_channel()) != samples_per_channel_) {
@@ -79,12 +73,12 @@ void GainApplier::ApplyGain(AudioFrameView<float> signal) {
   }
 
   ApplyGainWithRamping(last_gain_factor_, current_gain_factor_,
-                       inverse_samples_per_channel_, signal);
+                       inverse_samples_per_channel_, vector_math_, signal);
 
   last_gain_factor_ = current_gain_factor_;
 
   if (hard_clip_samples_) {
-    ClipSignal(signal);
+    ClipSignal(vector_math_, signal);
   }
 }
 
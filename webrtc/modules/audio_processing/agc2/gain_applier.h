@@ -13,6 +13,7 @@
 
 #include <stddef.h>
 
+#include "modules/audio_processing/agc2/agc2_vector_math.h"
 #include "modules/audio_processing/include/audio_frame_view.h"
 
 namespace webrtc {
@@ -36,6 +37,7 @@ class GainApplier {
   // ramped from 'last_gain_factor_' to this value during the next
   // 'ApplyGain'.
   float current_gain_factor_;
+  const Agc2VectorMath vector_math_;
   int samples_per_channel_ = -1;
   float inverse_samples_per_channel_ = -1.f;
 };
@@ -15,10 +15,11 @@
 #include <cmath>
 
 #include "api/array_view.h"
+#include "common_audio/vector_math.h"
 #include "modules/audio_processing/agc2/agc2_common.h"
+#include "modules/audio_processing/agc2/agc2_vector_math.h"
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 #include "rtc_base/checks.h"
-#include "rtc_base/numerics/safe_minmax.h"
 
 namespace webrtc {
 namespace {
@@ -45,6 +46,7 @@ void InterpolateFirstSubframe(float last_factor,
 void ComputePerSampleSubframeFactors(
     const std::array<float, kSubFramesInFrame + 1>& scaling_factors,
     size_t samples_per_channel,
+    const Agc2VectorMath& vector_math,
     rtc::ArrayView<float> per_sample_scaling_factors) {
   const size_t num_subframes = scaling_factors.size() - 1;
   const size_t subframe_size =
@@ -64,23 +66,20 @@ void ComputePerSampleSubframeFactors(
     const float scaling_start = scaling_factors[i];
     const float scaling_end = scaling_factors[i + 1];
     const float scaling_diff = (scaling_end - scaling_start) / subframe_size;
-    for (size_t j = 0; j < subframe_size; ++j) {
-      per_sample_scaling_factors[subframe_start + j] =
-          scaling_start + scaling_diff * j;
-    }
+    vector_math.Ramp(
+        scaling_start, scaling_diff,
+        per_sample_scaling_factors.subview(subframe_start, subframe_size));
   }
 }
 
 void ScaleSamples(rtc::ArrayView<const float> per_sample_scaling_factors,
+                  const Agc2VectorMath& vector_math,
                   AudioFrameView<float> signal) {
-  const size_t samples_per_channel = signal.samples_per_channel();
-  RTC_DCHECK_EQ(samples_per_channel, per_sample_scaling_factors.size());
+  RTC_DCHECK_EQ(signal.samples_per_channel(),
+                per_sample_scaling_factors.size());
   for (size_t i = 0; i < signal.num_channels(); ++i) {
-    auto channel = signal.channel(i);
-    for (size_t j = 0; j < samples_per_channel; ++j) {
-      channel[j] = rtc::SafeClamp(channel[j] * per_sample_scaling_factors[j],
-                                  kMinFloatS16Value, kMaxFloatS16Value);
-    }
+    vector_math.MultiplyAndClamp(per_sample_scaling_factors, kMinFloatS16Value,
+                                 kMaxFloatS16Value, signal.channel(i));
   }
 }
 
@@ -97,14 +96,30 @@ Limiter::Limiter(size_t sample_rate_hz,
                  std::string histogram_name)
     : interp_gain_curve_(apm_data_dumper, histogram_name),
       level_estimator_(sample_rate_hz, apm_data_dumper),
-      apm_data_dumper_(apm_data_dumper) {
+      apm_data_dumper_(apm_data_dumper),
+      vector_math_(DetectVectorMathOptimization()),
+      sample_rate_hz_(sample_rate_hz) {
   CheckLimiterSampleRate(sample_rate_hz);
 }
 
 Limiter::~Limiter() = default;
 
 void Limiter::Process(AudioFrameView<float> signal) {
-  const auto level_estimate = level_estimator_.ComputeLevel(signal);
+  const size_t samples_per_channel = signal.samples_per_channel();
+  RTC_DCHECK_LE(samples_per_channel, kMaximalNumberOfSamplesPerChannel);
+
+  std::array<float, kSubFramesInFrame> level_estimate;
+  if (lookahead_ms_ > 0) {
+    // Estimate the level of the delayed signal from its windowed peak.
+    rtc::ArrayView<float> envelope(lookahead_envelope_.data(),
+                                   samples_per_channel);
+    lookahead_.Process(signal, envelope);
+    const float* envelope_channel = envelope.data();
+    level_estimate = level_estimator_.ComputeLevel(
+        AudioFrameView<const float>(&envelope_channel, 1, samples_per_channel));
+  } else {
+    level_estimate = level_estimator_.ComputeLevel(signal);
+  }
 
   RTC_DCHECK_EQ(level_estimate.size() + 1, scaling_factors_.size());
   scaling_factors_[0] = last_scaling_factor_;
@@ -113,14 +128,11 @@ void Limiter::Process(AudioFrameView<float> signal) {
                    return interp_gain_curve_.LookUpGainToApply(x);
                  });
 
-  const size_t samples_per_channel = signal.samples_per_channel();
-  RTC_DCHECK_LE(samples_per_channel, kMaximalNumberOfSamplesPerChannel);
-
   auto per_sample_scaling_factors = rtc::ArrayView<float>(
       &per_sample_scaling_factors_[0], samples_per_channel);
   ComputePerSampleSubframeFactors(scaling_factors_, samples_per_channel,
-                                  per_sample_scaling_factors);
-  ScaleSamples(per_sample_scaling_factors, signal);
+                                  vector_math_, per_sample_scaling_factors);
+  ScaleSamples(per_sample_scaling_factors, vector_math_, signal);
 
   last_scaling_factor_ = scaling_factors_.back();
 
@@ -137,10 +149,26 @@ InterpolatedGainCurve::Stats Limiter::GetGainCurveStats() const {
 void Limiter::SetSampleRate(size_t sample_rate_hz) {
   CheckLimiterSampleRate(sample_rate_hz);
   level_estimator_.SetSampleRate(sample_rate_hz);
+  sample_rate_hz_ = sample_rate_hz;
+  UpdateLookahead();
+}
+
+void Limiter::SetLookaheadMs(int lookahead_ms) {
+  RTC_DCHECK_LE(0, lookahead_ms);
+  RTC_DCHECK_LE(lookahead_ms, LimiterLookahead::kMaxLookaheadMs);
+  if (lookahead_ms != lookahead_ms_) {
+    lookahead_ms_ = lookahead_ms;
+    UpdateLookahead();
+  }
 }
 
 void Limiter::Reset() {
   level_estimator_.Reset();
+  lookahead_.Reset();
+}
+
+void Limiter::UpdateLookahead() {
+  lookahead_.SetLookahead(sample_rate_hz_ * lookahead_ms_ / 1000);
 }
 
 float Limiter::LastAudioLevel() const {
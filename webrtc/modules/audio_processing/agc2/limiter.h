@@ -14,8 +14,10 @@
 #include <string>
 #include <vector>
 
+#include "modules/audio_processing/agc2/agc2_vector_math.h"
 #include "modules/audio_processing/agc2/fixed_digital_level_estimator.h"
 #include "modules/audio_processing/agc2/interpolated_gain_curve.h"
+#include "modules/audio_processing/agc2/limiter_lookahead.h"
 #include "modules/audio_processing/include/audio_frame_view.h"
 #include "rtc_base/constructor_magic.h"
 
@@ -42,20 +44,37 @@ class Limiter {
   //   per_sample_scaling_factors_ array.
   void SetSampleRate(size_t sample_rate_hz);
 
+  // Sets the lookahead of the limiter in ms, in the range [0, 5]. With a
+  // non-zero lookahead, the signal is delayed by that amount and the gain is
+  // computed from the peak level of the delayed sub-frame and of the
+  // lookahead samples that follow it. This removes the overshoot on abrupt
+  // level increases, at the cost of the added delay.
+  void SetLookaheadMs(int lookahead_ms);
+  int lookahead_ms() const { return lookahead_ms_; }
+
   // Resets the internal state.
   void Reset();
 
   float LastAudioLevel() const;
 
  private:
+  void UpdateLookahead();
+
   const InterpolatedGainCurve interp_gain_curve_;
   FixedDigitalLevelEstimator level_estimator_;
   ApmDataDumper* const apm_data_dumper_ = nullptr;
+  const Agc2VectorMath vector_math_;
+  size_t sample_rate_hz_;
+  int lookahead_ms_ = 0;
+  LimiterLookahead lookahead_;
 
   // Work array containing the sub-frame scaling factors to be interpolated.
   std::array<float, kSubFramesInFrame + 1> scaling_factors_ = {};
   std::array<float, kMaximalNumberOfSamplesPerChannel>
       per_sample_scaling_factors_ = {};
+  // Work array containing the peak level used for the lookahead.
+  std::array<float, kMaximalNumberOfSamplesPerChannel> lookahead_envelope_ =
+      {};
   float last_scaling_factor_ = 1.f;
 };
 
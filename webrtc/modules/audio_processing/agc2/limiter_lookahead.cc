@@ -0,0 +1,125 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/agc2/limiter_lookahead.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+constexpr int LimiterLookahead::kMaxLookaheadMs;
+constexpr size_t LimiterLookahead::kMaxLookaheadSamples;
+
+LimiterLookahead::LimiterLookahead()
+    // The window covers the delayed sample and the lookahead samples.
+    : delay_scratch_(kMaxLookaheadSamples),
+      queue_peaks_(kMaxLookaheadSamples + 1),
+      queue_indices_(kMaxLookaheadSamples + 1) {}
+
+LimiterLookahead::~LimiterLookahead() = default;
+
+void LimiterLookahead::SetLookahead(size_t lookahead_samples) {
+  RTC_DCHECK_LE(lookahead_samples, kMaxLookaheadSamples);
+  lookahead_samples_ = std::min(lookahead_samples, kMaxLookaheadSamples);
+  Initialize(delay_lines_.size());
+}
+
+void LimiterLookahead::Reset() {
+  Initialize(delay_lines_.size());
+}
+
+void LimiterLookahead::Initialize(size_t num_channels) {
+  // Only a change in the number of channels allocates memory.
+  if (delay_lines_.size() != num_channels) {
+    delay_lines_.resize(num_channels,
+                        std::vector<float>(kMaxLookaheadSamples));
+  }
+  for (auto& delay_line : delay_lines_) {
+    std::fill(delay_line.begin(), delay_line.end(), 0.f);
+  }
+  queue_front_ = 0;
+  queue_size_ = 0;
+  sample_index_ = 0;
+  // Account for the initial content of the delay lines.
+  for (size_t k = 0; k < lookahead_samples_; ++k) {
+    PushPeak(0.f);
+  }
+}
+
+void LimiterLookahead::PushPeak(float peak) {
+  const size_t capacity = queue_peaks_.size();
+  // Drop the samples that can no longer be the maximum of any window.
+  while (queue_size_ > 0) {
+    const size_t back = (queue_front_ + queue_size_ - 1) % capacity;
+    if (queue_peaks_[back] > peak) {
+      break;
+    }
+    --queue_size_;
+  }
+  // Drop the sample that has left the window.
+  if (queue_size_ > 0 &&
+      queue_indices_[queue_front_] <
+          sample_index_ - static_cast<int64_t>(lookahead_samples_)) {
+    queue_front_ = (queue_front_ + 1) % capacity;
+    --queue_size_;
+  }
+  RTC_DCHECK_LT(queue_size_, capacity);
+  const size_t back = (queue_front_ + queue_size_) % capacity;
+  queue_peaks_[back] = peak;
+  queue_indices_[back] = sample_index_;
+  ++queue_size_;
+  ++sample_index_;
+}
+
+void LimiterLookahead::Process(AudioFrameView<float> signal,
+                               rtc::ArrayView<float> envelope) {
+  const size_t num_samples = signal.samples_per_channel();
+  RTC_DCHECK_EQ(num_samples, envelope.size());
+  RTC_DCHECK_LE(lookahead_samples_, num_samples);
+  if (signal.num_channels() != delay_lines_.size()) {
+    Initialize(signal.num_channels());
+  }
+
+  // Compute the peak across channels of the incoming samples and update the
+  // window maximum, which then corresponds to the delayed sample.
+  std::fill(envelope.begin(), envelope.end(), 0.f);
+  for (size_t ch = 0; ch < signal.num_channels(); ++ch) {
+    rtc::ArrayView<const float> channel = signal.channel(ch);
+    for (size_t k = 0; k < num_samples; ++k) {
+      envelope[k] = std::max(envelope[k], std::fabs(channel[k]));
+    }
+  }
+  for (size_t k = 0; k < num_samples; ++k) {
+    PushPeak(envelope[k]);
+    envelope[k] = queue_peaks_[queue_front_];
+  }
+
+  if (lookahead_samples_ == 0) {
+    return;
+  }
+
+  // Delay the signal.
+  for (size_t ch = 0; ch < signal.num_channels(); ++ch) {
+    rtc::ArrayView<float> channel = signal.channel(ch);
+    std::vector<float>& delay_line = delay_lines_[ch];
+    std::copy(channel.end() - lookahead_samples_, channel.end(),
+              delay_scratch_.begin());
+    std::copy_backward(channel.begin(), channel.end() - lookahead_samples_,
+                       channel.end());
+    std::copy(delay_line.begin(), delay_line.begin() + lookahead_samples_,
+              channel.begin());
+    delay_line.swap(delay_scratch_);
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AGC2_LIMITER_LOOKAHEAD_H_
+#define MODULES_AUDIO_PROCESSING_AGC2_LIMITER_LOOKAHEAD_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "api/array_view.h"
+#include "modules/audio_processing/agc2/agc2_common.h"
+#include "modules/audio_processing/include/audio_frame_view.h"
+
+namespace webrtc {
+
+// Delays a multi-channel signal by a fixed lookahead and computes, for each
+// delayed sample, the peak absolute value across all channels over the window
+// made of that sample and the lookahead samples following it. The window
+// maximum is tracked with a monotonic queue stored in a ring buffer, which
+// gives amortized O(1) updates per sample. The buffers are allocated for the
+// maximum lookahead, so changing the lookahead or the sample rate does not
+// allocate memory.
+class LimiterLookahead {
+ public:
+  // Maximum lookahead, in ms and in samples at the highest sample rate.
+  static constexpr int kMaxLookaheadMs = 5;
+  static constexpr size_t kMaxLookaheadSamples =
+      kMaxLookaheadMs * kMaximalNumberOfSamplesPerChannel / kFrameDurationMs;
+
+  LimiterLookahead();
+  LimiterLookahead(const LimiterLookahead&) = delete;
+  LimiterLookahead& operator=(const LimiterLookahead&) = delete;
+  ~LimiterLookahead();
+
+  // Sets the lookahead, at most |kMaxLookaheadSamples|, and resets the
+  // internal state. A zero lookahead disables the delay.
+  void SetLookahead(size_t lookahead_samples);
+  size_t lookahead_samples() const { return lookahead_samples_; }
+
+  // Delays |signal| in-place by the lookahead and stores the windowed peak
+  // for each delayed sample in |envelope|. The lookahead must not exceed the
+  // number of samples per channel.
+  void Process(AudioFrameView<float> signal, rtc::ArrayView<float> envelope);
+
+  // Resets the delay lines and the window.
+  void Reset();
+
+ private:
+  void Initialize(size_t num_channels);
+  void PushPeak(float peak);
+
+  size_t lookahead_samples_ = 0;
+  // Delay lines of |kMaxLookaheadSamples| samples, of which the first
+  // |lookahead_samples_| are used.
+  std::vector<std::vector<float>> delay_lines_;
+  std::vector<float> delay_scratch_;
+
+  // Monotonic queue of the window peaks, with non-increasing values from the
+  // front to the back, and the absolute index of each stored sample.
+  std::vector<float> queue_peaks_;
+  std::vector<int64_t> queue_indices_;
+  size_t queue_front_ = 0;
+  size_t queue_size_ = 0;
+  int64_t sample_index_ = 0;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AGC2_LIMITER_LOOKAHEAD_H_
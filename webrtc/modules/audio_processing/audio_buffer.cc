@@ -12,10 +12,12 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <cstdint>
 
 #include "common_audio/channel_buffer.h"
 #include "common_audio/include/audio_util.h"
+#include "common_audio/resampler/low_latency_resampler.h"
 #include "common_audio/resampler/push_sinc_resampler.h"
 #include "modules/audio_processing/splitting_filter.h"
 #include "rtc_base/checks.h"
@@ -26,6 +28,7 @@ namespace {
 constexpr size_t kSamplesPer32kHzChannel = 320;
 constexpr size_t kSamplesPer48kHzChannel = 480;
 constexpr size_t kMaxSamplesPerChannel = AudioBuffer::kMaxSampleRate / 100;
+constexpr size_t kMinChannelCapacity = 2;
 
 size_t NumBandsFromFramesPerChannel(size_t num_frames) {
   if (num_frames == kSamplesPer32kHzChannel) {
@@ -39,68 +42,211 @@ size_t NumBandsFromFramesPerChannel(size_t num_frames) {
 
 }  // namespace
 
+class AudioBuffer::ChannelResampler {
+ public:
+  virtual ~ChannelResampler() = default;
+  virtual size_t Resample(const float* source,
+                          size_t source_length,
+                          float* destination,
+                          size_t destination_capacity) = 0;
+  virtual void Reset() = 0;
+};
+
+namespace {
+
+class SincChannelResampler : public AudioBuffer::ChannelResampler {
+ public:
+  SincChannelResampler(size_t source_frames, size_t destination_frames)
+      : resampler_(source_frames, destination_frames) {}
+
+  size_t Resample(const float* source,
+                  size_t source_length,
+                  float* destination,
+                  size_t destination_capacity) override {
+    return resampler_.Resample(source, source_length, destination,
+                               destination_capacity);
+  }
+  void Reset() override { resampler_.Reset(); }
+
+ private:
+  PushSincResampler resampler_;
+};
+
+class LowLatencyChannelResampler : public AudioBuffer::ChannelResampler {
+ public:
+  LowLatencyChannelResampler(size_t source_frames,
+                             size_t destination_frames,
+                             size_t kernel_size)
+      : resampler_(source_frames, destination_frames, kernel_size) {}
+
+  size_t Resample(const float* source,
+                  size_t source_length,
+                  float* destination,
+                  size_t destination_capacity) override {
+    return resampler_.Resample(source, source_length, destination,
+                               destination_capacity);
+  }
+  void Reset() override { resampler_.Reset(); }
+
+ private:
+  LowLatencyResampler resampler_;
+};
+
+}  // namespace
+
 AudioBuffer::AudioBuffer(size_t input_rate,
                          size_t input_num_channels,
                          size_t buffer_rate,
                          size_t buffer_num_channels,
                          size_t output_rate,
-                         size_t output_num_channels)
-    : AudioBuffer(static_cast<int>(input_rate) / 100,
-                  input_num_channels,
-                  static_cast<int>(buffer_rate) / 100,
-                  buffer_num_channels,
-                  static_cast<int>(output_rate) / 100) {}
+                         size_t output_num_channels,
+                         size_t low_latency_kernel_size)
+    : low_latency_kernel_size_(low_latency_kernel_size) {
+  const size_t buffer_num_frames = static_cast<int>(buffer_rate) / 100;
+  AllocateStorage(std::max(buffer_num_frames, kSamplesPer48kHzChannel),
+                  std::max(buffer_num_channels, kMinChannelCapacity));
+  // As for the deprecated constructor, the number of output channels is not
+  // stored.
+  Configure(static_cast<int>(input_rate) / 100, input_num_channels,
+            buffer_num_frames, buffer_num_channels,
+            static_cast<int>(output_rate) / 100, 0);
+}
 
 AudioBuffer::AudioBuffer(size_t input_num_frames,
                          size_t input_num_channels,
                          size_t buffer_num_frames,
                          size_t buffer_num_channels,
-                         size_t output_num_frames)
-    : input_num_frames_(input_num_frames),
-      input_num_channels_(input_num_channels),
-      buffer_num_frames_(buffer_num_frames),
-      buffer_num_channels_(buffer_num_channels),
-      output_num_frames_(output_num_frames),
-      output_num_channels_(0),
-      num_channels_(buffer_num_channels),
-      num_bands_(NumBandsFromFramesPerChannel(buffer_num_frames_)),
-      num_split_frames_(rtc::CheckedDivExact(buffer_num_frames_, num_bands_)),
-      data_(
-          new ChannelBuffer<float>(buffer_num_frames_, buffer_num_channels_)) {
+                         size_t output_num_frames) {
+  AllocateStorage(std::max(buffer_num_frames, kSamplesPer48kHzChannel),
+                  std::max(buffer_num_channels, kMinChannelCapacity));
+  Configure(input_num_frames, input_num_channels, buffer_num_frames,
+            buffer_num_channels, output_num_frames, 0);
+}
+
+AudioBuffer::~AudioBuffer() {}
+
+void AudioBuffer::Reconfigure(size_t input_rate,
+                              size_t input_num_channels,
+                              size_t buffer_rate,
+                              size_t buffer_num_channels,
+                              size_t output_rate,
+                              size_t output_num_channels,
+                              size_t low_latency_kernel_size) {
+  const size_t buffer_num_frames = static_cast<int>(buffer_rate) / 100;
+  if (buffer_num_frames > frame_capacity_ ||
+      buffer_num_channels > channel_capacity_) {
+    AllocateStorage(std::max(buffer_num_frames, frame_capacity_),
+                    std::max(buffer_num_channels, channel_capacity_));
+  }
+  low_latency_kernel_size_ = low_latency_kernel_size;
+  // As for the constructor, the number of output channels is not stored.
+  Configure(static_cast<int>(input_rate) / 100, input_num_channels,
+            buffer_num_frames, buffer_num_channels,
+            static_cast<int>(output_rate) / 100, 0);
+}
+
+void AudioBuffer::AllocateStorage(size_t num_frames, size_t num_channels) {
+  frame_capacity_ = num_frames;
+  channel_capacity_ = num_channels;
+  data_.reset(new ChannelBuffer<float>(frame_capacity_, channel_capacity_));
+  split_data_.reset(new ChannelBuffer<float>(
+      kSamplesPer48kHzChannel, channel_capacity_, kMaxNumBands));
+  splitting_filter_.reset(
+      new SplittingFilter(channel_capacity_, kMaxNumBands,
+                          kSamplesPer48kHzChannel));
+  input_resamplers_.reserve(channel_capacity_);
+  output_resamplers_.reserve(channel_capacity_);
+}
+
+void AudioBuffer::Configure(size_t input_num_frames,
+                            size_t input_num_channels,
+                            size_t buffer_num_frames,
+                            size_t buffer_num_channels,
+                            size_t output_num_frames,
+                            size_t output_num_channels) {
+  input_num_frames_ = input_num_frames;
+  input_num_channels_ = input_num_channels;
+  buffer_num_frames_ = buffer_num_frames;
+  buffer_num_channels_ = buffer_num_channels;
+  output_num_frames_ = output_num_frames;
+  output_num_channels_ = output_num_channels;
+  num_channels_ = buffer_num_channels_;
+  num_bands_ = NumBandsFromFramesPerChannel(buffer_num_frames_);
+  num_split_frames_ = rtc::CheckedDivExact(buffer_num_frames_, num_bands_);
+  downmix_by_averaging_ = true;
+  channel_for_downmixing_ = 0;
+
   RTC_DCHECK_GT(input_num_frames_, 0);
   RTC_DCHECK_GT(buffer_num_frames_, 0);
   RTC_DCHECK_GT(output_num_frames_, 0);
   RTC_DCHECK_GT(input_num_channels_, 0);
   RTC_DCHECK_GT(buffer_num_channels_, 0);
   RTC_DCHECK_LE(buffer_num_channels_, input_num_channels_);
+  RTC_DCHECK_LE(buffer_num_frames_, frame_capacity_);
+  RTC_DCHECK_LE(buffer_num_channels_, channel_capacity_);
+
+  data_->Reconfigure(buffer_num_frames_, buffer_num_channels_, 1);
+  ConfigureResamplers();
+
+  if (num_bands_ > 1) {
+    split_data_->Reconfigure(buffer_num_frames_, buffer_num_channels_,
+                             num_bands_);
+    splitting_filter_->Initialize(buffer_num_channels_, num_bands_);
+  }
+}
 
+void AudioBuffer::ConfigureResamplers() {
   const bool input_resampling_needed = input_num_frames_ != buffer_num_frames_;
   const bool output_resampling_needed =
       output_num_frames_ != buffer_num_frames_;
+  input_resamplers_.clear();
   if (input_resampling_needed) {
-    for (size_t i = 0; i < buffer_num_channels_; ++i) {
-      input_resamplers_.push_back(std::unique_ptr<PushSincResampler>(
-          new PushSincResampler(input_num_frames_, buffer_num_frames_)));
-    }
+    SelectResamplers(input_num_frames_, buffer_num_frames_,
+                     buffer_num_channels_, &input_resamplers_);
   }
 
+  output_resamplers_.clear();
   if (output_resampling_needed) {
-    for (size_t i = 0; i < buffer_num_channels_; ++i) {
-      output_resamplers_.push_back(std::unique_ptr<PushSincResampler>(
-          new PushSincResampler(buffer_num_frames_, output_num_frames_)));
-    }
+    SelectResamplers(buffer_num_frames_, output_num_frames_,
+                     buffer_num_channels_, &output_resamplers_);
   }
+}
 
-  if (num_bands_ > 1) {
-    split_data_.reset(new ChannelBuffer<float>(
-        buffer_num_frames_, buffer_num_channels_, num_bands_));
-    splitting_filter_.reset(new SplittingFilter(
-        buffer_num_channels_, num_bands_, buffer_num_frames_));
+void AudioBuffer::SelectResamplers(
+    size_t source_frames,
+    size_t destination_frames,
+    size_t num_channels,
+    std::vector<ChannelResampler*>* resamplers) {
+  auto set = std::find_if(
+      resampler_sets_.begin(), resampler_sets_.end(),
+      [&](const ResamplerSet& s) {
+        return s.source_frames == source_frames &&
+               s.destination_frames == destination_frames &&
+               s.low_latency_kernel_size == low_latency_kernel_size_;
+      });
+  if (set == resampler_sets_.end()) {
+    resampler_sets_.push_back(
+        {source_frames, destination_frames, low_latency_kernel_size_, {}});
+    set = resampler_sets_.end() - 1;
+  }
+  // Create resamplers for every channel the storage can hold, so that a later
+  // increase of the channel count within the capacity does not allocate.
+  while (set->resamplers.size() < std::max(num_channels, channel_capacity_)) {
+    if (low_latency_kernel_size_ > 0) {
+      set->resamplers.push_back(std::unique_ptr<ChannelResampler>(
+          new LowLatencyChannelResampler(source_frames, destination_frames,
+                                         low_latency_kernel_size_)));
+    } else {
+      set->resamplers.push_back(std::unique_ptr<ChannelResampler>(
+          new SincChannelResampler(source_frames, destination_frames)));
+    }
+  }
+  for (size_t i = 0; i < num_channels; ++i) {
+    set->resamplers[i]->Reset();
+    resamplers->push_back(set->resamplers[i].get());
   }
 }
 
-AudioBuffer::~AudioBuffer() {}
-
 void AudioBuffer::set_downmixing_to_specific_channel(size_t channel) {
   downmix_by_averaging_ = false;
   RTC_DCHECK_GT(input_num_channels_, channel);
@@ -113,6 +259,18 @@ void AudioBuffer::set_downmixing_by_averaging() {
 
 void AudioBuffer::CopyFrom(const float* const* stacked_data,
                            const StreamConfig& stream_config) {
+  CopyFrom(stacked_data, stream_config, /*split_into_bands=*/false);
+}
+
+void AudioBuffer::CopyFromAndSplit(const float* const* stacked_data,
+                                   const StreamConfig& stream_config) {
+  RTC_DCHECK_GT(num_bands_, 1);
+  CopyFrom(stacked_data, stream_config, /*split_into_bands=*/true);
+}
+
+void AudioBuffer::CopyFrom(const float* const* stacked_data,
+                           const StreamConfig& stream_config,
+                           bool split_into_bands) {
   RTC_DCHECK_EQ(stream_config.num_frames(), input_num_frames_);
   RTC_DCHECK_EQ(stream_config.num_channels(), input_num_channels_);
   RestoreNumChannels();
@@ -145,6 +303,7 @@ void AudioBuffer::CopyFrom(const float* const* stacked_data,
     const float* data_to_convert =
         resampling_needed ? data_->channels()[0] : downmixed_data;
     FloatToFloatS16(data_to_convert, buffer_num_frames_, data_->channels()[0]);
+    MaybeSplitChannel(0, split_into_bands);
   } else {
     if (resampling_needed) {
       for (size_t i = 0; i < num_channels_; ++i) {
@@ -153,11 +312,13 @@ void AudioBuffer::CopyFrom(const float* const* stacked_data,
                                        buffer_num_frames_);
         FloatToFloatS16(data_->channels()[i], buffer_num_frames_,
                         data_->channels()[i]);
+        MaybeSplitChannel(i, split_into_bands);
       }
     } else {
       for (size_t i = 0; i < num_channels_; ++i) {
         FloatToFloatS16(stacked_data[i], buffer_num_frames_,
                         data_->channels()[i]);
+        MaybeSplitChannel(i, split_into_bands);
       }
     }
   }
@@ -165,11 +326,24 @@ void AudioBuffer::CopyFrom(const float* const* stacked_data,
 
 void AudioBuffer::CopyTo(const StreamConfig& stream_config,
                          float* const* stacked_data) {
+  CopyTo(stream_config, stacked_data, /*merge_bands=*/false);
+}
+
+void AudioBuffer::MergeAndCopyTo(const StreamConfig& stream_config,
+                                 float* const* stacked_data) {
+  RTC_DCHECK_GT(num_bands_, 1);
+  CopyTo(stream_config, stacked_data, /*merge_bands=*/true);
+}
+
+void AudioBuffer::CopyTo(const StreamConfig& stream_config,
+                         float* const* stacked_data,
+                         bool merge_bands) {
   RTC_DCHECK_EQ(stream_config.num_frames(), output_num_frames_);
 
   const bool resampling_needed = output_num_frames_ != buffer_num_frames_;
   if (resampling_needed) {
     for (size_t i = 0; i < num_channels_; ++i) {
+      MaybeMergeChannel(i, merge_bands);
       FloatS16ToFloat(data_->channels()[i], buffer_num_frames_,
                       data_->channels()[i]);
       output_resamplers_[i]->Resample(data_->channels()[i], buffer_num_frames_,
@@ -177,6 +351,7 @@ void AudioBuffer::CopyTo(const StreamConfig& stream_config,
     }
   } else {
     for (size_t i = 0; i < num_channels_; ++i) {
+      MaybeMergeChannel(i, merge_bands);
       FloatS16ToFloat(data_->channels()[i], buffer_num_frames_,
                       stacked_data[i]);
     }
@@ -214,7 +389,7 @@ void AudioBuffer::CopyTo(AudioBuffer* buffer) const {
 void AudioBuffer::RestoreNumChannels() {
   num_channels_ = buffer_num_channels_;
   data_->set_num_channels(buffer_num_channels_);
-  if (split_data_.get()) {
+  if (num_bands_ > 1) {
     split_data_->set_num_channels(buffer_num_channels_);
   }
 }
@@ -223,7 +398,7 @@ void AudioBuffer::set_num_channels(size_t num_channels) {
   RTC_DCHECK_GE(buffer_num_channels_, num_channels);
   num_channels_ = num_channels;
   data_->set_num_channels(num_channels);
-  if (split_data_.get()) {
+  if (num_bands_ > 1) {
     split_data_->set_num_channels(num_channels);
   }
 }
@@ -231,6 +406,18 @@ void AudioBuffer::set_num_channels(size_t num_channels) {
 // The resampler is only for supporting 48kHz to 16kHz in the reverse stream.
 void AudioBuffer::CopyFrom(const int16_t* const interleaved_data,
                            const StreamConfig& stream_config) {
+  CopyFrom(interleaved_data, stream_config, /*split_into_bands=*/false);
+}
+
+void AudioBuffer::CopyFromAndSplit(const int16_t* const interleaved_data,
+                                   const StreamConfig& stream_config) {
+  RTC_DCHECK_GT(num_bands_, 1);
+  CopyFrom(interleaved_data, stream_config, /*split_into_bands=*/true);
+}
+
+void AudioBuffer::CopyFrom(const int16_t* const interleaved_data,
+                           const StreamConfig& stream_config,
+                           bool split_into_bands) {
   RTC_DCHECK_EQ(stream_config.num_channels(), input_num_channels_);
   RTC_DCHECK_EQ(stream_config.num_frames(), input_num_frames_);
   RestoreNumChannels();
@@ -274,6 +461,7 @@ void AudioBuffer::CopyFrom(const int16_t* const interleaved_data,
                                        buffer_num_frames_);
       }
     }
+    MaybeSplitChannel(0, split_into_bands);
   } else {
     auto deinterleave_channel = [](size_t channel, size_t num_channels,
                                    size_t samples_per_channel, const int16_t* x,
@@ -292,11 +480,13 @@ void AudioBuffer::CopyFrom(const int16_t* const interleaved_data,
         input_resamplers_[i]->Resample(float_buffer.data(), input_num_frames_,
                                        data_->channels()[i],
                                        buffer_num_frames_);
+        MaybeSplitChannel(i, split_into_bands);
       }
     } else {
       for (size_t i = 0; i < num_channels_; ++i) {
         deinterleave_channel(i, num_channels_, input_num_frames_, interleaved,
                              data_->channels()[i]);
+        MaybeSplitChannel(i, split_into_bands);
       }
     }
   }
@@ -304,6 +494,18 @@ void AudioBuffer::CopyFrom(const int16_t* const interleaved_data,
 
 void AudioBuffer::CopyTo(const StreamConfig& stream_config,
                          int16_t* const interleaved_data) {
+  CopyTo(stream_config, interleaved_data, /*merge_bands=*/false);
+}
+
+void AudioBuffer::MergeAndCopyTo(const StreamConfig& stream_config,
+                                 int16_t* const interleaved_data) {
+  RTC_DCHECK_GT(num_bands_, 1);
+  CopyTo(stream_config, interleaved_data, /*merge_bands=*/true);
+}
+
+void AudioBuffer::CopyTo(const StreamConfig& stream_config,
+                         int16_t* const interleaved_data,
+                         bool merge_bands) {
   const size_t config_num_channels = stream_config.num_channels();
 
   RTC_DCHECK(config_num_channels == num_channels_ || num_channels_ == 1);
@@ -315,6 +517,7 @@ void AudioBuffer::CopyTo(const StreamConfig& stream_config,
   if (num_channels_ == 1) {
     std::array<float, kMaxSamplesPerChannel> float_buffer;
 
+    MaybeMergeChannel(0, merge_bands);
     if (resampling_required) {
       output_resamplers_[0]->Resample(data_->channels()[0], buffer_num_frames_,
                                       float_buffer.data(), output_num_frames_);
@@ -347,6 +550,7 @@ void AudioBuffer::CopyTo(const StreamConfig& stream_config,
     if (resampling_required) {
       for (size_t i = 0; i < num_channels_; ++i) {
         std::array<float, kMaxSamplesPerChannel> float_buffer;
+        MaybeMergeChannel(i, merge_bands);
         output_resamplers_[i]->Resample(data_->channels()[i],
                                         buffer_num_frames_, float_buffer.data(),
                                         output_num_frames_);
@@ -355,6 +559,7 @@ void AudioBuffer::CopyTo(const StreamConfig& stream_config,
       }
     } else {
       for (size_t i = 0; i < num_channels_; ++i) {
+        MaybeMergeChannel(i, merge_bands);
         interleave_channel(i, config_num_channels, output_num_frames_,
                            data_->channels()[i], interleaved);
       }
@@ -377,6 +582,19 @@ void AudioBuffer::MergeFrequencyBands() {
   splitting_filter_->Synthesis(split_data_.get(), data_.get());
 }
 
+void AudioBuffer::MaybeSplitChannel(size_t channel, bool split_into_bands) {
+  if (split_into_bands) {
+    splitting_filter_->AnalyzeChannel(channel, data_.get(), split_data_.get());
+  }
+}
+
+void AudioBuffer::MaybeMergeChannel(size_t channel, bool merge_bands) {
+  if (merge_bands) {
+    splitting_filter_->SynthesizeChannel(channel, split_data_.get(),
+                                         data_.get());
+  }
+}
+
 void AudioBuffer::ExportSplitChannelData(
     size_t channel,
     int16_t* const* split_band_data) const {
@@ -22,23 +22,27 @@
 
 namespace webrtc {
 
-class PushSincResampler;
 class SplittingFilter;
 
 enum Band { kBand0To8kHz = 0, kBand8To16kHz = 1, kBand16To24kHz = 2 };
 
 // Stores any audio data in a way that allows the audio processing module to
-// operate on it in a controlled manner.
+// operate on it in a controlled manner. The storage is allocated for the
+// highest band-split rate and at least stereo at creation so that the buffer
+// can be reconfigured for another stream format without allocating memory.
 class AudioBuffer {
  public:
   static const int kSplitBandSize = 160;
   static const size_t kMaxSampleRate = 384000;
+  // Resamples with a LowLatencyResampler with |low_latency_kernel_size| taps
+  // instead of a PushSincResampler, unless |low_latency_kernel_size| is zero.
   AudioBuffer(size_t input_rate,
               size_t input_num_channels,
               size_t buffer_rate,
               size_t buffer_num_channels,
               size_t output_rate,
-              size_t output_num_channels);
+              size_t output_num_channels,
+              size_t low_latency_kernel_size = 0);
 
   // The constructor below will be deprecated.
   AudioBuffer(size_t input_num_frames,
@@ -51,6 +55,23 @@ class AudioBuffer {
   AudioBuffer(const AudioBuffer&) = delete;
   AudioBuffer& operator=(const AudioBuffer&) = delete;
 
+  // Common interface of the resamplers used for the conversions between the
+  // input, buffer and output rates. Defined in audio_buffer.cc.
+  class ChannelResampler;
+
+  // Reconfigures the buffer for new stream formats, leaving it in the same
+  // state as a newly created buffer. Memory is only allocated if the formats
+  // exceed the capacity of the buffer, or when a resampling ratio is needed
+  // that the buffer has not used before. Since the stream rates are arbitrary,
+  // the resamplers cannot be preallocated for every ratio.
+  void Reconfigure(size_t input_rate,
+                   size_t input_num_channels,
+                   size_t buffer_rate,
+                   size_t buffer_num_channels,
+                   size_t output_rate,
+                   size_t output_num_channels,
+                   size_t low_latency_kernel_size);
+
   // Specify that downmixing should be done by selecting a single channel.
   void set_downmixing_to_specific_channel(size_t channel);
 
@@ -84,12 +105,12 @@ class AudioBuffer {
   // 0 <= band < |num_bands_|
   // 0 <= sample < |num_split_frames_|
   const float* const* split_bands_const(size_t channel) const {
-    return split_data_.get() ? split_data_->bands(channel)
-                             : data_->bands(channel);
+    return num_bands_ > 1 ? split_data_->bands(channel)
+                          : data_->bands(channel);
   }
   float* const* split_bands(size_t channel) {
-    return split_data_.get() ? split_data_->bands(channel)
-                             : data_->bands(channel);
+    return num_bands_ > 1 ? split_data_->bands(channel)
+                          : data_->bands(channel);
   }
 
   // Returns a pointer array to the channels for a specific band.
@@ -100,7 +121,7 @@ class AudioBuffer {
   // 0 <= channel < |buffer_num_channels_|
   // 0 <= sample < |num_split_frames_|
   const float* const* split_channels_const(Band band) const {
-    if (split_data_.get()) {
+    if (num_bands_ > 1) {
       return split_data_->channels(band);
     } else {
       return band == kBand0To8kHz ? data_->channels() : nullptr;
@@ -125,6 +146,20 @@ class AudioBuffer {
   // Recombines the frequency bands into a full-band signal.
   void MergeFrequencyBands();
 
+  // Equivalent to CopyFrom() followed by SplitIntoFrequencyBands(), but splits
+  // each channel directly after it has been copied, while it is still cached.
+  void CopyFromAndSplit(const int16_t* const interleaved_data,
+                        const StreamConfig& stream_config);
+  void CopyFromAndSplit(const float* const* stacked_data,
+                        const StreamConfig& stream_config);
+
+  // Equivalent to MergeFrequencyBands() followed by CopyTo(), but copies each
+  // channel directly after its bands have been merged.
+  void MergeAndCopyTo(const StreamConfig& stream_config,
+                      int16_t* const interleaved_data);
+  void MergeAndCopyTo(const StreamConfig& stream_config,
+                      float* const* stacked_data);
+
   // Copies the split bands data into the integer two-dimensional array.
   void ExportSplitChannelData(size_t channel,
                               int16_t* const* split_band_data) const;
@@ -151,14 +186,57 @@ class AudioBuffer {
  private:
   FRIEND_TEST_ALL_PREFIXES(AudioBufferTest,
                            SetNumChannelsSetsChannelBuffersNumChannels);
+  // Resamplers for one conversion ratio and kernel, kept for reuse when the
+  // buffer is reconfigured. A |low_latency_kernel_size| of zero denotes
+  // PushSincResampler.
+  struct ResamplerSet {
+    size_t source_frames;
+    size_t destination_frames;
+    size_t low_latency_kernel_size;
+    std::vector<std::unique_ptr<ChannelResampler>> resamplers;
+  };
+
+  void Configure(size_t input_num_frames,
+                 size_t input_num_channels,
+                 size_t buffer_num_frames,
+                 size_t buffer_num_channels,
+                 size_t output_num_frames,
+                 size_t output_num_channels);
+  void AllocateStorage(size_t num_frames, size_t num_channels);
+  void ConfigureResamplers();
+  // Points |resamplers| to |num_channels| freshly reset resamplers for the
+  // given conversion. Resamplers for a conversion are created for the full
+  // channel capacity the first time the conversion is used.
+  void SelectResamplers(size_t source_frames,
+                        size_t destination_frames,
+                        size_t num_channels,
+                        std::vector<ChannelResampler*>* resamplers);
+  void CopyFrom(const int16_t* const interleaved_data,
+                const StreamConfig& stream_config,
+                bool split_into_bands);
+  void CopyFrom(const float* const* stacked_data,
+                const StreamConfig& stream_config,
+                bool split_into_bands);
+  void CopyTo(const StreamConfig& stream_config,
+              int16_t* const interleaved_data,
+              bool merge_bands);
+  void CopyTo(const StreamConfig& stream_config,
+              float* const* stacked_data,
+              bool merge_bands);
+  void MaybeSplitChannel(size_t channel, bool split_into_bands);
+  void MaybeMergeChannel(size_t channel, bool merge_bands);
   void RestoreNumChannels();
 
-  const size_t input_num_frames_;
-  const size_t input_num_channels_;
-  const size_t buffer_num_frames_;
-  const size_t buffer_num_channels_;
-  const size_t output_num_frames_;
-  const size_t output_num_channels_;
+  size_t input_num_frames_;
+  size_t input_num_channels_;
+  size_t buffer_num_frames_;
+  size_t buffer_num_channels_;
+  size_t output_num_frames_;
+  size_t output_num_channels_;
+
+  // Dimensions the storage has been allocated for.
+  size_t frame_capacity_ = 0;
+  size_t channel_capacity_ = 0;
 
   size_t num_channels_;
   size_t num_bands_;
@@ -167,8 +245,10 @@ class AudioBuffer {
   std::unique_ptr<ChannelBuffer<float>> data_;
   std::unique_ptr<ChannelBuffer<float>> split_data_;
   std::unique_ptr<SplittingFilter> splitting_filter_;
-  std::vector<std::unique_ptr<PushSincResampler>> input_resamplers_;
-  std::vector<std::unique_ptr<PushSincResampler>> output_resamplers_;
+  std::vector<ResamplerSet> resampler_sets_;
+  std::vector<ChannelResampler*> input_resamplers_;
+  std::vector<ChannelResampler*> output_resamplers_;
+  size_t low_latency_kernel_size_ = 0;
   bool downmix_by_averaging_ = true;
   size_t channel_for_downmixing_ = 0;
 };
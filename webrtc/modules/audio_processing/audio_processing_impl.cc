@@ -10,10 +10,14 @@
 
 #include "modules/audio_processing/audio_processing_impl.h"
 
+#include <string.h>
+
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 
@@ -22,6 +26,7 @@
 #include "api/audio/audio_frame.h"
 #include "common_audio/audio_converter.h"
 #include "common_audio/include/audio_util.h"
+#include "common_audio/resampler/low_latency_resampler.h"
 #include "modules/audio_processing/aec_dump/aec_dump_factory.h"
 #include "modules/audio_processing/agc2/gain_applier.h"
 #include "modules/audio_processing/audio_buffer.h"
@@ -33,6 +38,7 @@
 #include "rtc_base/checks.h"
 #include "rtc_base/constructor_magic.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/numerics/safe_minmax.h"
 #include "rtc_base/ref_counted_object.h"
 #include "rtc_base/time_utils.h"
 #include "rtc_base/trace_event.h"
@@ -116,6 +122,45 @@ GainControl::Mode Agc1ConfigModeToInterfaceMode(
   }
 }
 
+// Returns the kernel size of the low-latency resampler to use in the audio
+// buffers, or zero if the regular resampler should be used. Kernel sizes
+// outside the supported range are clamped, and rounded down to a multiple of
+// four.
+size_t LowLatencyResamplingKernelSize(
+    const AudioProcessing::Config::Pipeline& pipeline) {
+  if (!pipeline.low_latency_resampling.enabled) {
+    return 0;
+  }
+  const int kernel_size =
+      rtc::SafeClamp(pipeline.low_latency_resampling.kernel_size,
+                     static_cast<int>(LowLatencyResampler::kMinKernelSize),
+                     static_cast<int>(LowLatencyResampler::kMaxKernelSize));
+  return static_cast<size_t>(kernel_size - kernel_size % 4);
+}
+
+// Reconfigures |audio| for the given stream formats, and creates it if it does
+// not exist. Reusing the existing buffer avoids allocating memory on the audio
+// thread when the stream formats change.
+void ReconfigureAudioBuffer(size_t input_rate,
+                            size_t input_num_channels,
+                            size_t buffer_rate,
+                            size_t buffer_num_channels,
+                            size_t output_rate,
+                            size_t output_num_channels,
+                            size_t low_latency_kernel_size,
+                            std::unique_ptr<AudioBuffer>* audio) {
+  if (*audio) {
+    (*audio)->Reconfigure(input_rate, input_num_channels, buffer_rate,
+                          buffer_num_channels, output_rate,
+                          output_num_channels, low_latency_kernel_size);
+  } else {
+    audio->reset(new AudioBuffer(input_rate, input_num_channels, buffer_rate,
+                                 buffer_num_channels, output_rate,
+                                 output_num_channels,
+                                 low_latency_kernel_size));
+  }
+}
+
 // Maximum lengths that frame of samples being passed from the render side to
 // the capture side can have (does not apply to AEC3).
 static const size_t kMaxAllowedValuesOfSamplesPerBand = 160;
@@ -125,6 +170,71 @@ static const size_t kMaxAllowedValuesOfSamplesPerFrame = 480;
 // TODO(peah): Decrease this once we properly handle hugely unbalanced
 // reverse and forward call numbers.
 static const size_t kMaxNumFramesToBuffer = 100;
+
+// The fields of AudioProcessingStats, in the order they are packed.
+constexpr auto kStatsFields =
+    std::make_tuple(&AudioProcessingStats::output_rms_dbfs,
+                    &AudioProcessingStats::voice_detected,
+                    &AudioProcessingStats::echo_return_loss,
+                    &AudioProcessingStats::echo_return_loss_enhancement,
+                    &AudioProcessingStats::divergent_filter_fraction,
+                    &AudioProcessingStats::delay_median_ms,
+                    &AudioProcessingStats::delay_standard_deviation_ms,
+                    &AudioProcessingStats::residual_echo_likelihood,
+                    &AudioProcessingStats::residual_echo_likelihood_recent_max,
+                    &AudioProcessingStats::delay_ms,
+                    &AudioProcessingStats::noise_suppression_delay_ms,
+                    &AudioProcessingStats::gain_controller2_delay_ms);
+constexpr int kNumStatsFields = std::tuple_size<decltype(kStatsFields)>::value;
+static_assert(kNumStatsFields < 64, "The field mask must fit in one word");
+
+template <typename Stats, typename Visitor, size_t... Indices>
+void ForEachStatsField(Stats& stats,
+                       Visitor visitor,
+                       std::index_sequence<Indices...>) {
+  // Expands to one visitor call per field, evaluated in order.
+  const int unused[] = {
+      (visitor(stats.*std::get<Indices>(kStatsFields)), 0)...};
+  static_cast<void>(unused);
+}
+
+// Calls |visitor| with each field of |stats|, in the order of kStatsFields.
+template <typename Stats, typename Visitor>
+void ForEachStatsField(Stats& stats, Visitor visitor) {
+  ForEachStatsField(stats, visitor,
+                    std::make_index_sequence<kNumStatsFields>());
+}
+
+// Packs |stats| into the kNumStatsFields + 1 words of |words|. Word 0 has bit
+// i set if the field stored in word i is set.
+void PackStats(const AudioProcessingStats& stats, uint64_t* words) {
+  words[0] = 0;
+  int index = 0;
+  ForEachStatsField(stats, [&](const auto& field) {
+    ++index;
+    words[index] = 0;
+    if (field) {
+      static_assert(sizeof(*field) <= sizeof(words[index]), "");
+      words[0] |= uint64_t{1} << index;
+      memcpy(&words[index], &*field, sizeof(*field));
+    }
+  });
+}
+
+void UnpackStats(const uint64_t* words, AudioProcessingStats* stats) {
+  int index = 0;
+  ForEachStatsField(*stats, [&](auto& field) {
+    ++index;
+    if (words[0] & (uint64_t{1} << index)) {
+      typename std::decay<decltype(field)>::type::value_type value;
+      memcpy(&value, &words[index], sizeof(value));
+      field = value;
+    } else {
+      field = absl::nullopt;
+    }
+  });
+}
+
 }  // namespace
 
 // Throughout webrtc, it's assumed that success is represented by zero.
@@ -143,6 +253,7 @@ bool AudioProcessingImpl::SubmoduleStates::Update(
     bool mobile_echo_controller_enabled,
     bool residual_echo_detector_enabled,
     bool noise_suppressor_enabled,
+    bool full_band_noise_suppressor_enabled,
     bool adaptive_gain_controller_enabled,
     bool gain_controller2_enabled,
     bool pre_amplifier_enabled,
@@ -156,6 +267,8 @@ bool AudioProcessingImpl::SubmoduleStates::Update(
   changed |=
       (residual_echo_detector_enabled != residual_echo_detector_enabled_);
   changed |= (noise_suppressor_enabled != noise_suppressor_enabled_);
+  changed |= (full_band_noise_suppressor_enabled !=
+              full_band_noise_suppressor_enabled_);
   changed |=
       (adaptive_gain_controller_enabled != adaptive_gain_controller_enabled_);
   changed |= (gain_controller2_enabled != gain_controller2_enabled_);
@@ -168,6 +281,7 @@ bool AudioProcessingImpl::SubmoduleStates::Update(
     mobile_echo_controller_enabled_ = mobile_echo_controller_enabled;
     residual_echo_detector_enabled_ = residual_echo_detector_enabled;
     noise_suppressor_enabled_ = noise_suppressor_enabled;
+    full_band_noise_suppressor_enabled_ = full_band_noise_suppressor_enabled;
     adaptive_gain_controller_enabled_ = adaptive_gain_controller_enabled;
     gain_controller2_enabled_ = gain_controller2_enabled;
     pre_amplifier_enabled_ = pre_amplifier_enabled;
@@ -195,7 +309,8 @@ bool AudioProcessingImpl::SubmoduleStates::CaptureMultiBandProcessingPresent()
 bool AudioProcessingImpl::SubmoduleStates::CaptureMultiBandProcessingActive(
     bool ec_processing_active) const {
   return high_pass_filter_enabled_ || mobile_echo_controller_enabled_ ||
-         noise_suppressor_enabled_ || adaptive_gain_controller_enabled_ ||
+         (noise_suppressor_enabled_ && !full_band_noise_suppressor_enabled_) ||
+         adaptive_gain_controller_enabled_ ||
          (echo_controller_enabled_ && ec_processing_active);
 }
 
@@ -362,18 +477,22 @@ int AudioProcessingImpl::MaybeInitializeRender(
 void AudioProcessingImpl::InitializeLocked() {
   UpdateActiveSubmoduleStates();
 
+  const size_t low_latency_kernel_size =
+      LowLatencyResamplingKernelSize(config_.pipeline);
+
   const int render_audiobuffer_sample_rate_hz =
       formats_.api_format.reverse_output_stream().num_frames() == 0
           ? formats_.render_processing_format.sample_rate_hz()
           : formats_.api_format.reverse_output_stream().sample_rate_hz();
   if (formats_.api_format.reverse_input_stream().num_channels() > 0) {
-    render_.render_audio.reset(new AudioBuffer(
+    ReconfigureAudioBuffer(
         formats_.api_format.reverse_input_stream().sample_rate_hz(),
         formats_.api_format.reverse_input_stream().num_channels(),
         formats_.render_processing_format.sample_rate_hz(),
         formats_.render_processing_format.num_channels(),
         render_audiobuffer_sample_rate_hz,
-        formats_.render_processing_format.num_channels()));
+        formats_.render_processing_format.num_channels(),
+        low_latency_kernel_size, &render_.render_audio);
     if (formats_.api_format.reverse_input_stream() !=
         formats_.api_format.reverse_output_stream()) {
       render_.render_converter = AudioConverter::Create(
@@ -389,24 +508,26 @@ void AudioProcessingImpl::InitializeLocked() {
     render_.render_converter.reset(nullptr);
   }
 
-  capture_.capture_audio.reset(new AudioBuffer(
+  ReconfigureAudioBuffer(
       formats_.api_format.input_stream().sample_rate_hz(),
       formats_.api_format.input_stream().num_channels(),
       capture_nonlocked_.capture_processing_format.sample_rate_hz(),
       formats_.api_format.output_stream().num_channels(),
       formats_.api_format.output_stream().sample_rate_hz(),
-      formats_.api_format.output_stream().num_channels()));
+      formats_.api_format.output_stream().num_channels(),
+      low_latency_kernel_size, &capture_.capture_audio);
 
   if (capture_nonlocked_.capture_processing_format.sample_rate_hz() <
           formats_.api_format.output_stream().sample_rate_hz() &&
       formats_.api_format.output_stream().sample_rate_hz() == 48000) {
-    capture_.capture_fullband_audio.reset(
-        new AudioBuffer(formats_.api_format.input_stream().sample_rate_hz(),
-                        formats_.api_format.input_stream().num_channels(),
-                        formats_.api_format.output_stream().sample_rate_hz(),
-                        formats_.api_format.output_stream().num_channels(),
-                        formats_.api_format.output_stream().sample_rate_hz(),
-                        formats_.api_format.output_stream().num_channels()));
+    ReconfigureAudioBuffer(formats_.api_format.input_stream().sample_rate_hz(),
+                           formats_.api_format.input_stream().num_channels(),
+                           formats_.api_format.output_stream().sample_rate_hz(),
+                           formats_.api_format.output_stream().num_channels(),
+                           formats_.api_format.output_stream().sample_rate_hz(),
+                           formats_.api_format.output_stream().num_channels(),
+                           low_latency_kernel_size,
+                           &capture_.capture_fullband_audio);
   } else {
     capture_.capture_fullband_audio.reset();
   }
@@ -538,11 +659,17 @@ void AudioProcessingImpl::ApplyConfig(const AudioProcessing::Config& config) {
       config_.pipeline.multi_channel_capture !=
           config.pipeline.multi_channel_capture ||
       config_.pipeline.maximum_internal_processing_rate !=
-          config.pipeline.maximum_internal_processing_rate;
+          config.pipeline.maximum_internal_processing_rate ||
+      config_.pipeline.low_latency_resampling.enabled !=
+          config.pipeline.low_latency_resampling.enabled ||
+      config_.pipeline.low_latency_resampling.kernel_size !=
+          config.pipeline.low_latency_resampling.kernel_size;
 
   const bool aec_config_changed =
       config_.echo_canceller.enabled != config.echo_canceller.enabled ||
-      config_.echo_canceller.mobile_mode != config.echo_canceller.mobile_mode;
+      config_.echo_canceller.mobile_mode != config.echo_canceller.mobile_mode ||
+      config_.echo_canceller.mobile_delay_history_blocks !=
+          config.echo_canceller.mobile_delay_history_blocks;
 
   const bool agc1_config_changed =
       config_.gain_controller1.enabled != config.gain_controller1.enabled ||
@@ -572,14 +699,20 @@ void AudioProcessingImpl::ApplyConfig(const AudioProcessing::Config& config) {
               .enable_digital_adaptive;
 
   const bool agc2_config_changed =
-      config_.gain_controller2.enabled != config.gain_controller2.enabled;
+      config_.gain_controller2.enabled != config.gain_controller2.enabled ||
+      config_.gain_controller2.limiter.lookahead_ms !=
+          config.gain_controller2.limiter.lookahead_ms;
 
   const bool voice_detection_config_changed =
       config_.voice_detection.enabled != config.voice_detection.enabled;
 
   const bool ns_config_changed =
       config_.noise_suppression.enabled != config.noise_suppression.enabled ||
-      config_.noise_suppression.level != config.noise_suppression.level;
+      config_.noise_suppression.level != config.noise_suppression.level ||
+      config_.noise_suppression.low_latency !=
+          config.noise_suppression.low_latency ||
+      config_.noise_suppression.apply_in_full_band !=
+          config.noise_suppression.apply_in_full_band;
 
   const bool ts_config_changed = config_.transient_suppression.enabled !=
                                  config.transient_suppression.enabled;
@@ -793,7 +926,13 @@ int AudioProcessingImpl::ProcessStream(const float* const* src,
   }
 
   capture_.keyboard_info.Extract(src, formats_.api_format.input_stream());
-  capture_.capture_audio->CopyFrom(src, formats_.api_format.input_stream());
+  capture_.bands_split_on_copy = CaptureBandSplitCanBeFusedWithCopy();
+  if (capture_.bands_split_on_copy) {
+    capture_.capture_audio->CopyFromAndSplit(
+        src, formats_.api_format.input_stream());
+  } else {
+    capture_.capture_audio->CopyFrom(src, formats_.api_format.input_stream());
+  }
   if (capture_.capture_fullband_audio) {
     capture_.capture_fullband_audio->CopyFrom(
         src, formats_.api_format.input_stream());
@@ -903,8 +1042,7 @@ void AudioProcessingImpl::QueueBandedRenderAudio(AudioBuffer* audio) {
   RTC_DCHECK_GE(160, audio->num_frames_per_band());
 
   if (submodules_.echo_control_mobile) {
-    EchoControlMobileImpl::PackRenderAudioBuffer(audio, num_output_channels(),
-                                                 num_reverse_channels(),
+    EchoControlMobileImpl::PackRenderAudioBuffer(audio, num_reverse_channels(),
                                                  &aecm_render_queue_buffer_);
     RTC_DCHECK(aecm_render_signal_queue_);
     // Insert the samples into the queue.
@@ -1035,7 +1173,12 @@ int AudioProcessingImpl::ProcessStream(const int16_t* const src,
     RecordUnprocessedCaptureStream(src, input_config);
   }
 
-  capture_.capture_audio->CopyFrom(src, input_config);
+  capture_.bands_split_on_copy = CaptureBandSplitCanBeFusedWithCopy();
+  if (capture_.bands_split_on_copy) {
+    capture_.capture_audio->CopyFromAndSplit(src, input_config);
+  } else {
+    capture_.capture_audio->CopyFrom(src, input_config);
+  }
   if (capture_.capture_fullband_audio) {
     capture_.capture_fullband_audio->CopyFrom(src, input_config);
   }
@@ -1129,7 +1272,8 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
 
   if (submodule_states_.CaptureMultiBandSubModulesActive() &&
       SampleRateSupportsMultiBand(
-          capture_nonlocked_.capture_processing_format.sample_rate_hz())) {
+          capture_nonlocked_.capture_processing_format.sample_rate_hz()) &&
+      !capture_.bands_split_on_copy) {
     capture_buffer->SplitIntoFrequencyBands();
   }
 
@@ -1307,6 +1451,18 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
         ec_metrics.echo_return_loss_enhancement;
     capture_.stats.delay_ms = ec_metrics.delay_ms;
   }
+  if (submodules_.noise_suppressor) {
+    capture_.stats.noise_suppression_delay_ms =
+        submodules_.noise_suppressor->delay_ms();
+  } else {
+    capture_.stats.noise_suppression_delay_ms = absl::nullopt;
+  }
+  if (submodules_.gain_controller2) {
+    capture_.stats.gain_controller2_delay_ms =
+        submodules_.gain_controller2->delay_ms();
+  } else {
+    capture_.stats.gain_controller2_delay_ms = absl::nullopt;
+  }
   if (config_.residual_echo_detector.enabled) {
     RTC_DCHECK(submodules_.echo_detector);
     auto ed_metrics = submodules_.echo_detector->GetMetrics();
@@ -1322,12 +1478,24 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
   return kNoError;
 }
 
+bool AudioProcessingImpl::CaptureBandSplitCanBeFusedWithCopy() const {
+  const bool full_band_high_pass_filter =
+      submodules_.high_pass_filter &&
+      config_.high_pass_filter.apply_in_full_band &&
+      !constants_.enforce_split_band_hpf;
+  return submodule_states_.CaptureMultiBandSubModulesActive() &&
+         SampleRateSupportsMultiBand(
+             capture_nonlocked_.capture_processing_format.sample_rate_hz()) &&
+         !full_band_high_pass_filter && !submodules_.pre_amplifier;
+}
+
 int AudioProcessingImpl::AnalyzeReverseStream(
     const float* const* data,
     const StreamConfig& reverse_config) {
   TRACE_EVENT0("webrtc", "AudioProcessing::AnalyzeReverseStream_StreamConfig");
   MutexLock lock(&mutex_render_);
-  return AnalyzeReverseStreamLocked(data, reverse_config, reverse_config);
+  return AnalyzeReverseStreamLocked(data, reverse_config, reverse_config,
+                                    /*output_copied=*/false);
 }
 
 int AudioProcessingImpl::ProcessReverseStream(const float* const* src,
@@ -1336,9 +1504,13 @@ int AudioProcessingImpl::ProcessReverseStream(const float* const* src,
                                               float* const* dest) {
   TRACE_EVENT0("webrtc", "AudioProcessing::ProcessReverseStream_StreamConfig");
   MutexLock lock(&mutex_render_);
-  RETURN_ON_ERR(AnalyzeReverseStreamLocked(src, input_config, output_config));
-  if (submodule_states_.RenderMultiBandProcessingActive() ||
-      submodule_states_.RenderFullBandProcessingActive()) {
+  RETURN_ON_ERR(AnalyzeReverseStreamLocked(src, input_config, output_config,
+                                           /*output_copied=*/true));
+  if (render_.bands_merged_on_copy) {
+    render_.render_audio->MergeAndCopyTo(
+        formats_.api_format.reverse_output_stream(), dest);
+  } else if (submodule_states_.RenderMultiBandProcessingActive() ||
+             submodule_states_.RenderFullBandProcessingActive()) {
     render_.render_audio->CopyTo(formats_.api_format.reverse_output_stream(),
                                  dest);
   } else if (formats_.api_format.reverse_input_stream() !=
@@ -1356,7 +1528,8 @@ int AudioProcessingImpl::ProcessReverseStream(const float* const* src,
 int AudioProcessingImpl::AnalyzeReverseStreamLocked(
     const float* const* src,
     const StreamConfig& input_config,
-    const StreamConfig& output_config) {
+    const StreamConfig& output_config,
+    bool output_copied) {
   if (src == nullptr) {
     return kNullPointerError;
   }
@@ -1381,8 +1554,16 @@ int AudioProcessingImpl::AnalyzeReverseStreamLocked(
     aec_dump_->WriteRenderStreamMessage(
         AudioFrameView<const float>(src, num_channels, channel_size));
   }
-  render_.render_audio->CopyFrom(src,
-                                 formats_.api_format.reverse_input_stream());
+  render_.bands_split_on_copy = RenderBandSplitCanBeFusedWithCopy();
+  render_.bands_merged_on_copy =
+      output_copied && RenderBandMergeCanBeFusedWithCopy();
+  if (render_.bands_split_on_copy) {
+    render_.render_audio->CopyFromAndSplit(
+        src, formats_.api_format.reverse_input_stream());
+  } else {
+    render_.render_audio->CopyFrom(src,
+                                   formats_.api_format.reverse_input_stream());
+  }
   return ProcessRenderStreamLocked();
 }
 
@@ -1418,10 +1599,18 @@ int AudioProcessingImpl::ProcessReverseStream(const int16_t* const src,
                                         input_config.num_channels());
   }
 
-  render_.render_audio->CopyFrom(src, input_config);
+  render_.bands_split_on_copy = RenderBandSplitCanBeFusedWithCopy();
+  render_.bands_merged_on_copy = RenderBandMergeCanBeFusedWithCopy();
+  if (render_.bands_split_on_copy) {
+    render_.render_audio->CopyFromAndSplit(src, input_config);
+  } else {
+    render_.render_audio->CopyFrom(src, input_config);
+  }
   RETURN_ON_ERR(ProcessRenderStreamLocked());
-  if (submodule_states_.RenderMultiBandProcessingActive() ||
-      submodule_states_.RenderFullBandProcessingActive()) {
+  if (render_.bands_merged_on_copy) {
+    render_.render_audio->MergeAndCopyTo(output_config, dest);
+  } else if (submodule_states_.RenderMultiBandProcessingActive() ||
+             submodule_states_.RenderFullBandProcessingActive()) {
     render_.render_audio->CopyTo(output_config, dest);
   }
   return kNoError;
@@ -1440,7 +1629,8 @@ int AudioProcessingImpl::ProcessRenderStreamLocked() {
 
   if (submodule_states_.RenderMultiBandSubModulesActive() &&
       SampleRateSupportsMultiBand(
-          formats_.render_processing_format.sample_rate_hz())) {
+          formats_.render_processing_format.sample_rate_hz()) &&
+      !render_.bands_split_on_copy) {
     render_buffer->SplitIntoFrequencyBands();
   }
 
@@ -1455,13 +1645,27 @@ int AudioProcessingImpl::ProcessRenderStreamLocked() {
 
   if (submodule_states_.RenderMultiBandProcessingActive() &&
       SampleRateSupportsMultiBand(
-          formats_.render_processing_format.sample_rate_hz())) {
+          formats_.render_processing_format.sample_rate_hz()) &&
+      !render_.bands_merged_on_copy) {
     render_buffer->MergeFrequencyBands();
   }
 
   return kNoError;
 }
 
+bool AudioProcessingImpl::RenderBandSplitCanBeFusedWithCopy() const {
+  return submodule_states_.RenderMultiBandSubModulesActive() &&
+         SampleRateSupportsMultiBand(
+             formats_.render_processing_format.sample_rate_hz()) &&
+         !submodules_.render_pre_processor;
+}
+
+bool AudioProcessingImpl::RenderBandMergeCanBeFusedWithCopy() const {
+  return submodule_states_.RenderMultiBandProcessingActive() &&
+         SampleRateSupportsMultiBand(
+             formats_.render_processing_format.sample_rate_hz());
+}
+
 int AudioProcessingImpl::set_stream_delay_ms(int delay) {
   MutexLock lock(&mutex_capture_);
   Error retval = kNoError;
@@ -1615,8 +1819,9 @@ bool AudioProcessingImpl::UpdateActiveSubmoduleStates() {
   return submodule_states_.Update(
       config_.high_pass_filter.enabled, !!submodules_.echo_control_mobile,
       config_.residual_echo_detector.enabled, !!submodules_.noise_suppressor,
-      !!submodules_.gain_control, !!submodules_.gain_controller2,
-      config_.pre_amplifier.enabled, capture_nonlocked_.echo_controller_enabled,
+      FullBandNoiseSuppressionPossible(), !!submodules_.gain_control,
+      !!submodules_.gain_controller2, config_.pre_amplifier.enabled,
+      capture_nonlocked_.echo_controller_enabled,
       config_.voice_detection.enabled, !!submodules_.transient_suppressor);
 }
 
@@ -1729,7 +1934,7 @@ void AudioProcessingImpl::InitializeEchoController() {
         std::max(static_cast<size_t>(1),
                  kMaxAllowedValuesOfSamplesPerBand *
                      EchoControlMobileImpl::NumCancellersRequired(
-                         num_output_channels(), num_reverse_channels()));
+                         num_reverse_channels()));
 
     std::vector<int16_t> template_queue_element(max_element_size);
 
@@ -1743,9 +1948,10 @@ void AudioProcessingImpl::InitializeEchoController() {
 
     submodules_.echo_control_mobile.reset(new EchoControlMobileImpl());
 
-    submodules_.echo_control_mobile->Initialize(proc_split_sample_rate_hz(),
-                                                num_reverse_channels(),
-                                                num_output_channels());
+    submodules_.echo_control_mobile->Initialize(
+        proc_split_sample_rate_hz(), num_reverse_channels(),
+        num_output_channels(),
+        config_.echo_canceller.mobile_delay_history_blocks);
     return;
   }
 
@@ -1833,6 +2039,20 @@ void AudioProcessingImpl::InitializeGainController2() {
   }
 }
 
+bool AudioProcessingImpl::FullBandNoiseSuppressionPossible() const {
+  // The band-splitting can only be bypassed if no other submodule operates on
+  // the split bands.
+  return config_.noise_suppression.enabled &&
+         config_.noise_suppression.apply_in_full_band &&
+         proc_sample_rate_hz() == kSampleRate48kHz &&
+         !submodules_.echo_control_mobile && !submodules_.gain_control &&
+         !capture_nonlocked_.echo_controller_enabled &&
+         !config_.voice_detection.enabled &&
+         !submodules_.transient_suppressor &&
+         config_.high_pass_filter.apply_in_full_band &&
+         !constants_.enforce_split_band_hpf;
+}
+
 void AudioProcessingImpl::InitializeNoiseSuppressor() {
   submodules_.noise_suppressor.reset();
 
@@ -1857,6 +2077,8 @@ void AudioProcessingImpl::InitializeNoiseSuppressor() {
 
     NsConfig cfg;
     cfg.target_level = map_level(config_.noise_suppression.level);
+    cfg.low_latency = config_.noise_suppression.low_latency;
+    cfg.full_band = FullBandNoiseSuppressionPossible();
     submodules_.noise_suppressor = std::make_unique<NoiseSuppressor>(
         cfg, proc_sample_rate_hz(), num_proc_channels());
   }
@@ -2054,26 +2276,57 @@ AudioProcessingImpl::ApmRenderState::ApmRenderState() = default;
 
 AudioProcessingImpl::ApmRenderState::~ApmRenderState() = default;
 
-AudioProcessingImpl::ApmStatsReporter::ApmStatsReporter()
-    : stats_message_queue_(1) {}
+constexpr int AudioProcessingImpl::ApmStatsReporter::kNumStatsWords;
+
+AudioProcessingImpl::ApmStatsReporter::ApmStatsReporter() = default;
 
 AudioProcessingImpl::ApmStatsReporter::~ApmStatsReporter() = default;
 
-AudioProcessingStats AudioProcessingImpl::ApmStatsReporter::GetStatistics() {
-  MutexLock lock_stats(&mutex_stats_);
-  bool new_stats_available = stats_message_queue_.Remove(&cached_stats_);
-  // If the message queue is full, return the cached stats.
-  static_cast<void>(new_stats_available);
+AudioProcessingStats AudioProcessingImpl::ApmStatsReporter::GetStatistics()
+    const {
+  uint64_t words[kNumStatsWords];
+  while (true) {
+    const Snapshot& snapshot =
+        snapshots_[latest_snapshot_.load(std::memory_order_acquire)];
+    const uint32_t sequence = snapshot.sequence.load(std::memory_order_acquire);
+    // An odd sequence means that newer statistics have been reported since the
+    // snapshot index was loaded and that the snapshot is being overwritten.
+    if (sequence & 1) {
+      continue;
+    }
+    for (int k = 0; k < kNumStatsWords; ++k) {
+      words[k] = snapshot.words[k].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (snapshot.sequence.load(std::memory_order_relaxed) == sequence) {
+      break;
+    }
+  }
 
-  return cached_stats_;
+  AudioProcessingStats stats;
+  UnpackStats(words, &stats);
+  return stats;
 }
 
 void AudioProcessingImpl::ApmStatsReporter::UpdateStatistics(
     const AudioProcessingStats& new_stats) {
-  AudioProcessingStats stats_to_queue = new_stats;
-  bool stats_message_passed = stats_message_queue_.Insert(&stats_to_queue);
-  // If the message queue is full, discard the new stats.
-  static_cast<void>(stats_message_passed);
+  static_assert(kNumStatsWords == kNumStatsFields + 1,
+                "kNumStatsWords must match the number of statistics fields");
+  uint64_t words[kNumStatsWords];
+  PackStats(new_stats, words);
+
+  // Write the snapshot that readers are not directed to, then direct them to
+  // it.
+  const int index = 1 - latest_snapshot_.load(std::memory_order_relaxed);
+  Snapshot& snapshot = snapshots_[index];
+  const uint32_t sequence = snapshot.sequence.load(std::memory_order_relaxed);
+  snapshot.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  for (int k = 0; k < kNumStatsWords; ++k) {
+    snapshot.words[k].store(words[k], std::memory_order_relaxed);
+  }
+  snapshot.sequence.store(sequence + 2, std::memory_order_release);
+  latest_snapshot_.store(index, std::memory_order_release);
 }
 
 }  // namespace webrtc
@@ -13,6 +13,7 @@
 
 #include <stdio.h>
 
+#include <atomic>
 #include <list>
 #include <memory>
 #include <string>
@@ -197,6 +198,7 @@ class AudioProcessingImpl : public AudioProcessing {
                 bool mobile_echo_controller_enabled,
                 bool residual_echo_detector_enabled,
                 bool noise_suppressor_enabled,
+                bool full_band_noise_suppressor_enabled,
                 bool adaptive_gain_controller_enabled,
                 bool gain_controller2_enabled,
                 bool pre_amplifier_enabled,
@@ -221,6 +223,7 @@ class AudioProcessingImpl : public AudioProcessing {
     bool mobile_echo_controller_enabled_ = false;
     bool residual_echo_detector_enabled_ = false;
     bool noise_suppressor_enabled_ = false;
+    bool full_band_noise_suppressor_enabled_ = false;
     bool adaptive_gain_controller_enabled_ = false;
     bool gain_controller2_enabled_ = false;
     bool pre_amplifier_enabled_ = false;
@@ -243,6 +246,11 @@ class AudioProcessingImpl : public AudioProcessing {
   int MaybeInitializeCapture(const StreamConfig& input_config,
                              const StreamConfig& output_config);
 
+  // Returns whether the noise suppressor can operate on the full-band signal,
+  // without the signal being split into frequency bands.
+  bool FullBandNoiseSuppressionPossible() const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_capture_);
+
   // Method for updating the state keeping track of the active submodules.
   // Returns a bool indicating whether the state has changed.
   bool UpdateActiveSubmoduleStates()
@@ -299,15 +307,31 @@ class AudioProcessingImpl : public AudioProcessing {
   // manner that are called with the render lock already acquired.
   int ProcessCaptureStreamLocked() RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_capture_);
 
+  // Returns true if the capture signal is split into bands without being
+  // modified in full band after the copy into the capture buffer, which allows
+  // the copy and the split to be done in one pass.
+  bool CaptureBandSplitCanBeFusedWithCopy() const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_capture_);
+
   // Render-side exclusive methods possibly running APM in a multi-threaded
   // manner that are called with the render lock already acquired.
   // TODO(ekm): Remove once all clients updated to new interface.
+  // |output_copied| tells whether the processed signal is copied to the
+  // render output afterwards.
   int AnalyzeReverseStreamLocked(const float* const* src,
                                  const StreamConfig& input_config,
-                                 const StreamConfig& output_config)
+                                 const StreamConfig& output_config,
+                                 bool output_copied)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_render_);
   int ProcessRenderStreamLocked() RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_render_);
 
+  // Counterparts of CaptureBandSplitCanBeFusedWithCopy() for the render
+  // signal. The band merge can be fused with the copy to the render output.
+  bool RenderBandSplitCanBeFusedWithCopy() const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_render_);
+  bool RenderBandMergeCanBeFusedWithCopy() const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_render_);
+
   // Collects configuration settings from public and private
   // submodules to be saved as an audioproc::Config message on the
   // AecDump if it is attached.  If not |forced|, only writes the current
@@ -445,6 +469,8 @@ class AudioProcessingImpl : public AudioProcessing {
       const float* keyboard_data = nullptr;
     } keyboard_info;
     int cached_stream_analog_level_ = 0;
+    // Whether the bands of |capture_audio| were split when copying the input.
+    bool bands_split_on_copy = false;
   } capture_ RTC_GUARDED_BY(mutex_capture_);
 
   struct ApmCaptureNonLockedState {
@@ -466,25 +492,45 @@ class AudioProcessingImpl : public AudioProcessing {
     ~ApmRenderState();
     std::unique_ptr<AudioConverter> render_converter;
     std::unique_ptr<AudioBuffer> render_audio;
+    // Whether the bands of |render_audio| are split when copying the input and
+    // merged when copying the output, respectively.
+    bool bands_split_on_copy = false;
+    bool bands_merged_on_copy = false;
   } render_ RTC_GUARDED_BY(mutex_render_);
 
   // Class for statistics reporting. The class is thread-safe and no lock is
-  // needed when accessing it.
+  // needed when accessing it. The statistics are reported by a single thread,
+  // the capture thread, and read by any number of threads. Neither side locks:
+  // the statistics are packed into atomic words in one of two snapshots, each
+  // guarded by a sequence counter that readers use to detect and retry torn
+  // copies. The reporter always writes the snapshot readers are not directed
+  // to, so a reader only retries if two reports land during its copy.
   class ApmStatsReporter {
    public:
     ApmStatsReporter();
     ~ApmStatsReporter();
 
     // Returns the most recently reported statistics.
-    AudioProcessingStats GetStatistics();
+    AudioProcessingStats GetStatistics() const;
 
-    // Update the cached statistics.
+    // Update the cached statistics. Must only be called by one thread at a
+    // time.
     void UpdateStatistics(const AudioProcessingStats& new_stats);
 
+    // Number of words of a packed AudioProcessingStats: a mask of the fields
+    // that are set followed by the value of each field.
+    static constexpr int kNumStatsWords = 13;
+
    private:
-    Mutex mutex_stats_;
-    AudioProcessingStats cached_stats_ RTC_GUARDED_BY(mutex_stats_);
-    SwapQueue<AudioProcessingStats> stats_message_queue_;
+    struct Snapshot {
+      // Odd while the snapshot is written.
+      std::atomic<uint32_t> sequence{0};
+      std::atomic<uint64_t> words[kNumStatsWords] = {};
+    };
+
+    Snapshot snapshots_[2];
+    // Index of the snapshot holding the most recently reported statistics.
+    std::atomic<int> latest_snapshot_{0};
   } stats_reporter_;
 
   std::vector<int16_t> aecm_render_queue_buffer_ RTC_GUARDED_BY(mutex_render_);
@@ -12,8 +12,11 @@
 
 #include <string.h>
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
 
+#include "modules/audio_processing/aecm/aecm_defines.h"
 #include "modules/audio_processing/aecm/echo_control_mobile.h"
 #include "modules/audio_processing/audio_buffer.h"
 #include "modules/audio_processing/include/audio_processing.h"
@@ -23,6 +26,10 @@
 namespace webrtc {
 
 namespace {
+
+// The smallest history the AECM delay estimator can be created with.
+constexpr int kMinDelayHistoryBlocks = 2;
+
 int16_t MapSetting(EchoControlMobileImpl::RoutingMode mode) {
   switch (mode) {
     case EchoControlMobileImpl::kQuietEarpieceOrHeadset:
@@ -75,8 +82,9 @@ struct EchoControlMobileImpl::StreamProperties {
 
 class EchoControlMobileImpl::Canceller {
  public:
-  Canceller() {
-    state_ = WebRtcAecm_Create();
+  Canceller(size_t num_capture_channels, int delay_history_blocks) {
+    state_ = WebRtcAecm_CreateMultiChannel(num_capture_channels,
+                                           delay_history_blocks);
     RTC_CHECK(state_);
   }
 
@@ -112,8 +120,7 @@ void EchoControlMobileImpl::ProcessRenderAudio(
 
   size_t buffer_index = 0;
   size_t num_frames_per_band =
-      packed_render_audio.size() / (stream_properties_->num_output_channels *
-                                    stream_properties_->num_reverse_channels);
+      packed_render_audio.size() / stream_properties_->num_reverse_channels;
 
   for (auto& canceller : cancellers_) {
     WebRtcAecm_BufferFarend(canceller->state(),
@@ -126,35 +133,31 @@ void EchoControlMobileImpl::ProcessRenderAudio(
 
 void EchoControlMobileImpl::PackRenderAudioBuffer(
     const AudioBuffer* audio,
-    size_t num_output_channels,
     size_t num_channels,
     std::vector<int16_t>* packed_buffer) {
   RTC_DCHECK_GE(AudioBuffer::kMaxSplitFrameLength,
                 audio->num_frames_per_band());
   RTC_DCHECK_EQ(num_channels, audio->num_channels());
 
-  // The ordering convention must be followed to pass to the correct AECM.
+  // The ordering convention must be followed to pass to the correct AECM. The
+  // render channels are buffered once, as the AECM shares the far end of a
+  // render channel between the capture channels.
   packed_buffer->clear();
-  int render_channel = 0;
-  for (size_t i = 0; i < num_output_channels; i++) {
-    for (size_t j = 0; j < audio->num_channels(); j++) {
-      std::array<int16_t, AudioBuffer::kMaxSplitFrameLength> data_to_buffer;
-      FloatS16ToS16(audio->split_bands_const(render_channel)[kBand0To8kHz],
-                    audio->num_frames_per_band(), data_to_buffer.data());
-
-      // Buffer the samples in the render queue.
-      packed_buffer->insert(
-          packed_buffer->end(), data_to_buffer.data(),
-          data_to_buffer.data() + audio->num_frames_per_band());
-      render_channel = (render_channel + 1) % audio->num_channels();
-    }
+  for (size_t render_channel = 0; render_channel < audio->num_channels();
+       render_channel++) {
+    std::array<int16_t, AudioBuffer::kMaxSplitFrameLength> data_to_buffer;
+    FloatS16ToS16(audio->split_bands_const(render_channel)[kBand0To8kHz],
+                  audio->num_frames_per_band(), data_to_buffer.data());
+
+    // Buffer the samples in the render queue.
+    packed_buffer->insert(packed_buffer->end(), data_to_buffer.data(),
+                          data_to_buffer.data() + audio->num_frames_per_band());
   }
 }
 
 size_t EchoControlMobileImpl::NumCancellersRequired(
-    size_t num_output_channels,
     size_t num_reverse_channels) {
-  return num_output_channels * num_reverse_channels;
+  return num_reverse_channels;
 }
 
 int EchoControlMobileImpl::ProcessCaptureAudio(AudioBuffer* audio,
@@ -162,29 +165,25 @@ int EchoControlMobileImpl::ProcessCaptureAudio(AudioBuffer* audio,
   RTC_DCHECK(stream_properties_);
   RTC_DCHECK_GE(160, audio->num_frames_per_band());
   RTC_DCHECK_EQ(audio->num_channels(), stream_properties_->num_output_channels);
-  RTC_DCHECK_GE(cancellers_.size(), stream_properties_->num_reverse_channels *
-                                        audio->num_channels());
+  RTC_DCHECK_EQ(cancellers_.size(), stream_properties_->num_reverse_channels);
 
-  int err = AudioProcessing::kNoError;
+  const size_t num_capture_channels = audio->num_channels();
+  const size_t num_frames_per_band = audio->num_frames_per_band();
+  RTC_DCHECK_GE(AudioBuffer::kMaxSplitFrameLength, num_frames_per_band);
+  RTC_DCHECK_EQ(split_bands_data_.size(), num_capture_channels);
 
-  // The ordering convention must be followed to pass to the correct AECM.
-  size_t handle_index = 0;
-  for (size_t capture = 0; capture < audio->num_channels(); ++capture) {
+  for (size_t capture = 0; capture < num_capture_channels; ++capture) {
     // TODO(ajm): improve how this works, possibly inside AECM.
     //            This is kind of hacked up.
     RTC_DCHECK_LT(capture, low_pass_reference_.size());
     const int16_t* noisy =
         reference_copied_ ? low_pass_reference_[capture].data() : nullptr;
 
-    RTC_DCHECK_GE(AudioBuffer::kMaxSplitFrameLength,
-                  audio->num_frames_per_band());
-
-    std::array<int16_t, AudioBuffer::kMaxSplitFrameLength> split_bands_data;
-    int16_t* split_bands = split_bands_data.data();
-    const int16_t* clean = split_bands_data.data();
+    int16_t* split_bands = split_bands_data_[capture].data();
+    const int16_t* clean = split_bands_data_[capture].data();
     if (audio->split_bands(capture)[kBand0To8kHz]) {
       FloatS16ToS16(audio->split_bands(capture)[kBand0To8kHz],
-                    audio->num_frames_per_band(), split_bands_data.data());
+                    num_frames_per_band, split_bands);
     } else {
       clean = nullptr;
       split_bands = nullptr;
@@ -194,27 +193,63 @@ int EchoControlMobileImpl::ProcessCaptureAudio(AudioBuffer* audio,
       noisy = clean;
       clean = NULL;
     }
-    for (size_t render = 0; render < stream_properties_->num_reverse_channels;
-         ++render) {
-      err = WebRtcAecm_Process(cancellers_[handle_index]->state(), noisy, clean,
-                               split_bands, audio->num_frames_per_band(),
-                               stream_delay_ms);
-
-      if (split_bands) {
-        S16ToFloatS16(split_bands, audio->num_frames_per_band(),
-                      audio->split_bands(capture)[kBand0To8kHz]);
-      }
+    noisy_[capture] = noisy;
+    clean_[capture] = clean;
+    split_bands_[capture] = split_bands;
+  }
 
-      if (err != AudioProcessing::kNoError) {
-        return MapError(err);
-      }
+  // The ordering convention must be followed to pass to the correct AECM. The
+  // capture channels are processed together by the canceller of each render
+  // channel, the output of a canceller being the input of the next one.
+  for (size_t render = 0; render < stream_properties_->num_reverse_channels;
+       ++render) {
+    int err = WebRtcAecm_ProcessMultiChannel(
+        cancellers_[render]->state(), noisy_.data(),
+        reference_copied_ ? clean_.data() : nullptr, split_bands_.data(),
+        num_frames_per_band, stream_delay_ms);
+
+    if (err != AudioProcessing::kNoError) {
+      return MapError(err);
+    }
+  }
 
-      ++handle_index;
+  for (size_t capture = 0; capture < num_capture_channels; ++capture) {
+    if (split_bands_[capture]) {
+      S16ToFloatS16(split_bands_[capture], num_frames_per_band,
+                    audio->split_bands(capture)[kBand0To8kHz]);
+    }
+
+    if (audio->num_bands() == 1) {
+      continue;
+    }
+
+    // The bands above 8 kHz are not processed by the AECM. They are delayed
+    // like the processed band and scaled by the suppression gain of its
+    // highest frequencies, accumulated over the cancellers.
+    float upper_band_gain = 1.f;
+    for (auto& canceller : cancellers_) {
+      upper_band_gain *=
+          WebRtcAecm_GetUpperBandGain(canceller->state(), capture) / 16384.f;
     }
     for (size_t band = 1u; band < audio->num_bands(); ++band) {
-      memset(audio->split_bands_f(capture)[band], 0,
-             audio->num_frames_per_band() *
-                 sizeof(audio->split_bands_f(capture)[band][0]));
+      float* band_data = audio->split_bands(capture)[band];
+      std::vector<float>& delay_memory =
+          upper_band_delay_memory_[capture][band - 1];
+      RTC_DCHECK_LE(delay_memory.size(), num_frames_per_band);
+      const size_t samples_from_band =
+          num_frames_per_band - delay_memory.size();
+
+      std::array<float, AudioBuffer::kMaxSplitFrameLength> delayed_band;
+      std::copy(delay_memory.begin(), delay_memory.end(),
+                delayed_band.begin());
+      std::copy(band_data, band_data + samples_from_band,
+                delayed_band.begin() + delay_memory.size());
+      std::copy(band_data + samples_from_band, band_data + num_frames_per_band,
+                delay_memory.begin());
+
+      for (size_t k = 0; k < num_frames_per_band; ++k) {
+        band_data[k] = delayed_band[k] * upper_band_gain;
+      }
     }
   }
   return AudioProcessing::kNoError;
@@ -243,7 +278,8 @@ bool EchoControlMobileImpl::is_comfort_noise_enabled() const {
 
 void EchoControlMobileImpl::Initialize(int sample_rate_hz,
                                        size_t num_reverse_channels,
-                                       size_t num_output_channels) {
+                                       size_t num_output_channels,
+                                       int delay_history_blocks) {
   low_pass_reference_.resize(num_output_channels);
   for (auto& reference : low_pass_reference_) {
     reference.fill(0);
@@ -256,14 +292,30 @@ void EchoControlMobileImpl::Initialize(int sample_rate_hz,
   RTC_DCHECK_LE(stream_properties_->sample_rate_hz,
                 AudioProcessing::kSampleRate16kHz);
 
+  split_bands_data_.resize(num_output_channels);
+  noisy_.resize(num_output_channels);
+  clean_.resize(num_output_channels);
+  split_bands_.resize(num_output_channels);
+
+  // The upper bands are delayed by the latency of the AECM block processing,
+  // which the processed band only has once past the AECM startup phase.
+  upper_band_delay_memory_.resize(num_output_channels);
+  for (auto& channel_memory : upper_band_delay_memory_) {
+    channel_memory.resize(AudioBuffer::kMaxNumBands - 1);
+    for (auto& band_memory : channel_memory) {
+      band_memory.assign(PROCESS_DELAY_LEN, 0.f);
+    }
+  }
+
+  // The cancellers are recreated, as their number of capture channels may have
+  // changed.
   cancellers_.resize(
-      NumCancellersRequired(stream_properties_->num_output_channels,
-                            stream_properties_->num_reverse_channels));
+      NumCancellersRequired(stream_properties_->num_reverse_channels));
 
   for (auto& canceller : cancellers_) {
-    if (!canceller) {
-      canceller.reset(new Canceller());
-    }
+    canceller.reset(new Canceller(
+        num_output_channels,
+        std::max(delay_history_blocks, kMinDelayHistoryBlocks)));
     canceller->Initialize(sample_rate_hz);
   }
   Configure();
@@ -55,17 +55,20 @@ class EchoControlMobileImpl {
   void ProcessRenderAudio(rtc::ArrayView<const int16_t> packed_render_audio);
   int ProcessCaptureAudio(AudioBuffer* audio, int stream_delay_ms);
 
+  // Recreates the cancellers, which search the echo delay over the last
+  // |delay_history_blocks| render blocks. At least 2 blocks are used.
   void Initialize(int sample_rate_hz,
                   size_t num_reverse_channels,
-                  size_t num_output_channels);
+                  size_t num_output_channels,
+                  int delay_history_blocks);
 
   static void PackRenderAudioBuffer(const AudioBuffer* audio,
-                                    size_t num_output_channels,
                                     size_t num_channels,
                                     std::vector<int16_t>* packed_buffer);
 
-  static size_t NumCancellersRequired(size_t num_output_channels,
-                                      size_t num_reverse_channels);
+  // Returns the number of cancellers, one per render channel. Each of them
+  // processes all the capture channels.
+  static size_t NumCancellersRequired(size_t num_reverse_channels);
 
  private:
   class Canceller;
@@ -80,6 +83,15 @@ class EchoControlMobileImpl {
   std::unique_ptr<StreamProperties> stream_properties_;
   std::vector<std::array<int16_t, 160>> low_pass_reference_;
   bool reference_copied_ = false;
+  // Band 0 of the capture channels, and the pointers to them passed to the
+  // cancellers.
+  std::vector<std::array<int16_t, 160>> split_bands_data_;
+  std::vector<const int16_t*> noisy_;
+  std::vector<const int16_t*> clean_;
+  std::vector<int16_t*> split_bands_;
+  // The last samples of the bands above 8 kHz of the capture channels, which
+  // are delayed like band 0 through the cancellers.
+  std::vector<std::vector<std::vector<float>>> upper_band_delay_memory_;
 };
 }  // namespace webrtc
 
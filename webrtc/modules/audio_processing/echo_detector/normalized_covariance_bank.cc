@@ -0,0 +1,168 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/echo_detector/normalized_covariance_bank.h"
+
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+#include <math.h>
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+// Parameter controlling the adaptation speed.
+constexpr float kAlpha = 0.001f;
+
+}  // namespace
+
+NormalizedCovarianceBank::NormalizedCovarianceBank(size_t num_delays)
+    : NormalizedCovarianceBank(num_delays, DetectVectorMathOptimization()) {}
+
+NormalizedCovarianceBank::NormalizedCovarianceBank(
+    size_t num_delays,
+    VectorMathOptimization optimization)
+    : optimization_(optimization),
+      covariances_(num_delays, 0.f),
+      normalized_cross_correlations_(num_delays, 0.f) {}
+
+NormalizedCovarianceBank::~NormalizedCovarianceBank() = default;
+
+void NormalizedCovarianceBank::Update(float x,
+                                      float x_mean,
+                                      float x_sigma,
+                                      rtc::ArrayView<const float> y,
+                                      rtc::ArrayView<const float> y_mean,
+                                      rtc::ArrayView<const float> y_sigma) {
+  const size_t num_delays = covariances_.size();
+  RTC_DCHECK_EQ(y.size(), num_delays);
+  RTC_DCHECK_EQ(y_mean.size(), num_delays);
+  RTC_DCHECK_EQ(y_sigma.size(), num_delays);
+
+  // The operations are ordered as in NormalizedCovarianceEstimator::Update(),
+  // so that the code paths only differ by the rounding of fused multiply-adds.
+  const float forgetting_factor = 1.f - kAlpha;
+  const float x_deviation = kAlpha * (x - x_mean);
+  float* covariances = covariances_.data();
+  float* normalized_cross_correlations = normalized_cross_correlations_.data();
+  float max_normalized_cross_correlation = 0.f;
+
+  size_t k = 0;
+  switch (optimization_) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case VectorMathOptimization::kAvx2:
+    case VectorMathOptimization::kSse2: {
+      const __m128 forgetting_factor_v = _mm_set1_ps(forgetting_factor);
+      const __m128 x_deviation_v = _mm_set1_ps(x_deviation);
+      const __m128 x_sigma_v = _mm_set1_ps(x_sigma);
+      const __m128 regularization = _mm_set1_ps(.0001f);
+      __m128 max_v = _mm_setzero_ps();
+      for (; k + 4 <= num_delays; k += 4) {
+        const __m128 y_deviation =
+            _mm_sub_ps(_mm_loadu_ps(&y[k]), _mm_loadu_ps(&y_mean[k]));
+        const __m128 covariance = _mm_add_ps(
+            _mm_mul_ps(forgetting_factor_v, _mm_loadu_ps(&covariances[k])),
+            _mm_mul_ps(x_deviation_v, y_deviation));
+        const __m128 normalized_cross_correlation = _mm_div_ps(
+            covariance,
+            _mm_add_ps(_mm_mul_ps(x_sigma_v, _mm_loadu_ps(&y_sigma[k])),
+                       regularization));
+        _mm_storeu_ps(&covariances[k], covariance);
+        _mm_storeu_ps(&normalized_cross_correlations[k],
+                      normalized_cross_correlation);
+        max_v = _mm_max_ps(max_v, normalized_cross_correlation);
+      }
+      max_v = _mm_max_ps(max_v, _mm_movehl_ps(max_v, max_v));
+      max_v = _mm_max_ss(max_v, _mm_shuffle_ps(max_v, max_v, 1));
+      max_normalized_cross_correlation = _mm_cvtss_f32(max_v);
+    } break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case VectorMathOptimization::kNeon: {
+      const float32x4_t forgetting_factor_v = vdupq_n_f32(forgetting_factor);
+      const float32x4_t x_deviation_v = vdupq_n_f32(x_deviation);
+      const float32x4_t x_sigma_v = vdupq_n_f32(x_sigma);
+      const float32x4_t regularization = vdupq_n_f32(.0001f);
+      float32x4_t max_v = vdupq_n_f32(0.f);
+      for (; k + 4 <= num_delays; k += 4) {
+        const float32x4_t y_deviation =
+            vsubq_f32(vld1q_f32(&y[k]), vld1q_f32(&y_mean[k]));
+        const float32x4_t covariance = vaddq_f32(
+            vmulq_f32(forgetting_factor_v, vld1q_f32(&covariances[k])),
+            vmulq_f32(x_deviation_v, y_deviation));
+        const float32x4_t denominator = vaddq_f32(
+            vmulq_f32(x_sigma_v, vld1q_f32(&y_sigma[k])), regularization);
+#if defined(WEBRTC_ARCH_ARM64)
+        const float32x4_t normalized_cross_correlation =
+            vdivq_f32(covariance, denominator);
+#else
+        // ARMv7 has no vector division. Refine the reciprocal estimate with
+        // two Newton-Raphson iterations.
+        float32x4_t inverse = vrecpeq_f32(denominator);
+        inverse = vmulq_f32(vrecpsq_f32(denominator, inverse), inverse);
+        inverse = vmulq_f32(vrecpsq_f32(denominator, inverse), inverse);
+        const float32x4_t normalized_cross_correlation =
+            vmulq_f32(covariance, inverse);
+#endif
+        vst1q_f32(&covariances[k], covariance);
+        vst1q_f32(&normalized_cross_correlations[k],
+                  normalized_cross_correlation);
+        max_v = vmaxq_f32(max_v, normalized_cross_correlation);
+      }
+      float32x2_t max_2 = vmax_f32(vget_low_f32(max_v), vget_high_f32(max_v));
+      max_2 = vpmax_f32(max_2, max_2);
+      max_normalized_cross_correlation = vget_lane_f32(max_2, 0);
+    } break;
+#endif
+    default:
+      break;
+  }
+
+  for (; k < num_delays; ++k) {
+    covariances[k] = forgetting_factor * covariances[k] +
+                     x_deviation * (y[k] - y_mean[k]);
+    normalized_cross_correlations[k] =
+        covariances[k] / (x_sigma * y_sigma[k] + .0001f);
+    max_normalized_cross_correlation = std::max(
+        max_normalized_cross_correlation, normalized_cross_correlations[k]);
+  }
+  max_normalized_cross_correlation_ = max_normalized_cross_correlation;
+  RTC_DCHECK(isfinite(max_normalized_cross_correlation_));
+}
+
+int NormalizedCovarianceBank::BestDelay() const {
+  if (max_normalized_cross_correlation_ <= 0.f) {
+    return -1;
+  }
+  const auto best = std::find(normalized_cross_correlations_.begin(),
+                              normalized_cross_correlations_.end(),
+                              max_normalized_cross_correlation_);
+  RTC_DCHECK(best != normalized_cross_correlations_.end());
+  return static_cast<int>(best - normalized_cross_correlations_.begin());
+}
+
+void NormalizedCovarianceBank::Clear() {
+  std::fill(covariances_.begin(), covariances_.end(), 0.f);
+  std::fill(normalized_cross_correlations_.begin(),
+            normalized_cross_correlations_.end(), 0.f);
+  max_normalized_cross_correlation_ = 0.f;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_ECHO_DETECTOR_NORMALIZED_COVARIANCE_BANK_H_
+#define MODULES_AUDIO_PROCESSING_ECHO_DETECTOR_NORMALIZED_COVARIANCE_BANK_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "api/array_view.h"
+#include "common_audio/vector_math.h"
+
+namespace webrtc {
+
+// Iteratively estimates the normalized covariance between a signal and a set of
+// delayed versions of another signal. This is equivalent to one
+// NormalizedCovarianceEstimator per delay, but the estimates are stored as
+// contiguous arrays and updated in a single vectorized loop over all delays.
+class NormalizedCovarianceBank {
+ public:
+  explicit NormalizedCovarianceBank(size_t num_delays);
+  // Sets the optimization to use, for testing purposes.
+  NormalizedCovarianceBank(size_t num_delays,
+                           VectorMathOptimization optimization);
+  ~NormalizedCovarianceBank();
+
+  // Updates the estimates with the value |x| of the first signal, and the
+  // values |y| of the second signal at each delay. |x_mean| and |x_sigma| are
+  // the mean and standard deviation of the first signal, |y_mean| and
+  // |y_sigma| those of the second signal at each delay. All views must have
+  // num_delays() elements.
+  void Update(float x,
+              float x_mean,
+              float x_sigma,
+              rtc::ArrayView<const float> y,
+              rtc::ArrayView<const float> y_mean,
+              rtc::ArrayView<const float> y_sigma);
+
+  // Returns the largest estimate of the Pearson product-moment correlation
+  // coefficient over all delays after the last update, or zero if no estimate
+  // is positive.
+  float max_normalized_cross_correlation() const {
+    return max_normalized_cross_correlation_;
+  }
+  // Returns the smallest delay with the largest positive normalized cross
+  // correlation, or -1 if no estimate is positive. This is a linear search over
+  // all delays.
+  int BestDelay() const;
+
+  float normalized_cross_correlation(size_t delay) const {
+    return normalized_cross_correlations_[delay];
+  }
+  float covariance(size_t delay) const { return covariances_[delay]; }
+  size_t num_delays() const { return covariances_.size(); }
+
+  // Resets the estimated values to zero.
+  void Clear();
+
+ private:
+  const VectorMathOptimization optimization_;
+  // Estimates of the covariance values, one per delay.
+  std::vector<float> covariances_;
+  std::vector<float> normalized_cross_correlations_;
+  float max_normalized_cross_correlation_ = 0.f;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_ECHO_DETECTOR_NORMALIZED_COVARIANCE_BANK_H_
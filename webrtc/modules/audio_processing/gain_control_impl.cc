@@ -44,25 +44,19 @@ bool UseLegacyDigitalGainApplier() {
   return field_trial::IsEnabled("WebRTC-UseLegacyDigitalGainApplier");
 }
 
-// Floating point variant of WebRtcAgc_Process.
-void ApplyDigitalGain(const int32_t gains[11],
+// Floating point variant of WebRtcAgc_Process, applying the linear gains
+// produced by WebRtcAgc_AnalyzeFloat.
+void ApplyDigitalGain(const float gains[11],
                       size_t num_bands,
                       float* const* out) {
-  constexpr float kScaling = 1.f / 65536.f;
   constexpr int kNumSubSections = 16;
   constexpr float kOneByNumSubSections = 1.f / kNumSubSections;
 
-  float gains_scaled[11];
-  for (int k = 0; k < 11; ++k) {
-    gains_scaled[k] = gains[k] * kScaling;
-  }
-
   for (size_t b = 0; b < num_bands; ++b) {
     float* out_band = out[b];
     for (int k = 0, sample = 0; k < 10; ++k) {
-      const float delta =
-          (gains_scaled[k + 1] - gains_scaled[k]) * kOneByNumSubSections;
-      float gain = gains_scaled[k];
+      const float delta = (gains[k + 1] - gains[k]) * kOneByNumSubSections;
+      float gain = gains[k];
       for (int n = 0; n < kNumSubSections; ++n, ++sample) {
         RTC_DCHECK_EQ(k * kNumSubSections + n, sample);
         out_band[sample] *= gain;
@@ -90,6 +84,7 @@ struct GainControlImpl::MonoAgcState {
   MonoAgcState(const MonoAgcState&) = delete;
   MonoAgcState& operator=(const MonoAgcState&) = delete;
   int32_t gains[11];
+  float float_gains[11];
   Handle* state;
 };
 
@@ -152,20 +147,20 @@ int GainControlImpl::AnalyzeCaptureAudio(const AudioBuffer& audio) {
   RTC_DCHECK_EQ(audio.num_channels(), *num_proc_channels_);
   RTC_DCHECK_LE(*num_proc_channels_, mono_agcs_.size());
 
-  int16_t split_band_data[AudioBuffer::kMaxNumBands]
-                         [AudioBuffer::kMaxSplitFrameLength];
-  int16_t* split_bands[AudioBuffer::kMaxNumBands] = {
-      split_band_data[0], split_band_data[1], split_band_data[2]};
+  // Only the lowest band is used for the analysis, and the signal modified by
+  // WebRtcAgc_AddMic() and WebRtcAgc_VirtualMic() is not used further.
+  int16_t band0_data[AudioBuffer::kMaxSplitFrameLength];
+  int16_t* band0[1] = {band0_data};
 
   if (mode_ == kAdaptiveAnalog) {
     for (size_t ch = 0; ch < mono_agcs_.size(); ++ch) {
       capture_levels_[ch] = analog_capture_level_;
 
-      audio.ExportSplitChannelData(ch, split_bands);
+      FloatS16ToS16(audio.split_bands_const(ch)[kBand0To8kHz],
+                    audio.num_frames_per_band(), band0_data);
 
-      int err =
-          WebRtcAgc_AddMic(mono_agcs_[ch]->state, split_bands,
-                           audio.num_bands(), audio.num_frames_per_band());
+      int err = WebRtcAgc_AddMic(mono_agcs_[ch]->state, band0, 1,
+                                 audio.num_frames_per_band());
 
       if (err != AudioProcessing::kNoError) {
         return AudioProcessing::kUnspecifiedError;
@@ -175,12 +170,12 @@ int GainControlImpl::AnalyzeCaptureAudio(const AudioBuffer& audio) {
     for (size_t ch = 0; ch < mono_agcs_.size(); ++ch) {
       int32_t capture_level_out = 0;
 
-      audio.ExportSplitChannelData(ch, split_bands);
+      FloatS16ToS16(audio.split_bands_const(ch)[kBand0To8kHz],
+                    audio.num_frames_per_band(), band0_data);
 
-      int err =
-          WebRtcAgc_VirtualMic(mono_agcs_[ch]->state, split_bands,
-                               audio.num_bands(), audio.num_frames_per_band(),
-                               analog_capture_level_, &capture_level_out);
+      int err = WebRtcAgc_VirtualMic(
+          mono_agcs_[ch]->state, band0, 1, audio.num_frames_per_band(),
+          analog_capture_level_, &capture_level_out);
 
       capture_levels_[ch] = capture_level_out;
 
@@ -206,37 +201,39 @@ int GainControlImpl::ProcessCaptureAudio(AudioBuffer* audio,
 
   stream_is_saturated_ = false;
   bool error_reported = false;
-  for (size_t ch = 0; ch < mono_agcs_.size(); ++ch) {
-    int16_t split_band_data[AudioBuffer::kMaxNumBands]
-                           [AudioBuffer::kMaxSplitFrameLength];
-    int16_t* split_bands[AudioBuffer::kMaxNumBands] = {
-        split_band_data[0], split_band_data[1], split_band_data[2]};
-    audio->ExportSplitChannelData(ch, split_bands);
-
-    // The call to stream_has_echo() is ok from a deadlock perspective
-    // as the capture lock is allready held.
-    int32_t new_capture_level = 0;
-    uint8_t saturation_warning = 0;
-    int err_analyze = WebRtcAgc_Analyze(
-        mono_agcs_[ch]->state, split_bands, audio->num_bands(),
-        audio->num_frames_per_band(), capture_levels_[ch], &new_capture_level,
-        stream_has_echo, &saturation_warning, mono_agcs_[ch]->gains);
-    capture_levels_[ch] = new_capture_level;
-
-    error_reported = error_reported || err_analyze != AudioProcessing::kNoError;
-
-    stream_is_saturated_ = stream_is_saturated_ || saturation_warning == 1;
-  }
+  if (use_legacy_gain_applier_) {
+    for (size_t ch = 0; ch < mono_agcs_.size(); ++ch) {
+      int16_t split_band_data[AudioBuffer::kMaxNumBands]
+                             [AudioBuffer::kMaxSplitFrameLength];
+      int16_t* split_bands[AudioBuffer::kMaxNumBands] = {
+          split_band_data[0], split_band_data[1], split_band_data[2]};
+      audio->ExportSplitChannelData(ch, split_bands);
 
-  // Choose the minimun gain for application
-  size_t index_to_apply = 0;
-  for (size_t ch = 1; ch < mono_agcs_.size(); ++ch) {
-    if (mono_agcs_[index_to_apply]->gains[10] < mono_agcs_[ch]->gains[10]) {
-      index_to_apply = ch;
+      // The call to stream_has_echo() is ok from a deadlock perspective
+      // as the capture lock is allready held.
+      int32_t new_capture_level = 0;
+      uint8_t saturation_warning = 0;
+      int err_analyze = WebRtcAgc_Analyze(
+          mono_agcs_[ch]->state, split_bands, audio->num_bands(),
+          audio->num_frames_per_band(), capture_levels_[ch],
+          &new_capture_level, stream_has_echo, &saturation_warning,
+          mono_agcs_[ch]->gains);
+      capture_levels_[ch] = new_capture_level;
+
+      error_reported =
+          error_reported || err_analyze != AudioProcessing::kNoError;
+
+      stream_is_saturated_ = stream_is_saturated_ || saturation_warning == 1;
+    }
+
+    // Choose the minimun gain for application
+    size_t index_to_apply = 0;
+    for (size_t ch = 1; ch < mono_agcs_.size(); ++ch) {
+      if (mono_agcs_[index_to_apply]->gains[10] < mono_agcs_[ch]->gains[10]) {
+        index_to_apply = ch;
+      }
     }
-  }
 
-  if (use_legacy_gain_applier_) {
     for (size_t ch = 0; ch < mono_agcs_.size(); ++ch) {
       int16_t split_band_data[AudioBuffer::kMaxNumBands]
                              [AudioBuffer::kMaxSplitFrameLength];
@@ -252,9 +249,35 @@ int GainControlImpl::ProcessCaptureAudio(AudioBuffer* audio,
       audio->ImportSplitChannelData(ch, split_bands);
     }
   } else {
+    // The gains are computed directly from the floating point lowest band.
+    for (size_t ch = 0; ch < mono_agcs_.size(); ++ch) {
+      int32_t new_capture_level = 0;
+      uint8_t saturation_warning = 0;
+      int err_analyze = WebRtcAgc_AnalyzeFloat(
+          mono_agcs_[ch]->state, audio->split_bands_const(ch)[kBand0To8kHz],
+          audio->num_frames_per_band(), capture_levels_[ch],
+          &new_capture_level, stream_has_echo, &saturation_warning,
+          mono_agcs_[ch]->float_gains);
+      capture_levels_[ch] = new_capture_level;
+
+      error_reported =
+          error_reported || err_analyze != AudioProcessing::kNoError;
+
+      stream_is_saturated_ = stream_is_saturated_ || saturation_warning == 1;
+    }
+
+    // Choose the minimun gain for application
+    size_t index_to_apply = 0;
+    for (size_t ch = 1; ch < mono_agcs_.size(); ++ch) {
+      if (mono_agcs_[index_to_apply]->float_gains[10] <
+          mono_agcs_[ch]->float_gains[10]) {
+        index_to_apply = ch;
+      }
+    }
+
     for (size_t ch = 0; ch < mono_agcs_.size(); ++ch) {
-      ApplyDigitalGain(mono_agcs_[index_to_apply]->gains, audio->num_bands(),
-                       audio->split_bands(ch));
+      ApplyDigitalGain(mono_agcs_[index_to_apply]->float_gains,
+                       audio->num_bands(), audio->split_bands(ch));
     }
   }
 
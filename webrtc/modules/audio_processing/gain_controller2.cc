@@ -75,6 +75,7 @@ void GainController2::ApplyConfig(
     limiter_.Reset();
   }
   gain_applier_.SetGainFactor(DbToRatio(config_.fixed_digital.gain_db));
+  limiter_.SetLookaheadMs(config_.limiter.lookahead_ms);
   if (config_.adaptive_digital.enabled) {
     adaptive_agc_.reset(new AdaptiveAgc(data_dumper_.get(), config_));
   } else {
@@ -86,6 +87,8 @@ bool GainController2::Validate(
     const AudioProcessing::Config::GainController2& config) {
   return config.fixed_digital.gain_db >= 0.f &&
          config.fixed_digital.gain_db < 50.f &&
+         config.limiter.lookahead_ms >= 0 &&
+         config.limiter.lookahead_ms <= LimiterLookahead::kMaxLookaheadMs &&
          config.adaptive_digital.extra_saturation_margin_db >= 0.f &&
          config.adaptive_digital.extra_saturation_margin_db <= 100.f;
 }
@@ -109,6 +112,7 @@ std::string GainController2::ToString(
   ss << "{"
         "enabled: " << (config.enabled ? "true" : "false") << ", "
         "fixed_digital: {gain_db: " << config.fixed_digital.gain_db << "}, "
+        "limiter: {lookahead_ms: " << config.limiter.lookahead_ms << "}, "
         "adaptive_digital: {"
           "enabled: "
             << (config.adaptive_digital.enabled ? "true" : "false") << ", "
@@ -36,6 +36,9 @@ class GainController2 {
   void Process(AudioBuffer* audio);
   void NotifyAnalogLevel(int level);
 
+  // Returns the delay, in milliseconds, added by the limiter lookahead.
+  int delay_ms() const { return limiter_.lookahead_ms(); }
+
   void ApplyConfig(const AudioProcessing::Config::GainController2& config);
   static bool Validate(const AudioProcessing::Config::GainController2& config);
   static std::string ToString(
@@ -81,18 +81,25 @@ std::string AudioProcessing::Config::ToString() const {
           << ", "
              ", multi_channel_capture: "
           << pipeline.multi_channel_capture
-          << "}, "
+          << ", low_latency_resampling: { enabled: "
+          << pipeline.low_latency_resampling.enabled
+          << ", kernel_size: " << pipeline.low_latency_resampling.kernel_size
+          << " }}, "
              "pre_amplifier: { enabled: "
           << pre_amplifier.enabled
           << ", fixed_gain_factor: " << pre_amplifier.fixed_gain_factor
           << " }, high_pass_filter: { enabled: " << high_pass_filter.enabled
           << " }, echo_canceller: { enabled: " << echo_canceller.enabled
           << ", mobile_mode: " << echo_canceller.mobile_mode
+          << ", mobile_delay_history_blocks: "
+          << echo_canceller.mobile_delay_history_blocks
           << ", enforce_high_pass_filtering: "
           << echo_canceller.enforce_high_pass_filtering
           << " }, noise_suppression: { enabled: " << noise_suppression.enabled
           << ", level: "
           << NoiseSuppressionLevelToString(noise_suppression.level)
+          << ", low_latency: " << noise_suppression.low_latency
+          << ", apply_in_full_band: " << noise_suppression.apply_in_full_band
           << " }, transient_suppression: { enabled: "
           << transient_suppression.enabled
           << " }, voice_detection: { enabled: " << voice_detection.enabled
@@ -106,6 +113,8 @@ std::string AudioProcessing::Config::ToString() const {
           << " }, gain_controller2: { enabled: " << gain_controller2.enabled
           << ", fixed_digital: { gain_db: "
           << gain_controller2.fixed_digital.gain_db
+          << " }, limiter: { lookahead_ms: "
+          << gain_controller2.limiter.lookahead_ms
           << " }, adaptive_digital: { enabled: "
           << gain_controller2.adaptive_digital.enabled << ", level_estimator: "
           << GainController2LevelEstimatorToString(
@@ -226,6 +226,16 @@ class RTC_EXPORT AudioProcessing : public rtc::RefCountInterface {
       // Allow multi-channel processing of capture audio when AEC3 is active
       // or a custom AEC is injected..
       bool multi_channel_capture = false;
+      // Resample between the API and the processing rates with a short
+      // windowed sinc() kernel that produces each output sample as soon as its
+      // input is available, instead of the 32 tap block-based SincResampler.
+      // This lowers the resampling delay to |kernel_size| / 2 input samples at
+      // the cost of a wider transition band. |kernel_size| must be a multiple
+      // of 4 between 4 and 32.
+      struct LowLatencyResampling {
+        bool enabled = false;
+        int kernel_size = 8;
+      } low_latency_resampling;
     } pipeline;
 
     // Enabled the pre-amplifier. It amplifies the capture signal
@@ -243,6 +253,11 @@ class RTC_EXPORT AudioProcessing : public rtc::RefCountInterface {
     struct EchoCanceller {
       bool enabled = false;
       bool mobile_mode = false;
+      // Number of render blocks over which the mobile mode searches for the
+      // echo delay. A block is 64 samples at the processing rate of the mobile
+      // mode, 4 ms at 16 kHz. Longer histories handle devices with larger or
+      // more variable output latencies, at a higher cost.
+      int mobile_delay_history_blocks = 100;
       bool export_linear_aec_output = false;
       // Enforce the highpass filter to be on (has no effect for the mobile
       // mode).
@@ -255,6 +270,15 @@ class RTC_EXPORT AudioProcessing : public rtc::RefCountInterface {
       enum Level { kLow, kModerate, kHigh, kVeryHigh };
       Level level = kModerate;
       bool analyze_linear_aec_output_when_available = false;
+      // Uses shorter analysis and synthesis windows, reducing the algorithmic
+      // delay of the noise suppressor from 6 ms to 2 ms. The delay is reported
+      // in |AudioProcessingStats::noise_suppression_delay_ms|.
+      bool low_latency = false;
+      // At 48 kHz, lets the noise suppressor operate directly on the full-band
+      // signal when no other enabled submodule requires the signal to be split
+      // into frequency bands. This avoids the cost of the band-splitting and
+      // band-merging filter banks.
+      bool apply_in_full_band = false;
     } noise_suppression;
 
     // Enables transient suppression.
@@ -343,6 +367,14 @@ class RTC_EXPORT AudioProcessing : public rtc::RefCountInterface {
       struct {
         float gain_db = 0.f;
       } fixed_digital;
+      // The limiter can look ahead at the signal to avoid overshooting on
+      // abrupt level increases, which allows higher gains without clipping.
+      // This delays the output by |lookahead_ms|, which must be in [0, 5]; the
+      // delay is reported in
+      // |AudioProcessingStats::gain_controller2_delay_ms|.
+      struct {
+        int lookahead_ms = 0;
+      } limiter;
       struct {
         bool enabled = false;
         float vad_probability_attack = 1.f;
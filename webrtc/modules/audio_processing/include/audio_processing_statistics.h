@@ -66,6 +66,17 @@ struct RTC_EXPORT AudioProcessingStats {
   // milliseconds and the value is the instantaneous value at the time of the
   // call to |GetStatistics()|.
   absl::optional<int32_t> delay_ms;
+
+  // The algorithmic delay, in milliseconds, added by the noise suppressor
+  // through the overlap of its analysis and synthesis windows. The noise
+  // suppressor has no lookahead beyond this delay.
+  // Only reported if noise suppression is enabled in AudioProcessing::Config.
+  absl::optional<int32_t> noise_suppression_delay_ms;
+
+  // The delay, in milliseconds, added by the lookahead of the AGC2 limiter.
+  // Only reported if the gain controller 2 is enabled in
+  // AudioProcessing::Config.
+  absl::optional<int32_t> gain_controller2_delay_ms;
 };
 
 }  // namespace webrtc
@@ -11,29 +11,169 @@
 #include "modules/audio_processing/ns/fast_math.h"
 
 #include <math.h>
-#include <stdint.h>
 
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
+#include "common_audio/vector_math.h"
+#include "modules/audio_processing/ns/fast_math_internal.h"
 #include "rtc_base/checks.h"
 
 namespace webrtc {
 
 namespace {
 
-float FastLog2f(float in) {
-  RTC_DCHECK_GT(in, .0f);
-  // Read and interpret float as uint32_t and then cast to float.
-  // This is done to extract the exponent (bits 30 - 23).
-  // "Right shift" of the exponent is then performed by multiplying
-  // with the constant (1/2^23). Finally, we subtract a constant to
-  // remove the bias (https://en.wikipedia.org/wiki/Exponent_bias).
-  union {
-    float dummy;
-    uint32_t a;
-  } x = {in};
-  float out = x.a;
-  out *= 1.1920929e-7f;  // 1/2^23
-  out -= 126.942695f;    // Remove bias.
-  return out;
+using fast_math_internal::FastLog2f;
+using fast_math_internal::kMaxPow2Argument;
+using fast_math_internal::kMinPow2Argument;
+using fast_math_internal::kPow2Coefficients;
+
+// Returns the optimization to use for the array approximations. The CPU
+// features are only detected once.
+VectorMathOptimization GetOptimization() {
+  static const VectorMathOptimization optimization =
+      DetectVectorMathOptimization();
+  return optimization;
+}
+
+constexpr float kLogOf2 = 0.69314718056f;
+constexpr float kLog10Ofe = 0.4342944819f;
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Vectorized counterpart of FastLog2f.
+__m128 FastLog2Sse2(__m128 x) {
+  __m128 out = _mm_cvtepi32_ps(_mm_castps_si128(x));
+  out = _mm_mul_ps(out, _mm_set1_ps(1.1920929e-7f));
+  return _mm_sub_ps(out, _mm_set1_ps(126.942695f));
+}
+
+// Computes 2^p by splitting p into an integer part, which is applied to the
+// exponent, and a fractional part which is approximated by a polynomial.
+__m128 Pow2Sse2(__m128 p) {
+  p = _mm_min_ps(_mm_max_ps(p, _mm_set1_ps(kMinPow2Argument)),
+                 _mm_set1_ps(kMaxPow2Argument));
+  const __m128i n = _mm_cvtps_epi32(p);
+  const __m128 f = _mm_sub_ps(p, _mm_cvtepi32_ps(n));
+  __m128 poly = _mm_set1_ps(kPow2Coefficients[0]);
+  for (size_t k = 1; k < 6; ++k) {
+    poly = _mm_add_ps(_mm_mul_ps(poly, f), _mm_set1_ps(kPow2Coefficients[k]));
+  }
+  poly = _mm_add_ps(_mm_mul_ps(poly, f), _mm_set1_ps(1.f));
+  const __m128i exponent =
+      _mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23);
+  return _mm_mul_ps(poly, _mm_castsi128_ps(exponent));
+}
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+// Vectorized counterpart of FastLog2f.
+float32x4_t FastLog2Neon(float32x4_t x) {
+  float32x4_t out = vcvtq_f32_s32(vreinterpretq_s32_f32(x));
+  out = vmulq_n_f32(out, 1.1920929e-7f);
+  return vsubq_f32(out, vdupq_n_f32(126.942695f));
+}
+
+// Computes 2^p by splitting p into an integer part, which is applied to the
+// exponent, and a fractional part which is approximated by a polynomial.
+float32x4_t Pow2Neon(float32x4_t p) {
+  p = vminq_f32(vmaxq_f32(p, vdupq_n_f32(kMinPow2Argument)),
+                vdupq_n_f32(kMaxPow2Argument));
+  // Round to nearest by flooring p + 0.5, where the flooring is done by
+  // truncation followed by a correction for negative non-integer values.
+  const float32x4_t p_plus_half = vaddq_f32(p, vdupq_n_f32(0.5f));
+  int32x4_t n = vcvtq_s32_f32(p_plus_half);
+  const uint32x4_t too_large = vcgtq_f32(vcvtq_f32_s32(n), p_plus_half);
+  n = vsubq_s32(n, vreinterpretq_s32_u32(vandq_u32(too_large, vdupq_n_u32(1))));
+  const float32x4_t f = vsubq_f32(p, vcvtq_f32_s32(n));
+  float32x4_t poly = vdupq_n_f32(kPow2Coefficients[0]);
+  for (size_t k = 1; k < 6; ++k) {
+    poly = vmlaq_f32(vdupq_n_f32(kPow2Coefficients[k]), poly, f);
+  }
+  poly = vmlaq_f32(vdupq_n_f32(1.f), poly, f);
+  const int32x4_t exponent = vshlq_n_s32(vaddq_s32(n, vdupq_n_s32(127)), 23);
+  return vmulq_f32(poly, vreinterpretq_f32_s32(exponent));
+}
+#endif
+
+// Computes y = scale * log2(x) for an array.
+void ScaledLog2Approximation(rtc::ArrayView<const float> x,
+                             float scale,
+                             rtc::ArrayView<float> y) {
+  RTC_DCHECK_EQ(y.size(), x.size());
+  const int size = static_cast<int>(x.size());
+  int j = 0;
+  switch (GetOptimization()) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case VectorMathOptimization::kAvx2:
+      fast_math_avx2::Log2Approximation(x, scale, y);
+      return;
+    case VectorMathOptimization::kSse2: {
+      const __m128 scale_v = _mm_set1_ps(scale);
+      for (; j + 4 <= size; j += 4) {
+        const __m128 x_j = _mm_loadu_ps(&x[j]);
+        _mm_storeu_ps(&y[j], _mm_mul_ps(FastLog2Sse2(x_j), scale_v));
+      }
+    } break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case VectorMathOptimization::kNeon:
+      for (; j + 4 <= size; j += 4) {
+        const float32x4_t x_j = vld1q_f32(&x[j]);
+        vst1q_f32(&y[j], vmulq_n_f32(FastLog2Neon(x_j), scale));
+      }
+      break;
+#endif
+    default:
+      break;
+  }
+
+  for (; j < size; ++j) {
+    y[j] = FastLog2f(x[j]) * scale;
+  }
+}
+
+// Computes y = 2^(scale * x) for an array.
+void ScaledPow2Approximation(rtc::ArrayView<const float> x,
+                             float scale,
+                             rtc::ArrayView<float> y) {
+  RTC_DCHECK_EQ(y.size(), x.size());
+  const int size = static_cast<int>(x.size());
+  int j = 0;
+  switch (GetOptimization()) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case VectorMathOptimization::kAvx2:
+      fast_math_avx2::Pow2Approximation(x, scale, y);
+      return;
+    case VectorMathOptimization::kSse2: {
+      const __m128 scale_v = _mm_set1_ps(scale);
+      for (; j + 4 <= size; j += 4) {
+        const __m128 x_j = _mm_loadu_ps(&x[j]);
+        _mm_storeu_ps(&y[j], Pow2Sse2(_mm_mul_ps(x_j, scale_v)));
+      }
+    } break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case VectorMathOptimization::kNeon:
+      for (; j + 4 <= size; j += 4) {
+        const float32x4_t x_j = vld1q_f32(&x[j]);
+        vst1q_f32(&y[j], Pow2Neon(vmulq_n_f32(x_j, scale)));
+      }
+      break;
+#endif
+    default:
+      break;
+  }
+
+  for (; j < size; ++j) {
+    y[j] = Pow2Approximation(scale * x[j]);
+  }
 }
 
 }  // namespace
@@ -52,33 +192,37 @@ float PowApproximation(float x, float p) {
   return Pow2Approximation(p * FastLog2f(x));
 }
 
+void PowApproximation(rtc::ArrayView<const float> x,
+                      float p,
+                      rtc::ArrayView<float> y) {
+  RTC_DCHECK_EQ(y.size(), x.size());
+  if (GetOptimization() == VectorMathOptimization::kAvx2) {
+    fast_math_avx2::PowApproximation(x, p, y);
+    return;
+  }
+  ScaledLog2Approximation(x, 1.f, y);
+  ScaledPow2Approximation(y, p, y);
+}
+
 float LogApproximation(float x) {
-  constexpr float kLogOf2 = 0.69314718056f;
   return FastLog2f(x) * kLogOf2;
 }
 
 void LogApproximation(rtc::ArrayView<const float> x, rtc::ArrayView<float> y) {
-  for (size_t k = 0; k < x.size(); ++k) {
-    y[k] = LogApproximation(x[k]);
-  }
+  ScaledLog2Approximation(x, kLogOf2, y);
 }
 
 float ExpApproximation(float x) {
-  constexpr float kLog10Ofe = 0.4342944819f;
   return PowApproximation(10.f, x * kLog10Ofe);
 }
 
 void ExpApproximation(rtc::ArrayView<const float> x, rtc::ArrayView<float> y) {
-  for (size_t k = 0; k < x.size(); ++k) {
-    y[k] = ExpApproximation(x[k]);
-  }
+  ScaledPow2Approximation(x, kLog10Ofe * FastLog2f(10.f), y);
 }
 
 void ExpApproximationSignFlip(rtc::ArrayView<const float> x,
                               rtc::ArrayView<float> y) {
-  for (size_t k = 0; k < x.size(); ++k) {
-    y[k] = ExpApproximation(-x[k]);
-  }
+  ScaledPow2Approximation(x, -kLog10Ofe * FastLog2f(10.f), y);
 }
 
 }  // namespace webrtc
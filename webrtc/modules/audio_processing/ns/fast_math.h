@@ -27,12 +27,37 @@ float Pow2Approximation(float p);
 
 // x^p approximation.
 float PowApproximation(float x, float p);
+void PowApproximation(rtc::ArrayView<const float> x,
+                      float p,
+                      rtc::ArrayView<float> y);
 
 // e^x approximation.
 float ExpApproximation(float x);
 void ExpApproximation(rtc::ArrayView<const float> x, rtc::ArrayView<float> y);
 void ExpApproximationSignFlip(rtc::ArrayView<const float> x,
                               rtc::ArrayView<float> y);
+
+// AVX2 implementations of the array approximations above, selected at runtime
+// when the CPU supports them. The vectorized 2^x approximation is accurate to
+// within a relative error of about 2e-7 of the scalar implementation.
+namespace fast_math_avx2 {
+
+// y = scale * log2(x), using the bit-pattern based log2 approximation.
+void Log2Approximation(rtc::ArrayView<const float> x,
+                       float scale,
+                       rtc::ArrayView<float> y);
+
+// y = 2^(scale * x).
+void Pow2Approximation(rtc::ArrayView<const float> x,
+                       float scale,
+                       rtc::ArrayView<float> y);
+
+// y = x^p.
+void PowApproximation(rtc::ArrayView<const float> x,
+                      float p,
+                      rtc::ArrayView<float> y);
+
+}  // namespace fast_math_avx2
 }  // namespace webrtc
 
 #endif  // MODULES_AUDIO_PROCESSING_NS_FAST_MATH_H_
@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+
+#include "api/array_view.h"
+#include "modules/audio_processing/ns/fast_math.h"
+#include "modules/audio_processing/ns/fast_math_internal.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace fast_math_avx2 {
+
+namespace {
+
+using fast_math_internal::FastLog2f;
+using fast_math_internal::kMaxPow2Argument;
+using fast_math_internal::kMinPow2Argument;
+using fast_math_internal::kPow2Coefficients;
+
+__m256 FastLog2(__m256 x) {
+  __m256 out = _mm256_cvtepi32_ps(_mm256_castps_si256(x));
+  out = _mm256_mul_ps(out, _mm256_set1_ps(1.1920929e-7f));
+  return _mm256_sub_ps(out, _mm256_set1_ps(126.942695f));
+}
+
+__m256 Pow2(__m256 p) {
+  p = _mm256_min_ps(_mm256_max_ps(p, _mm256_set1_ps(kMinPow2Argument)),
+                    _mm256_set1_ps(kMaxPow2Argument));
+  const __m256 n = _mm256_round_ps(p, _MM_FROUND_TO_NEAREST_INT |
+                                          _MM_FROUND_NO_EXC);
+  const __m256 f = _mm256_sub_ps(p, n);
+  __m256 poly = _mm256_set1_ps(kPow2Coefficients[0]);
+  for (size_t k = 1; k < 6; ++k) {
+    poly = _mm256_fmadd_ps(poly, f, _mm256_set1_ps(kPow2Coefficients[k]));
+  }
+  poly = _mm256_fmadd_ps(poly, f, _mm256_set1_ps(1.f));
+  const __m256i exponent = _mm256_slli_epi32(
+      _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23);
+  return _mm256_mul_ps(poly, _mm256_castsi256_ps(exponent));
+}
+
+}  // namespace
+
+void Log2Approximation(rtc::ArrayView<const float> x,
+                       float scale,
+                       rtc::ArrayView<float> y) {
+  RTC_DCHECK_EQ(y.size(), x.size());
+  const int size = static_cast<int>(x.size());
+  const __m256 scale_v = _mm256_set1_ps(scale);
+  int j = 0;
+  for (; j + 8 <= size; j += 8) {
+    const __m256 x_j = _mm256_loadu_ps(&x[j]);
+    _mm256_storeu_ps(&y[j], _mm256_mul_ps(FastLog2(x_j), scale_v));
+  }
+
+  for (; j < size; ++j) {
+    y[j] = FastLog2f(x[j]) * scale;
+  }
+}
+
+void Pow2Approximation(rtc::ArrayView<const float> x,
+                       float scale,
+                       rtc::ArrayView<float> y) {
+  RTC_DCHECK_EQ(y.size(), x.size());
+  const int size = static_cast<int>(x.size());
+  const __m256 scale_v = _mm256_set1_ps(scale);
+  int j = 0;
+  for (; j + 8 <= size; j += 8) {
+    const __m256 x_j = _mm256_loadu_ps(&x[j]);
+    _mm256_storeu_ps(&y[j], Pow2(_mm256_mul_ps(x_j, scale_v)));
+  }
+
+  for (; j < size; ++j) {
+    y[j] = webrtc::Pow2Approximation(scale * x[j]);
+  }
+}
+
+void PowApproximation(rtc::ArrayView<const float> x,
+                      float p,
+                      rtc::ArrayView<float> y) {
+  RTC_DCHECK_EQ(y.size(), x.size());
+  const int size = static_cast<int>(x.size());
+  const __m256 p_v = _mm256_set1_ps(p);
+  int j = 0;
+  for (; j + 8 <= size; j += 8) {
+    const __m256 x_j = _mm256_loadu_ps(&x[j]);
+    _mm256_storeu_ps(&y[j], Pow2(_mm256_mul_ps(FastLog2(x_j), p_v)));
+  }
+
+  for (; j < size; ++j) {
+    y[j] = webrtc::PowApproximation(x[j], p);
+  }
+}
+
+}  // namespace fast_math_avx2
+}  // namespace webrtc
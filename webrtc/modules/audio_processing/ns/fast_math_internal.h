@@ -0,0 +1,52 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_NS_FAST_MATH_INTERNAL_H_
+#define MODULES_AUDIO_PROCESSING_NS_FAST_MATH_INTERNAL_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include "rtc_base/checks.h"
+
+// Helpers shared by the generic and the AVX2 implementations of the NS fast
+// math approximations.
+namespace webrtc {
+namespace fast_math_internal {
+
+// Range of the argument of the vectorized 2^x approximation, chosen to keep
+// the result a normal float.
+constexpr float kMinPow2Argument = -126.f;
+constexpr float kMaxPow2Argument = 127.f;
+
+// Polynomial approximation of 2^x - 1 on [-0.5, 0.5], taken from Cephes.
+constexpr float kPow2Coefficients[] = {
+    1.535336188319500e-4f, 1.339887440266574e-3f, 9.618437357674640e-3f,
+    5.550332471162809e-2f, 2.402264791363012e-1f, 6.931472028550421e-1f};
+
+inline float FastLog2f(float in) {
+  RTC_DCHECK_GT(in, .0f);
+  // Read and interpret float as uint32_t and then cast to float.
+  // This is done to extract the exponent (bits 30 - 23).
+  // "Right shift" of the exponent is then performed by multiplying
+  // with the constant (1/2^23). Finally, we subtract a constant to
+  // remove the bias (https://en.wikipedia.org/wiki/Exponent_bias).
+  uint32_t a;
+  memcpy(&a, &in, sizeof(a));
+  float out = a;
+  out *= 1.1920929e-7f;  // 1/2^23
+  out -= 126.942695f;    // Remove bias.
+  return out;
+}
+
+}  // namespace fast_math_internal
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_NS_FAST_MATH_INTERNAL_H_
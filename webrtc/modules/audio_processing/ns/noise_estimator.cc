@@ -69,11 +69,13 @@ void NoiseEstimator::PreUpdate(
     float sum_log_i = 0.f;
     float sum_log_i_square = 0.f;
     float sum_log_magn = 0.f;
+    std::array<float, kFftSizeBy2Plus1 - kStartBand> log_signal_spectrum;
+    LogApproximation(signal_spectrum.subview(kStartBand), log_signal_spectrum);
     for (size_t i = kStartBand; i < kFftSizeBy2Plus1; ++i) {
       float log_i = log_table[i];
       sum_log_i += log_i;
       sum_log_i_square += log_i * log_i;
-      float log_signal = LogApproximation(signal_spectrum[i]);
+      float log_signal = log_signal_spectrum[i - kStartBand];
       sum_log_magn += log_signal;
       sum_log_i_log_magn += log_i * log_signal;
     }
@@ -120,18 +122,22 @@ void NoiseEstimator::PreUpdate(
 
     constexpr float kOneByShortStartupPhaseBlocks =
         1.f / kShortStartupPhaseBlocks;
-    for (size_t i = 0; i < kFftSizeBy2Plus1; ++i) {
-      // Estimate the background noise using the white and pink noise
-      // parameters.
-      if (pink_noise_exp_ == 0.f) {
-        // Use white noise estimate.
-        parametric_noise_spectrum_[i] = white_noise_level_;
-      } else {
-        // Use pink noise estimate.
-        float use_band = i < kStartBand ? kStartBand : i;
-        float denom = PowApproximation(use_band, parametric_exp);
-        RTC_DCHECK_NE(denom, 0.f);
-        parametric_noise_spectrum_[i] = parametric_num / denom;
+    // Estimate the background noise using the white and pink noise
+    // parameters.
+    if (pink_noise_exp_ == 0.f) {
+      // Use white noise estimate.
+      parametric_noise_spectrum_.fill(white_noise_level_);
+    } else {
+      // Use pink noise estimate.
+      std::array<float, kFftSizeBy2Plus1> use_band;
+      for (size_t i = 0; i < kFftSizeBy2Plus1; ++i) {
+        use_band[i] = i < kStartBand ? kStartBand : i;
+      }
+      std::array<float, kFftSizeBy2Plus1> denom;
+      PowApproximation(use_band, parametric_exp, denom);
+      for (size_t i = 0; i < kFftSizeBy2Plus1; ++i) {
+        RTC_DCHECK_NE(denom[i], 0.f);
+        parametric_noise_spectrum_[i] = parametric_num / denom[i];
       }
     }
 
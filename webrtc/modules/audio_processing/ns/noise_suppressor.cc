@@ -15,7 +15,7 @@
 #include <string.h>
 #include <algorithm>
 
-#include "modules/audio_processing/ns/fast_math.h"
+#include "common_audio/vector_math.h"
 #include "rtc_base/checks.h"
 
 namespace webrtc {
@@ -29,22 +29,6 @@ size_t NumBandsForRate(size_t sample_rate_hz) {
   return sample_rate_hz / 16000;
 }
 
-// Maximum number of channels for which the channel data is stored on
-// the stack. If the number of channels are larger than this, they are stored
-// using scratch memory that is pre-allocated on the heap. The reason for this
-// partitioning is not to waste heap space for handling the more common numbers
-// of channels, while at the same time not limiting the support for higher
-// numbers of channels by enforcing the channel data to be stored on the
-// stack using a fixed maximum value.
-constexpr size_t kMaxNumChannelsOnStack = 2;
-
-// Chooses the number of channels to store on the heap when that is required due
-// to the number of channels being larger than the pre-defined number
-// of channels to store on the stack.
-size_t NumChannelsOnHeap(size_t num_channels) {
-  return num_channels > kMaxNumChannelsOnStack ? num_channels : 0;
-}
-
 // Hybrib Hanning and flat window for the filterbank.
 constexpr std::array<float, 96> kBlocks160w256FirstHalf = {
     0.00000000f, 0.01636173f, 0.03271908f, 0.04906767f, 0.06540313f,
@@ -68,96 +52,97 @@ constexpr std::array<float, 96> kBlocks160w256FirstHalf = {
     0.99518473f, 0.99665524f, 0.99785892f, 0.99879546f, 0.99946459f,
     0.99986614f};
 
-// Applies the filterbank window to a buffer.
-void ApplyFilterBankWindow(rtc::ArrayView<float, kFftSize> x) {
-  for (size_t i = 0; i < 96; ++i) {
-    x[i] = kBlocks160w256FirstHalf[i] * x[i];
+// Hybrid Hanning and flat window for the filterbank in the low-latency mode,
+// using a shorter overlap between consecutive frames.
+constexpr std::array<float, kLowLatencyOverlapSize>
+    kBlocks160w192FirstHalf = {
+        0.00000000f, 0.04906767f, 0.09801714f, 0.14673047f, 0.19509032f,
+        0.24298018f, 0.29028468f, 0.33688985f, 0.38268343f, 0.42755509f,
+        0.47139674f, 0.51410274f, 0.55557023f, 0.59569930f, 0.63439328f,
+        0.67155895f, 0.70710678f, 0.74095113f, 0.77301045f, 0.80320753f,
+        0.83146961f, 0.85772861f, 0.88192126f, 0.90398929f, 0.92387953f,
+        0.94154407f, 0.95694034f, 0.97003125f, 0.98078528f, 0.98917651f,
+        0.99518473f, 0.99879546f};
+
+// Returns the rising half of the hybrid Hanning and flat filterbank window for
+// an overlap of |overlap_size| samples between consecutive frames.
+std::vector<float> CreateWindowFirstHalf(size_t overlap_size) {
+  if (overlap_size == kBlocks160w256FirstHalf.size()) {
+    return std::vector<float>(kBlocks160w256FirstHalf.begin(),
+                              kBlocks160w256FirstHalf.end());
+  }
+  if (overlap_size == kBlocks160w192FirstHalf.size()) {
+    return std::vector<float>(kBlocks160w192FirstHalf.begin(),
+                              kBlocks160w192FirstHalf.end());
+  }
+  constexpr double kPi = 3.14159265358979323846;
+  std::vector<float> window(overlap_size);
+  for (size_t i = 0; i < overlap_size; ++i) {
+    window[i] = static_cast<float>(sin(kPi * i / (2 * overlap_size)));
+  }
+  return window;
+}
+
+// Applies the filterbank window to a buffer. The window spans the frame and
+// its overlap with the previous frame, and any remaining samples are zeroed.
+void ApplyFilterBankWindow(rtc::ArrayView<const float> window_first_half,
+                           size_t frame_size,
+                           rtc::ArrayView<float> x) {
+  const size_t overlap_size = window_first_half.size();
+  for (size_t i = 0; i < overlap_size; ++i) {
+    x[i] = window_first_half[i] * x[i];
   }
 
-  for (size_t i = 161, k = 95; i < kFftSize; ++i, --k) {
+  const size_t window_size = frame_size + overlap_size;
+  RTC_DCHECK_LE(window_size, x.size());
+  for (size_t i = frame_size + 1, k = overlap_size - 1; i < window_size;
+       ++i, --k) {
     RTC_DCHECK_NE(0, k);
-    x[i] = kBlocks160w256FirstHalf[k] * x[i];
+    x[i] = window_first_half[k] * x[i];
   }
+  std::fill(x.begin() + window_size, x.end(), 0.f);
 }
 
 // Extends a frame with previous data.
-void FormExtendedFrame(rtc::ArrayView<const float, kNsFrameSize> frame,
-                       rtc::ArrayView<float, kFftSize - kNsFrameSize> old_data,
-                       rtc::ArrayView<float, kFftSize> extended_frame) {
+void FormExtendedFrame(rtc::ArrayView<const float> frame,
+                       rtc::ArrayView<float> old_data,
+                       rtc::ArrayView<float> extended_frame) {
   std::copy(old_data.begin(), old_data.end(), extended_frame.begin());
   std::copy(frame.begin(), frame.end(),
             extended_frame.begin() + old_data.size());
-  std::copy(extended_frame.end() - old_data.size(), extended_frame.end(),
-            old_data.begin());
+  std::copy(frame.end() - old_data.size(), frame.end(), old_data.begin());
 }
 
 // Uses overlap-and-add to produce an output frame.
-void OverlapAndAdd(rtc::ArrayView<const float, kFftSize> extended_frame,
-                   rtc::ArrayView<float, kOverlapSize> overlap_memory,
-                   rtc::ArrayView<float, kNsFrameSize> output_frame) {
-  for (size_t i = 0; i < kOverlapSize; ++i) {
+void OverlapAndAdd(rtc::ArrayView<const float> extended_frame,
+                   rtc::ArrayView<float> overlap_memory,
+                   rtc::ArrayView<float> output_frame) {
+  const size_t overlap_size = overlap_memory.size();
+  const size_t frame_size = output_frame.size();
+  for (size_t i = 0; i < overlap_size; ++i) {
     output_frame[i] = overlap_memory[i] + extended_frame[i];
   }
-  std::copy(extended_frame.begin() + kOverlapSize,
-            extended_frame.begin() + kNsFrameSize,
-            output_frame.begin() + kOverlapSize);
-  std::copy(extended_frame.begin() + kNsFrameSize, extended_frame.end(),
+  std::copy(extended_frame.begin() + overlap_size,
+            extended_frame.begin() + frame_size,
+            output_frame.begin() + overlap_size);
+  std::copy(extended_frame.begin() + frame_size,
+            extended_frame.begin() + frame_size + overlap_size,
             overlap_memory.begin());
 }
 
-// Produces a delayed frame.
+// Produces a frame delayed by the size of the delay buffer.
 void DelaySignal(rtc::ArrayView<const float, kNsFrameSize> frame,
-                 rtc::ArrayView<float, kFftSize - kNsFrameSize> delay_buffer,
+                 rtc::ArrayView<float> delay_buffer,
                  rtc::ArrayView<float, kNsFrameSize> delayed_frame) {
-  constexpr size_t kSamplesFromFrame = kNsFrameSize - (kFftSize - kNsFrameSize);
+  const size_t samples_from_frame = kNsFrameSize - delay_buffer.size();
   std::copy(delay_buffer.begin(), delay_buffer.end(), delayed_frame.begin());
-  std::copy(frame.begin(), frame.begin() + kSamplesFromFrame,
+  std::copy(frame.begin(), frame.begin() + samples_from_frame,
             delayed_frame.begin() + delay_buffer.size());
 
-  std::copy(frame.begin() + kSamplesFromFrame, frame.end(),
+  std::copy(frame.begin() + samples_from_frame, frame.end(),
             delay_buffer.begin());
 }
 
-// Computes the energy of an extended frame.
-float ComputeEnergyOfExtendedFrame(rtc::ArrayView<const float, kFftSize> x) {
-  float energy = 0.f;
-  for (float x_k : x) {
-    energy += x_k * x_k;
-  }
-
-  return energy;
-}
-
-// Computes the energy of an extended frame based on its subcomponents.
-float ComputeEnergyOfExtendedFrame(
-    rtc::ArrayView<const float, kNsFrameSize> frame,
-    rtc::ArrayView<float, kFftSize - kNsFrameSize> old_data) {
-  float energy = 0.f;
-  for (float v : old_data) {
-    energy += v * v;
-  }
-  for (float v : frame) {
-    energy += v * v;
-  }
-
-  return energy;
-}
-
-// Computes the magnitude spectrum based on an FFT output.
-void ComputeMagnitudeSpectrum(
-    rtc::ArrayView<const float, kFftSize> real,
-    rtc::ArrayView<const float, kFftSize> imag,
-    rtc::ArrayView<float, kFftSizeBy2Plus1> signal_spectrum) {
-  signal_spectrum[0] = fabsf(real[0]) + 1.f;
-  signal_spectrum[kFftSizeBy2Plus1 - 1] =
-      fabsf(real[kFftSizeBy2Plus1 - 1]) + 1.f;
-
-  for (size_t i = 1; i < kFftSizeBy2Plus1 - 1; ++i) {
-    signal_spectrum[i] =
-        SqrtFastApproximation(real[i] * real[i] + imag[i] * imag[i]) + 1.f;
-  }
-}
-
 // Compute prior and post SNR.
 void ComputeSnr(rtc::ArrayView<const float, kFftSizeBy2Plus1> filter,
                 rtc::ArrayView<const float> prev_signal_spectrum,
@@ -239,36 +224,60 @@ float ComputeUpperBandsGain(
 
 NoiseSuppressor::ChannelState::ChannelState(
     const SuppressionParams& suppression_params,
-    size_t num_bands)
+    size_t num_delayed_bands,
+    size_t overlap_size)
     : wiener_filter(suppression_params),
       noise_estimator(suppression_params),
-      process_delay_memory(num_bands > 1 ? num_bands - 1 : 0) {
-  analyze_analysis_memory.fill(0.f);
+      analyze_analysis_memory(overlap_size, 0.f),
+      process_analysis_memory(overlap_size, 0.f),
+      process_synthesis_memory(overlap_size, 0.f),
+      process_delay_memory(num_delayed_bands,
+                           std::vector<float>(overlap_size, 0.f)) {
   prev_analysis_signal_spectrum.fill(1.f);
-  process_analysis_memory.fill(0.f);
-  process_synthesis_memory.fill(0.f);
-  for (auto& d : process_delay_memory) {
-    d.fill(0.f);
-  }
 }
 
+NoiseSuppressor::FilterBankStates::FilterBankStates(size_t num_channels,
+                                                    size_t fft_size)
+    : fft_size(fft_size),
+      real(num_channels * fft_size),
+      imag(num_channels * fft_size),
+      extended_frames(num_channels * fft_size),
+      signal_spectra(num_channels),
+      energies_before_filtering(num_channels),
+      energies_after_filtering(num_channels),
+      upper_band_gains(num_channels),
+      gain_adjustments(num_channels) {}
+
 NoiseSuppressor::NoiseSuppressor(const NsConfig& config,
                                  size_t sample_rate_hz,
                                  size_t num_channels)
     : num_bands_(NumBandsForRate(sample_rate_hz)),
       num_channels_(num_channels),
+      full_band_(config.full_band),
+      fft_size_(full_band_ ? kFullBandFftSize : kFftSize),
+      frame_size_(full_band_ ? kFullBandNsFrameSize : kNsFrameSize),
+      overlap_size_((config.low_latency ? kLowLatencyOverlapSize
+                                        : kOverlapSize) *
+                    (frame_size_ / kNsFrameSize)),
+      window_first_half_(CreateWindowFirstHalf(overlap_size_)),
       suppression_params_(config.target_level),
-      filter_bank_states_heap_(NumChannelsOnHeap(num_channels_)),
-      upper_band_gains_heap_(NumChannelsOnHeap(num_channels_)),
-      energies_before_filtering_heap_(NumChannelsOnHeap(num_channels_)),
-      gain_adjustments_heap_(NumChannelsOnHeap(num_channels_)),
+      vector_math_(DetectVectorMathOptimization()),
+      fft_(fft_size_),
+      filter_bank_states_(num_channels_, fft_size_),
       channels_(num_channels_) {
+  RTC_DCHECK(!full_band_ || sample_rate_hz == 48000);
+  const size_t num_delayed_bands = full_band_ ? 0 : num_bands_ - 1;
   for (size_t ch = 0; ch < num_channels_; ++ch) {
-    channels_[ch] =
-        std::make_unique<ChannelState>(suppression_params_, num_bands_);
+    channels_[ch] = std::make_unique<ChannelState>(
+        suppression_params_, num_delayed_bands, overlap_size_);
   }
 }
 
+int NoiseSuppressor::delay_ms() const {
+  // Each frame covers 10 ms.
+  return static_cast<int>(overlap_size_ * 10 / frame_size_);
+}
+
 void NoiseSuppressor::AggregateWienerFilters(
     rtc::ArrayView<float, kFftSizeBy2Plus1> filter) const {
   rtc::ArrayView<const float, kFftSizeBy2Plus1> filter0 =
@@ -276,13 +285,74 @@ void NoiseSuppressor::AggregateWienerFilters(
   std::copy(filter0.begin(), filter0.end(), filter.begin());
 
   for (size_t ch = 1; ch < num_channels_; ++ch) {
-    rtc::ArrayView<const float, kFftSizeBy2Plus1> filter_ch =
-        channels_[ch]->wiener_filter.get_filter();
+    vector_math_.Min(channels_[ch]->wiener_filter.get_filter(), filter);
+  }
+}
+
+rtc::ArrayView<const float> NoiseSuppressor::FilterBankFrame(
+    const AudioBuffer& audio,
+    size_t ch) const {
+  return rtc::ArrayView<const float>(
+      full_band_ ? audio.channels_const()[ch] : audio.split_bands_const(ch)[0],
+      frame_size_);
+}
 
-    for (size_t k = 0; k < kFftSizeBy2Plus1; ++k) {
-      filter[k] = std::min(filter[k], filter_ch[k]);
+void NoiseSuppressor::ComputeSpectra(bool analysis_memory_for_process,
+                                     const AudioBuffer& audio) {
+  FilterBankStates& s = filter_bank_states_;
+  for (size_t ch = 0; ch < num_channels_; ++ch) {
+    // Form an extended frame and apply analysis filter bank windowing.
+    std::vector<float>& analysis_memory =
+        analysis_memory_for_process ? channels_[ch]->process_analysis_memory
+                                    : channels_[ch]->analyze_analysis_memory;
+    FormExtendedFrame(FilterBankFrame(audio, ch), analysis_memory,
+                      s.extended_frame(ch));
+    ApplyFilterBankWindow(window_first_half_, frame_size_,
+                          s.extended_frame(ch));
+  }
+
+  if (analysis_memory_for_process && !full_band_) {
+    for (size_t ch = 0; ch < num_channels_; ++ch) {
+      s.energies_before_filtering[ch] =
+          vector_math_.SumOfSquares(s.extended_frame(ch));
     }
   }
+
+  // Perform filter bank analysis for all channels.
+  for (size_t ch = 0; ch < num_channels_; ++ch) {
+    fft_.Fft(s.extended_frame(ch), s.real_row(ch), s.imag_row(ch));
+  }
+
+  if (full_band_) {
+    // Scale the spectra to the level of the lowest band spectra that the
+    // noise suppressor models are tuned for.
+    constexpr float kFullBandSpectrumScaling =
+        static_cast<float>(kFftSize) / kFullBandFftSize;
+    vector_math_.Scale(kFullBandSpectrumScaling, s.real, s.real);
+    vector_math_.Scale(kFullBandSpectrumScaling, s.imag, s.imag);
+
+    // Compute the energies of the lowest band in the frequency domain, as the
+    // time-domain signal also contains the upper bands.
+    if (analysis_memory_for_process) {
+      for (size_t ch = 0; ch < num_channels_; ++ch) {
+        s.energies_before_filtering[ch] =
+            vector_math_.SumOfSquares(s.real_row(ch).subview(
+                0, kFftSizeBy2Plus1)) +
+            vector_math_.SumOfSquares(
+                s.imag_row(ch).subview(0, kFftSizeBy2Plus1));
+      }
+    }
+  }
+
+  // Compute the magnitude spectra. The FFT sets the imaginary parts of the
+  // first and last bins to zero, which means that those bins are computed
+  // correctly by the elementwise magnitude as well. In the full-band mode,
+  // only the bins of the lowest band are used.
+  for (size_t ch = 0; ch < num_channels_; ++ch) {
+    vector_math_.Magnitude(s.real_row(ch).subview(0, kFftSizeBy2Plus1),
+                           s.imag_row(ch).subview(0, kFftSizeBy2Plus1), 1.f,
+                           s.signal_spectra[ch]);
+  }
 }
 
 void NoiseSuppressor::Analyze(const AudioBuffer& audio) {
@@ -294,10 +364,9 @@ void NoiseSuppressor::Analyze(const AudioBuffer& audio) {
   // Check for zero frames.
   bool zero_frame = true;
   for (size_t ch = 0; ch < num_channels_; ++ch) {
-    rtc::ArrayView<const float, kNsFrameSize> y_band0(
-        &audio.split_bands_const(ch)[0][0], kNsFrameSize);
-    float energy = ComputeEnergyOfExtendedFrame(
-        y_band0, channels_[ch]->analyze_analysis_memory);
+    float energy =
+        vector_math_.SumOfSquares(channels_[ch]->analyze_analysis_memory) +
+        vector_math_.SumOfSquares(FilterBankFrame(audio, ch));
     if (energy > 0.f) {
       zero_frame = false;
       break;
@@ -321,36 +390,23 @@ void NoiseSuppressor::Analyze(const AudioBuffer& audio) {
     num_analyzed_frames_ = 0;
   }
 
+  // Compute the spectra for all channels in one pass.
+  ComputeSpectra(/*analysis_memory_for_process=*/false, audio);
+
   // Analyze all channels.
+  FilterBankStates& s = filter_bank_states_;
   for (size_t ch = 0; ch < num_channels_; ++ch) {
     std::unique_ptr<ChannelState>& ch_p = channels_[ch];
-    rtc::ArrayView<const float, kNsFrameSize> y_band0(
-        &audio.split_bands_const(ch)[0][0], kNsFrameSize);
-
-    // Form an extended frame and apply analysis filter bank windowing.
-    std::array<float, kFftSize> extended_frame;
-    FormExtendedFrame(y_band0, ch_p->analyze_analysis_memory, extended_frame);
-    ApplyFilterBankWindow(extended_frame);
-
-    // Compute the magnitude spectrum.
-    std::array<float, kFftSize> real;
-    std::array<float, kFftSize> imag;
-    fft_.Fft(extended_frame, real, imag);
-
-    std::array<float, kFftSizeBy2Plus1> signal_spectrum;
-    ComputeMagnitudeSpectrum(real, imag, signal_spectrum);
+    rtc::ArrayView<const float, kFftSizeBy2Plus1> signal_spectrum =
+        s.signal_spectra[ch];
 
     // Compute energies.
-    float signal_energy = 0.f;
-    for (size_t i = 0; i < kFftSizeBy2Plus1; ++i) {
-      signal_energy += real[i] * real[i] + imag[i] * imag[i];
-    }
+    float signal_energy =
+        vector_math_.SumOfSquares(s.real_row(ch).subview(0, kFftSizeBy2Plus1)) +
+        vector_math_.SumOfSquares(s.imag_row(ch).subview(0, kFftSizeBy2Plus1));
     signal_energy /= kFftSizeBy2Plus1;
 
-    float signal_spectral_sum = 0.f;
-    for (size_t i = 0; i < kFftSizeBy2Plus1; ++i) {
-      signal_spectral_sum += signal_spectrum[i];
-    }
+    float signal_spectral_sum = vector_math_.Sum(signal_spectrum);
 
     // Estimate the noise spectra and the probability estimates of speech
     // presence.
@@ -380,74 +436,40 @@ void NoiseSuppressor::Analyze(const AudioBuffer& audio) {
 }
 
 void NoiseSuppressor::Process(AudioBuffer* audio) {
-  // Select the space for storing data during the processing.
-  std::array<FilterBankState, kMaxNumChannelsOnStack> filter_bank_states_stack;
-  rtc::ArrayView<FilterBankState> filter_bank_states(
-      filter_bank_states_stack.data(), num_channels_);
-  std::array<float, kMaxNumChannelsOnStack> upper_band_gains_stack;
-  rtc::ArrayView<float> upper_band_gains(upper_band_gains_stack.data(),
-                                         num_channels_);
-  std::array<float, kMaxNumChannelsOnStack> energies_before_filtering_stack;
-  rtc::ArrayView<float> energies_before_filtering(
-      energies_before_filtering_stack.data(), num_channels_);
-  std::array<float, kMaxNumChannelsOnStack> gain_adjustments_stack;
-  rtc::ArrayView<float> gain_adjustments(gain_adjustments_stack.data(),
-                                         num_channels_);
-  if (NumChannelsOnHeap(num_channels_) > 0) {
-    // If the stack-allocated space is too small, use the heap for storing the
-    // data.
-    filter_bank_states = rtc::ArrayView<FilterBankState>(
-        filter_bank_states_heap_.data(), num_channels_);
-    upper_band_gains =
-        rtc::ArrayView<float>(upper_band_gains_heap_.data(), num_channels_);
-    energies_before_filtering = rtc::ArrayView<float>(
-        energies_before_filtering_heap_.data(), num_channels_);
-    gain_adjustments =
-        rtc::ArrayView<float>(gain_adjustments_heap_.data(), num_channels_);
-  }
+  FilterBankStates& s = filter_bank_states_;
+
+  // Perform filter bank analysis and compute the magnitude spectra for all
+  // channels.
+  ComputeSpectra(/*analysis_memory_for_process=*/true, *audio);
 
   // Compute the suppression filters for all channels.
   for (size_t ch = 0; ch < num_channels_; ++ch) {
-    // Form an extended frame and apply analysis filter bank windowing.
-    rtc::ArrayView<float, kNsFrameSize> y_band0(&audio->split_bands(ch)[0][0],
-                                                kNsFrameSize);
-
-    FormExtendedFrame(y_band0, channels_[ch]->process_analysis_memory,
-                      filter_bank_states[ch].extended_frame);
-
-    ApplyFilterBankWindow(filter_bank_states[ch].extended_frame);
-
-    energies_before_filtering[ch] =
-        ComputeEnergyOfExtendedFrame(filter_bank_states[ch].extended_frame);
-
-    // Perform filter bank analysis and compute the magnitude spectrum.
-    fft_.Fft(filter_bank_states[ch].extended_frame, filter_bank_states[ch].real,
-             filter_bank_states[ch].imag);
-
-    std::array<float, kFftSizeBy2Plus1> signal_spectrum;
-    ComputeMagnitudeSpectrum(filter_bank_states[ch].real,
-                             filter_bank_states[ch].imag, signal_spectrum);
-
     // Compute the frequency domain gain filter for noise attenuation.
     channels_[ch]->wiener_filter.Update(
         num_analyzed_frames_,
         channels_[ch]->noise_estimator.get_noise_spectrum(),
         channels_[ch]->noise_estimator.get_prev_noise_spectrum(),
         channels_[ch]->noise_estimator.get_parametric_noise_spectrum(),
-        signal_spectrum);
+        s.signal_spectra[ch]);
 
     if (num_bands_ > 1) {
       // Compute the time-domain gain for attenuating the noise in the upper
       // bands.
 
-      upper_band_gains[ch] = ComputeUpperBandsGain(
+      s.upper_band_gains[ch] = ComputeUpperBandsGain(
           suppression_params_.minimum_attenuating_gain,
           channels_[ch]->wiener_filter.get_filter(),
           channels_[ch]->speech_probability_estimator.get_probability(),
-          channels_[ch]->prev_analysis_signal_spectrum, signal_spectrum);
+          channels_[ch]->prev_analysis_signal_spectrum, s.signal_spectra[ch]);
     }
   }
 
+  // Select the noise attenuating gain to apply to the upper bands.
+  const float upper_band_gain =
+      num_bands_ > 1 ? *std::min_element(s.upper_band_gains.begin(),
+                                         s.upper_band_gains.end())
+                     : 1.f;
+
   // Aggregate the Wiener filters for all channels.
   std::array<float, kFftSizeBy2Plus1> filter_data;
   rtc::ArrayView<const float, kFftSizeBy2Plus1> filter = filter_data;
@@ -459,62 +481,79 @@ void NoiseSuppressor::Process(AudioBuffer* audio) {
 
   for (size_t ch = 0; ch < num_channels_; ++ch) {
     // Apply the filter to the lower band.
-    for (size_t i = 0; i < kFftSizeBy2Plus1; ++i) {
-      filter_bank_states[ch].real[i] *= filter[i];
-      filter_bank_states[ch].imag[i] *= filter[i];
+    vector_math_.Multiply(filter, s.real_row(ch).subview(0, kFftSizeBy2Plus1));
+    vector_math_.Multiply(filter, s.imag_row(ch).subview(0, kFftSizeBy2Plus1));
+  }
+
+  if (full_band_) {
+    const size_t num_upper_band_bins = fft_size_ / 2 + 1 - kFftSizeBy2Plus1;
+    for (size_t ch = 0; ch < num_channels_; ++ch) {
+      // Apply the noise-attenuating gain to the upper bands in the frequency
+      // domain.
+      rtc::ArrayView<float> real_upper =
+          s.real_row(ch).subview(kFftSizeBy2Plus1, num_upper_band_bins);
+      rtc::ArrayView<float> imag_upper =
+          s.imag_row(ch).subview(kFftSizeBy2Plus1, num_upper_band_bins);
+      vector_math_.Scale(upper_band_gain, real_upper, real_upper);
+      vector_math_.Scale(upper_band_gain, imag_upper, imag_upper);
+
+      // Compute the energy of the filtered lowest band.
+      s.energies_after_filtering[ch] =
+          vector_math_.SumOfSquares(s.real_row(ch).subview(
+              0, kFftSizeBy2Plus1)) +
+          vector_math_.SumOfSquares(
+              s.imag_row(ch).subview(0, kFftSizeBy2Plus1));
     }
   }
 
   // Perform filter bank synthesis
   for (size_t ch = 0; ch < num_channels_; ++ch) {
-    fft_.Ifft(filter_bank_states[ch].real, filter_bank_states[ch].imag,
-              filter_bank_states[ch].extended_frame);
+    fft_.Ifft(s.real_row(ch), s.imag_row(ch), s.extended_frame(ch));
   }
 
   for (size_t ch = 0; ch < num_channels_; ++ch) {
-    const float energy_after_filtering =
-        ComputeEnergyOfExtendedFrame(filter_bank_states[ch].extended_frame);
+    // In the full-band mode, the energy after filtering has already been
+    // computed in the frequency domain.
+    if (!full_band_) {
+      s.energies_after_filtering[ch] =
+          vector_math_.SumOfSquares(s.extended_frame(ch));
+    }
 
     // Apply synthesis window.
-    ApplyFilterBankWindow(filter_bank_states[ch].extended_frame);
+    ApplyFilterBankWindow(window_first_half_, frame_size_,
+                          s.extended_frame(ch));
 
     // Compute the adjustment of the noise attenuation filter based on the
     // effect of the attenuation.
-    gain_adjustments[ch] =
+    s.gain_adjustments[ch] =
         channels_[ch]->wiener_filter.ComputeOverallScalingFactor(
             num_analyzed_frames_,
             channels_[ch]->speech_probability_estimator.get_prior_probability(),
-            energies_before_filtering[ch], energy_after_filtering);
+            s.energies_before_filtering[ch], s.energies_after_filtering[ch]);
   }
 
   // Select and apply adjustment of the noise attenuation filter based on the
-  // effect of the attenuation.
-  float gain_adjustment = gain_adjustments[0];
-  for (size_t ch = 1; ch < num_channels_; ++ch) {
-    gain_adjustment = std::min(gain_adjustment, gain_adjustments[ch]);
-  }
-  for (size_t ch = 0; ch < num_channels_; ++ch) {
-    for (size_t i = 0; i < kFftSize; ++i) {
-      filter_bank_states[ch].extended_frame[i] =
-          gain_adjustment * filter_bank_states[ch].extended_frame[i];
-    }
+  // effect of the attenuation. The adjustment is common to all channels and is
+  // therefore applied to the extended frames of all channels in one pass. In
+  // the full-band mode, the scaling of the spectra is undone as well.
+  float gain_adjustment =
+      *std::min_element(s.gain_adjustments.begin(), s.gain_adjustments.end());
+  if (full_band_) {
+    gain_adjustment *= static_cast<float>(kFullBandFftSize) / kFftSize;
   }
+  vector_math_.Scale(gain_adjustment, s.extended_frames, s.extended_frames);
 
-  // Use overlap-and-add to form the output frame of the lowest band.
+  // Use overlap-and-add to form the output frame of the lowest band, or of the
+  // full-band signal.
   for (size_t ch = 0; ch < num_channels_; ++ch) {
-    rtc::ArrayView<float, kNsFrameSize> y_band0(&audio->split_bands(ch)[0][0],
-                                                kNsFrameSize);
-    OverlapAndAdd(filter_bank_states[ch].extended_frame,
-                  channels_[ch]->process_synthesis_memory, y_band0);
+    rtc::ArrayView<float> y(
+        full_band_ ? audio->channels()[ch] : audio->split_bands(ch)[0],
+        frame_size_);
+    OverlapAndAdd(s.extended_frame(ch), channels_[ch]->process_synthesis_memory,
+                  y);
   }
 
-  if (num_bands_ > 1) {
-    // Select the noise attenuating gain to apply to the upper band.
-    float upper_band_gain = upper_band_gains[0];
-    for (size_t ch = 1; ch < num_channels_; ++ch) {
-      upper_band_gain = std::min(upper_band_gain, upper_band_gains[ch]);
-    }
-
+  if (num_bands_ > 1 && !full_band_) {
     // Process the upper bands.
     for (size_t ch = 0; ch < num_channels_; ++ch) {
       for (size_t b = 1; b < num_bands_; ++b) {
@@ -527,20 +566,22 @@ void NoiseSuppressor::Process(AudioBuffer* audio) {
                     delayed_frame);
 
         // Apply the time-domain noise-attenuating gain.
-        for (size_t j = 0; j < kNsFrameSize; j++) {
-          y_band[j] = upper_band_gain * delayed_frame[j];
-        }
+        vector_math_.Scale(upper_band_gain, delayed_frame, y_band);
       }
     }
   }
 
   // Limit the output the allowed range.
   for (size_t ch = 0; ch < num_channels_; ++ch) {
-    for (size_t b = 0; b < num_bands_; ++b) {
-      rtc::ArrayView<float, kNsFrameSize> y_band(&audio->split_bands(ch)[b][0],
-                                                 kNsFrameSize);
-      for (size_t j = 0; j < kNsFrameSize; j++) {
-        y_band[j] = std::min(std::max(y_band[j], -32768.f), 32767.f);
+    if (full_band_) {
+      vector_math_.Clamp(
+          -32768.f, 32767.f,
+          rtc::ArrayView<float>(audio->channels()[ch], frame_size_));
+    } else {
+      for (size_t b = 0; b < num_bands_; ++b) {
+        rtc::ArrayView<float, kNsFrameSize> y_band(
+            &audio->split_bands(ch)[b][0], kNsFrameSize);
+        vector_math_.Clamp(-32768.f, 32767.f, y_band);
       }
     }
   }
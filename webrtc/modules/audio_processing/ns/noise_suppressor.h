@@ -20,12 +20,14 @@
 #include "modules/audio_processing/ns/ns_common.h"
 #include "modules/audio_processing/ns/ns_config.h"
 #include "modules/audio_processing/ns/ns_fft.h"
+#include "modules/audio_processing/ns/ns_vector_math.h"
 #include "modules/audio_processing/ns/speech_probability_estimator.h"
 #include "modules/audio_processing/ns/wiener_filter.h"
 
 namespace webrtc {
 
-// Class for suppressing noise in a signal.
+// Class for suppressing noise in a signal. In the full-band mode, the signal is
+// processed without being split into bands.
 class NoiseSuppressor {
  public:
   NoiseSuppressor(const NsConfig& config,
@@ -41,38 +43,80 @@ class NoiseSuppressor {
   // Applies noise suppression.
   void Process(AudioBuffer* audio);
 
+  // Returns the algorithmic delay that the suppressor adds to the signal, in
+  // milliseconds.
+  int delay_ms() const;
+
  private:
   const size_t num_bands_;
   const size_t num_channels_;
+  const bool full_band_;
+  const size_t fft_size_;
+  const size_t frame_size_;
+  const size_t overlap_size_;
+  const std::vector<float> window_first_half_;
   const SuppressionParams suppression_params_;
+  const NsVectorMath vector_math_;
   int32_t num_analyzed_frames_ = -1;
   NrFft fft_;
 
   struct ChannelState {
-    ChannelState(const SuppressionParams& suppression_params, size_t num_bands);
+    ChannelState(const SuppressionParams& suppression_params,
+                 size_t num_delayed_bands,
+                 size_t overlap_size);
 
     SpeechProbabilityEstimator speech_probability_estimator;
     WienerFilter wiener_filter;
     NoiseEstimator noise_estimator;
     std::array<float, kFftSizeBy2Plus1> prev_analysis_signal_spectrum;
-    std::array<float, kFftSize - kNsFrameSize> analyze_analysis_memory;
-    std::array<float, kOverlapSize> process_analysis_memory;
-    std::array<float, kOverlapSize> process_synthesis_memory;
-    std::vector<std::array<float, kOverlapSize>> process_delay_memory;
+    std::vector<float> analyze_analysis_memory;
+    std::vector<float> process_analysis_memory;
+    std::vector<float> process_synthesis_memory;
+    std::vector<std::vector<float>> process_delay_memory;
   };
 
-  struct FilterBankState {
-    std::array<float, kFftSize> real;
-    std::array<float, kFftSize> imag;
-    std::array<float, kFftSize> extended_frame;
+  // Filter bank state for all channels, stored as a structure of arrays where
+  // each member holds one contiguous row per channel. This allows the
+  // elementwise operations to be applied to all channels in one pass.
+  struct FilterBankStates {
+    FilterBankStates(size_t num_channels, size_t fft_size);
+
+    // Returns the rows of the FFT-sized members for channel |ch|.
+    rtc::ArrayView<float> real_row(size_t ch) {
+      return rtc::ArrayView<float>(&real[ch * fft_size], fft_size);
+    }
+    rtc::ArrayView<float> imag_row(size_t ch) {
+      return rtc::ArrayView<float>(&imag[ch * fft_size], fft_size);
+    }
+    rtc::ArrayView<float> extended_frame(size_t ch) {
+      return rtc::ArrayView<float>(&extended_frames[ch * fft_size], fft_size);
+    }
+
+    const size_t fft_size;
+    std::vector<float> real;
+    std::vector<float> imag;
+    std::vector<float> extended_frames;
+    std::vector<std::array<float, kFftSizeBy2Plus1>> signal_spectra;
+    std::vector<float> energies_before_filtering;
+    std::vector<float> energies_after_filtering;
+    std::vector<float> upper_band_gains;
+    std::vector<float> gain_adjustments;
   };
 
-  std::vector<FilterBankState> filter_bank_states_heap_;
-  std::vector<float> upper_band_gains_heap_;
-  std::vector<float> energies_before_filtering_heap_;
-  std::vector<float> gain_adjustments_heap_;
+  FilterBankStates filter_bank_states_;
   std::vector<std::unique_ptr<ChannelState>> channels_;
 
+  // Returns the frame that the filter bank operates on for channel |ch|, which
+  // is either the full-band signal or the lowest of the split bands.
+  rtc::ArrayView<const float> FilterBankFrame(const AudioBuffer& audio,
+                                              size_t ch) const;
+
+  // Forms the windowed extended frames and computes the spectra for all
+  // channels, using either the analysis memory of the process or the analyze
+  // stage.
+  void ComputeSpectra(bool analysis_memory_for_process,
+                      const AudioBuffer& audio);
+
   // Aggregates the Wiener filters into a single filter to use.
   void AggregateWienerFilters(
       rtc::ArrayView<float, kFftSizeBy2Plus1> filter) const;
@@ -19,6 +19,14 @@ constexpr size_t kFftSize = 256;
 constexpr size_t kFftSizeBy2Plus1 = kFftSize / 2 + 1;
 constexpr size_t kNsFrameSize = 160;
 constexpr size_t kOverlapSize = kFftSize - kNsFrameSize;
+// Overlap used by the low-latency mode, where the analysis and synthesis
+// windows are shortened and the remainder of the FFT input is zero-padded.
+constexpr size_t kLowLatencyOverlapSize = 32;
+
+// Sizes used when the full-band 48 kHz signal is processed directly. The FFT
+// has the same frequency resolution as the one applied to the lowest band.
+constexpr size_t kFullBandFftSize = 3 * kFftSize;
+constexpr size_t kFullBandNsFrameSize = 3 * kNsFrameSize;
 
 constexpr int kShortStartupPhaseBlocks = 50;
 constexpr int kLongStartupPhaseBlocks = 200;
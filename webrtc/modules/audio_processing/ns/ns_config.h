@@ -17,6 +17,15 @@ namespace webrtc {
 struct NsConfig {
   enum class SuppressionLevel { k6dB, k12dB, k18dB, k21dB };
   SuppressionLevel target_level = SuppressionLevel::k12dB;
+  // Uses shorter analysis and synthesis windows which reduces the algorithmic
+  // delay of the suppressor from kOverlapSize to kLowLatencyOverlapSize
+  // samples, at the cost of a lower frequency resolution of the windowing.
+  bool low_latency = false;
+  // Only applicable at 48 kHz. Processes the full-band signal directly, using
+  // a kFullBandFftSize point FFT, instead of the lowest of the split bands. The
+  // upper bands are then attenuated in the frequency domain, which removes the
+  // need for splitting the signal into bands.
+  bool full_band = false;
 };
 
 }  // namespace webrtc
@@ -10,54 +10,71 @@
 
 #include "modules/audio_processing/ns/ns_fft.h"
 
-#include "common_audio/third_party/ooura/fft_size_256/fft4g.h"
+#include <algorithm>
+
+#include "rtc_base/checks.h"
 
 namespace webrtc {
 
-NrFft::NrFft() : bit_reversal_state_(kFftSize / 2), tables_(kFftSize / 2) {
-  // Initialize WebRtc_rdt (setting (bit_reversal_state_[0] to 0 triggers
-  // initialization)
-  bit_reversal_state_[0] = 0.f;
-  std::array<float, kFftSize> tmp_buffer;
-  tmp_buffer.fill(0.f);
-  WebRtc_rdft(kFftSize, 1, tmp_buffer.data(), bit_reversal_state_.data(),
-              tables_.data());
+NrFft::NrFft(size_t fft_size)
+    : fft_size_(fft_size),
+      fft_(fft_size_, Pffft::FftType::kReal),
+      time_buffer_(fft_.CreateBuffer()),
+      frequency_buffer_(fft_.CreateBuffer()) {
+  RTC_DCHECK(fft_size_ == kFftSize || fft_size_ == kFullBandFftSize);
 }
 
-void NrFft::Fft(rtc::ArrayView<float, kFftSize> time_data,
-                rtc::ArrayView<float, kFftSize> real,
-                rtc::ArrayView<float, kFftSize> imag) {
-  WebRtc_rdft(kFftSize, 1, time_data.data(), bit_reversal_state_.data(),
-              tables_.data());
+NrFft::~NrFft() = default;
+
+void NrFft::Fft(rtc::ArrayView<const float> time_data,
+                rtc::ArrayView<float> real,
+                rtc::ArrayView<float> imag) {
+  RTC_DCHECK_EQ(fft_size_, time_data.size());
+  RTC_DCHECK_LE(fft_size_ / 2 + 1, real.size());
+  RTC_DCHECK_LE(fft_size_ / 2 + 1, imag.size());
+  auto in = time_buffer_->GetView();
+  std::copy(time_data.begin(), time_data.end(), in.begin());
+  fft_.ForwardTransform(*time_buffer_, frequency_buffer_.get(),
+                        /*ordered=*/true);
 
+  // The ordered PFFFT output packs the real-valued DC and Nyquist components
+  // into the first two elements, followed by interleaved complex values. The
+  // sign of the imaginary parts is flipped to match the Ooura FFT convention
+  // that the rest of the noise suppressor relies on.
+  auto out = frequency_buffer_->GetConstView();
+  const size_t fft_size_by_2 = fft_size_ / 2;
   imag[0] = 0;
-  real[0] = time_data[0];
+  real[0] = out[0];
 
-  imag[kFftSizeBy2Plus1 - 1] = 0;
-  real[kFftSizeBy2Plus1 - 1] = time_data[1];
+  imag[fft_size_by_2] = 0;
+  real[fft_size_by_2] = out[1];
 
-  for (size_t i = 1; i < kFftSizeBy2Plus1 - 1; ++i) {
-    real[i] = time_data[2 * i];
-    imag[i] = time_data[2 * i + 1];
+  for (size_t i = 1; i < fft_size_by_2; ++i) {
+    real[i] = out[2 * i];
+    imag[i] = -out[2 * i + 1];
   }
 }
 
 void NrFft::Ifft(rtc::ArrayView<const float> real,
                  rtc::ArrayView<const float> imag,
                  rtc::ArrayView<float> time_data) {
-  time_data[0] = real[0];
-  time_data[1] = real[kFftSizeBy2Plus1 - 1];
-  for (size_t i = 1; i < kFftSizeBy2Plus1 - 1; ++i) {
-    time_data[2 * i] = real[i];
-    time_data[2 * i + 1] = imag[i];
+  RTC_DCHECK_EQ(fft_size_, time_data.size());
+  auto in = frequency_buffer_->GetView();
+  const size_t fft_size_by_2 = fft_size_ / 2;
+  in[0] = real[0];
+  in[1] = real[fft_size_by_2];
+  for (size_t i = 1; i < fft_size_by_2; ++i) {
+    in[2 * i] = real[i];
+    in[2 * i + 1] = -imag[i];
   }
-  WebRtc_rdft(kFftSize, -1, time_data.data(), bit_reversal_state_.data(),
-              tables_.data());
+  fft_.BackwardTransform(*frequency_buffer_, time_buffer_.get(),
+                         /*ordered=*/true);
 
-  // Scale the output
-  constexpr float kScaling = 2.f / kFftSize;
-  for (float& d : time_data) {
-    d *= kScaling;
+  // Scale the output, PFFFT leaves the backward transform unnormalized.
+  const float scaling = 1.f / fft_size_;
+  auto out = time_buffer_->GetConstView();
+  for (size_t i = 0; i < fft_size_; ++i) {
+    time_data[i] = out[i] * scaling;
   }
 }
 
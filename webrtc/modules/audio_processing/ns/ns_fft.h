@@ -11,24 +11,32 @@
 #ifndef MODULES_AUDIO_PROCESSING_NS_NS_FFT_H_
 #define MODULES_AUDIO_PROCESSING_NS_NS_FFT_H_
 
-#include <vector>
+#include <memory>
 
 #include "api/array_view.h"
 #include "modules/audio_processing/ns/ns_common.h"
+#include "modules/audio_processing/utility/pffft_wrapper.h"
 
 namespace webrtc {
 
-// Wrapper class providing 256 point FFT functionality.
+// Wrapper class providing the FFT functionality of the noise suppressor. The
+// transforms are computed using the SIMD optimized PFFFT library while the
+// spectra are exposed using the same sign convention as the Ooura FFT
+// previously used.
 class NrFft {
  public:
-  NrFft();
+  // Creates an FFT of size |fft_size|, which must be either kFftSize or
+  // kFullBandFftSize.
+  explicit NrFft(size_t fft_size);
+  ~NrFft();
   NrFft(const NrFft&) = delete;
   NrFft& operator=(const NrFft&) = delete;
 
-  // Transforms the signal from time to frequency domain.
-  void Fft(rtc::ArrayView<float, kFftSize> time_data,
-           rtc::ArrayView<float, kFftSize> real,
-           rtc::ArrayView<float, kFftSize> imag);
+  // Transforms the signal from time to frequency domain. Only the first
+  // fft_size / 2 + 1 elements of |real| and |imag| are written.
+  void Fft(rtc::ArrayView<const float> time_data,
+           rtc::ArrayView<float> real,
+           rtc::ArrayView<float> imag);
 
   // Transforms the signal from frequency to time domain.
   void Ifft(rtc::ArrayView<const float> real,
@@ -36,8 +44,10 @@ class NrFft {
             rtc::ArrayView<float> time_data);
 
  private:
-  std::vector<size_t> bit_reversal_state_;
-  std::vector<float> tables_;
+  const size_t fft_size_;
+  Pffft fft_;
+  std::unique_ptr<Pffft::FloatBuffer> time_buffer_;
+  std::unique_ptr<Pffft::FloatBuffer> frequency_buffer_;
 };
 
 }  // namespace webrtc
@@ -0,0 +1,268 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/ns/ns_vector_math.h"
+
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+#include <math.h>
+
+#include <algorithm>
+
+#include "common_audio/vector_math.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace {
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Sums the four lanes of an SSE2 register.
+float HorizontalSumSse2(__m128 x) {
+  x = _mm_add_ps(x, _mm_movehl_ps(x, x));
+  x = _mm_add_ss(x, _mm_shuffle_ps(x, x, _MM_SHUFFLE(1, 1, 1, 1)));
+  return _mm_cvtss_f32(x);
+}
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+// Sums the four lanes of a NEON register.
+float HorizontalSumNeon(float32x4_t x) {
+  float32x2_t tmp = vadd_f32(vget_high_f32(x), vget_low_f32(x));
+  tmp = vpadd_f32(tmp, tmp);
+  return vget_lane_f32(tmp, 0);
+}
+
+// Elementwise square root.
+float32x4_t SqrtNeon(float32x4_t x) {
+#if defined(WEBRTC_ARCH_ARM64)
+  return vsqrtq_f32(x);
+#else
+  float32x4_t y = vrsqrteq_f32(x);
+
+  // Code to handle sqrt(0): zero out the positive infinity results returned by
+  // vrsqrteq_f32() for zero inputs.
+  const uint32x4_t vec_p_inf = vdupq_n_u32(0x7F800000);
+  const uint32x4_t div_by_zero = vceqq_u32(vec_p_inf, vreinterpretq_u32_f32(y));
+  y = vreinterpretq_f32_u32(
+      vandq_u32(vmvnq_u32(div_by_zero), vreinterpretq_u32_f32(y)));
+
+  // Newton-Raphson iterations y[n+1] = y[n] * (3 - d * (y[n] * y[n])) / 2.
+  for (int i = 0; i < 2; i++) {
+    y = vmulq_f32(vrsqrtsq_f32(vmulq_f32(y, y), x), y);
+  }
+  return vmulq_f32(x, y);
+#endif
+}
+#endif
+
+}  // namespace
+
+void NsVectorMath::Magnitude(rtc::ArrayView<const float> re,
+                             rtc::ArrayView<const float> im,
+                             float offset,
+                             rtc::ArrayView<float> y) const {
+  RTC_DCHECK_EQ(y.size(), re.size());
+  RTC_DCHECK_EQ(y.size(), im.size());
+  const int size = static_cast<int>(y.size());
+  int j = 0;
+  switch (optimization_) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case VectorMathOptimization::kAvx2:
+    case VectorMathOptimization::kSse2: {
+      const __m128 offset_v = _mm_set1_ps(offset);
+      for (; j + 4 <= size; j += 4) {
+        const __m128 re_j = _mm_loadu_ps(&re[j]);
+        const __m128 im_j = _mm_loadu_ps(&im[j]);
+        __m128 p = _mm_add_ps(_mm_mul_ps(re_j, re_j), _mm_mul_ps(im_j, im_j));
+        p = _mm_add_ps(_mm_sqrt_ps(p), offset_v);
+        _mm_storeu_ps(&y[j], p);
+      }
+    } break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case VectorMathOptimization::kNeon: {
+      const float32x4_t offset_v = vdupq_n_f32(offset);
+      for (; j + 4 <= size; j += 4) {
+        const float32x4_t re_j = vld1q_f32(&re[j]);
+        const float32x4_t im_j = vld1q_f32(&im[j]);
+        float32x4_t p = vmlaq_f32(vmulq_f32(re_j, re_j), im_j, im_j);
+        p = vaddq_f32(SqrtNeon(p), offset_v);
+        vst1q_f32(&y[j], p);
+      }
+    } break;
+#endif
+    default:
+      break;
+  }
+
+  for (; j < size; ++j) {
+    y[j] = sqrtf(re[j] * re[j] + im[j] * im[j]) + offset;
+  }
+}
+
+void NsVectorMath::Multiply(rtc::ArrayView<const float> x,
+                            rtc::ArrayView<float> y) const {
+  RTC_DCHECK_EQ(y.size(), x.size());
+  const int size = static_cast<int>(y.size());
+  int j = 0;
+  switch (optimization_) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case VectorMathOptimization::kAvx2:
+    case VectorMathOptimization::kSse2:
+      for (; j + 4 <= size; j += 4) {
+        const __m128 x_j = _mm_loadu_ps(&x[j]);
+        const __m128 y_j = _mm_loadu_ps(&y[j]);
+        _mm_storeu_ps(&y[j], _mm_mul_ps(x_j, y_j));
+      }
+      break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case VectorMathOptimization::kNeon:
+      for (; j + 4 <= size; j += 4) {
+        const float32x4_t x_j = vld1q_f32(&x[j]);
+        const float32x4_t y_j = vld1q_f32(&y[j]);
+        vst1q_f32(&y[j], vmulq_f32(x_j, y_j));
+      }
+      break;
+#endif
+    default:
+      break;
+  }
+
+  for (; j < size; ++j) {
+    y[j] *= x[j];
+  }
+}
+
+void NsVectorMath::Scale(float gain,
+                         rtc::ArrayView<const float> x,
+                         rtc::ArrayView<float> y) const {
+  VectorScale(optimization_, gain, x, y);
+}
+
+void NsVectorMath::Min(rtc::ArrayView<const float> x,
+                       rtc::ArrayView<float> y) const {
+  RTC_DCHECK_EQ(y.size(), x.size());
+  const int size = static_cast<int>(y.size());
+  int j = 0;
+  switch (optimization_) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case VectorMathOptimization::kAvx2:
+    case VectorMathOptimization::kSse2:
+      for (; j + 4 <= size; j += 4) {
+        const __m128 x_j = _mm_loadu_ps(&x[j]);
+        const __m128 y_j = _mm_loadu_ps(&y[j]);
+        _mm_storeu_ps(&y[j], _mm_min_ps(y_j, x_j));
+      }
+      break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case VectorMathOptimization::kNeon:
+      for (; j + 4 <= size; j += 4) {
+        const float32x4_t x_j = vld1q_f32(&x[j]);
+        const float32x4_t y_j = vld1q_f32(&y[j]);
+        vst1q_f32(&y[j], vminq_f32(y_j, x_j));
+      }
+      break;
+#endif
+    default:
+      break;
+  }
+
+  for (; j < size; ++j) {
+    y[j] = std::min(y[j], x[j]);
+  }
+}
+
+void NsVectorMath::Clamp(float min_value,
+                         float max_value,
+                         rtc::ArrayView<float> x) const {
+  VectorClamp(optimization_, min_value, max_value, x);
+}
+
+float NsVectorMath::Sum(rtc::ArrayView<const float> x) const {
+  const int size = static_cast<int>(x.size());
+  int j = 0;
+  float sum = 0.f;
+  switch (optimization_) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case VectorMathOptimization::kAvx2:
+    case VectorMathOptimization::kSse2: {
+      __m128 sum_v = _mm_setzero_ps();
+      for (; j + 4 <= size; j += 4) {
+        sum_v = _mm_add_ps(sum_v, _mm_loadu_ps(&x[j]));
+      }
+      sum = HorizontalSumSse2(sum_v);
+    } break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case VectorMathOptimization::kNeon: {
+      float32x4_t sum_v = vdupq_n_f32(0.f);
+      for (; j + 4 <= size; j += 4) {
+        sum_v = vaddq_f32(sum_v, vld1q_f32(&x[j]));
+      }
+      sum = HorizontalSumNeon(sum_v);
+    } break;
+#endif
+    default:
+      break;
+  }
+
+  for (; j < size; ++j) {
+    sum += x[j];
+  }
+  return sum;
+}
+
+float NsVectorMath::SumOfSquares(rtc::ArrayView<const float> x) const {
+  const int size = static_cast<int>(x.size());
+  int j = 0;
+  float sum = 0.f;
+  switch (optimization_) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case VectorMathOptimization::kAvx2:
+    case VectorMathOptimization::kSse2: {
+      __m128 sum_v = _mm_setzero_ps();
+      for (; j + 4 <= size; j += 4) {
+        const __m128 x_j = _mm_loadu_ps(&x[j]);
+        sum_v = _mm_add_ps(sum_v, _mm_mul_ps(x_j, x_j));
+      }
+      sum = HorizontalSumSse2(sum_v);
+    } break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case VectorMathOptimization::kNeon: {
+      float32x4_t sum_v = vdupq_n_f32(0.f);
+      for (; j + 4 <= size; j += 4) {
+        const float32x4_t x_j = vld1q_f32(&x[j]);
+        sum_v = vmlaq_f32(sum_v, x_j, x_j);
+      }
+      sum = HorizontalSumNeon(sum_v);
+    } break;
+#endif
+    default:
+      break;
+  }
+
+  for (; j < size; ++j) {
+    sum += x[j] * x[j];
+  }
+  return sum;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,59 @@
+/*
+ *  Copyright (c) 2019 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_NS_NS_VECTOR_MATH_H_
+#define MODULES_AUDIO_PROCESSING_NS_NS_VECTOR_MATH_H_
+
+#include "api/array_view.h"
+#include "common_audio/vector_math.h"
+
+namespace webrtc {
+
+// Provides optimizations for the elementwise vector operations used by the
+// noise suppressor. The operations are intended to be applied to data for
+// several channels at once, stored as consecutive rows in one array.
+class NsVectorMath {
+ public:
+  explicit NsVectorMath(VectorMathOptimization optimization)
+      : optimization_(optimization) {}
+
+  // Elementwise magnitude y = sqrt(re * re + im * im) + offset.
+  void Magnitude(rtc::ArrayView<const float> re,
+                 rtc::ArrayView<const float> im,
+                 float offset,
+                 rtc::ArrayView<float> y) const;
+
+  // Elementwise vector multiplication y = x * y.
+  void Multiply(rtc::ArrayView<const float> x, rtc::ArrayView<float> y) const;
+
+  // Elementwise vector scaling y = gain * x. May be applied in-place.
+  void Scale(float gain,
+             rtc::ArrayView<const float> x,
+             rtc::ArrayView<float> y) const;
+
+  // Elementwise minimum y = min(x, y).
+  void Min(rtc::ArrayView<const float> x, rtc::ArrayView<float> y) const;
+
+  // Elementwise clamping of x to the range [min_value, max_value].
+  void Clamp(float min_value, float max_value, rtc::ArrayView<float> x) const;
+
+  // Returns the sum of the elements of x.
+  float Sum(rtc::ArrayView<const float> x) const;
+
+  // Returns the sum of the squares of the elements of x.
+  float SumOfSquares(rtc::ArrayView<const float> x) const;
+
+ private:
+  const VectorMathOptimization optimization_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_NS_NS_VECTOR_MATH_H_
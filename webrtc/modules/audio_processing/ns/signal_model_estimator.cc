@@ -77,8 +77,10 @@ void UpdateSpectralFlatness(
     }
   }
 
-  for (size_t i = 1; i < kFftSizeBy2Plus1; ++i) {
-    avg_spect_flatness_num += LogApproximation(signal_spectrum[i]);
+  std::array<float, kFftSizeBy2Plus1 - 1> log_signal_spectrum;
+  LogApproximation(signal_spectrum.subview(1), log_signal_spectrum);
+  for (float log_signal : log_signal_spectrum) {
+    avg_spect_flatness_num += log_signal;
   }
 
   float avg_spect_flatness_denom = signal_spectral_sum - signal_spectrum[0];
@@ -100,12 +102,17 @@ void UpdateSpectralLrt(rtc::ArrayView<const float, kFftSizeBy2Plus1> prior_snr,
                        float* lrt) {
   RTC_DCHECK(lrt);
 
+  std::array<float, kFftSizeBy2Plus1> tmp1;
+  for (size_t i = 0; i < kFftSizeBy2Plus1; ++i) {
+    tmp1[i] = 1.f + 2.f * prior_snr[i];
+  }
+  std::array<float, kFftSizeBy2Plus1> log_tmp1;
+  LogApproximation(tmp1, log_tmp1);
+
   for (size_t i = 0; i < kFftSizeBy2Plus1; ++i) {
-    float tmp1 = 1.f + 2.f * prior_snr[i];
-    float tmp2 = 2.f * prior_snr[i] / (tmp1 + 0.0001f);
+    float tmp2 = 2.f * prior_snr[i] / (tmp1[i] + 0.0001f);
     float bessel_tmp = (post_snr[i] + 1.f) * tmp2;
-    avg_log_lrt[i] +=
-        .5f * (bessel_tmp - LogApproximation(tmp1) - avg_log_lrt[i]);
+    avg_log_lrt[i] += .5f * (bessel_tmp - log_tmp1[i] - avg_log_lrt[i]);
   }
 
   float log_lrt_time_avg_k_sum = 0.f;
@@ -17,7 +17,7 @@
 #include "modules/audio_processing/echo_detector/circular_buffer.h"
 #include "modules/audio_processing/echo_detector/mean_variance_estimator.h"
 #include "modules/audio_processing/echo_detector/moving_max.h"
-#include "modules/audio_processing/echo_detector/normalized_covariance_estimator.h"
+#include "modules/audio_processing/echo_detector/normalized_covariance_bank.h"
 #include "modules/audio_processing/include/audio_processing.h"
 
 namespace webrtc {
@@ -64,14 +64,16 @@ class ResidualEchoDetector : public EchoDetector {
   size_t frames_since_zero_buffer_size_ = 0;
 
   // Circular buffers containing delayed versions of the power, mean and
-  // standard deviation, for calculating the delayed covariance values.
+  // standard deviation, for calculating the delayed covariance values. Each
+  // buffer holds two copies of the history, so that the values for all delays
+  // are found in increasing delay order starting at |next_insertion_index_|.
   std::vector<float> render_power_;
   std::vector<float> render_power_mean_;
   std::vector<float> render_power_std_dev_;
   // Covariance estimates for different delay values.
-  std::vector<NormalizedCovarianceEstimator> covariances_;
+  NormalizedCovarianceBank covariances_;
   // Index where next element should be inserted in all of the above circular
-  // buffers.
+  // buffers. The index is decremented after each insertion.
   size_t next_insertion_index_ = 0;
 
   MeanVarianceEstimator render_statistics_;
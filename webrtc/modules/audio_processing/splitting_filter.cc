@@ -10,135 +10,153 @@
 
 #include "modules/audio_processing/splitting_filter.h"
 
-#include <array>
-
 #include "api/array_view.h"
 #include "common_audio/channel_buffer.h"
-#include "common_audio/signal_processing/include/signal_processing_library.h"
 #include "rtc_base/checks.h"
 
 namespace webrtc {
-namespace {
-
-constexpr size_t kSamplesPerBand = 160;
-constexpr size_t kTwoBandFilterSamplesPerFrame = 320;
-
-}  // namespace
-
 SplittingFilter::SplittingFilter(size_t num_channels,
                                  size_t num_bands,
                                  size_t num_frames)
-    : num_bands_(num_bands),
-      two_bands_states_(num_bands_ == 2 ? num_channels : 0),
-      three_band_filter_banks_(num_bands_ == 3 ? num_channels : 0) {
+    : num_channels_(num_channels),
+      num_bands_(num_bands),
+      two_band_filter_banks_(num_channels),
+      three_band_filter_banks_(num_channels) {
   RTC_CHECK(num_bands_ == 2 || num_bands_ == 3);
 }
 
 SplittingFilter::~SplittingFilter() = default;
 
+void SplittingFilter::Initialize(size_t num_channels, size_t num_bands) {
+  RTC_CHECK(num_bands == 2 || num_bands == 3);
+  num_channels_ = num_channels;
+  num_bands_ = num_bands;
+  if (num_channels_ > two_band_filter_banks_.size()) {
+    two_band_filter_banks_.resize(num_channels_);
+    three_band_filter_banks_.resize(num_channels_);
+  }
+  for (size_t i = 0; i < num_channels_; ++i) {
+    two_band_filter_banks_[i].Reset();
+    three_band_filter_banks_[i].Reset();
+  }
+}
+
 void SplittingFilter::Analysis(const ChannelBuffer<float>* data,
                                ChannelBuffer<float>* bands) {
+  RTC_DCHECK_EQ(num_channels_, data->num_channels());
+  for (size_t i = 0; i < num_channels_; ++i) {
+    AnalyzeChannel(i, data, bands);
+  }
+}
+
+void SplittingFilter::Synthesis(const ChannelBuffer<float>* bands,
+                                ChannelBuffer<float>* data) {
+  RTC_DCHECK_LE(data->num_channels(), num_channels_);
+  for (size_t i = 0; i < data->num_channels(); ++i) {
+    SynthesizeChannel(i, bands, data);
+  }
+}
+
+void SplittingFilter::AnalyzeChannel(size_t channel,
+                                     const ChannelBuffer<float>* data,
+                                     ChannelBuffer<float>* bands) {
   RTC_DCHECK_EQ(num_bands_, bands->num_bands());
   RTC_DCHECK_EQ(data->num_channels(), bands->num_channels());
+  RTC_DCHECK_LT(channel, num_channels_);
+  RTC_DCHECK_LT(channel, data->num_channels());
   RTC_DCHECK_EQ(data->num_frames(),
                 bands->num_frames_per_band() * bands->num_bands());
   if (bands->num_bands() == 2) {
-    TwoBandsAnalysis(data, bands);
+    TwoBandsAnalysis(channel, data, bands);
   } else if (bands->num_bands() == 3) {
-    ThreeBandsAnalysis(data, bands);
+    ThreeBandsAnalysis(channel, data, bands);
   }
 }
 
-void SplittingFilter::Synthesis(const ChannelBuffer<float>* bands,
-                                ChannelBuffer<float>* data) {
+void SplittingFilter::SynthesizeChannel(size_t channel,
+                                        const ChannelBuffer<float>* bands,
+                                        ChannelBuffer<float>* data) {
   RTC_DCHECK_EQ(num_bands_, bands->num_bands());
   RTC_DCHECK_EQ(data->num_channels(), bands->num_channels());
+  RTC_DCHECK_LT(channel, num_channels_);
+  RTC_DCHECK_LT(channel, data->num_channels());
   RTC_DCHECK_EQ(data->num_frames(),
                 bands->num_frames_per_band() * bands->num_bands());
   if (bands->num_bands() == 2) {
-    TwoBandsSynthesis(bands, data);
+    TwoBandsSynthesis(channel, bands, data);
   } else if (bands->num_bands() == 3) {
-    ThreeBandsSynthesis(bands, data);
+    ThreeBandsSynthesis(channel, bands, data);
   }
 }
 
-void SplittingFilter::TwoBandsAnalysis(const ChannelBuffer<float>* data,
+void SplittingFilter::TwoBandsAnalysis(size_t channel,
+                                       const ChannelBuffer<float>* data,
                                        ChannelBuffer<float>* bands) {
-  RTC_DCHECK_EQ(two_bands_states_.size(), data->num_channels());
-  RTC_DCHECK_EQ(data->num_frames(), kTwoBandFilterSamplesPerFrame);
-
-  for (size_t i = 0; i < two_bands_states_.size(); ++i) {
-    std::array<std::array<int16_t, kSamplesPerBand>, 2> bands16;
-    std::array<int16_t, kTwoBandFilterSamplesPerFrame> full_band16;
-    FloatS16ToS16(data->channels(0)[i], full_band16.size(), full_band16.data());
-    WebRtcSpl_AnalysisQMF(full_band16.data(), data->num_frames(),
-                          bands16[0].data(), bands16[1].data(),
-                          two_bands_states_[i].analysis_state1,
-                          two_bands_states_[i].analysis_state2);
-    S16ToFloatS16(bands16[0].data(), bands16[0].size(), bands->channels(0)[i]);
-    S16ToFloatS16(bands16[1].data(), bands16[1].size(), bands->channels(1)[i]);
-  }
+  RTC_DCHECK_EQ(data->num_frames(), TwoBandFilterBank::kFullBandSize);
+  RTC_DCHECK_EQ(bands->num_frames(), TwoBandFilterBank::kFullBandSize);
+  RTC_DCHECK_EQ(bands->num_bands(), TwoBandFilterBank::kNumBands);
+  RTC_DCHECK_EQ(bands->num_frames_per_band(),
+                TwoBandFilterBank::kSplitBandSize);
+
+  two_band_filter_banks_[channel].Analysis(
+      rtc::ArrayView<const float, TwoBandFilterBank::kFullBandSize>(
+          data->channels_view()[channel].data(),
+          TwoBandFilterBank::kFullBandSize),
+      rtc::ArrayView<const rtc::ArrayView<float>, TwoBandFilterBank::kNumBands>(
+          bands->bands_view(channel).data(), TwoBandFilterBank::kNumBands));
 }
 
-void SplittingFilter::TwoBandsSynthesis(const ChannelBuffer<float>* bands,
+void SplittingFilter::TwoBandsSynthesis(size_t channel,
+                                        const ChannelBuffer<float>* bands,
                                         ChannelBuffer<float>* data) {
-  RTC_DCHECK_LE(data->num_channels(), two_bands_states_.size());
-  RTC_DCHECK_EQ(data->num_frames(), kTwoBandFilterSamplesPerFrame);
-  for (size_t i = 0; i < data->num_channels(); ++i) {
-    std::array<std::array<int16_t, kSamplesPerBand>, 2> bands16;
-    std::array<int16_t, kTwoBandFilterSamplesPerFrame> full_band16;
-    FloatS16ToS16(bands->channels(0)[i], bands16[0].size(), bands16[0].data());
-    FloatS16ToS16(bands->channels(1)[i], bands16[1].size(), bands16[1].data());
-    WebRtcSpl_SynthesisQMF(bands16[0].data(), bands16[1].data(),
-                           bands->num_frames_per_band(), full_band16.data(),
-                           two_bands_states_[i].synthesis_state1,
-                           two_bands_states_[i].synthesis_state2);
-    S16ToFloatS16(full_band16.data(), full_band16.size(), data->channels(0)[i]);
-  }
+  RTC_DCHECK_EQ(data->num_frames(), TwoBandFilterBank::kFullBandSize);
+  RTC_DCHECK_EQ(bands->num_frames(), TwoBandFilterBank::kFullBandSize);
+  RTC_DCHECK_EQ(bands->num_bands(), TwoBandFilterBank::kNumBands);
+  RTC_DCHECK_EQ(bands->num_frames_per_band(),
+                TwoBandFilterBank::kSplitBandSize);
+
+  two_band_filter_banks_[channel].Synthesis(
+      rtc::ArrayView<const rtc::ArrayView<float>, TwoBandFilterBank::kNumBands>(
+          bands->bands_view(channel).data(), TwoBandFilterBank::kNumBands),
+      rtc::ArrayView<float, TwoBandFilterBank::kFullBandSize>(
+          data->channels_view()[channel].data(),
+          TwoBandFilterBank::kFullBandSize));
 }
 
-void SplittingFilter::ThreeBandsAnalysis(const ChannelBuffer<float>* data,
+void SplittingFilter::ThreeBandsAnalysis(size_t channel,
+                                         const ChannelBuffer<float>* data,
                                          ChannelBuffer<float>* bands) {
-  RTC_DCHECK_EQ(three_band_filter_banks_.size(), data->num_channels());
-  RTC_DCHECK_LE(data->num_channels(), three_band_filter_banks_.size());
-  RTC_DCHECK_LE(data->num_channels(), bands->num_channels());
   RTC_DCHECK_EQ(data->num_frames(), ThreeBandFilterBank::kFullBandSize);
   RTC_DCHECK_EQ(bands->num_frames(), ThreeBandFilterBank::kFullBandSize);
   RTC_DCHECK_EQ(bands->num_bands(), ThreeBandFilterBank::kNumBands);
   RTC_DCHECK_EQ(bands->num_frames_per_band(),
                 ThreeBandFilterBank::kSplitBandSize);
 
-  for (size_t i = 0; i < three_band_filter_banks_.size(); ++i) {
-    three_band_filter_banks_[i].Analysis(
-        rtc::ArrayView<const float, ThreeBandFilterBank::kFullBandSize>(
-            data->channels_view()[i].data(),
-            ThreeBandFilterBank::kFullBandSize),
-        rtc::ArrayView<const rtc::ArrayView<float>,
-                       ThreeBandFilterBank::kNumBands>(
-            bands->bands_view(i).data(), ThreeBandFilterBank::kNumBands));
-  }
+  three_band_filter_banks_[channel].Analysis(
+      rtc::ArrayView<const float, ThreeBandFilterBank::kFullBandSize>(
+          data->channels_view()[channel].data(),
+          ThreeBandFilterBank::kFullBandSize),
+      rtc::ArrayView<const rtc::ArrayView<float>,
+                     ThreeBandFilterBank::kNumBands>(
+          bands->bands_view(channel).data(), ThreeBandFilterBank::kNumBands));
 }
 
-void SplittingFilter::ThreeBandsSynthesis(const ChannelBuffer<float>* bands,
+void SplittingFilter::ThreeBandsSynthesis(size_t channel,
+                                          const ChannelBuffer<float>* bands,
                                           ChannelBuffer<float>* data) {
-  RTC_DCHECK_LE(data->num_channels(), three_band_filter_banks_.size());
-  RTC_DCHECK_LE(data->num_channels(), bands->num_channels());
-  RTC_DCHECK_LE(data->num_channels(), three_band_filter_banks_.size());
   RTC_DCHECK_EQ(data->num_frames(), ThreeBandFilterBank::kFullBandSize);
   RTC_DCHECK_EQ(bands->num_frames(), ThreeBandFilterBank::kFullBandSize);
   RTC_DCHECK_EQ(bands->num_bands(), ThreeBandFilterBank::kNumBands);
   RTC_DCHECK_EQ(bands->num_frames_per_band(),
                 ThreeBandFilterBank::kSplitBandSize);
 
-  for (size_t i = 0; i < data->num_channels(); ++i) {
-    three_band_filter_banks_[i].Synthesis(
-        rtc::ArrayView<const rtc::ArrayView<float>,
-                       ThreeBandFilterBank::kNumBands>(
-            bands->bands_view(i).data(), ThreeBandFilterBank::kNumBands),
-        rtc::ArrayView<float, ThreeBandFilterBank::kFullBandSize>(
-            data->channels_view()[i].data(),
-            ThreeBandFilterBank::kFullBandSize));
-  }
+  three_band_filter_banks_[channel].Synthesis(
+      rtc::ArrayView<const rtc::ArrayView<float>,
+                     ThreeBandFilterBank::kNumBands>(
+          bands->bands_view(channel).data(), ThreeBandFilterBank::kNumBands),
+      rtc::ArrayView<float, ThreeBandFilterBank::kFullBandSize>(
+          data->channels_view()[channel].data(),
+          ThreeBandFilterBank::kFullBandSize));
 }
 
 }  // namespace webrtc
@@ -11,32 +11,18 @@
 #ifndef MODULES_AUDIO_PROCESSING_SPLITTING_FILTER_H_
 #define MODULES_AUDIO_PROCESSING_SPLITTING_FILTER_H_
 
-#include <cstring>
 #include <memory>
 #include <vector>
 
 #include "common_audio/channel_buffer.h"
 #include "modules/audio_processing/three_band_filter_bank.h"
+#include "modules/audio_processing/two_band_filter_bank.h"
 
 namespace webrtc {
 
-struct TwoBandsStates {
-  TwoBandsStates() {
-    memset(analysis_state1, 0, sizeof(analysis_state1));
-    memset(analysis_state2, 0, sizeof(analysis_state2));
-    memset(synthesis_state1, 0, sizeof(synthesis_state1));
-    memset(synthesis_state2, 0, sizeof(synthesis_state2));
-  }
-
-  static const int kStateSize = 6;
-  int analysis_state1[kStateSize];
-  int analysis_state2[kStateSize];
-  int synthesis_state1[kStateSize];
-  int synthesis_state2[kStateSize];
-};
-
 // Splitting filter which is able to split into and merge from 2 or 3 frequency
-// bands. The number of channels needs to be provided at construction time.
+// bands. The number of channels needs to be provided at construction time, and
+// can later be changed with Initialize().
 //
 // For each block, Analysis() is called to split into bands and then Synthesis()
 // to merge these bands again. The input and output signals are contained in
@@ -47,23 +33,41 @@ class SplittingFilter {
   SplittingFilter(size_t num_channels, size_t num_bands, size_t num_frames);
   ~SplittingFilter();
 
+  // Resets the filter states and prepares the filter for |num_channels|
+  // channels split into |num_bands| bands. Memory is only allocated when the
+  // number of channels exceeds the largest one used so far.
+  void Initialize(size_t num_channels, size_t num_bands);
+
   void Analysis(const ChannelBuffer<float>* data, ChannelBuffer<float>* bands);
   void Synthesis(const ChannelBuffer<float>* bands, ChannelBuffer<float>* data);
 
+  // Splits and merges a single channel, which allows the band split to be
+  // done in the same pass as other per-channel processing.
+  void AnalyzeChannel(size_t channel,
+                      const ChannelBuffer<float>* data,
+                      ChannelBuffer<float>* bands);
+  void SynthesizeChannel(size_t channel,
+                         const ChannelBuffer<float>* bands,
+                         ChannelBuffer<float>* data);
+
  private:
-  // Two-band analysis and synthesis work for 640 samples or less.
-  void TwoBandsAnalysis(const ChannelBuffer<float>* data,
+  void TwoBandsAnalysis(size_t channel,
+                        const ChannelBuffer<float>* data,
                         ChannelBuffer<float>* bands);
-  void TwoBandsSynthesis(const ChannelBuffer<float>* bands,
+  void TwoBandsSynthesis(size_t channel,
+                         const ChannelBuffer<float>* bands,
                          ChannelBuffer<float>* data);
-  void ThreeBandsAnalysis(const ChannelBuffer<float>* data,
+  void ThreeBandsAnalysis(size_t channel,
+                          const ChannelBuffer<float>* data,
                           ChannelBuffer<float>* bands);
-  void ThreeBandsSynthesis(const ChannelBuffer<float>* bands,
+  void ThreeBandsSynthesis(size_t channel,
+                           const ChannelBuffer<float>* bands,
                            ChannelBuffer<float>* data);
   void InitBuffers();
 
-  const size_t num_bands_;
-  std::vector<TwoBandsStates> two_bands_states_;
+  size_t num_channels_;
+  size_t num_bands_;
+  std::vector<TwoBandFilterBank> two_band_filter_banks_;
   std::vector<ThreeBandFilterBank> three_band_filter_banks_;
 };
 
@@ -32,6 +32,16 @@
 
 #include "modules/audio_processing/three_band_filter_bank.h"
 
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
 #include <array>
 
 #include "rtc_base/checks.h"
@@ -103,6 +113,7 @@ const float kDctModulation[ThreeBandFilterBank::kNumNonZeroFilters][kDctSize] =
 // Filters the input signal |in| with the filter |filter| using a shift by
 // |in_shift|, taking into account the previous state.
 void FilterCore(
+    VectorMathOptimization optimization,
     rtc::ArrayView<const float, kFilterSize> filter,
     rtc::ArrayView<const float, ThreeBandFilterBank::kSplitBandSize> in,
     const int in_shift,
@@ -111,31 +122,62 @@ void FilterCore(
   constexpr int kMaxInShift = (kStride - 1);
   RTC_DCHECK_GE(in_shift, 0);
   RTC_DCHECK_LE(in_shift, kMaxInShift);
-  std::fill(out.begin(), out.end(), 0.f);
-
-  for (int k = 0; k < in_shift; ++k) {
-    for (int i = 0, j = kMemorySize + k - in_shift; i < kFilterSize;
-         ++i, j -= kStride) {
-      out[k] += state[j] * filter[i];
-    }
-  }
 
-  for (int k = in_shift, shift = 0; k < kFilterSize * kStride; ++k, ++shift) {
-    RTC_DCHECK_GE(shift, 0);
-    const int loop_limit = std::min(kFilterSize, 1 + (shift >> kStrideLog2));
-    for (int i = 0, j = shift; i < loop_limit; ++i, j -= kStride) {
-      out[k] += in[j] * filter[i];
-    }
-    for (int i = loop_limit, j = kMemorySize + shift - loop_limit * kStride;
-         i < kFilterSize; ++i, j -= kStride) {
-      out[k] += state[j] * filter[i];
-    }
+  // Place the state in front of the input so that each output sample is a
+  // sparse dot product over contiguous memory, regardless of whether its
+  // filter taps reach into the state.
+  std::array<float, kMemorySize + ThreeBandFilterBank::kSplitBandSize>
+      extended_in;
+  std::copy(state.begin(), state.end(), extended_in.begin());
+  std::copy(in.begin(), in.end(), extended_in.begin() + kMemorySize);
+  const float* x = &extended_in[kMemorySize - in_shift];
+
+  int k = 0;
+  switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case VectorMathOptimization::kAvx2:
+      three_band_filter_bank_avx2::FilterCore(filter, x, out);
+      k = ThreeBandFilterBank::kSplitBandSize;
+      break;
+    case VectorMathOptimization::kSse2: {
+      __m128 filter_v[kFilterSize];
+      for (int i = 0; i < kFilterSize; ++i) {
+        filter_v[i] = _mm_set1_ps(filter[i]);
+      }
+      for (; k + 4 <= ThreeBandFilterBank::kSplitBandSize; k += 4) {
+        __m128 out_k = _mm_setzero_ps();
+        for (int i = 0; i < kFilterSize; ++i) {
+          const __m128 x_k = _mm_loadu_ps(&x[k - kStride * i]);
+          out_k = _mm_add_ps(out_k, _mm_mul_ps(x_k, filter_v[i]));
+        }
+        _mm_storeu_ps(&out[k], out_k);
+      }
+    } break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case VectorMathOptimization::kNeon: {
+      float32x4_t filter_v[kFilterSize];
+      for (int i = 0; i < kFilterSize; ++i) {
+        filter_v[i] = vdupq_n_f32(filter[i]);
+      }
+      for (; k + 4 <= ThreeBandFilterBank::kSplitBandSize; k += 4) {
+        float32x4_t out_k = vdupq_n_f32(0.f);
+        for (int i = 0; i < kFilterSize; ++i) {
+          const float32x4_t x_k = vld1q_f32(&x[k - kStride * i]);
+          out_k = vaddq_f32(out_k, vmulq_f32(x_k, filter_v[i]));
+        }
+        vst1q_f32(&out[k], out_k);
+      }
+    } break;
+#endif
+    default:
+      break;
   }
 
-  for (int k = kFilterSize * kStride, shift = kFilterSize * kStride - in_shift;
-       k < ThreeBandFilterBank::kSplitBandSize; ++k, ++shift) {
-    for (int i = 0, j = shift; i < kFilterSize; ++i, j -= kStride) {
-      out[k] += in[j] * filter[i];
+  for (; k < ThreeBandFilterBank::kSplitBandSize; ++k) {
+    out[k] = 0.f;
+    for (int i = 0; i < kFilterSize; ++i) {
+      out[k] += x[k - kStride * i] * filter[i];
     }
   }
 
@@ -144,12 +186,63 @@ void FilterCore(
             in.end(), state.begin());
 }
 
+// Computes y += gain * x.
+void AccumulateScaled(
+    VectorMathOptimization optimization,
+    float gain,
+    rtc::ArrayView<const float, ThreeBandFilterBank::kSplitBandSize> x,
+    rtc::ArrayView<float, ThreeBandFilterBank::kSplitBandSize> y) {
+  int k = 0;
+  switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case VectorMathOptimization::kAvx2:
+      three_band_filter_bank_avx2::AccumulateScaled(gain, x, y);
+      k = ThreeBandFilterBank::kSplitBandSize;
+      break;
+    case VectorMathOptimization::kSse2: {
+      const __m128 gain_v = _mm_set1_ps(gain);
+      for (; k + 4 <= ThreeBandFilterBank::kSplitBandSize; k += 4) {
+        const __m128 x_k = _mm_loadu_ps(&x[k]);
+        const __m128 y_k = _mm_loadu_ps(&y[k]);
+        _mm_storeu_ps(&y[k], _mm_add_ps(y_k, _mm_mul_ps(gain_v, x_k)));
+      }
+    } break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case VectorMathOptimization::kNeon: {
+      const float32x4_t gain_v = vdupq_n_f32(gain);
+      for (; k + 4 <= ThreeBandFilterBank::kSplitBandSize; k += 4) {
+        const float32x4_t x_k = vld1q_f32(&x[k]);
+        const float32x4_t y_k = vld1q_f32(&y[k]);
+        vst1q_f32(&y[k], vaddq_f32(y_k, vmulq_f32(gain_v, x_k)));
+      }
+    } break;
+#endif
+    default:
+      break;
+  }
+
+  for (; k < ThreeBandFilterBank::kSplitBandSize; ++k) {
+    y[k] += gain * x[k];
+  }
+}
+
 }  // namespace
 
 // Because the low-pass filter prototype has half bandwidth it is possible to
 // use a DCT to shift it in both directions at the same time, to the center
 // frequencies [1 / 12, 3 / 12, 5 / 12].
-ThreeBandFilterBank::ThreeBandFilterBank() {
+ThreeBandFilterBank::ThreeBandFilterBank()
+    : ThreeBandFilterBank(DetectVectorMathOptimization()) {}
+
+ThreeBandFilterBank::ThreeBandFilterBank(VectorMathOptimization optimization)
+    : optimization_(optimization) {
+  Reset();
+}
+
+ThreeBandFilterBank::~ThreeBandFilterBank() = default;
+
+void ThreeBandFilterBank::Reset() {
   RTC_DCHECK_EQ(state_analysis_.size(), kNumNonZeroFilters);
   RTC_DCHECK_EQ(state_synthesis_.size(), kNumNonZeroFilters);
   for (int k = 0; k < kNumNonZeroFilters; ++k) {
@@ -161,8 +254,6 @@ ThreeBandFilterBank::ThreeBandFilterBank() {
   }
 }
 
-ThreeBandFilterBank::~ThreeBandFilterBank() = default;
-
 // The analysis can be separated in these steps:
 //   1. Serial to parallel downsampling by a factor of |kNumBands|.
 //   2. Filtering of |kSparsity| different delayed signals with polyphase
@@ -207,13 +298,14 @@ void ThreeBandFilterBank::Analysis(
 
       // Filter.
       std::array<float, kSplitBandSize> out_subsampled;
-      FilterCore(filter, in_subsampled, in_shift, out_subsampled, state);
+      FilterCore(optimization_, filter, in_subsampled, in_shift,
+                 out_subsampled, state);
 
       // Band and modulate the output.
       for (int band = 0; band < ThreeBandFilterBank::kNumBands; ++band) {
-        for (int n = 0; n < kSplitBandSize; ++n) {
-          out[band][n] += dct_modulation[band] * out_subsampled[n];
-        }
+        AccumulateScaled(optimization_, dct_modulation[band], out_subsampled,
+                         rtc::ArrayView<float, kSplitBandSize>(
+                             out[band].data(), kSplitBandSize));
       }
     }
   }
@@ -254,14 +346,16 @@ void ThreeBandFilterBank::Synthesis(
       std::fill(in_subsampled.begin(), in_subsampled.end(), 0.f);
       for (int band = 0; band < ThreeBandFilterBank::kNumBands; ++band) {
         RTC_DCHECK_EQ(in[band].size(), kSplitBandSize);
-        for (int n = 0; n < kSplitBandSize; ++n) {
-          in_subsampled[n] += dct_modulation[band] * in[band][n];
-        }
+        AccumulateScaled(optimization_, dct_modulation[band],
+                         rtc::ArrayView<const float, kSplitBandSize>(
+                             in[band].data(), kSplitBandSize),
+                         in_subsampled);
       }
 
       // Filter.
       std::array<float, kSplitBandSize> out_subsampled;
-      FilterCore(filter, in_subsampled, in_shift, out_subsampled, state);
+      FilterCore(optimization_, filter, in_subsampled, in_shift,
+                 out_subsampled, state);
 
       // Upsample.
       constexpr float kUpsamplingScaling = kSubSampling;
@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "api/array_view.h"
+#include "common_audio/vector_math.h"
 
 namespace webrtc {
 
@@ -53,8 +54,12 @@ class ThreeBandFilterBank final {
       kSparsity * ThreeBandFilterBank::kNumBands - kNumZeroFilters;
 
   ThreeBandFilterBank();
+  explicit ThreeBandFilterBank(VectorMathOptimization optimization);
   ~ThreeBandFilterBank();
 
+  // Resets the filter states.
+  void Reset();
+
   // Splits |in| of size kFullBandSize into 3 downsampled frequency bands in
   // |out|, each of size 160.
   void Analysis(rtc::ArrayView<const float, kFullBandSize> in,
@@ -66,12 +71,34 @@ class ThreeBandFilterBank final {
                  rtc::ArrayView<float, kFullBandSize> out);
 
  private:
+  const VectorMathOptimization optimization_;
   std::array<std::array<float, kMemorySize>, kNumNonZeroFilters>
       state_analysis_;
   std::array<std::array<float, kMemorySize>, kNumNonZeroFilters>
       state_synthesis_;
 };
 
+// AVX2 versions of the kernels of the filter bank, selected at runtime when the
+// CPU supports them. The results match the scalar versions up to rounding, as
+// builds with FMA enabled may contract the multiply-adds differently in each
+// version.
+namespace three_band_filter_bank_avx2 {
+
+// Filters the |kSplitBandSize| samples starting at |in| with the sparse filter
+// |filter|. The |kMemorySize| samples preceding |in| must be valid, as the
+// filter taps reach back into them.
+void FilterCore(
+    rtc::ArrayView<const float, kFilterSize> filter,
+    const float* in,
+    rtc::ArrayView<float, ThreeBandFilterBank::kSplitBandSize> out);
+
+// y += gain * x.
+void AccumulateScaled(
+    float gain,
+    rtc::ArrayView<const float, ThreeBandFilterBank::kSplitBandSize> x,
+    rtc::ArrayView<float, ThreeBandFilterBank::kSplitBandSize> y);
+
+}  // namespace three_band_filter_bank_avx2
 }  // namespace webrtc
 
 #endif  // MODULES_AUDIO_PROCESSING_THREE_BAND_FILTER_BANK_H_
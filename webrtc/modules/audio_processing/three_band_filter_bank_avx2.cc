@@ -0,0 +1,57 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+
+#include "api/array_view.h"
+#include "modules/audio_processing/three_band_filter_bank.h"
+
+namespace webrtc {
+namespace three_band_filter_bank_avx2 {
+
+static_assert(ThreeBandFilterBank::kSplitBandSize % 8 == 0,
+              "The split band size must be a multiple of the AVX2 width");
+
+void FilterCore(
+    rtc::ArrayView<const float, kFilterSize> filter,
+    const float* in,
+    rtc::ArrayView<float, ThreeBandFilterBank::kSplitBandSize> out) {
+  __m256 filter_v[kFilterSize];
+  for (int i = 0; i < kFilterSize; ++i) {
+    filter_v[i] = _mm256_set1_ps(filter[i]);
+  }
+
+  // Multiplications and additions are kept separate, and in the same order as
+  // in the scalar code, so that the results only differ from the scalar code
+  // where the compiler fuses them differently.
+  for (int k = 0; k < ThreeBandFilterBank::kSplitBandSize; k += 8) {
+    __m256 out_k = _mm256_setzero_ps();
+    for (int i = 0; i < kFilterSize; ++i) {
+      const __m256 in_k = _mm256_loadu_ps(&in[k - kStride * i]);
+      out_k = _mm256_add_ps(out_k, _mm256_mul_ps(in_k, filter_v[i]));
+    }
+    _mm256_storeu_ps(&out[k], out_k);
+  }
+}
+
+void AccumulateScaled(
+    float gain,
+    rtc::ArrayView<const float, ThreeBandFilterBank::kSplitBandSize> x,
+    rtc::ArrayView<float, ThreeBandFilterBank::kSplitBandSize> y) {
+  const __m256 gain_v = _mm256_set1_ps(gain);
+  for (int k = 0; k < ThreeBandFilterBank::kSplitBandSize; k += 8) {
+    const __m256 x_k = _mm256_loadu_ps(&x[k]);
+    const __m256 y_k = _mm256_loadu_ps(&y[k]);
+    _mm256_storeu_ps(&y[k], _mm256_add_ps(y_k, _mm256_mul_ps(gain_v, x_k)));
+  }
+}
+
+}  // namespace three_band_filter_bank_avx2
+}  // namespace webrtc
@@ -10,12 +10,21 @@
 
 #include "modules/audio_processing/transient/moving_moments.h"
 
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
 #include <algorithm>
 
 #include "rtc_base/checks.h"
 
 namespace webrtc {
-
 MovingMoments::MovingMoments(size_t length)
     : length_(length), queue_(), sum_(0.0), sum_of_squares_(0.0) {
   RTC_DCHECK_GT(length, 0);
@@ -47,4 +56,119 @@ void MovingMoments::CalculateMoments(const float* in,
   }
 }
 
+BatchedMovingMoments::BatchedMovingMoments(size_t num_signals, size_t length)
+    : BatchedMovingMoments(num_signals,
+                           length,
+                           DetectVectorMathOptimization()) {}
+
+BatchedMovingMoments::BatchedMovingMoments(
+    size_t num_signals,
+    size_t length,
+    VectorMathOptimization optimization)
+    : optimization_(optimization),
+      num_signals_(num_signals),
+      length_(length),
+      history_(num_signals * length, 0.f),
+      sums_(num_signals, 0.f),
+      sums_of_squares_(num_signals, 0.f) {
+  RTC_DCHECK_GT(num_signals, 0);
+  RTC_DCHECK_GT(length, 0);
+}
+
+BatchedMovingMoments::~BatchedMovingMoments() = default;
+
+void BatchedMovingMoments::CalculateMoments(const float* in,
+                                            size_t in_length,
+                                            float* first,
+                                            float* second) {
+  RTC_DCHECK(in);
+  RTC_DCHECK_GT(in_length, 0);
+  RTC_DCHECK(first);
+  RTC_DCHECK(second);
+
+  // Each group of signals is updated over all the time steps before moving on
+  // to the next group, so that its sums stay in registers.
+  const float length = static_cast<float>(length_);
+  size_t s = 0;
+  switch (optimization_) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case VectorMathOptimization::kAvx2:
+    case VectorMathOptimization::kSse2: {
+      const __m128 length_v = _mm_set1_ps(length);
+      const __m128 zero = _mm_setzero_ps();
+      for (; s + 4 <= num_signals_; s += 4) {
+        __m128 sum = _mm_loadu_ps(&sums_[s]);
+        __m128 sum_of_squares = _mm_loadu_ps(&sums_of_squares_[s]);
+        size_t history_index = history_index_;
+        for (size_t i = 0; i < in_length; ++i) {
+          const size_t k = i * num_signals_ + s;
+          float* history = &history_[history_index * num_signals_ + s];
+          const __m128 value = _mm_loadu_ps(&in[k]);
+          const __m128 old_value = _mm_loadu_ps(history);
+          _mm_storeu_ps(history, value);
+          sum = _mm_add_ps(sum, _mm_sub_ps(value, old_value));
+          sum_of_squares = _mm_add_ps(
+              sum_of_squares, _mm_sub_ps(_mm_mul_ps(value, value),
+                                         _mm_mul_ps(old_value, old_value)));
+          _mm_storeu_ps(&first[k], _mm_div_ps(sum, length_v));
+          _mm_storeu_ps(&second[k],
+                        _mm_max_ps(zero, _mm_div_ps(sum_of_squares, length_v)));
+          history_index = history_index + 1 < length_ ? history_index + 1 : 0;
+        }
+        _mm_storeu_ps(&sums_[s], sum);
+        _mm_storeu_ps(&sums_of_squares_[s], sum_of_squares);
+      }
+    } break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case VectorMathOptimization::kNeon: {
+      // ARMv7 has no vector division.
+      const float inverse_length = 1.f / length;
+      const float32x4_t zero = vdupq_n_f32(0.f);
+      for (; s + 4 <= num_signals_; s += 4) {
+        float32x4_t sum = vld1q_f32(&sums_[s]);
+        float32x4_t sum_of_squares = vld1q_f32(&sums_of_squares_[s]);
+        size_t history_index = history_index_;
+        for (size_t i = 0; i < in_length; ++i) {
+          const size_t k = i * num_signals_ + s;
+          float* history = &history_[history_index * num_signals_ + s];
+          const float32x4_t value = vld1q_f32(&in[k]);
+          const float32x4_t old_value = vld1q_f32(history);
+          vst1q_f32(history, value);
+          sum = vaddq_f32(sum, vsubq_f32(value, old_value));
+          const float32x4_t squares_difference = vsubq_f32(
+              vmulq_f32(value, value), vmulq_f32(old_value, old_value));
+          sum_of_squares = vaddq_f32(sum_of_squares, squares_difference);
+          vst1q_f32(&first[k], vmulq_n_f32(sum, inverse_length));
+          vst1q_f32(&second[k], vmaxq_f32(zero, vmulq_n_f32(sum_of_squares,
+                                                            inverse_length)));
+          history_index = history_index + 1 < length_ ? history_index + 1 : 0;
+        }
+        vst1q_f32(&sums_[s], sum);
+        vst1q_f32(&sums_of_squares_[s], sum_of_squares);
+      }
+    } break;
+#endif
+    default:
+      break;
+  }
+
+  for (; s < num_signals_; ++s) {
+    size_t history_index = history_index_;
+    for (size_t i = 0; i < in_length; ++i) {
+      const size_t k = i * num_signals_ + s;
+      float& history = history_[history_index * num_signals_ + s];
+      const float old_value = history;
+      history = in[k];
+      sums_[s] += in[k] - old_value;
+      sums_of_squares_[s] += in[k] * in[k] - old_value * old_value;
+      first[k] = sums_[s] / length;
+      second[k] = std::max(0.f, sums_of_squares_[s] / length);
+      history_index = history_index + 1 < length_ ? history_index + 1 : 0;
+    }
+  }
+
+  history_index_ = (history_index_ + in_length) % length_;
+}
+
 }  // namespace webrtc
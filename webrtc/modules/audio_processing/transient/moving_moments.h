@@ -14,6 +14,9 @@
 #include <stddef.h>
 
 #include <queue>
+#include <vector>
+
+#include "common_audio/vector_math.h"
 
 namespace webrtc {
 
@@ -48,6 +51,48 @@ class MovingMoments {
   float sum_of_squares_;
 };
 
+// Calculates the first and second moments of several signals at once, with the
+// same results as one MovingMoments object per signal. The signals are
+// interleaved, so that the moments of all the signals are updated together for
+// each time step.
+// It preserves its state, so it can be multiple-called.
+class BatchedMovingMoments {
+ public:
+  // Creates an object for |num_signals| signals, that uses the last |length|
+  // values of each signal.
+  BatchedMovingMoments(size_t num_signals, size_t length);
+  // Sets the optimization to use, for testing purposes.
+  BatchedMovingMoments(size_t num_signals,
+                       size_t length,
+                       VectorMathOptimization optimization);
+  ~BatchedMovingMoments();
+
+  // Calculates the new values using |in|, which holds |in_length| values of
+  // each signal, interleaved. The results are interleaved in the same way in
+  // the out buffers. |first| and |second| must be allocated with at least
+  // |in_length| * num_signals().
+  void CalculateMoments(const float* in,
+                        size_t in_length,
+                        float* first,
+                        float* second);
+
+  size_t num_signals() const { return num_signals_; }
+
+ private:
+  const VectorMathOptimization optimization_;
+  const size_t num_signals_;
+  const size_t length_;
+  // Circular buffer holding the |length_| latest values of each signal,
+  // interleaved.
+  std::vector<float> history_;
+  // Position of the oldest values in |history_|.
+  size_t history_index_ = 0;
+  // Sums of the values and of the squares of the values in |history_|, for
+  // each signal.
+  std::vector<float> sums_;
+  std::vector<float> sums_of_squares_;
+};
+
 }  // namespace webrtc
 
 #endif  // MODULES_AUDIO_PROCESSING_TRANSIENT_MOVING_MOMENTS_H_
@@ -17,10 +17,6 @@
 #include <cmath>
 
 #include "modules/audio_processing/transient/common.h"
-#include "modules/audio_processing/transient/daubechies_8_wavelet_coeffs.h"
-#include "modules/audio_processing/transient/moving_moments.h"
-#include "modules/audio_processing/transient/wpd_node.h"
-#include "modules/audio_processing/transient/wpd_tree.h"
 #include "rtc_base/checks.h"
 
 namespace webrtc {
@@ -30,8 +26,26 @@ static const int kChunksAtStartupLeftToDelete =
     kTransientLengthMs / ts::kChunkSizeMs;
 static const float kDetectThreshold = 16.f;
 
+// Adjustment to avoid data loss while downsampling, making the number of
+// samples per chunk and per transient always divisible by the number of leaves.
+static size_t RoundDownToMultiple(size_t value, size_t multiple) {
+  return value - value % multiple;
+}
+
 TransientDetector::TransientDetector(int sample_rate_hz)
-    : samples_per_chunk_(sample_rate_hz * ts::kChunkSizeMs / 1000),
+    : samples_per_chunk_(
+          RoundDownToMultiple(sample_rate_hz * ts::kChunkSizeMs / 1000,
+                              kLeaves)),
+      wpd_(samples_per_chunk_, kLevels),
+      tree_leaves_data_length_(samples_per_chunk_ / kLeaves),
+      moving_moments_(
+          kLeaves,
+          RoundDownToMultiple(sample_rate_hz * kTransientLengthMs / 1000,
+                              kLeaves) /
+              kLeaves),
+      leaves_data_(samples_per_chunk_),
+      first_moments_(samples_per_chunk_),
+      second_moments_(samples_per_chunk_),
       last_first_moment_(),
       last_second_moment_(),
       chunks_at_startup_left_to_delete_(kChunksAtStartupLeftToDelete),
@@ -41,25 +55,6 @@ TransientDetector::TransientDetector(int sample_rate_hz)
              sample_rate_hz == ts::kSampleRate16kHz ||
              sample_rate_hz == ts::kSampleRate32kHz ||
              sample_rate_hz == ts::kSampleRate48kHz);
-  int samples_per_transient = sample_rate_hz * kTransientLengthMs / 1000;
-  // Adjustment to avoid data loss while downsampling, making
-  // |samples_per_chunk_| and |samples_per_transient| always divisible by
-  // |kLeaves|.
-  samples_per_chunk_ -= samples_per_chunk_ % kLeaves;
-  samples_per_transient -= samples_per_transient % kLeaves;
-
-  tree_leaves_data_length_ = samples_per_chunk_ / kLeaves;
-  wpd_tree_.reset(new WPDTree(samples_per_chunk_,
-                              kDaubechies8HighPassCoefficients,
-                              kDaubechies8LowPassCoefficients,
-                              kDaubechies8CoefficientsLength, kLevels));
-  for (size_t i = 0; i < kLeaves; ++i) {
-    moving_moments_[i].reset(
-        new MovingMoments(samples_per_transient / kLeaves));
-  }
-
-  first_moments_.reset(new float[tree_leaves_data_length_]);
-  second_moments_.reset(new float[tree_leaves_data_length_]);
 
   for (int i = 0; i < kChunksAtStartupLeftToDelete; ++i) {
     previous_results_.push_back(0.f);
@@ -75,36 +70,43 @@ float TransientDetector::Detect(const float* data,
   RTC_DCHECK(data);
   RTC_DCHECK_EQ(samples_per_chunk_, data_length);
 
-  // TODO(aluebs): Check if these errors can logically happen and if not assert
-  // on them.
-  if (wpd_tree_->Update(data, samples_per_chunk_) != 0) {
+  if (!data) {
     return -1.f;
   }
+  wpd_.Update(rtc::ArrayView<const float>(data, samples_per_chunk_));
 
-  float result = 0.f;
-
+  // Interleave the leaves, so that the moments of all the leaves are
+  // calculated in a single pass.
   for (size_t i = 0; i < kLeaves; ++i) {
-    WPDNode* leaf = wpd_tree_->NodeAt(kLevels, i);
-
-    moving_moments_[i]->CalculateMoments(leaf->data(), tree_leaves_data_length_,
-                                         first_moments_.get(),
-                                         second_moments_.get());
-
-    // Add value delayed (Use the last moments from the last call to Detect).
-    float unbiased_data = leaf->data()[0] - last_first_moment_[i];
-    result +=
-        unbiased_data * unbiased_data / (last_second_moment_[i] + FLT_MIN);
-
-    // Add new values.
-    for (size_t j = 1; j < tree_leaves_data_length_; ++j) {
-      unbiased_data = leaf->data()[j] - first_moments_[j - 1];
-      result +=
-          unbiased_data * unbiased_data / (second_moments_[j - 1] + FLT_MIN);
+    rtc::ArrayView<const float> leaf = wpd_.NodeAt(kLevels, i);
+    for (size_t j = 0; j < tree_leaves_data_length_; ++j) {
+      leaves_data_[j * kLeaves + i] = leaf[j];
     }
+  }
+  moving_moments_.CalculateMoments(leaves_data_.data(),
+                                   tree_leaves_data_length_,
+                                   first_moments_.data(),
+                                   second_moments_.data());
 
-    last_first_moment_[i] = first_moments_[tree_leaves_data_length_ - 1];
-    last_second_moment_[i] = second_moments_[tree_leaves_data_length_ - 1];
+  // Each value is compared to the moments up to the previous value, which for
+  // the first value are the last moments from the last call to Detect.
+  float result = 0.f;
+  const float* previous_first_moments = last_first_moment_;
+  const float* previous_second_moments = last_second_moment_;
+  for (size_t j = 0; j < tree_leaves_data_length_; ++j) {
+    const float* values = &leaves_data_[j * kLeaves];
+    for (size_t i = 0; i < kLeaves; ++i) {
+      const float unbiased_data = values[i] - previous_first_moments[i];
+      result += unbiased_data * unbiased_data /
+                (previous_second_moments[i] + FLT_MIN);
+    }
+    previous_first_moments = &first_moments_[j * kLeaves];
+    previous_second_moments = &second_moments_[j * kLeaves];
   }
+  std::copy(previous_first_moments, previous_first_moments + kLeaves,
+            last_first_moment_);
+  std::copy(previous_second_moments, previous_second_moments + kLeaves,
+            last_second_moment_);
 
   result /= tree_leaves_data_length_;
 
@@ -14,10 +14,10 @@
 #include <stddef.h>
 
 #include <deque>
-#include <memory>
+#include <vector>
 
 #include "modules/audio_processing/transient/moving_moments.h"
-#include "modules/audio_processing/transient/wpd_tree.h"
+#include "modules/audio_processing/transient/wavelet_packet_decomposition.h"
 
 namespace webrtc {
 
@@ -57,14 +57,16 @@ class TransientDetector {
 
   size_t samples_per_chunk_;
 
-  std::unique_ptr<WPDTree> wpd_tree_;
+  WaveletPacketDecomposition wpd_;
   size_t tree_leaves_data_length_;
 
-  // A MovingMoments object is needed for each leaf in the WPD tree.
-  std::unique_ptr<MovingMoments> moving_moments_[kLeaves];
+  // The moments of all the leaves of the WPD are calculated together, from
+  // the leaf data interleaved in |leaves_data_|.
+  BatchedMovingMoments moving_moments_;
 
-  std::unique_ptr<float[]> first_moments_;
-  std::unique_ptr<float[]> second_moments_;
+  std::vector<float> leaves_data_;
+  std::vector<float> first_moments_;
+  std::vector<float> second_moments_;
 
   // Stores the last calculated moments from the previous detection.
   float last_first_moment_[kLeaves];
@@ -0,0 +1,202 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// A node of a WPDTree filters its parent data x with a 16 tap filter h and
+// keeps the odd output samples,
+//
+//   y[m] = sum_{k=0..15} h[k] * x[2m+1-k].
+//
+// Splitting the sum into the even and odd taps gives
+//
+//   y[m] = sum_{t=0..7} h[2t] * x_odd[m-t] + h[2t+1] * x_even[m-t],
+//
+// with x_even[m] = x[2m] and x_odd[m] = x[2m+1]. Each decimated output is then
+// computed from contiguous samples, and both children of a node share the
+// loads of its even and odd samples.
+
+#include "modules/audio_processing/transient/wavelet_packet_decomposition.h"
+
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+#include <math.h>
+
+#include <algorithm>
+
+#include "modules/audio_processing/transient/daubechies_8_wavelet_coeffs.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kTapsPerPhase = kDaubechies8CoefficientsLength / 2;
+// Number of samples of the previous call needed to filter a node, and the
+// corresponding number of samples in each polyphase component.
+constexpr size_t kPhaseHistorySize = kTapsPerPhase - 1;
+constexpr size_t kHistorySize = 2 * kPhaseHistorySize;
+
+// Computes the |out_length| samples of both children of the node with the data
+// |x|, which is preceded by kHistorySize samples of the previous call. |even|
+// and |odd| are scratch buffers of kPhaseHistorySize + |out_length| samples.
+void SplitNode(VectorMathOptimization optimization,
+               const float* x,
+               size_t out_length,
+               float* even,
+               float* odd,
+               float* low,
+               float* high) {
+  const float* h_low = kDaubechies8LowPassCoefficients;
+  const float* h_high = kDaubechies8HighPassCoefficients;
+
+  // Split into the polyphase components. Sample m of the node is placed at
+  // index kPhaseHistorySize + m / 2.
+  const float* x_history = x - kHistorySize;
+  for (size_t j = 0; j < kPhaseHistorySize + out_length; ++j) {
+    even[j] = x_history[2 * j];
+    odd[j] = x_history[2 * j + 1];
+  }
+
+  size_t m = 0;
+  switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case VectorMathOptimization::kAvx2:
+    case VectorMathOptimization::kSse2: {
+      const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+      for (; m + 4 <= out_length; m += 4) {
+        __m128 low_v = _mm_setzero_ps();
+        __m128 high_v = _mm_setzero_ps();
+        for (size_t t = 0; t < kTapsPerPhase; ++t) {
+          const __m128 odd_v = _mm_loadu_ps(&odd[m + kPhaseHistorySize - t]);
+          const __m128 even_v = _mm_loadu_ps(&even[m + kPhaseHistorySize - t]);
+          low_v = _mm_add_ps(low_v,
+                             _mm_mul_ps(_mm_set1_ps(h_low[2 * t]), odd_v));
+          low_v = _mm_add_ps(
+              low_v, _mm_mul_ps(_mm_set1_ps(h_low[2 * t + 1]), even_v));
+          high_v = _mm_add_ps(high_v,
+                              _mm_mul_ps(_mm_set1_ps(h_high[2 * t]), odd_v));
+          high_v = _mm_add_ps(
+              high_v, _mm_mul_ps(_mm_set1_ps(h_high[2 * t + 1]), even_v));
+        }
+        _mm_storeu_ps(&low[m], _mm_and_ps(low_v, abs_mask));
+        _mm_storeu_ps(&high[m], _mm_and_ps(high_v, abs_mask));
+      }
+    } break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case VectorMathOptimization::kNeon: {
+      for (; m + 4 <= out_length; m += 4) {
+        float32x4_t low_v = vdupq_n_f32(0.f);
+        float32x4_t high_v = vdupq_n_f32(0.f);
+        for (size_t t = 0; t < kTapsPerPhase; ++t) {
+          const float32x4_t odd_v = vld1q_f32(&odd[m + kPhaseHistorySize - t]);
+          const float32x4_t even_v =
+              vld1q_f32(&even[m + kPhaseHistorySize - t]);
+          low_v = vmlaq_n_f32(low_v, odd_v, h_low[2 * t]);
+          low_v = vmlaq_n_f32(low_v, even_v, h_low[2 * t + 1]);
+          high_v = vmlaq_n_f32(high_v, odd_v, h_high[2 * t]);
+          high_v = vmlaq_n_f32(high_v, even_v, h_high[2 * t + 1]);
+        }
+        vst1q_f32(&low[m], vabsq_f32(low_v));
+        vst1q_f32(&high[m], vabsq_f32(high_v));
+      }
+    } break;
+#endif
+    default:
+      break;
+  }
+
+  for (; m < out_length; ++m) {
+    float low_sum = 0.f;
+    float high_sum = 0.f;
+    for (size_t t = 0; t < kTapsPerPhase; ++t) {
+      const float odd_sample = odd[m + kPhaseHistorySize - t];
+      const float even_sample = even[m + kPhaseHistorySize - t];
+      low_sum += h_low[2 * t] * odd_sample;
+      low_sum += h_low[2 * t + 1] * even_sample;
+      high_sum += h_high[2 * t] * odd_sample;
+      high_sum += h_high[2 * t + 1] * even_sample;
+    }
+    low[m] = fabsf(low_sum);
+    high[m] = fabsf(high_sum);
+  }
+}
+
+}  // namespace
+
+WaveletPacketDecomposition::WaveletPacketDecomposition(size_t data_length,
+                                                       int levels)
+    : WaveletPacketDecomposition(data_length,
+                                 levels,
+                                 DetectVectorMathOptimization()) {}
+
+WaveletPacketDecomposition::WaveletPacketDecomposition(
+    size_t data_length,
+    int levels,
+    VectorMathOptimization optimization)
+    : optimization_(optimization),
+      data_length_(data_length),
+      levels_(levels),
+      level_data_(levels + 1),
+      even_samples_(kPhaseHistorySize + data_length / 2, 0.f),
+      odd_samples_(kPhaseHistorySize + data_length / 2, 0.f) {
+  RTC_DCHECK_GT(levels, 0);
+  RTC_DCHECK_EQ(data_length % (static_cast<size_t>(1) << levels), 0);
+  for (int level = 0; level <= levels_; ++level) {
+    level_data_[level].resize(
+        (static_cast<size_t>(1) << level) * (kHistorySize + NodeLength(level)),
+        0.f);
+  }
+}
+
+WaveletPacketDecomposition::~WaveletPacketDecomposition() = default;
+
+float* WaveletPacketDecomposition::NodeData(int level, int index) {
+  return &level_data_[level][index * (kHistorySize + NodeLength(level)) +
+                             kHistorySize];
+}
+
+rtc::ArrayView<const float> WaveletPacketDecomposition::NodeAt(
+    int level,
+    int index) const {
+  RTC_DCHECK_GE(level, 0);
+  RTC_DCHECK_LE(level, levels_);
+  RTC_DCHECK_GE(index, 0);
+  RTC_DCHECK_LT(index, 1 << level);
+  const size_t length = NodeLength(level);
+  return rtc::ArrayView<const float>(
+      &level_data_[level][index * (kHistorySize + length) + kHistorySize],
+      length);
+}
+
+void WaveletPacketDecomposition::Update(rtc::ArrayView<const float> data) {
+  RTC_DCHECK_EQ(data.size(), data_length_);
+  std::copy(data.begin(), data.end(), NodeData(0, 0));
+
+  for (int level = 0; level < levels_; ++level) {
+    const size_t length = NodeLength(level);
+    for (int i = 0; i < (1 << level); ++i) {
+      float* node = NodeData(level, i);
+      SplitNode(optimization_, node, length / 2, even_samples_.data(),
+                odd_samples_.data(), NodeData(level + 1, 2 * i),
+                NodeData(level + 1, 2 * i + 1));
+      // Keep the history needed to filter the next chunk.
+      std::copy(node + length - kHistorySize, node + length,
+                node - kHistorySize);
+    }
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,70 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_TRANSIENT_WAVELET_PACKET_DECOMPOSITION_H_
+#define MODULES_AUDIO_PROCESSING_TRANSIENT_WAVELET_PACKET_DECOMPOSITION_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "api/array_view.h"
+#include "common_audio/vector_math.h"
+
+namespace webrtc {
+
+// Daubechies 8 Wavelet Packet Decomposition, computing the same node data as a
+// WPDTree built with the Daubechies 8 coefficients. Instead of filtering and
+// decimating each node separately, the children of a node are computed
+// together directly at the decimated rate, from a polyphase split of the node
+// data. The nodes of each level are stored contiguously, each preceded by the
+// samples of the previous call needed to filter it.
+// It preserves its state, so it can be multiple-called.
+class WaveletPacketDecomposition {
+ public:
+  // Creates a decomposition with |levels| levels below the root, for chunks of
+  // |data_length| samples. |data_length| must be divisible by 2 ^ |levels|.
+  WaveletPacketDecomposition(size_t data_length, int levels);
+  // Sets the optimization to use, for testing purposes.
+  WaveletPacketDecomposition(size_t data_length,
+                             int levels,
+                             VectorMathOptimization optimization);
+  ~WaveletPacketDecomposition();
+
+  // Updates all the nodes with a new chunk of data.
+  void Update(rtc::ArrayView<const float> data);
+
+  // Returns the data of the node at |index| of the level |level|, with the same
+  // indexing as WPDTree::NodeAt(). All nodes except the root hold the absolute
+  // values of the filter outputs.
+  rtc::ArrayView<const float> NodeAt(int level, int index) const;
+
+  int levels() const { return levels_; }
+  int num_leaves() const { return 1 << levels_; }
+
+ private:
+  size_t NodeLength(int level) const { return data_length_ >> level; }
+  float* NodeData(int level, int index);
+
+  const VectorMathOptimization optimization_;
+  const size_t data_length_;
+  const int levels_;
+  // The nodes of each level, one after the other. Each node is preceded by the
+  // history needed to filter it.
+  std::vector<std::vector<float>> level_data_;
+  // Even and odd samples of the node being filtered, preceded by their
+  // histories.
+  std::vector<float> even_samples_;
+  std::vector<float> odd_samples_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_TRANSIENT_WAVELET_PACKET_DECOMPOSITION_H_
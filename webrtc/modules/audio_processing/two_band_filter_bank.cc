@@ -0,0 +1,258 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Each all-pass section computes
+//
+//   y[n] = x[n-1] + a * (x[n] - y[n-1]),
+//
+// which is a first order recursion and can not be vectorized over n as it
+// stands. It is rewritten as a non-recursive part u[n] = x[n-1] + a * x[n],
+// which vectorizes trivially, followed by the recursion y[n] = u[n] + b *
+// y[n-1] with b = -a. Unrolling the recursion over a block of four samples
+// gives
+//
+//   y[n+k] = sum_{j=0..k} b^(k-j) * u[n+j] + b^(k+1) * y[n-1],  k = 0..3,
+//
+// so that each block only depends on the previous one through its last output
+// sample. This replaces four serially dependent multiply-adds per block with
+// five independent vector multiply-adds.
+
+#include "modules/audio_processing/two_band_filter_bank.h"
+
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <array>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kSplitBandSize = TwoBandFilterBank::kSplitBandSize;
+constexpr int kNumAllPassSections = TwoBandFilterBank::kNumAllPassSections;
+constexpr int kBlockSize = 4;
+
+// All-pass filter coefficients of the two polyphase branches. These are the
+// Q16 coefficients of the fixed point QMF in
+// common_audio/signal_processing/splitting_filter.c.
+constexpr std::array<float, kNumAllPassSections> kAllPassCoefficients1 = {
+    6418.f / 65536.f, 36982.f / 65536.f, 57261.f / 65536.f};
+constexpr std::array<float, kNumAllPassSections> kAllPassCoefficients2 = {
+    21333.f / 65536.f, 49062.f / 65536.f, 63010.f / 65536.f};
+
+// Gains applied to the non-recursive part and to the last output of the
+// previous block when computing a block of all-pass output samples.
+struct AllPassBlockGains {
+  explicit AllPassBlockGains(float a) {
+    const float b = -a;
+    std::array<float, kBlockSize + 1> b_pow;
+    b_pow[0] = 1.f;
+    for (int k = 1; k <= kBlockSize; ++k) {
+      b_pow[k] = b_pow[k - 1] * b;
+    }
+    for (int j = 0; j < kBlockSize; ++j) {
+      for (int k = 0; k < kBlockSize; ++k) {
+        input[j][k] = k < j ? 0.f : b_pow[k - j];
+      }
+    }
+    for (int k = 0; k < kBlockSize; ++k) {
+      feedback[k] = b_pow[k + 1];
+    }
+  }
+
+  // input[j][k] is the contribution of u[n+j] to y[n+k].
+  std::array<std::array<float, kBlockSize>, kBlockSize> input;
+  // feedback[k] is the contribution of y[n-1] to y[n+k].
+  std::array<float, kBlockSize> feedback;
+};
+
+// Filters |data| in place with the first-order all-pass section with
+// coefficient |a|. |x_prev| and |y_prev| hold the last input and output sample
+// of the previous call and are updated.
+void AllPassSection(VectorMathOptimization optimization,
+                    float a,
+                    rtc::ArrayView<float, kSplitBandSize> data,
+                    float* x_prev,
+                    float* y_prev) {
+  // Place the previous input in front of the current one so that x[n-1] and
+  // x[n] can both be read from contiguous memory.
+  std::array<float, kSplitBandSize + 1> extended_in;
+  extended_in[0] = *x_prev;
+  std::copy(data.begin(), data.end(), extended_in.begin() + 1);
+  const float* x = &extended_in[1];
+  float y = *y_prev;
+
+  int k = 0;
+  switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case VectorMathOptimization::kAvx2:
+    case VectorMathOptimization::kSse2: {
+      const AllPassBlockGains gains(a);
+      const __m128 a_v = _mm_set1_ps(a);
+      const __m128 g0 = _mm_loadu_ps(gains.input[0].data());
+      const __m128 g1 = _mm_loadu_ps(gains.input[1].data());
+      const __m128 g2 = _mm_loadu_ps(gains.input[2].data());
+      const __m128 g3 = _mm_loadu_ps(gains.input[3].data());
+      const __m128 g_feedback = _mm_loadu_ps(gains.feedback.data());
+      __m128 y_v = _mm_set1_ps(y);
+      for (; k + kBlockSize <= kSplitBandSize; k += kBlockSize) {
+        const __m128 u = _mm_add_ps(_mm_loadu_ps(&x[k - 1]),
+                                    _mm_mul_ps(a_v, _mm_loadu_ps(&x[k])));
+        __m128 acc = _mm_mul_ps(g_feedback, y_v);
+        acc = _mm_add_ps(
+            acc, _mm_mul_ps(g0, _mm_shuffle_ps(u, u, _MM_SHUFFLE(0, 0, 0, 0))));
+        acc = _mm_add_ps(
+            acc, _mm_mul_ps(g1, _mm_shuffle_ps(u, u, _MM_SHUFFLE(1, 1, 1, 1))));
+        acc = _mm_add_ps(
+            acc, _mm_mul_ps(g2, _mm_shuffle_ps(u, u, _MM_SHUFFLE(2, 2, 2, 2))));
+        acc = _mm_add_ps(
+            acc, _mm_mul_ps(g3, _mm_shuffle_ps(u, u, _MM_SHUFFLE(3, 3, 3, 3))));
+        _mm_storeu_ps(&data[k], acc);
+        y_v = _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(3, 3, 3, 3));
+      }
+      y = _mm_cvtss_f32(y_v);
+    } break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case VectorMathOptimization::kNeon: {
+      const AllPassBlockGains gains(a);
+      const float32x4_t a_v = vdupq_n_f32(a);
+      const float32x4_t g0 = vld1q_f32(gains.input[0].data());
+      const float32x4_t g1 = vld1q_f32(gains.input[1].data());
+      const float32x4_t g2 = vld1q_f32(gains.input[2].data());
+      const float32x4_t g3 = vld1q_f32(gains.input[3].data());
+      const float32x4_t g_feedback = vld1q_f32(gains.feedback.data());
+      float32x4_t y_v = vdupq_n_f32(y);
+      for (; k + kBlockSize <= kSplitBandSize; k += kBlockSize) {
+        const float32x4_t u =
+            vmlaq_f32(vld1q_f32(&x[k - 1]), a_v, vld1q_f32(&x[k]));
+        const float32x2_t u_low = vget_low_f32(u);
+        const float32x2_t u_high = vget_high_f32(u);
+        float32x4_t acc = vmulq_f32(g_feedback, y_v);
+        acc = vmlaq_lane_f32(acc, g0, u_low, 0);
+        acc = vmlaq_lane_f32(acc, g1, u_low, 1);
+        acc = vmlaq_lane_f32(acc, g2, u_high, 0);
+        acc = vmlaq_lane_f32(acc, g3, u_high, 1);
+        vst1q_f32(&data[k], acc);
+        y_v = vdupq_n_f32(vgetq_lane_f32(acc, 3));
+      }
+      y = vgetq_lane_f32(y_v, 0);
+    } break;
+#endif
+    default:
+      break;
+  }
+
+  for (; k < kSplitBandSize; ++k) {
+    y = x[k - 1] + a * (x[k] - y);
+    data[k] = y;
+  }
+
+  *x_prev = x[kSplitBandSize - 1];
+  *y_prev = y;
+}
+
+// Filters |data| in place with the cascade of all-pass sections with the
+// coefficients |coefficients|.
+void AllPassCascade(
+    VectorMathOptimization optimization,
+    const std::array<float, kNumAllPassSections>& coefficients,
+    rtc::ArrayView<float, kSplitBandSize> data,
+    rtc::ArrayView<float, 2 * kNumAllPassSections> state) {
+  for (int i = 0; i < kNumAllPassSections; ++i) {
+    AllPassSection(optimization, coefficients[i], data, &state[2 * i],
+                   &state[2 * i + 1]);
+  }
+}
+
+}  // namespace
+
+TwoBandFilterBank::TwoBandFilterBank()
+    : TwoBandFilterBank(DetectVectorMathOptimization()) {}
+
+TwoBandFilterBank::TwoBandFilterBank(VectorMathOptimization optimization)
+    : optimization_(optimization) {
+  Reset();
+}
+
+TwoBandFilterBank::~TwoBandFilterBank() = default;
+
+void TwoBandFilterBank::Reset() {
+  analysis_state1_.fill(0.f);
+  analysis_state2_.fill(0.f);
+  synthesis_state1_.fill(0.f);
+  synthesis_state2_.fill(0.f);
+}
+
+void TwoBandFilterBank::Analysis(
+    rtc::ArrayView<const float, kFullBandSize> in,
+    rtc::ArrayView<const rtc::ArrayView<float>, kNumBands> out) {
+  RTC_DCHECK_EQ(out[0].size(), kSplitBandSize);
+  RTC_DCHECK_EQ(out[1].size(), kSplitBandSize);
+
+  // Split into the odd and the even samples.
+  std::array<float, kSplitBandSize> half_in1;
+  std::array<float, kSplitBandSize> half_in2;
+  for (int k = 0; k < kSplitBandSize; ++k) {
+    half_in2[k] = in[2 * k];
+    half_in1[k] = in[2 * k + 1];
+  }
+
+  // All-pass filter the odd and even samples independently.
+  AllPassCascade(optimization_, kAllPassCoefficients1, half_in1,
+                 analysis_state1_);
+  AllPassCascade(optimization_, kAllPassCoefficients2, half_in2,
+                 analysis_state2_);
+
+  // Take the sum and difference of the filtered branches to get the lower and
+  // upper band.
+  for (int k = 0; k < kSplitBandSize; ++k) {
+    out[0][k] = 0.5f * (half_in1[k] + half_in2[k]);
+    out[1][k] = 0.5f * (half_in1[k] - half_in2[k]);
+  }
+}
+
+void TwoBandFilterBank::Synthesis(
+    rtc::ArrayView<const rtc::ArrayView<float>, kNumBands> in,
+    rtc::ArrayView<float, kFullBandSize> out) {
+  RTC_DCHECK_EQ(in[0].size(), kSplitBandSize);
+  RTC_DCHECK_EQ(in[1].size(), kSplitBandSize);
+
+  // Obtain the sum and difference of the lower and upper band.
+  std::array<float, kSplitBandSize> half_in1;
+  std::array<float, kSplitBandSize> half_in2;
+  for (int k = 0; k < kSplitBandSize; ++k) {
+    half_in1[k] = in[0][k] + in[1][k];
+    half_in2[k] = in[0][k] - in[1][k];
+  }
+
+  // All-pass filter the sum and difference.
+  AllPassCascade(optimization_, kAllPassCoefficients2, half_in1,
+                 synthesis_state1_);
+  AllPassCascade(optimization_, kAllPassCoefficients1, half_in2,
+                 synthesis_state2_);
+
+  // The filtered signals are the even and odd samples of the output.
+  for (int k = 0; k < kSplitBandSize; ++k) {
+    out[2 * k] = half_in2[k];
+    out[2 * k + 1] = half_in1[k];
+  }
+}
+
+}  // namespace webrtc
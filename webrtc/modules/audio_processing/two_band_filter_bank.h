@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_TWO_BAND_FILTER_BANK_H_
+#define MODULES_AUDIO_PROCESSING_TWO_BAND_FILTER_BANK_H_
+
+#include <array>
+
+#include "api/array_view.h"
+#include "common_audio/vector_math.h"
+
+namespace webrtc {
+
+// A floating point implementation of the 2-band QMF filter bank in
+// WebRtcSpl_AnalysisQMF() and WebRtcSpl_SynthesisQMF(). The even and odd input
+// samples are filtered by two cascades of three first-order all-pass sections
+// and the bands are obtained as the sum and difference of the two branches.
+// The coefficients are the same as in the fixed point version, but the signal
+// is kept in float at the FloatS16 scale, so no quantization or saturation to
+// 16 bits takes place.
+class TwoBandFilterBank final {
+ public:
+  static const int kNumBands = 2;
+  static const int kFullBandSize = 320;
+  static const int kSplitBandSize =
+      TwoBandFilterBank::kFullBandSize / TwoBandFilterBank::kNumBands;
+  static const int kNumAllPassSections = 3;
+
+  TwoBandFilterBank();
+  explicit TwoBandFilterBank(VectorMathOptimization optimization);
+  ~TwoBandFilterBank();
+
+  // Resets the filter states.
+  void Reset();
+
+  // Splits |in| of size kFullBandSize into 2 downsampled frequency bands in
+  // |out|, each of size 160.
+  void Analysis(rtc::ArrayView<const float, kFullBandSize> in,
+                rtc::ArrayView<const rtc::ArrayView<float>, kNumBands> out);
+
+  // Merges the 2 downsampled frequency bands in |in|, each of size 160, into
+  // |out|, which is of size kFullBandSize.
+  void Synthesis(rtc::ArrayView<const rtc::ArrayView<float>, kNumBands> in,
+                 rtc::ArrayView<float, kFullBandSize> out);
+
+ private:
+  // The last input and output sample of each all-pass section in a cascade.
+  using AllPassState = std::array<float, 2 * kNumAllPassSections>;
+
+  const VectorMathOptimization optimization_;
+  AllPassState analysis_state1_;
+  AllPassState analysis_state2_;
+  AllPassState synthesis_state1_;
+  AllPassState synthesis_state2_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_TWO_BAND_FILTER_BANK_H_
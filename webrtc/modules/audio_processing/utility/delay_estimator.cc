@@ -10,6 +10,15 @@
 
 #include "modules/audio_processing/utility/delay_estimator.h"
 
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
 #include <stdlib.h>
 #include <string.h>
 
@@ -41,6 +50,9 @@ static const float kQ14Scaling = 1.f / (1 << 14);  // Scaling by 2^14 to get Q0.
 static const float kFractionSlope = 0.05f;
 static const float kMinFractionWhenPossiblyCausal = 0.5f;
 static const float kMinFractionWhenPossiblyNonCausal = 0.25f;
+// Number of histogram bins in the neighborhoods of |candidate_delay| and
+// |last_delay| in UpdateRobustValidationStatistics().
+static const int kNeighborhoodBins = 4;
 
 }  // namespace
 
@@ -80,6 +92,79 @@ static void BitCountComparison(uint32_t binary_vector,
   }
 }
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Same as BitCountComparison(), comparing four rows at a time. The bits are
+// counted in parallel within each 32-bit lane.
+static void BitCountComparisonSse2(uint32_t binary_vector,
+                                   const uint32_t* binary_matrix,
+                                   int matrix_size,
+                                   int32_t* bit_counts) {
+  const __m128i vector = _mm_set1_epi32((int32_t)binary_vector);
+  const __m128i mask1 = _mm_set1_epi32(0x55555555);
+  const __m128i mask2 = _mm_set1_epi32(0x33333333);
+  const __m128i mask4 = _mm_set1_epi32(0x0F0F0F0F);
+  const __m128i mask6 = _mm_set1_epi32(0x3F);
+  int n = 0;
+
+  for (; n + 4 <= matrix_size; n += 4) {
+    __m128i x = _mm_xor_si128(
+        vector, _mm_loadu_si128((const __m128i*)&binary_matrix[n]));
+    x = _mm_sub_epi32(x, _mm_and_si128(_mm_srli_epi32(x, 1), mask1));
+    x = _mm_add_epi32(_mm_and_si128(x, mask2),
+                      _mm_and_si128(_mm_srli_epi32(x, 2), mask2));
+    x = _mm_and_si128(_mm_add_epi32(x, _mm_srli_epi32(x, 4)), mask4);
+    x = _mm_add_epi32(x, _mm_srli_epi32(x, 8));
+    x = _mm_and_si128(_mm_add_epi32(x, _mm_srli_epi32(x, 16)), mask6);
+    _mm_storeu_si128((__m128i*)&bit_counts[n], x);
+  }
+  BitCountComparison(binary_vector, &binary_matrix[n], matrix_size - n,
+                     &bit_counts[n]);
+}
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+// Same as BitCountComparison(), comparing four rows at a time.
+static void BitCountComparisonNeon(uint32_t binary_vector,
+                                   const uint32_t* binary_matrix,
+                                   int matrix_size,
+                                   int32_t* bit_counts) {
+  const uint32x4_t vector = vdupq_n_u32(binary_vector);
+  int n = 0;
+
+  for (; n + 4 <= matrix_size; n += 4) {
+    const uint32x4_t x = veorq_u32(vector, vld1q_u32(&binary_matrix[n]));
+    // Count the bits of each byte and add them up per 32-bit lane.
+    const uint8x16_t byte_counts = vcntq_u8(vreinterpretq_u8_u32(x));
+    const uint32x4_t counts = vpaddlq_u16(vpaddlq_u8(byte_counts));
+    vst1q_s32(&bit_counts[n], vreinterpretq_s32_u32(counts));
+  }
+  BitCountComparison(binary_vector, &binary_matrix[n], matrix_size - n,
+                     &bit_counts[n]);
+}
+#endif
+
+// Stores the far-end histories of the first |history_size| elements of their
+// buffers also in the second ones, as expected by the buffer layout described
+// in BinaryDelayEstimatorFarend.
+static void MirrorFarendHistory(BinaryDelayEstimatorFarend* self) {
+  const int position = self->history_position;
+  const int size = self->history_size;
+
+  // The part of the histories in the first half of the buffers.
+  memcpy(&self->binary_far_history_buffer[size + position],
+         &self->binary_far_history_buffer[position],
+         sizeof(*self->binary_far_history_buffer) * (size - position));
+  memcpy(&self->far_bit_counts_buffer[size + position],
+         &self->far_bit_counts_buffer[position],
+         sizeof(*self->far_bit_counts_buffer) * (size - position));
+  // The part of the histories in the second half of the buffers.
+  memcpy(&self->binary_far_history_buffer[0],
+         &self->binary_far_history_buffer[size],
+         sizeof(*self->binary_far_history_buffer) * position);
+  memcpy(&self->far_bit_counts_buffer[0], &self->far_bit_counts_buffer[size],
+         sizeof(*self->far_bit_counts_buffer) * position);
+}
+
 // Collects necessary statistics for the HistogramBasedValidation().  This
 // function has to be called prior to calling HistogramBasedValidation().  The
 // statistics updated and used by the HistogramBasedValidation() are:
@@ -106,7 +191,11 @@ static void UpdateRobustValidationStatistics(BinaryDelayEstimator* self,
   const int max_hits_for_slow_change = (candidate_delay < self->last_delay)
                                            ? kMaxHitsWhenPossiblyNonCausal
                                            : kMaxHitsWhenPossiblyCausal;
+  int special_bins[2 * kNeighborhoodBins];
+  float special_bin_values[2 * kNeighborhoodBins];
+  int num_special_bins = 0;
   int i = 0;
+  int k = 0;
 
   RTC_DCHECK_EQ(self->history_size, self->farend->history_size);
   // Reset |candidate_hits| if we have a new candidate.
@@ -140,13 +229,34 @@ static void UpdateRobustValidationStatistics(BinaryDelayEstimator* self,
         kQ14Scaling;
   }
   // 4. All other bins are decreased with |valley_depth|.
-  // TODO(bjornv): Investigate how to make this loop more efficient.  Split up
-  // the loop?  Remove parts that doesn't add too much.
+  // The bins of both neighborhoods are stored, all bins are decreased with
+  // |valley_depth| in a loop without branches, and the stored bins are then
+  // restored and updated separately.
+  for (i = candidate_delay - 2; i <= candidate_delay + 1; ++i) {
+    if (i >= 0 && i < self->history_size) {
+      special_bins[num_special_bins++] = i;
+    }
+  }
+  for (i = self->last_delay - 2; i <= self->last_delay + 1; ++i) {
+    if (i >= 0 && i < self->history_size &&
+        (i < candidate_delay - 2 || i > candidate_delay + 1)) {
+      special_bins[num_special_bins++] = i;
+    }
+  }
+  for (k = 0; k < num_special_bins; ++k) {
+    special_bin_values[k] = self->histogram[special_bins[k]];
+  }
   for (i = 0; i < self->history_size; ++i) {
+    // 5. No histogram bin can go below 0.
+    self->histogram[i] = std::max(self->histogram[i] - valley_depth, 0.f);
+  }
+  for (k = 0; k < num_special_bins; ++k) {
+    i = special_bins[k];
     int is_in_last_set = (i >= self->last_delay - 2) &&
                          (i <= self->last_delay + 1) && (i != candidate_delay);
     int is_in_candidate_set =
         (i >= candidate_delay - 2) && (i <= candidate_delay + 1);
+    self->histogram[i] = special_bin_values[k];
     self->histogram[i] -=
         decrease_in_last_set * is_in_last_set +
         valley_depth * (!is_in_last_set && !is_in_candidate_set);
@@ -274,10 +384,12 @@ void WebRtc_FreeBinaryDelayEstimatorFarend(BinaryDelayEstimatorFarend* self) {
     return;
   }
 
-  free(self->binary_far_history);
+  free(self->binary_far_history_buffer);
+  self->binary_far_history_buffer = NULL;
   self->binary_far_history = NULL;
 
-  free(self->far_bit_counts);
+  free(self->far_bit_counts_buffer);
+  self->far_bit_counts_buffer = NULL;
   self->far_bit_counts = NULL;
 
   free(self);
@@ -299,6 +411,9 @@ BinaryDelayEstimatorFarend* WebRtc_CreateBinaryDelayEstimatorFarend(
   self->history_size = 0;
   self->binary_far_history = NULL;
   self->far_bit_counts = NULL;
+  self->binary_far_history_buffer = NULL;
+  self->far_bit_counts_buffer = NULL;
+  self->history_position = 0;
   if (WebRtc_AllocateFarendBufferMemory(self, history_size) == 0) {
     WebRtc_FreeBinaryDelayEstimatorFarend(self);
     self = NULL;
@@ -308,33 +423,58 @@ BinaryDelayEstimatorFarend* WebRtc_CreateBinaryDelayEstimatorFarend(
 
 int WebRtc_AllocateFarendBufferMemory(BinaryDelayEstimatorFarend* self,
                                       int history_size) {
+  uint32_t* binary_far_history_buffer = NULL;
+  int* far_bit_counts_buffer = NULL;
+  int copy_size = 0;
+
   RTC_DCHECK(self);
-  // (Re-)Allocate memory for history buffers.
-  self->binary_far_history = static_cast<uint32_t*>(
-      realloc(self->binary_far_history,
-              history_size * sizeof(*self->binary_far_history)));
-  self->far_bit_counts = static_cast<int*>(realloc(
-      self->far_bit_counts, history_size * sizeof(*self->far_bit_counts)));
-  if ((self->binary_far_history == NULL) || (self->far_bit_counts == NULL)) {
+  // (Re-)Allocate memory for history buffers, keeping the current histories.
+  binary_far_history_buffer = static_cast<uint32_t*>(
+      malloc(2 * history_size * sizeof(*binary_far_history_buffer)));
+  far_bit_counts_buffer = static_cast<int*>(
+      malloc(2 * history_size * sizeof(*far_bit_counts_buffer)));
+  if ((binary_far_history_buffer == NULL) || (far_bit_counts_buffer == NULL)) {
     history_size = 0;
   }
-  // Fill with zeros if we have expanded the buffers.
-  if (history_size > self->history_size) {
-    int size_diff = history_size - self->history_size;
-    memset(&self->binary_far_history[self->history_size], 0,
-           sizeof(*self->binary_far_history) * size_diff);
-    memset(&self->far_bit_counts[self->history_size], 0,
-           sizeof(*self->far_bit_counts) * size_diff);
+  copy_size = std::min(history_size, self->history_size);
+  if (copy_size > 0) {
+    memcpy(binary_far_history_buffer, self->binary_far_history,
+           sizeof(*binary_far_history_buffer) * copy_size);
+    memcpy(far_bit_counts_buffer, self->far_bit_counts,
+           sizeof(*far_bit_counts_buffer) * copy_size);
   }
+  // Fill with zeros if we have expanded the buffers.
+  if (history_size > copy_size) {
+    int size_diff = history_size - copy_size;
+    memset(&binary_far_history_buffer[copy_size], 0,
+           sizeof(*binary_far_history_buffer) * size_diff);
+    memset(&far_bit_counts_buffer[copy_size], 0,
+           sizeof(*far_bit_counts_buffer) * size_diff);
+  }
+  free(self->binary_far_history_buffer);
+  free(self->far_bit_counts_buffer);
+
+  self->binary_far_history_buffer = binary_far_history_buffer;
+  self->far_bit_counts_buffer = far_bit_counts_buffer;
+  self->binary_far_history = binary_far_history_buffer;
+  self->far_bit_counts = far_bit_counts_buffer;
   self->history_size = history_size;
+  self->history_position = 0;
+  if (history_size > 0) {
+    MirrorFarendHistory(self);
+  }
 
   return self->history_size;
 }
 
 void WebRtc_InitBinaryDelayEstimatorFarend(BinaryDelayEstimatorFarend* self) {
   RTC_DCHECK(self);
-  memset(self->binary_far_history, 0, sizeof(uint32_t) * self->history_size);
-  memset(self->far_bit_counts, 0, sizeof(int) * self->history_size);
+  memset(self->binary_far_history_buffer, 0,
+         sizeof(uint32_t) * 2 * self->history_size);
+  memset(self->far_bit_counts_buffer, 0, sizeof(int) * 2 * self->history_size);
+  self->history_position = 0;
+  self->binary_far_history = self->binary_far_history_buffer;
+  self->far_bit_counts = self->far_bit_counts_buffer;
 }
 
 void WebRtc_SoftResetBinaryDelayEstimatorFarend(
@@ -368,21 +508,33 @@ void WebRtc_SoftResetBinaryDelayEstimatorFarend(
           sizeof(*self->far_bit_counts) * shift_size);
   memset(&self->far_bit_counts[padding_index], 0,
          sizeof(*self->far_bit_counts) * abs_shift);
+  MirrorFarendHistory(self);
 }
 
 void WebRtc_AddBinaryFarSpectrum(BinaryDelayEstimatorFarend* handle,
                                  uint32_t binary_far_spectrum) {
+  int position = 0;
+  int far_bit_count = 0;
+
   RTC_DCHECK(handle);
-  // Shift binary spectrum history and insert current |binary_far_spectrum|.
-  memmove(&(handle->binary_far_history[1]), &(handle->binary_far_history[0]),
-          (handle->history_size - 1) * sizeof(uint32_t));
-  handle->binary_far_history[0] = binary_far_spectrum;
-
-  // Shift history of far-end binary spectrum bit counts and insert bit count
-  // of current |binary_far_spectrum|.
-  memmove(&(handle->far_bit_counts[1]), &(handle->far_bit_counts[0]),
-          (handle->history_size - 1) * sizeof(int));
-  handle->far_bit_counts[0] = BitCount(binary_far_spectrum);
+  // Move the start of the histories one element back, which drops the oldest
+  // element, and insert current |binary_far_spectrum| and its bit count. The
+  // values are written to both halves of the buffers.
+  position = handle->history_position - 1;
+  if (position < 0) {
+    position += handle->history_size;
+  }
+  far_bit_count = BitCount(binary_far_spectrum);
+  handle->binary_far_history_buffer[position] = binary_far_spectrum;
+  handle->binary_far_history_buffer[position + handle->history_size] =
+      binary_far_spectrum;
+  handle->far_bit_counts_buffer[position] = far_bit_count;
+  handle->far_bit_counts_buffer[position + handle->history_size] =
+      far_bit_count;
+
+  handle->history_position = position;
+  handle->binary_far_history = &handle->binary_far_history_buffer[position];
+  handle->far_bit_counts = &handle->far_bit_counts_buffer[position];
 }
 
 void WebRtc_FreeBinaryDelayEstimator(BinaryDelayEstimator* self) {
@@ -431,6 +583,8 @@ BinaryDelayEstimator* WebRtc_CreateBinaryDelayEstimator(
 
   self->lookahead = max_lookahead;
 
+  self->optimization = DetectVectorMathOptimization();
+
   // Allocate memory for spectrum and history buffers.
   self->mean_bit_counts = NULL;
   self->bit_counts = NULL;
@@ -547,10 +701,31 @@ int WebRtc_ProcessBinarySpectrum(BinaryDelayEstimator* self,
   }
 
   // Compare with delayed spectra and store the |bit_counts| for each delay.
-  BitCountComparison(binary_near_spectrum, self->farend->binary_far_history,
-                     self->history_size, self->bit_counts);
-
-  // Update |mean_bit_counts|, which is the smoothed version of |bit_counts|.
+  switch (self->optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case VectorMathOptimization::kAvx2:
+    case VectorMathOptimization::kSse2:
+      BitCountComparisonSse2(binary_near_spectrum,
+                             self->farend->binary_far_history,
+                             self->history_size, self->bit_counts);
+      break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case VectorMathOptimization::kNeon:
+      BitCountComparisonNeon(binary_near_spectrum,
+                             self->farend->binary_far_history,
+                             self->history_size, self->bit_counts);
+      break;
+#endif
+    default:
+      BitCountComparison(binary_near_spectrum,
+                         self->farend->binary_far_history, self->history_size,
+                         self->bit_counts);
+  }
+
+  // Update |mean_bit_counts|, which is the smoothed version of |bit_counts|,
+  // and find |candidate_delay|, |value_best_candidate| and
+  // |value_worst_candidate| of |mean_bit_counts|.
   for (i = 0; i < self->history_size; i++) {
     // |bit_counts| is constrained to [0, 32], meaning we can smooth with a
     // factor up to 2^26. We use Q9.
@@ -565,11 +740,7 @@ int WebRtc_ProcessBinarySpectrum(BinaryDelayEstimator* self,
       shifts -= (kShiftsLinearSlope * self->farend->far_bit_counts[i]) >> 4;
       WebRtc_MeanEstimatorFix(bit_count, shifts, &(self->mean_bit_counts[i]));
     }
-  }
 
-  // Find |candidate_delay|, |value_best_candidate| and |value_worst_candidate|
-  // of |mean_bit_counts|.
-  for (i = 0; i < self->history_size; i++) {
     if (self->mean_bit_counts[i] < value_best_candidate) {
       value_best_candidate = self->mean_bit_counts[i];
       candidate_delay = i;
@@ -695,14 +866,14 @@ void WebRtc_MeanEstimatorFix(int32_t new_value,
                              int factor,
                              int32_t* mean_value) {
   int32_t diff = new_value - *mean_value;
+  // All ones if |diff| is negative, otherwise zero.
+  const int32_t sign = diff >> 31;
 
   // mean_new = mean_value + ((new_value - mean_value) >> factor);
-  if (diff < 0) {
-    diff = -((-diff) >> factor);
-  } else {
-    diff = (diff >> factor);
-  }
-  *mean_value += diff;
+  // The shift is applied to the magnitude of |diff|, without branching on its
+  // sign, which is not predictable when called for all delays.
+  diff = ((diff ^ sign) - sign) >> factor;
+  *mean_value += (diff ^ sign) - sign;
 }
 
 }  // namespace webrtc
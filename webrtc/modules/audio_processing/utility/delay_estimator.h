@@ -16,6 +16,8 @@
 
 #include <stdint.h>
 
+#include "common_audio/vector_math.h"
+
 namespace webrtc {
 
 static const int32_t kMaxBitCountsQ9 = (32 << 9);  // 32 matching bits in Q9.
@@ -26,6 +28,14 @@ typedef struct {
   // Binary history variables.
   uint32_t* binary_far_history;
   int history_size;
+
+  // Buffers of 2 * |history_size| elements holding the histories above, with
+  // each value stored twice, |history_size| elements apart. The histories
+  // start at |history_position|, so adding a far-end spectrum only moves the
+  // position instead of shifting the whole histories.
+  int* far_bit_counts_buffer;
+  uint32_t* binary_far_history_buffer;
+  int history_position;
 } BinaryDelayEstimatorFarend;
 
 typedef struct {
@@ -59,6 +69,9 @@ typedef struct {
   // For dynamically changing the lookahead when using SoftReset...().
   int lookahead;
 
+  // Selects the bit count comparison kernel.
+  VectorMathOptimization optimization;
+
   // Far-end binary spectrum history buffer etc.
   BinaryDelayEstimatorFarend* farend;
 } BinaryDelayEstimator;
@@ -0,0 +1,1081 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/vad/pitch_analysis.h"
+
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON) && defined(WEBRTC_ARCH_ARM64)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+#include <math.h>
+#include <string.h>
+
+#include <array>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+// Pitch lag range, in samples at 8 kHz, and number of lags searched in the
+// decimated (4 kHz) signal.
+constexpr int kMinLag = 20;
+constexpr int kMaxLag = 140;
+constexpr int kLagSpan = kMaxLag / 2 - kMinLag / 2 + 5;
+// Correlation length and step of the two correlations computed on the
+// decimated signal.
+constexpr int kCorrLength = 60;
+constexpr int kCorrStep = PitchAnalyzer::kFrameLength / 4;
+constexpr int kDecimatedLength = kCorrLength + kCorrStep + kMaxLag / 2 + 2;
+static_assert(kDecimatedLength - PitchAnalyzer::kFrameLength / 2 ==
+                  PitchAnalyzer::kDecimatedStateLength,
+              "decimated state has the wrong length");
+// Half the bandwidth of the correlation surface.
+constexpr int kBandwidth = 11;
+constexpr int kMaxNumPeaks = 10;
+constexpr double kPeakDecay = 0.85;
+
+constexpr int kNumPitchSubframes = PitchAnalyzer::kNumSubframes;
+constexpr int kSubframeLength =
+    PitchAnalyzer::kFrameLength / kNumPitchSubframes;
+constexpr int kFrameLengthWithLookahead =
+    PitchAnalyzer::kFrameLength + PitchAnalyzer::kLookahead;
+constexpr double kMaxGain = 0.45;
+constexpr double kInitialGain = 0.27;  // 0.6 * kMaxGain.
+
+// Pitch pre-filter parameters. The lag and gain are interpolated
+// |kGranularity| times per subframe.
+constexpr int kGranularity = 5;
+constexpr int kUpdateLength = kSubframeLength / kGranularity;
+constexpr int kPitchBufferLength = PitchAnalyzer::kPitchBufferLength;
+static_assert(kPitchBufferLength == kMaxLag + 50,
+              "pitch filter buffer has the wrong length");
+constexpr int kDampingOrder = PitchAnalyzer::kDampingOrder;
+constexpr int kNumFractions = 8;
+constexpr int kFractionOrder = 9;
+constexpr double kFilterDelay = 1.5;
+constexpr double kLagUpStep = 1.5;
+constexpr double kLagDownStep = 0.67;
+
+constexpr int kWeightingLpcOrder = PitchAnalyzer::kWeightingOrder;
+constexpr size_t kWeightingWindowLength = PitchAnalyzer::kFrameLength;
+
+// All-pass factors of the two polyphase branches of the band split.
+constexpr float kUpperAllPassFactorsFloat[2] = {0.0347f, 0.3826f};
+constexpr float kLowerAllPassFactorsFloat[2] = {0.1544f, 0.744f};
+constexpr double kUpperAllPassFactors[2] = {0.0347, 0.3826};
+constexpr double kLowerAllPassFactors[2] = {0.1544, 0.744};
+
+constexpr double kInterpolationWindow[8] = {
+    -0.00067556028640, 0.02184247643159, -0.12203175715679, 0.60086484101160,
+    0.60086484101160,  -0.12203175715679, 0.02184247643159, -0.00067556028640};
+
+// Weighting matrix obtained by orthogonalizing a basis of polynomials of
+// increasing order:
+// t = (0:4)';
+// A = [t.^0, t.^1, t.^2, t.^3, t.^4];
+// [Q, dummy] = qr(A);
+// Weight = Q * diag([0, .1, .5, 1, 1]) * Q';
+constexpr double kGainWeight[5][5] = {
+    {0.29714285714286, -0.30857142857143, -0.05714285714286, 0.05142857142857,
+     0.01714285714286},
+    {-0.30857142857143, 0.67428571428571, -0.27142857142857, -0.14571428571429,
+     0.05142857142857},
+    {-0.05714285714286, -0.27142857142857, 0.65714285714286, -0.27142857142857,
+     -0.05714285714286},
+    {0.05142857142857, -0.14571428571429, -0.27142857142857, 0.67428571428571,
+     -0.30857142857143},
+    {0.01714285714286, 0.05142857142857, -0.05714285714286, -0.30857142857143,
+     0.29714285714286}};
+
+constexpr double kDampingFilter[kDampingOrder] = {-0.07, 0.25, 0.64, 0.25,
+                                                  -0.07};
+
+// Fractional lag interpolation filters.
+constexpr double kFractionalLagFilters[kNumFractions][kFractionOrder] = {
+    {-0.02239172458614, 0.06653315052934, -0.16515880017569, 0.60701333734125,
+     0.64671399919202, -0.20249000396417, 0.09926548334755, -0.04765933793109,
+     0.01754159521746},
+    {-0.01985640750434, 0.05816126837866, -0.13991265473714, 0.44560418147643,
+     0.79117042386876, -0.20266133815188, 0.09585268418555, -0.04533310458084,
+     0.01654127246314},
+    {-0.01463300534216, 0.04229888475060, -0.09897034715253, 0.28284326017787,
+     0.90385267956632, -0.16976950138649, 0.07704272393639, -0.03584218578311,
+     0.01295781500709},
+    {-0.00764851320885, 0.02184035544377, -0.04985561057281, 0.13083306574393,
+     0.97545011664662, -0.10177807997561, 0.04400901776474, -0.02010737175166,
+     0.00719783432422},
+    {-0.00000000000000, 0.00000000000000, -0.00000000000001, 0.00000000000001,
+     0.99999999999999, 0.00000000000001, -0.00000000000001, 0.00000000000000,
+     -0.00000000000000},
+    {0.00719783432422, -0.02010737175166, 0.04400901776474, -0.10177807997562,
+     0.97545011664663, 0.13083306574393, -0.04985561057280, 0.02184035544377,
+     -0.00764851320885},
+    {0.01295781500710, -0.03584218578312, 0.07704272393640, -0.16976950138650,
+     0.90385267956634, 0.28284326017785, -0.09897034715252, 0.04229888475059,
+     -0.01463300534216},
+    {0.01654127246315, -0.04533310458085, 0.09585268418557, -0.20266133815190,
+     0.79117042386878, 0.44560418147640, -0.13991265473712, 0.05816126837865,
+     -0.01985640750433}};
+
+// Window of the weighting filter LPC analysis, asymmetric towards the end of
+// the frame.
+const double* WeightingWindow() {
+  static const std::array<double, kWeightingWindowLength> window = [] {
+    constexpr double kAsymmetry = 0.3;
+    std::array<double, kWeightingWindowLength> w;
+    const double scale = 1.0 / static_cast<double>(kWeightingWindowLength);
+    const double scale_squared = scale * scale;
+    double t = 0.5;
+    for (size_t k = 0; k < kWeightingWindowLength; ++k, ++t) {
+      const double x = 3.14159265 * (kAsymmetry * t * scale +
+                                     (1 - kAsymmetry) * t * t * scale_squared);
+      const double s = sin(x);
+      w[k] = s * s;
+    }
+    return w;
+  }();
+  return window.data();
+}
+
+void CrossCorrelationC(const double* x,
+                       const double* y,
+                       size_t length,
+                       size_t num_lags,
+                       double* corr) {
+  for (size_t k = 0; k < num_lags; ++k) {
+    double sum = 0.0;
+    for (size_t n = 0; n < length; ++n) {
+      sum += x[n] * y[n + k];
+    }
+    corr[k] = sum;
+  }
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Computes eight lags at a time, one per lane, so that each lag is still
+// accumulated in sample order.
+void CrossCorrelationSse2(const double* x,
+                          const double* y,
+                          size_t length,
+                          size_t num_lags,
+                          double* corr) {
+  size_t k = 0;
+  for (; k + 8 <= num_lags; k += 8) {
+    __m128d sum0 = _mm_setzero_pd();
+    __m128d sum1 = _mm_setzero_pd();
+    __m128d sum2 = _mm_setzero_pd();
+    __m128d sum3 = _mm_setzero_pd();
+    for (size_t n = 0; n < length; ++n) {
+      const __m128d x_n = _mm_set1_pd(x[n]);
+      const double* y_n = &y[n + k];
+      sum0 = _mm_add_pd(sum0, _mm_mul_pd(x_n, _mm_loadu_pd(&y_n[0])));
+      sum1 = _mm_add_pd(sum1, _mm_mul_pd(x_n, _mm_loadu_pd(&y_n[2])));
+      sum2 = _mm_add_pd(sum2, _mm_mul_pd(x_n, _mm_loadu_pd(&y_n[4])));
+      sum3 = _mm_add_pd(sum3, _mm_mul_pd(x_n, _mm_loadu_pd(&y_n[6])));
+    }
+    _mm_storeu_pd(&corr[k], sum0);
+    _mm_storeu_pd(&corr[k + 2], sum1);
+    _mm_storeu_pd(&corr[k + 4], sum2);
+    _mm_storeu_pd(&corr[k + 6], sum3);
+  }
+  for (; k + 2 <= num_lags; k += 2) {
+    __m128d sum = _mm_setzero_pd();
+    for (size_t n = 0; n < length; ++n) {
+      sum = _mm_add_pd(sum,
+                       _mm_mul_pd(_mm_set1_pd(x[n]), _mm_loadu_pd(&y[n + k])));
+    }
+    _mm_storeu_pd(&corr[k], sum);
+  }
+  CrossCorrelationC(x, y + k, length, num_lags - k, corr + k);
+}
+#endif
+
+#if defined(WEBRTC_HAS_NEON) && defined(WEBRTC_ARCH_ARM64)
+// Computes eight lags at a time, one per lane, so that each lag is still
+// accumulated in sample order.
+void CrossCorrelationNeon(const double* x,
+                          const double* y,
+                          size_t length,
+                          size_t num_lags,
+                          double* corr) {
+  size_t k = 0;
+  for (; k + 8 <= num_lags; k += 8) {
+    float64x2_t sum0 = vdupq_n_f64(0.0);
+    float64x2_t sum1 = vdupq_n_f64(0.0);
+    float64x2_t sum2 = vdupq_n_f64(0.0);
+    float64x2_t sum3 = vdupq_n_f64(0.0);
+    for (size_t n = 0; n < length; ++n) {
+      const float64x2_t x_n = vdupq_n_f64(x[n]);
+      const double* y_n = &y[n + k];
+      sum0 = vaddq_f64(sum0, vmulq_f64(x_n, vld1q_f64(&y_n[0])));
+      sum1 = vaddq_f64(sum1, vmulq_f64(x_n, vld1q_f64(&y_n[2])));
+      sum2 = vaddq_f64(sum2, vmulq_f64(x_n, vld1q_f64(&y_n[4])));
+      sum3 = vaddq_f64(sum3, vmulq_f64(x_n, vld1q_f64(&y_n[6])));
+    }
+    vst1q_f64(&corr[k], sum0);
+    vst1q_f64(&corr[k + 2], sum1);
+    vst1q_f64(&corr[k + 4], sum2);
+    vst1q_f64(&corr[k + 6], sum3);
+  }
+  for (; k + 2 <= num_lags; k += 2) {
+    float64x2_t sum = vdupq_n_f64(0.0);
+    for (size_t n = 0; n < length; ++n) {
+      sum = vaddq_f64(sum, vmulq_f64(vdupq_n_f64(x[n]), vld1q_f64(&y[n + k])));
+    }
+    vst1q_f64(&corr[k], sum);
+  }
+  CrossCorrelationC(x, y + k, length, num_lags - k, corr + k);
+}
+#endif
+
+// Applies a cascade of two first order all-pass sections to |x|.
+template <typename T>
+T AllPass(const T* factors, T x, T* state) {
+  for (int j = 0; j < 2; ++j) {
+    const T y = state[j] + factors[j] * x;
+    state[j] = -factors[j] * y + x;
+    x = y;
+  }
+  return x;
+}
+
+// Computes the normalized correlation between the |kCorrLength| samples of
+// |in| starting after the longest decimated lag and the windows of |in|
+// starting at each of the |kLagSpan| lags. |corr| is ordered by increasing
+// lag, i.e., by decreasing window start.
+void PitchCorrelation(const double* in,
+                      VectorMathOptimization optimization,
+                      double* corr) {
+  double sums[kLagSpan];
+  CrossCorrelation(&in[kMaxLag / 2 + 2], in, kCorrLength, kLagSpan,
+                   optimization, sums);
+
+  double energy = 1e-13;
+  for (int n = 0; n < kCorrLength; ++n) {
+    energy += in[n] * in[n];
+  }
+  corr[kLagSpan - 1] = sums[0] / sqrt(energy);
+  for (int k = 1; k < kLagSpan; ++k) {
+    energy -= in[k - 1] * in[k - 1];
+    energy += in[kCorrLength + k - 1] * in[kCorrLength + k - 1];
+    corr[kLagSpan - 1 - k] = sums[k] / sqrt(energy);
+  }
+}
+
+// Interpolates the correlation surface half way between |data[0]| and
+// |data[1]|.
+double Interpolate(const double* data) {
+  double value = kInterpolationWindow[0] * data[-3];
+  for (int k = 1; k < 8; ++k) {
+    value += kInterpolationWindow[k] * data[k - 3];
+  }
+  return value;
+}
+
+// 2D parabolic interpolation of the peak in the 3x3 neighbourhood |t|.
+// Refines the lags |x| and |y| and returns the peak value.
+double Interpolate2D(const double t[3][3], double* x, double* y) {
+  const double c = t[1][1];
+  double b[2];
+  double a[2][2];
+  b[0] = 0.5 * (t[1][2] + t[2][1] - t[0][1] - t[1][0]);
+  b[1] = 0.5 * (t[1][0] + t[2][1] - t[0][1] - t[1][2]);
+  a[0][1] = -0.5 * (t[0][1] + t[2][1] - t[1][0] - t[1][2]);
+  double t1 = 0.5 * (t[0][0] + t[2][2]) - c;
+  double t2 = 0.5 * (t[2][0] + t[0][2]) - c;
+  const double d = (t[0][1] + t[1][2] + t[1][0] + t[2][1]) - 4.0 * c - t1 - t2;
+  a[0][0] = -t1 - 0.5 * d;
+  a[1][1] = -t2 - 0.5 * d;
+
+  // Deal with singular or ill-conditioned cases.
+  if ((a[0][0] < 1e-7) || ((a[0][0] * a[1][1] - a[0][1] * a[0][1]) < 1e-7)) {
+    return c;
+  }
+
+  // Cholesky decomposition: replace |a| by its upper-triangular factor.
+  a[0][0] = sqrt(a[0][0]);
+  a[0][1] = a[0][1] / a[0][0];
+  a[1][1] = sqrt(a[1][1] - a[0][1] * a[0][1]);
+
+  // Compute [delta1; delta2] = -0.5 * inv(a) * b.
+  t1 = b[0] / a[0][0];
+  t2 = (b[1] - t1 * a[0][1]) / a[1][1];
+  double delta2 = t2 / a[1][1];
+  double delta1 = 0.5 * (t1 - delta2 * a[0][1]) / a[0][0];
+  delta2 *= 0.5;
+
+  // Limit the norm.
+  t1 = delta1 * delta1 + delta2 * delta2;
+  if (t1 > 1.0) {
+    delta1 /= t1;
+    delta2 /= t1;
+  }
+
+  *x += delta1;
+  *y += delta2;
+  return 0.5 * (b[0] * delta1 + b[1] * delta2) + c;
+}
+
+// Working parameters of the pitch pre-filter.
+struct PitchFilterParams {
+  double buffer[PitchAnalyzer::kPitchBufferLength + kFrameLengthWithLookahead];
+  double damper_state[kDampingOrder];
+  const double* interpolation_filter;
+  double gain;
+  double lag;
+  int lag_offset;
+  int subframe;
+  int num_samples;
+  int index;
+  // Only used when computing the derivatives towards the gains.
+  double damper_state_dg[kNumPitchSubframes][kDampingOrder];
+  double gain_mult[kNumPitchSubframes];
+};
+
+// Filters |params->num_samples| samples with the pitch pre-filter
+//   y(z) = x(z) + damper(z) * gain * (x(z) + y(z)) * z^(-lag).
+// If |out_dg| is not null, the derivatives of the output towards the gains of
+// the subframes processed so far are written to it, one sample per row.
+void FilterSegment(const double* in,
+                   PitchFilterParams* params,
+                   double* out,
+                   double (*out_dg)[kNumPitchSubframes]) {
+  int pos = params->index + kPitchBufferLength;
+  int pos_lag = pos - params->lag_offset;
+  for (int n = 0; n < params->num_samples; ++n) {
+    for (int m = kDampingOrder - 1; m > 0; --m) {
+      params->damper_state[m] = params->damper_state[m - 1];
+    }
+    // Fractional pitch.
+    double sum = 0.0;
+    for (int m = 0; m < kFractionOrder; ++m) {
+      sum += params->buffer[pos_lag + m] * params->interpolation_filter[m];
+    }
+    params->damper_state[0] = params->gain * sum;
+
+    if (out_dg) {
+      const int lag_index = params->index - params->lag_offset;
+      const int m_min = lag_index < 0 ? -lag_index : 0;
+      for (int m = kDampingOrder - 1; m > 0; --m) {
+        for (int j = 0; j < kNumPitchSubframes; ++j) {
+          params->damper_state_dg[j][m] = params->damper_state_dg[j][m - 1];
+        }
+      }
+      // The fractional pitch of the derivatives is computed for all the
+      // subframes at once, with the rows of |out_dg| as vectors. Samples before
+      // the start of |out_dg| are zero.
+      double sum2[kNumPitchSubframes] = {};
+      for (int m = kFractionOrder - 1; m >= m_min; --m) {
+        const double* out_dg_m = out_dg[lag_index + m];
+        for (int j = 0; j < kNumPitchSubframes; ++j) {
+          sum2[j] += out_dg_m[j] * params->interpolation_filter[m];
+        }
+      }
+      for (int j = 0; j < params->subframe + 1; ++j) {
+        params->damper_state_dg[j][0] =
+            params->gain_mult[j] * sum + params->gain * sum2[j];
+      }
+      for (int j = 0; j < params->subframe + 1; ++j) {
+        double dg = 0.0;
+        for (int m = 0; m < kDampingOrder; ++m) {
+          dg -= params->damper_state_dg[j][m] * kDampingFilter[m];
+        }
+        out_dg[params->index][j] = dg;
+      }
+    }
+
+    sum = 0.0;
+    for (int m = 0; m < kDampingOrder; ++m) {
+      sum += params->damper_state[m] * kDampingFilter[m];
+    }
+    out[params->index] = in[params->index] - sum;
+    params->buffer[pos] = in[params->index] + out[params->index];
+
+    ++params->index;
+    ++pos;
+    ++pos_lag;
+  }
+}
+
+// Updates the filter parameters after a change of lag.
+void UpdateFilterParams(bool gain_derivatives, PitchFilterParams* params) {
+  params->lag_offset =
+      static_cast<int>(lrint(params->lag + kFilterDelay + 0.5));
+  const double fraction = params->lag_offset - (params->lag + kFilterDelay);
+  const int fraction_index =
+      static_cast<int>(lrint(kNumFractions * fraction - 0.5));
+  params->interpolation_filter = kFractionalLagFilters[fraction_index];
+
+  if (gain_derivatives) {
+    params->gain_mult[params->subframe] += 0.2;
+    if (params->gain_mult[params->subframe] > 1.0) {
+      params->gain_mult[params->subframe] = 1.0;
+    }
+    if (params->subframe > 0) {
+      params->gain_mult[params->subframe - 1] -= 0.2;
+    }
+  }
+}
+
+// Pitch pre-filters a frame, interpolating |lags| and |gains| from the values
+// of the previous frame. Without |out_dg|, the frame is filtered and |state|
+// updated. With |out_dg|, the frame and its lookahead are filtered and the
+// derivatives of the output towards the gains are computed, leaving |state|
+// untouched.
+void PitchFilterFrame(const double* in,
+                      const double* lags,
+                      const double* gains,
+                      PitchAnalyzer::PitchFilterState* state,
+                      double* out,
+                      double (*out_dg)[kNumPitchSubframes]) {
+  const bool gain_derivatives = out_dg != nullptr;
+  PitchFilterParams params;
+  params.index = 0;
+  params.lag_offset = 0;
+  memcpy(params.buffer, state->buffer, sizeof(state->buffer));
+  memset(&params.buffer[kPitchBufferLength], 0,
+         sizeof(params.buffer) - sizeof(state->buffer));
+  memcpy(params.damper_state, state->damper_state,
+         sizeof(state->damper_state));
+  if (gain_derivatives) {
+    memset(params.gain_mult, 0, sizeof(params.gain_mult));
+    memset(params.damper_state_dg, 0, sizeof(params.damper_state_dg));
+    memset(out_dg, 0, sizeof(out_dg[0]) * kFrameLengthWithLookahead);
+  }
+
+  double old_lag = state->old_lag;
+  double old_gain = state->old_gain;
+  // No interpolation if the pitch lag step is big.
+  if ((lags[0] > (kLagUpStep * old_lag)) ||
+      (lags[0] < (kLagDownStep * old_lag))) {
+    old_lag = lags[0];
+    old_gain = gains[0];
+    if (gain_derivatives) {
+      params.gain_mult[0] = 1.0;
+    }
+  }
+
+  params.num_samples = kUpdateLength;
+  for (int m = 0; m < kNumPitchSubframes; ++m) {
+    params.subframe = m;
+    const double lag_delta = (lags[m] - old_lag) / kGranularity;
+    params.lag = old_lag;
+    const double gain_delta = (gains[m] - old_gain) / kGranularity;
+    params.gain = old_gain;
+    old_lag = lags[m];
+    old_gain = gains[m];
+
+    for (int n = 0; n < kGranularity; ++n) {
+      params.gain += gain_delta;
+      params.lag += lag_delta;
+      UpdateFilterParams(gain_derivatives, &params);
+      FilterSegment(in, &params, out, out_dg);
+    }
+  }
+
+  if (gain_derivatives) {
+    // The lookahead is filtered as part of the last subframe.
+    params.subframe = kNumPitchSubframes - 1;
+    params.num_samples = PitchAnalyzer::kLookahead;
+    FilterSegment(in, &params, out, out_dg);
+  } else {
+    memcpy(state->buffer, &params.buffer[PitchAnalyzer::kFrameLength],
+           sizeof(state->buffer));
+    memcpy(state->damper_state, params.damper_state,
+           sizeof(state->damper_state));
+    state->old_lag = old_lag;
+    state->old_gain = old_gain;
+  }
+}
+
+}  // namespace
+
+void CrossCorrelation(const double* x,
+                      const double* y,
+                      size_t length,
+                      size_t num_lags,
+                      VectorMathOptimization optimization,
+                      double* corr) {
+  switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case VectorMathOptimization::kAvx2:
+    case VectorMathOptimization::kSse2:
+      CrossCorrelationSse2(x, y, length, num_lags, corr);
+      return;
+#endif
+#if defined(WEBRTC_HAS_NEON) && defined(WEBRTC_ARCH_ARM64)
+    // The NEON version needs the float64 vectors of ARM64, so 32-bit ARM uses
+    // the plain loop.
+    case VectorMathOptimization::kNeon:
+      CrossCorrelationNeon(x, y, length, num_lags, corr);
+      return;
+#endif
+    default:
+      CrossCorrelationC(x, y, length, num_lags, corr);
+  }
+}
+
+void AutoCorrelation(const double* x,
+                     size_t length,
+                     size_t order,
+                     VectorMathOptimization optimization,
+                     double* r) {
+  RTC_DCHECK_GT(length, order);
+  // All lags share the first |length| - |order| products, the remaining ones
+  // are added in sample order.
+  const size_t common_length = length - order;
+  CrossCorrelation(x, x, common_length, order + 1, optimization, r);
+  for (size_t lag = 0; lag < order; ++lag) {
+    for (size_t n = common_length; n < length - lag; ++n) {
+      r[lag] += x[n] * x[n + lag];
+    }
+  }
+}
+
+double LevinsonDurbin(const double* r, size_t order, double* a, double* k) {
+  constexpr double kEpsilon = 1.0e-10;
+  double alpha = 0;
+  a[0] = 1.0;
+  if (r[0] < kEpsilon) {
+    // If r[0] <= 0, set the LPC coefficients to zero.
+    for (size_t i = 0; i < order; ++i) {
+      k[i] = 0;
+      a[i + 1] = 0;
+    }
+    return alpha;
+  }
+
+  a[1] = k[0] = -r[1] / r[0];
+  alpha = r[0] + r[1] * k[0];
+  for (size_t m = 1; m < order; ++m) {
+    double sum = r[m + 1];
+    for (size_t i = 0; i < m; ++i) {
+      sum += a[i + 1] * r[m - i];
+    }
+    k[m] = -sum / alpha;
+    alpha += k[m] * sum;
+    const size_t m_h = (m + 1) >> 1;
+    for (size_t i = 0; i < m_h; ++i) {
+      sum = a[i + 1] + k[m] * a[m - i];
+      a[m - i] += k[m] * a[i + 1];
+      a[i + 1] = sum;
+    }
+    a[m + 1] = k[m];
+  }
+  return alpha;
+}
+
+PitchAnalyzer::PitchAnalyzer()
+    : PitchAnalyzer(DetectVectorMathOptimization()) {}
+
+PitchAnalyzer::PitchAnalyzer(VectorMathOptimization optimization)
+    : optimization_(optimization),
+      split_high_pass_state_(),
+      upper_all_pass_state_(),
+      lower_all_pass_state_(),
+      high_pass_state_(),
+      decimated_buffer_(),
+      decimator_state_(),
+      whitened_buffer_(),
+      weighting_buffer_(),
+      weighted_state_(),
+      whitened_state_(),
+      pitch_filter_state_() {
+  pitch_filter_state_.old_lag = 50.0;
+  pitch_filter_state_.old_gain = 0.0;
+}
+
+PitchAnalyzer::~PitchAnalyzer() = default;
+
+void PitchAnalyzer::Analyze(const float* audio, double* lags, double* gains) {
+  double lower_band[kFrameLength];
+  SplitLowerBand(audio, lower_band);
+
+  // Second order pole-zero high-pass filter, with zeros at
+  // 0.998 * exp(j*2*pi*35/8000) and poles at 0.94 * exp(j*2*pi*140/8000).
+  constexpr double kHighPassA[2] = {1.86864659625574, -0.88360000000000};
+  constexpr double kHighPassB[2] = {-1.99524591718270, 0.99600400000000};
+  double high_passed[kFrameLength];
+  for (size_t k = 0; k < kFrameLength; ++k) {
+    const double x = lower_band[k];
+    const double y = x + high_pass_state_[1];
+    high_pass_state_[1] =
+        high_pass_state_[0] + kHighPassB[0] * x + kHighPassA[0] * y;
+    high_pass_state_[0] = kHighPassB[1] * x + kHighPassA[1] * y;
+    high_passed[k] = y;
+  }
+
+  // Weighted and whitened signals; the latter is delayed by the lookahead.
+  double weighted[kFrameLength];
+  double whitened[kFrameLengthWithLookahead];
+  memcpy(whitened, whitened_buffer_, sizeof(whitened_buffer_));
+  WeightingFilter(high_passed, weighted, &whitened[kLookahead]);
+  memcpy(whitened_buffer_, &whitened[kFrameLength], sizeof(whitened_buffer_));
+
+  const double old_gain = pitch_filter_state_.old_gain;
+  InitialPitchEstimate(weighted, pitch_filter_state_.old_lag, old_gain, lags);
+  OptimizeGains(whitened, lags, old_gain, gains);
+
+  // Update the pitch filter state for the next frame.
+  double filtered[kFrameLengthWithLookahead];
+  PitchFilterFrame(whitened, lags, gains, &pitch_filter_state_, filtered,
+                   nullptr);
+}
+
+// Computes the lower band of the high-pass filtered |audio| from the sum of
+// its two all-pass polyphase branches. This is the lookahead lower band of
+// the iSAC filter bank, which is not phase equalized.
+void PitchAnalyzer::SplitLowerBand(const float* audio, double* lower_band) {
+  // {a1, a2, b1 - b0 * a1, b2 - b0 * a2}.
+  constexpr float kHighPassCoefficients[4] = {
+      -1.94895953203325f, 0.94984516000000f, -0.05101826139794f,
+      0.05015484000000f};
+  float* const state = split_high_pass_state_;
+  float in[2];
+  for (size_t k = 0; k < kFrameLength; ++k) {
+    for (int i = 0; i < 2; ++i) {
+      const float x = audio[2 * k + i];
+      in[i] = x + kHighPassCoefficients[2] * state[0] +
+              kHighPassCoefficients[3] * state[1];
+      const float y = x - kHighPassCoefficients[0] * state[0] -
+                      kHighPassCoefficients[1] * state[1];
+      state[1] = state[0];
+      state[0] = y;
+    }
+    const float upper =
+        AllPass(kUpperAllPassFactorsFloat, in[1], upper_all_pass_state_);
+    const float lower =
+        AllPass(kLowerAllPassFactorsFloat, in[0], lower_all_pass_state_);
+    lower_band[k] = 0.5f * (upper + lower);
+  }
+}
+
+// Filters |in| with a perceptual weighting filter and a whitening filter,
+// both derived from an LPC analysis of each subframe.
+void PitchAnalyzer::WeightingFilter(const double* in,
+                                    double* weighted,
+                                    double* whitened) {
+  constexpr double kBandwidthExpansion = 0.9;
+  const double* const window = WeightingWindow();
+
+  double buffer[kWeightingWindowLength + kFrameLength];
+  memcpy(buffer, weighting_buffer_, sizeof(weighting_buffer_));
+  memcpy(&buffer[kWeightingWindowLength], in, sizeof(double) * kFrameLength);
+  memcpy(weighting_buffer_, in, sizeof(weighting_buffer_));
+
+  // Outputs preceded by the filter states.
+  double weighted_out[kWeightingLpcOrder + kFrameLength];
+  double whitened_out[kWeightingLpcOrder + kFrameLength];
+  memcpy(weighted_out, weighted_state_, sizeof(weighted_state_));
+  memcpy(whitened_out, whitened_state_, sizeof(whitened_state_));
+
+  for (int n = 0; n < kNumPitchSubframes; ++n) {
+    const int offset = n * kSubframeLength;
+    double windowed[kWeightingWindowLength];
+    for (size_t k = 0; k < kWeightingWindowLength; ++k) {
+      windowed[k] = window[k] * buffer[offset + kSubframeLength + k];
+    }
+
+    double corr[kWeightingLpcOrder + 1];
+    double lpc[kWeightingLpcOrder + 1];
+    double reflection[kWeightingLpcOrder];
+    AutoCorrelation(windowed, kWeightingWindowLength, kWeightingLpcOrder,
+                    optimization_, corr);
+    corr[0] = 1.01 * corr[0] + 1.0;  // White noise correction.
+    LevinsonDurbin(corr, kWeightingLpcOrder, lpc, reflection);
+    double lpc_expanded[kWeightingLpcOrder + 1];
+    lpc_expanded[0] = lpc[0];
+    double chirp = kBandwidthExpansion;
+    for (int k = 1; k < kWeightingLpcOrder + 1; ++k) {
+      lpc_expanded[k] = chirp * lpc[k];
+      chirp *= kBandwidthExpansion;
+    }
+
+    // The weighting filter is A(z) / A(z / 0.9) and the whitening filter
+    // A(z / 0.9).
+    const double* x = &buffer[kWeightingWindowLength + offset];
+    double* weighted_n = &weighted_out[kWeightingLpcOrder + offset];
+    double* whitened_n = &whitened_out[kWeightingLpcOrder + offset];
+    for (int i = 0; i < kSubframeLength; ++i) {
+      double zeros = x[i] * lpc[0];
+      double zeros_expanded = x[i] * lpc_expanded[0];
+      for (int k = 1; k <= kWeightingLpcOrder; ++k) {
+        zeros += lpc[k] * x[i - k];
+        zeros_expanded += lpc_expanded[k] * x[i - k];
+      }
+      double poles = lpc_expanded[1] * weighted_n[i - 1];
+      for (int k = 2; k <= kWeightingLpcOrder; ++k) {
+        poles += lpc_expanded[k] * weighted_n[i - k];
+      }
+      weighted_n[i] = zeros - poles;
+      whitened_n[i] = zeros_expanded;
+    }
+  }
+
+  memcpy(weighted_state_, &weighted_out[kFrameLength], sizeof(weighted_state_));
+  memcpy(whitened_state_, &whitened_out[kFrameLength], sizeof(whitened_state_));
+  memcpy(weighted, &weighted_out[kWeightingLpcOrder],
+         sizeof(double) * kFrameLength);
+  memcpy(whitened, &whitened_out[kWeightingLpcOrder],
+         sizeof(double) * kFrameLength);
+}
+
+// Estimates the lags from the peaks of a correlation surface, spanned by the
+// correlations of the first and second halves of the decimated frame.
+void PitchAnalyzer::InitialPitchEstimate(const double* weighted,
+                                         double old_lag,
+                                         double old_gain,
+                                         double* lags) {
+  constexpr int kRowLength = kLagSpan + 4;
+  constexpr int kNumRows = 2 * kBandwidth + 3;
+  constexpr int kStateLength = kDecimatedStateLength;
+
+  // Decimate to 4 kHz with a polyphase all-pass half-band filter and append
+  // the result to the previous samples.
+  double decimated[kDecimatedLength];
+  memcpy(decimated, decimated_buffer_, sizeof(decimated_buffer_));
+  for (size_t n = 0; n < kFrameLength / 2; ++n) {
+    const double previous = decimator_state_[4];
+    decimator_state_[4] = weighted[2 * n + 1];
+    decimated[kStateLength + n] =
+        AllPass(kLowerAllPassFactors, previous, &decimator_state_[2]) +
+        AllPass(kUpperAllPassFactors, weighted[2 * n], &decimator_state_[0]);
+  }
+  // Low-pass filter the new samples.
+  for (int k = kStateLength; k < kDecimatedLength; ++k) {
+    decimated[k] += 0.75 * decimated[k - 1] - 0.25 * decimated[k - 2];
+  }
+  memcpy(decimated_buffer_, &decimated[kFrameLength / 2],
+         sizeof(decimated_buffer_));
+
+  double corr1[kLagSpan];
+  double corr2[kLagSpan];
+  PitchCorrelation(decimated, optimization_, corr1);
+  PitchCorrelation(&decimated[kCorrStep], optimization_, corr2);
+
+  // Bias towards the pitch lag of the previous frame.
+  const double log_lag = log(0.5 * old_lag);
+  double gain_bias = 4.0 * old_gain * old_gain;
+  if (gain_bias > 0.8) {
+    gain_bias = 0.8;
+  }
+  for (int k = 0; k < kLagSpan; ++k) {
+    const double ratio = log(static_cast<double>(k + (kMinLag / 2 - 2))) -
+                         log_lag;
+    corr1[k] *= 1.0 + gain_bias * exp(-5.0 * ratio * ratio);
+  }
+
+  // Taper the correlation functions.
+  constexpr double kLagWindow[3] = {0.2, 0.5, 0.98};
+  for (int k = 0; k < 3; ++k) {
+    corr1[k] *= kLagWindow[k];
+    corr2[k] *= kLagWindow[k];
+    corr1[kLagSpan - 1 - k] *= kLagWindow[k];
+    corr2[kLagSpan - 1 - k] *= kLagWindow[k];
+  }
+
+  // The correlation surface has 10 extra entries at the beginning for the
+  // neighbours of the peaks on the first rows. Row |m| pairs the lags of the
+  // two halves |kBandwidth| - |m| apart.
+  double surface_buffer[10 + kNumRows * kRowLength] = {};
+  double* const surface = &surface_buffer[10];
+  double corr_max = 0.0;
+  int max_ind = 0;
+  auto store = [&](double* row, int k, double corr) {
+    row[k] = corr;
+    if (corr > corr_max) {
+      corr_max = corr;
+      max_ind = static_cast<int>(&row[k] - surface);
+    }
+  };
+
+  // Middle row.
+  double* row1 = &surface[kBandwidth * kRowLength + 2];
+  for (int k = 0; k < kLagSpan; ++k) {
+    store(row1, k, corr1[k] + corr2[k]);
+  }
+  // Remaining rows, in pairs symmetric around the middle one, weighted by an
+  // inverse parabola of the lag ratio.
+  for (int m = 0; m < kBandwidth; ++m) {
+    const double scale = m == 0 ? 0.2 : (m == 1 ? 0.9 : 1.0);
+    int ind1 = 0;
+    int ind2 = kBandwidth - m;
+    row1 = &surface[m * kRowLength + 2];
+    double* row2 = &surface[(2 * kBandwidth - m) * kRowLength + kBandwidth + 2 -
+                            m];
+    for (int k = 0; k < kLagSpan - kBandwidth + m; ++k) {
+      const double ratio = static_cast<double>(ind1 + 12) /
+                           static_cast<double>(ind2 + 12);
+      const double adj = scale * ratio * (2.0 - ratio);
+      store(row1, k, adj * (corr1[ind1] + corr2[ind2]));
+      store(row2, k, adj * (corr1[ind2++] + corr2[ind1++]));
+    }
+  }
+
+  // Threshold to qualify as a peak.
+  corr_max *= 0.6;
+
+  int peaks[kMaxNumPeaks];
+  int num_peaks = 0;
+  auto find_peaks = [&](int m, int begin, int end) {
+    const double* row = &surface[m * kRowLength + 2];
+    for (int k = begin; k < end && num_peaks < kMaxNumPeaks; ++k) {
+      const double corr = row[k];
+      if (corr > corr_max && corr > row[k - (kLagSpan + 5)] &&
+          corr > row[k - (kLagSpan + 4)] && corr > row[k + (kLagSpan + 4)] &&
+          corr > row[k + (kLagSpan + 5)]) {
+        peaks[num_peaks++] = static_cast<int>(&row[k] - surface);
+      }
+    }
+  };
+  for (int m = 1; m < kBandwidth + 1; ++m) {
+    find_peaks(m, 2, kLagSpan - kBandwidth - 2 + m);
+  }
+  for (int m = kBandwidth + 1; m < 2 * kBandwidth; ++m) {
+    find_peaks(m, 2 + m - kBandwidth, kLagSpan - 2);
+  }
+
+  double lag1;
+  double lag2;
+  if (num_peaks > 0) {
+    double peak_values[kMaxNumPeaks];
+    double lags1[kMaxNumPeaks];
+    double lags2[kMaxNumPeaks];
+    const double* s = surface;
+    for (int k = 0; k < num_peaks; ++k) {
+      const int peak = peaks[k];
+
+      // Four interpolated values around the current peak.
+      const double intrp_a = Interpolate(&s[peak - (kLagSpan + 5)]);
+      const double intrp_b = Interpolate(&s[peak - 1]);
+      const double intrp_c = Interpolate(&s[peak]);
+      const double intrp_d = Interpolate(&s[peak + (kLagSpan + 4)]);
+      const double corr = s[peak];
+      double intrp_max = intrp_a;
+      if (intrp_b > intrp_max)
+        intrp_max = intrp_b;
+      if (intrp_c > intrp_max)
+        intrp_max = intrp_c;
+      if (intrp_d > intrp_max)
+        intrp_max = intrp_d;
+
+      // Fill a 3x3 matrix around the maximum.
+      const int row = peak / kRowLength;
+      lags1[k] = static_cast<double>((peak - row * kRowLength) + kMinLag / 2 -
+                                     4);
+      lags2[k] = lags1[k] + kBandwidth - row;
+      double t[3][3];
+      if (corr > intrp_max) {
+        t[0][0] = s[peak - (kLagSpan + 5)];
+        t[2][0] = s[peak - (kLagSpan + 4)];
+        t[1][1] = corr;
+        t[0][2] = s[peak + (kLagSpan + 4)];
+        t[2][2] = s[peak + (kLagSpan + 5)];
+        t[1][0] = intrp_a;
+        t[0][1] = intrp_b;
+        t[2][1] = intrp_c;
+        t[1][2] = intrp_d;
+      } else if (intrp_a == intrp_max) {
+        lags1[k] -= 0.5;
+        lags2[k] += 0.5;
+        t[0][0] = Interpolate(&s[peak - 2 * (kLagSpan + 5)]);
+        t[2][0] = Interpolate(&s[peak - (2 * kLagSpan + 9)]);
+        t[1][1] = intrp_a;
+        t[0][2] = intrp_b;
+        t[2][2] = intrp_c;
+        t[1][0] = s[peak - (2 * kLagSpan + 9)];
+        t[0][1] = s[peak - (kLagSpan + 5)];
+        t[2][1] = s[peak - (kLagSpan + 4)];
+        t[1][2] = corr;
+      } else if (intrp_b == intrp_max) {
+        lags1[k] -= 0.5;
+        lags2[k] -= 0.5;
+        t[0][0] = Interpolate(&s[peak - (kLagSpan + 6)]);
+        t[2][0] = intrp_a;
+        t[1][1] = intrp_b;
+        t[0][2] = Interpolate(&s[peak + (kLagSpan + 3)]);
+        t[2][2] = intrp_d;
+        t[1][0] = s[peak - (kLagSpan + 5)];
+        t[0][1] = s[peak - 1];
+        t[2][1] = corr;
+        t[1][2] = s[peak + (kLagSpan + 4)];
+      } else if (intrp_c == intrp_max) {
+        lags1[k] += 0.5;
+        lags2[k] += 0.5;
+        t[0][0] = intrp_a;
+        t[2][0] = Interpolate(&s[peak - (kLagSpan + 4)]);
+        t[1][1] = intrp_c;
+        t[0][2] = intrp_d;
+        t[2][2] = Interpolate(&s[peak + (kLagSpan + 5)]);
+        t[1][0] = s[peak - (kLagSpan + 4)];
+        t[0][1] = corr;
+        t[2][1] = s[peak + 1];
+        t[1][2] = s[peak + (kLagSpan + 5)];
+      } else {
+        lags1[k] += 0.5;
+        lags2[k] -= 0.5;
+        t[0][0] = intrp_b;
+        t[2][0] = intrp_c;
+        t[1][1] = intrp_d;
+        t[0][2] = Interpolate(&s[peak + 2 * (kLagSpan + 4)]);
+        t[2][2] = Interpolate(&s[peak + (2 * kLagSpan + 9)]);
+        t[1][0] = corr;
+        t[0][1] = s[peak + (kLagSpan + 4)];
+        t[2][1] = s[peak + (kLagSpan + 5)];
+        t[1][2] = s[peak + (2 * kLagSpan + 9)];
+      }
+      peak_values[k] = Interpolate2D(t, &lags1[k], &lags2[k]);
+    }
+
+    // Pick the highest peak, after applying a bias towards short lags.
+    int best = 0;
+    double best_value = 0.0;
+    for (int k = 0; k < num_peaks; ++k) {
+      const double value =
+          peak_values[k] * pow(kPeakDecay, log(lags1[k] + lags2[k]));
+      if (value > best_value) {
+        best_value = value;
+        best = k;
+      }
+    }
+    lag1 = 2.0 * lags1[best];
+    lag2 = 2.0 * lags2[best];
+  } else {
+    const int row = max_ind / kRowLength;
+    lag1 = static_cast<double>((max_ind - row * kRowLength) + kMinLag / 2 - 4);
+    lag2 = lag1 + kBandwidth - row;
+  }
+
+  auto clamp_lag = [](double lag) {
+    if (lag < static_cast<double>(kMinLag))
+      return static_cast<double>(kMinLag);
+    if (lag > static_cast<double>(kMaxLag))
+      return static_cast<double>(kMaxLag);
+    return lag;
+  };
+  lags[0] = lags[1] = clamp_lag(lag1);
+  lags[2] = lags[3] = clamp_lag(lag2);
+}
+
+// Finds the gains minimizing the output power of the pitch pre-filter, with
+// penalties on gain fluctuations and large gains, using two Newton steps.
+void PitchAnalyzer::OptimizeGains(const double* whitened,
+                                  const double* lags,
+                                  double old_gain,
+                                  double* gains) {
+  constexpr double kGainPenalty = 0.005;
+  constexpr double kFluctuationPenalty = 3.0;
+
+  double energy = 0.0;
+  for (int k = 0; k < kFrameLengthWithLookahead; ++k) {
+    energy += whitened[k] * whitened[k];
+  }
+  const double energy_weight = 1.0 / energy;
+
+  for (int k = 0; k < kNumPitchSubframes; ++k) {
+    gains[k] = kInitialGain;
+  }
+
+  double out[kFrameLengthWithLookahead];
+  double out_dg[kFrameLengthWithLookahead][kNumPitchSubframes];
+  for (int iter = 0; iter < 2; ++iter) {
+    PitchFilterFrame(whitened, lags, gains, &pitch_filter_state_, out, out_dg);
+
+    // Gradient and approximate Hessian (lower triangle) of the output power.
+    // All the sums are accumulated in one pass, each in sample order.
+    double grad[kNumPitchSubframes] = {};
+    double h[kNumPitchSubframes][kNumPitchSubframes] = {};
+    for (int n = 0; n < kFrameLengthWithLookahead; ++n) {
+      const double* out_dg_n = out_dg[n];
+      for (int k = 0; k < kNumPitchSubframes; ++k) {
+        grad[k] += out[n] * out_dg_n[k];
+        for (int m = 0; m <= k; ++m) {
+          h[k][m] += out_dg_n[m] * out_dg_n[k];
+        }
+      }
+    }
+    for (int k = 0; k < kNumPitchSubframes; ++k) {
+      grad[k] *= energy_weight;
+      for (int m = 0; m <= k; ++m) {
+        h[k][m] *= energy_weight;
+      }
+    }
+
+    // Gain fluctuation penalty.
+    for (int k = 0; k < kNumPitchSubframes; ++k) {
+      double tmp = kGainWeight[k + 1][0] * old_gain;
+      for (int m = 0; m < kNumPitchSubframes; ++m) {
+        tmp += kGainWeight[k + 1][m + 1] * gains[m];
+      }
+      grad[k] += tmp * kFluctuationPenalty;
+    }
+    for (int k = 0; k < kNumPitchSubframes; ++k) {
+      for (int m = 0; m <= k; ++m) {
+        h[k][m] += kGainWeight[k + 1][m + 1] * kFluctuationPenalty;
+      }
+    }
+
+    // Gain penalty.
+    for (int k = 0; k < 3; ++k) {
+      const double tmp = 1.0 / (1 - gains[k]);
+      grad[k] += tmp * tmp * kGainPenalty;
+      h[k][k] += 2.0 * tmp * (tmp * tmp * kGainPenalty);
+    }
+    const double tmp = 1.0 / (1 - gains[3]);
+    grad[3] += 1.33 * (tmp * tmp * kGainPenalty);
+    h[3][3] += 2.66 * tmp * (tmp * tmp * kGainPenalty);
+
+    // Cholesky factorization of the Hessian, overwriting its upper triangle,
+    // with the scale factors on the diagonal.
+    h[0][1] = h[1][0] / h[0][0];
+    h[0][2] = h[2][0] / h[0][0];
+    h[0][3] = h[3][0] / h[0][0];
+    h[1][1] -= h[0][0] * h[0][1] * h[0][1];
+    h[1][2] = (h[2][1] - h[0][1] * h[2][0]) / h[1][1];
+    h[1][3] = (h[3][1] - h[0][1] * h[3][0]) / h[1][1];
+    h[2][2] -= h[0][0] * h[0][2] * h[0][2] + h[1][1] * h[1][2] * h[1][2];
+    h[2][3] = (h[3][2] - h[0][2] * h[3][0] - h[1][2] * h[1][1] * h[1][3]) /
+              h[2][2];
+    h[3][3] -= h[0][0] * h[0][3] * h[0][3] + h[1][1] * h[1][3] * h[1][3] +
+               h[2][2] * h[2][3] * h[2][3];
+
+    // Newton step, delta_gains = -inv(h) * grad.
+    double dg[kNumPitchSubframes];
+    for (int k = 0; k < kNumPitchSubframes; ++k) {
+      dg[k] = -grad[k];
+    }
+    dg[1] -= dg[0] * h[0][1];
+    dg[2] -= dg[0] * h[0][2] + dg[1] * h[1][2];
+    dg[3] -= dg[0] * h[0][3] + dg[1] * h[1][3] + dg[2] * h[2][3];
+    for (int k = 0; k < kNumPitchSubframes; ++k) {
+      dg[k] /= h[k][k];
+    }
+    dg[2] -= dg[3] * h[2][3];
+    dg[1] -= dg[3] * h[1][3] + dg[2] * h[1][2];
+    dg[0] -= dg[3] * h[0][3] + dg[2] * h[0][2] + dg[1] * h[0][1];
+
+    for (int k = 0; k < kNumPitchSubframes; ++k) {
+      gains[k] += dg[k];
+      if (gains[k] > kMaxGain) {
+        gains[k] = kMaxGain;
+      } else if (gains[k] < 0.0) {
+        gains[k] = 0.0;
+      }
+    }
+  }
+}
+
+}  // namespace webrtc
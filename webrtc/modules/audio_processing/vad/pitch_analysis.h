@@ -0,0 +1,113 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_VAD_PITCH_ANALYSIS_H_
+#define MODULES_AUDIO_PROCESSING_VAD_PITCH_ANALYSIS_H_
+
+#include <stddef.h>
+
+#include "common_audio/vector_math.h"
+
+namespace webrtc {
+
+// Computes |num_lags| cross-correlation coefficients,
+// |corr[k]| = sum_n x[n] * y[n + k] for 0 <= n < |length|. Each coefficient is
+// accumulated in sample order, so all optimizations give the same result as a
+// plain loop; the SIMD versions compute several lags at a time instead. Builds
+// with FMA enabled may contract the multiply-adds differently in each version,
+// in which case the results only match up to rounding.
+void CrossCorrelation(const double* x,
+                      const double* y,
+                      size_t length,
+                      size_t num_lags,
+                      VectorMathOptimization optimization,
+                      double* corr);
+
+// Computes the |order| + 1 first autocorrelation coefficients of |x|.
+void AutoCorrelation(const double* x,
+                     size_t length,
+                     size_t order,
+                     VectorMathOptimization optimization,
+                     double* r);
+
+// Levinson-Durbin recursion. Computes the |order| + 1 coefficients of the LPC
+// polynomial |a|, with a[0] = 1, and the |order| reflection coefficients |k|
+// from the autocorrelation |r|. Returns the prediction error.
+double LevinsonDurbin(const double* r, size_t order, double* a, double* k);
+
+// Estimates the pitch of 30 ms of 16 kHz audio. The audio is split to get its
+// lower band at 8 kHz, in which four pitch lags and gains are estimated, one
+// per 7.5 ms subframe. The estimates match the pitch analysis of the iSAC
+// encoder, which the pitch-based VAD models were trained with. They are
+// bit-exact when built without floating point contraction, and match up to
+// rounding otherwise.
+class PitchAnalyzer {
+ public:
+  enum : size_t { kNumInputSamples = 480 };
+  enum : size_t { kNumSubframes = 4 };
+
+  PitchAnalyzer();
+  explicit PitchAnalyzer(VectorMathOptimization optimization);
+  ~PitchAnalyzer();
+
+  // Analyzes |kNumInputSamples| samples of |audio|. Writes |kNumSubframes|
+  // pitch lags, in samples at 8 kHz, to |lags| and as many gains to |gains|.
+  void Analyze(const float* audio, double* lags, double* gains);
+
+  // Lower band frame length, lookahead and LPC order of the weighting filter.
+  enum : size_t { kFrameLength = kNumInputSamples / 2 };
+  enum : size_t { kLookahead = 24 };
+  enum : size_t { kWeightingOrder = 6 };
+  // Decimated correlation buffer and pitch filter buffer lengths.
+  enum : size_t { kDecimatedStateLength = 72 };
+  enum : size_t { kPitchBufferLength = 190 };
+  enum : size_t { kDampingOrder = 5 };
+
+  // State of the pitch pre-filter used to optimize the gains.
+  struct PitchFilterState {
+    double buffer[kPitchBufferLength];
+    double damper_state[kDampingOrder];
+    double old_lag;
+    double old_gain;
+  };
+
+ private:
+  void SplitLowerBand(const float* audio, double* lower_band);
+  void WeightingFilter(const double* in, double* weighted, double* whitened);
+  void InitialPitchEstimate(const double* weighted,
+                            double old_lag,
+                            double old_gain,
+                            double* lags);
+  void OptimizeGains(const double* whitened,
+                     const double* lags,
+                     double old_gain,
+                     double* gains);
+
+  const VectorMathOptimization optimization_;
+
+  // Band split states.
+  float split_high_pass_state_[2];
+  float upper_all_pass_state_[2];
+  float lower_all_pass_state_[2];
+
+  // Pitch analysis states.
+  double high_pass_state_[2];
+  double decimated_buffer_[kDecimatedStateLength];
+  double decimator_state_[5];
+  double whitened_buffer_[kLookahead];
+  double weighting_buffer_[kFrameLength];
+  double weighted_state_[kWeightingOrder];
+  double whitened_state_[kWeightingOrder];
+  PitchFilterState pitch_filter_state_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_VAD_PITCH_ANALYSIS_H_
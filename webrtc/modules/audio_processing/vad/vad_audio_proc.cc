@@ -19,20 +19,9 @@
 #include "modules/audio_processing/vad/pole_zero_filter.h"
 #include "modules/audio_processing/vad/vad_audio_proc_internal.h"
 #include "rtc_base/checks.h"
-extern "C" {
-#include "modules/audio_coding/codecs/isac/main/source/filter_functions.h"
-#include "modules/audio_coding/codecs/isac/main/source/isac_vad.h"
-#include "modules/audio_coding/codecs/isac/main/source/pitch_estimator.h"
-#include "modules/audio_coding/codecs/isac/main/source/structs.h"
-}
 
 namespace webrtc {
 
-// The following structures are declared anonymous in iSAC's structs.h. To
-// forward declare them, we use this derived class trick.
-struct VadAudioProc::PitchAnalysisStruct : public ::PitchAnalysisStruct {};
-struct VadAudioProc::PreFiltBankstr : public ::PreFiltBankstr {};
-
 static constexpr float kFrequencyResolution =
     kSampleRateHz / static_cast<float>(VadAudioProc::kDftSize);
 static constexpr int kSilenceRms = 5;
@@ -43,8 +32,8 @@ VadAudioProc::VadAudioProc()
       num_buffer_samples_(kNumPastSignalSamples),
       log_old_gain_(-2),
       old_lag_(50),  // Arbitrary but valid as pitch-lag (in samples).
-      pitch_analysis_handle_(new PitchAnalysisStruct),
-      pre_filter_handle_(new PreFiltBankstr),
+      optimization_(DetectVectorMathOptimization()),
+      pitch_analyzer_(optimization_),
       high_pass_filter_(PoleZeroFilter::Create(kCoeffNumerator,
                                                kFilterOrder,
                                                kCoeffDenominator,
@@ -61,10 +50,6 @@ VadAudioProc::VadAudioProc()
   ip_[0] = 0;
   WebRtc_rdft(kDftSize, 1, data, ip_, w_fft_);
   // TODO(turajs): Need to initialize high-pass filter.
-
-  // Initialize iSAC components.
-  WebRtcIsac_InitPreFilterbank(pre_filter_handle_.get());
-  WebRtcIsac_InitPitchAnalysis(pitch_analysis_handle_.get());
 }
 
 VadAudioProc::~VadAudioProc() {}
@@ -128,8 +113,8 @@ void VadAudioProc::SubframeCorrelation(double* corr,
   for (size_t n = 0; n < kNumSubframeSamples + kNumPastSignalSamples; n++)
     windowed_audio[n] = audio_buffer_[buffer_index++] * kLpcAnalWin[n];
 
-  WebRtcIsac_AutoCorr(corr, windowed_audio,
-                      kNumSubframeSamples + kNumPastSignalSamples, kLpcOrder);
+  AutoCorrelation(windowed_audio, kNumSubframeSamples + kNumPastSignalSamples,
+                  kLpcOrder, optimization_, corr);
 }
 
 // Compute |kNum10msSubframes| sets of LPC coefficients, one per 10 ms input.
@@ -148,7 +133,7 @@ void VadAudioProc::GetLpcPolynomials(double* lpc, size_t length_lpc) {
     for (size_t k = 0; k < kLpcOrder + 1; k++) {
       corr[k] *= kCorrWeight[k];
     }
-    WebRtcIsac_LevDurb(&lpc[offset_lpc], reflec_coeff, corr, kLpcOrder);
+    LevinsonDurbin(corr, kLpcOrder, &lpc[offset_lpc], reflec_coeff);
   }
 }
 
@@ -226,33 +211,19 @@ void VadAudioProc::FindFirstSpectralPeaks(double* f_peak,
   }
 }
 
-// Using iSAC functions to estimate pitch gains & lags.
+// Estimates pitch gains & lags with the same analysis as the iSAC encoder.
 void VadAudioProc::PitchAnalysis(double* log_pitch_gains,
                                  double* pitch_lags_hz,
                                  size_t length) {
-  // TODO(turajs): This can be "imported" from iSAC & and the next two
-  // constants.
   RTC_DCHECK_GE(length, kNum10msSubframes);
-  const int kNumPitchSubframes = 4;
+  static_assert(static_cast<size_t>(kNumSamplesToProcess) ==
+                    PitchAnalyzer::kNumInputSamples,
+                "pitch analysis frame incorrect size");
+  const int kNumPitchSubframes = PitchAnalyzer::kNumSubframes;
   double gains[kNumPitchSubframes];
   double lags[kNumPitchSubframes];
 
-  const int kNumSubbandFrameSamples = 240;
-  const int kNumLookaheadSamples = 24;
-
-  float lower[kNumSubbandFrameSamples];
-  float upper[kNumSubbandFrameSamples];
-  double lower_lookahead[kNumSubbandFrameSamples];
-  double upper_lookahead[kNumSubbandFrameSamples];
-  double lower_lookahead_pre_filter[kNumSubbandFrameSamples +
-                                    kNumLookaheadSamples];
-
-  // Split signal to lower and upper bands
-  WebRtcIsac_SplitAndFilterFloat(&audio_buffer_[kNumPastSignalSamples], lower,
-                                 upper, lower_lookahead, upper_lookahead,
-                                 pre_filter_handle_.get());
-  WebRtcIsac_PitchAnalysis(lower_lookahead, lower_lookahead_pre_filter,
-                           pitch_analysis_handle_.get(), lags, gains);
+  pitch_analyzer_.Analyze(&audio_buffer_[kNumPastSignalSamples], lags, gains);
 
   // Lags are computed on lower-band signal with sampling rate half of the
   // input signal.
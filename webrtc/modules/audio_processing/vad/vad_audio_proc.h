@@ -16,7 +16,9 @@
 
 #include <memory>
 
+#include "common_audio/vector_math.h"
 #include "modules/audio_processing/vad/common.h"  // AudioFeatures, kSampleR...
+#include "modules/audio_processing/vad/pitch_analysis.h"
 
 namespace webrtc {
 
@@ -24,10 +26,6 @@ class PoleZeroFilter;
 
 class VadAudioProc {
  public:
-  // Forward declare iSAC structs.
-  struct PitchAnalysisStruct;
-  struct PreFiltBankstr;
-
   VadAudioProc();
   ~VadAudioProc();
 
@@ -84,8 +82,8 @@ class VadAudioProc {
   double log_old_gain_;
   double old_lag_;
 
-  std::unique_ptr<PitchAnalysisStruct> pitch_analysis_handle_;
-  std::unique_ptr<PreFiltBankstr> pre_filter_handle_;
+  const VectorMathOptimization optimization_;
+  PitchAnalyzer pitch_analyzer_;
   std::unique_ptr<PoleZeroFilter> high_pass_filter_;
 };
 
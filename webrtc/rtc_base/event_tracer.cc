@@ -14,17 +14,18 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
+#include <atomic>
 #include <string>
 #include <vector>
 
+#include "absl/base/attributes.h"
 #include "rtc_base/atomic_ops.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/event.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/platform_thread.h"
 #include "rtc_base/platform_thread_types.h"
-#include "rtc_base/synchronization/mutex.h"
-#include "rtc_base/thread_annotations.h"
 #include "rtc_base/thread_checker.h"
 #include "rtc_base/time_utils.h"
 #include "rtc_base/trace_event.h"
@@ -32,6 +33,15 @@
 // This is a guesstimate that should be enough in most cases.
 static const size_t kEventLoggerArgsStrBufferInitialSize = 256;
 static const size_t kTraceArgBufferLength = 32;
+// The trace event macros record at most two arguments per event.
+static const int kMaxTraceArgs = 2;
+// Events buffered per thread between two drains of the logging thread. Must be
+// a power of two. With a drain every 100 ms this lets a thread record 10000
+// events per second before events are dropped, for about 90 KB per buffer.
+static const uint32_t kThreadBufferSize = 1024;
+// Thread buffers allocated when tracing starts, so that the first threads to
+// record an event do not have to allocate one.
+static const int kNumPreallocatedThreadBuffers = 4;
 
 namespace webrtc {
 
@@ -84,6 +94,136 @@ static void EventTracingThreadFunc(void* params);
 // Atomic-int fast path for avoiding logging when disabled.
 static volatile int g_event_logging_active = 0;
 
+struct TraceArg {
+  const char* name;
+  unsigned char type;
+  // Copied from webrtc/rtc_base/trace_event.h TraceValueUnion.
+  union TraceArgValue {
+    bool as_bool;
+    unsigned long long as_uint;
+    long long as_int;
+    double as_double;
+    const void* as_pointer;
+    const char* as_string;
+  } value;
+
+  // Assert that the size of the union is equal to the size of the as_uint
+  // field since we are assigning to arbitrary types using it.
+  static_assert(sizeof(TraceArgValue) == sizeof(unsigned long long),
+                "Size of TraceArg value union is not equal to the size of "
+                "the uint field of that union.");
+};
+
+struct TraceEvent {
+  const char* name;
+  const unsigned char* category_enabled;
+  char phase;
+  int num_args;
+  TraceArg args[kMaxTraceArgs];
+  uint64_t timestamp;
+  rtc::PlatformThreadId tid;
+};
+
+// Ring of the events recorded by one thread. Only the thread owning the buffer
+// writes events and only the logging thread reads them, so no lock is needed:
+// the writer publishes an event by advancing |write_index| with release
+// semantics once the slot is filled, and the reader hands the slot back by
+// advancing |read_index| the same way once the event is copied out.
+struct ThreadBuffer {
+  std::atomic<uint32_t> write_index{0};
+  std::atomic<uint32_t> read_index{0};
+  // Events dropped because the ring was full.
+  std::atomic<uint32_t> num_dropped{0};
+  // Set while a thread owns the buffer.
+  std::atomic<bool> in_use{false};
+  // Next buffer in |g_thread_buffers|, never changed once published.
+  ThreadBuffer* next = nullptr;
+  TraceEvent events[kThreadBufferSize];
+};
+
+// List of all the thread buffers. Buffers are never freed: when a thread exits,
+// its buffer is handed over to the next thread that starts tracing, so the list
+// only grows to the number of threads tracing at the same time, or to
+// kNumPreallocatedThreadBuffers. The buffers outlive the EventLogger so that
+// threads can keep theirs across sessions.
+std::atomic<ThreadBuffer*> g_thread_buffers{nullptr};
+
+// Adds a newly allocated buffer to |g_thread_buffers|, owned by the calling
+// thread if |in_use| is true.
+ThreadBuffer* AddThreadBuffer(bool in_use) {
+  ThreadBuffer* buffer = new ThreadBuffer();
+  buffer->in_use.store(in_use, std::memory_order_relaxed);
+  ThreadBuffer* head = g_thread_buffers.load(std::memory_order_relaxed);
+  do {
+    buffer->next = head;
+  } while (!g_thread_buffers.compare_exchange_weak(
+      head, buffer, std::memory_order_release, std::memory_order_relaxed));
+  return buffer;
+}
+
+// Grows |g_thread_buffers| to at least |num_buffers| buffers.
+void PreallocateThreadBuffers(int num_buffers) {
+  for (ThreadBuffer* buffer = g_thread_buffers.load(std::memory_order_acquire);
+       buffer; buffer = buffer->next) {
+    --num_buffers;
+  }
+  for (; num_buffers > 0; --num_buffers) {
+    AddThreadBuffer(/*in_use=*/false);
+  }
+}
+
+// Returns a buffer no other thread owns, taken from |g_thread_buffers| if one
+// is free.
+ThreadBuffer* AcquireThreadBuffer() {
+  for (ThreadBuffer* buffer = g_thread_buffers.load(std::memory_order_acquire);
+       buffer; buffer = buffer->next) {
+    bool in_use = false;
+    if (!buffer->in_use.load(std::memory_order_relaxed) &&
+        buffer->in_use.compare_exchange_strong(in_use, true,
+                                               std::memory_order_acquire)) {
+      return buffer;
+    }
+  }
+  return AddThreadBuffer(/*in_use=*/true);
+}
+
+// Gives each thread its buffer, acquired on the first event it records, and
+// caches the thread id so that recording an event does not have to query it.
+class ThreadBufferHandle {
+ public:
+  constexpr ThreadBufferHandle() = default;
+  ~ThreadBufferHandle() {
+    if (buffer_)
+      buffer_->in_use.store(false, std::memory_order_release);
+  }
+
+  ThreadBuffer* buffer() {
+    if (!buffer_) {
+      buffer_ = AcquireThreadBuffer();
+      thread_id_ = rtc::CurrentThreadId();
+    }
+    return buffer_;
+  }
+  rtc::PlatformThreadId thread_id() const { return thread_id_; }
+
+ private:
+  ThreadBuffer* buffer_ = nullptr;
+  rtc::PlatformThreadId thread_id_{};
+};
+
+ABSL_CONST_INIT thread_local ThreadBufferHandle g_thread_buffer_handle;
+
+// Frees the strings copied by EventLogger::AddTraceEvent().
+void DeleteCopiedStrings(TraceEvent* event) {
+  for (int i = 0; i < event->num_args; ++i) {
+    TraceArg& arg = event->args[i];
+    if (arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
+      delete[] arg.value.as_string;
+      arg.value.as_string = nullptr;
+    }
+  }
+}
+
 // TODO(pbos): Log metadata for all threads, etc.
 class EventLogger final {
  public:
@@ -94,6 +234,9 @@ class EventLogger final {
                         kLowPriority) {}
   ~EventLogger() { RTC_DCHECK(thread_checker_.IsCurrent()); }
 
+  // Records an event in the buffer of the calling thread. Does not lock and
+  // only allocates to copy TRACE_VALUE_TYPE_COPY_STRING arguments; the event is
+  // dropped if the logging thread has not drained the buffer in time.
   void AddTraceEvent(const char* name,
                      const unsigned char* category_enabled,
                      char phase,
@@ -101,12 +244,24 @@ class EventLogger final {
                      const char** arg_names,
                      const unsigned char* arg_types,
                      const unsigned long long* arg_values,
-                     uint64_t timestamp,
-                     int pid,
-                     rtc::PlatformThreadId thread_id) {
-    std::vector<TraceArg> args(num_args);
-    for (int i = 0; i < num_args; ++i) {
-      TraceArg& arg = args[i];
+                     uint64_t timestamp) {
+    RTC_DCHECK_LE(num_args, kMaxTraceArgs);
+    ThreadBuffer* buffer = g_thread_buffer_handle.buffer();
+    const uint32_t write_index =
+        buffer->write_index.load(std::memory_order_relaxed);
+    if (write_index - buffer->read_index.load(std::memory_order_acquire) ==
+        kThreadBufferSize) {
+      buffer->num_dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    TraceEvent& event = buffer->events[write_index & (kThreadBufferSize - 1)];
+    event.name = name;
+    event.category_enabled = category_enabled;
+    event.phase = phase;
+    event.num_args = std::min(num_args, kMaxTraceArgs);
+    for (int i = 0; i < event.num_args; ++i) {
+      TraceArg& arg = event.args[i];
       arg.name = arg_names[i];
       arg.type = arg_types[i];
       arg.value.as_uint = arg_values[i];
@@ -120,9 +275,9 @@ class EventLogger final {
         arg.value.as_string = str_copy;
       }
     }
-    webrtc::MutexLock lock(&mutex_);
-    trace_events_.push_back(
-        {name, category_enabled, phase, args, timestamp, 1, thread_id});
+    event.timestamp = timestamp;
+    event.tid = g_thread_buffer_handle.thread_id();
+    buffer->write_index.store(write_index + 1, std::memory_order_release);
   }
 
   // The TraceEvent format is documented here:
@@ -132,36 +287,37 @@ class EventLogger final {
     static const int kLoggingIntervalMs = 100;
     fprintf(output_file_, "{ \"traceEvents\": [\n");
     bool has_logged_event = false;
+    std::vector<TraceEvent> events;
+    std::string args_str;
+    args_str.reserve(kEventLoggerArgsStrBufferInitialSize);
     while (true) {
       bool shutting_down = shutdown_event_.Wait(kLoggingIntervalMs);
-      std::vector<TraceEvent> events;
-      {
-        webrtc::MutexLock lock(&mutex_);
-        trace_events_.swap(events);
+      events.clear();
+      uint32_t num_dropped = DrainThreadBuffers(&events);
+      if (num_dropped > 0) {
+        RTC_LOG(LS_WARNING) << "Dropped " << num_dropped
+                            << " trace events, the thread buffers are full.";
       }
-      std::string args_str;
-      args_str.reserve(kEventLoggerArgsStrBufferInitialSize);
+      // Each thread buffer is in time order; merge them.
+      std::stable_sort(events.begin(), events.end(),
+                       [](const TraceEvent& a, const TraceEvent& b) {
+                         return a.timestamp < b.timestamp;
+                       });
       for (TraceEvent& e : events) {
         args_str.clear();
-        if (!e.args.empty()) {
+        if (e.num_args > 0) {
           args_str += ", \"args\": {";
-          bool is_first_argument = true;
-          for (TraceArg& arg : e.args) {
-            if (!is_first_argument)
+          for (int i = 0; i < e.num_args; ++i) {
+            if (i > 0)
               args_str += ",";
-            is_first_argument = false;
             args_str += " \"";
-            args_str += arg.name;
+            args_str += e.args[i].name;
             args_str += "\": ";
-            args_str += TraceArgValueAsString(arg);
-
-            // Delete our copy of the string.
-            if (arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
-              delete[] arg.value.as_string;
-              arg.value.as_string = nullptr;
-            }
+            args_str += TraceArgValueAsString(e.args[i]);
           }
           args_str += " }";
+          // Delete our copies of the strings.
+          DeleteCopiedStrings(&e);
         }
         fprintf(output_file_,
                 "%s{ \"name\": \"%s\""
@@ -177,7 +333,7 @@ class EventLogger final {
                 "%s"
                 "}\n",
                 has_logged_event ? "," : " ", e.name, e.category_enabled,
-                e.phase, e.timestamp, e.pid, e.tid, args_str.c_str());
+                e.phase, e.timestamp, kTracePid, e.tid, args_str.c_str());
         has_logged_event = true;
       }
       if (shutting_down)
@@ -195,14 +351,16 @@ class EventLogger final {
     RTC_DCHECK(!output_file_);
     output_file_ = file;
     output_file_owned_ = owned;
-    {
-      webrtc::MutexLock lock(&mutex_);
-      // Since the atomic fast-path for adding events to the queue can be
-      // bypassed while the logging thread is shutting down there may be some
-      // stale events in the queue, hence the vector needs to be cleared to not
-      // log events from a previous logging session (which may be days old).
-      trace_events_.clear();
-    }
+    // Since the atomic fast-path for adding events to the buffers can be
+    // bypassed while the logging thread is shutting down there may be some
+    // stale events in the buffers, hence they need to be drained to not log
+    // events from a previous logging session (which may be days old). The
+    // logging thread is not running, so this thread can read the buffers.
+    std::vector<TraceEvent> stale_events;
+    DrainThreadBuffers(&stale_events);
+    for (TraceEvent& e : stale_events)
+      DeleteCopiedStrings(&e);
+    PreallocateThreadBuffers(kNumPreallocatedThreadBuffers);
     // Enable event logging (fast-path). This should be disabled since starting
     // shouldn't be done twice.
     RTC_CHECK_EQ(0,
@@ -227,35 +385,29 @@ class EventLogger final {
   }
 
  private:
-  struct TraceArg {
-    const char* name;
-    unsigned char type;
-    // Copied from webrtc/rtc_base/trace_event.h TraceValueUnion.
-    union TraceArgValue {
-      bool as_bool;
-      unsigned long long as_uint;
-      long long as_int;
-      double as_double;
-      const void* as_pointer;
-      const char* as_string;
-    } value;
-
-    // Assert that the size of the union is equal to the size of the as_uint
-    // field since we are assigning to arbitrary types using it.
-    static_assert(sizeof(TraceArgValue) == sizeof(unsigned long long),
-                  "Size of TraceArg value union is not equal to the size of "
-                  "the uint field of that union.");
-  };
-
-  struct TraceEvent {
-    const char* name;
-    const unsigned char* category_enabled;
-    char phase;
-    std::vector<TraceArg> args;
-    uint64_t timestamp;
-    int pid;
-    rtc::PlatformThreadId tid;
-  };
+  // All events are logged with the same process id.
+  static const int kTracePid = 1;
+
+  // Moves the events of all the thread buffers to |events| and returns the
+  // number of events dropped since the last drain. Must only be called by one
+  // thread at a time: the logging thread, or the thread starting it.
+  static uint32_t DrainThreadBuffers(std::vector<TraceEvent>* events) {
+    uint32_t num_dropped = 0;
+    for (ThreadBuffer* buffer =
+             g_thread_buffers.load(std::memory_order_acquire);
+         buffer; buffer = buffer->next) {
+      uint32_t read_index = buffer->read_index.load(std::memory_order_relaxed);
+      const uint32_t write_index =
+          buffer->write_index.load(std::memory_order_acquire);
+      for (; read_index != write_index; ++read_index) {
+        events->push_back(
+            buffer->events[read_index & (kThreadBufferSize - 1)]);
+      }
+      buffer->read_index.store(read_index, std::memory_order_release);
+      num_dropped += buffer->num_dropped.exchange(0, std::memory_order_relaxed);
+    }
+    return num_dropped;
+  }
 
   static std::string TraceArgValueAsString(TraceArg arg) {
     std::string output;
@@ -317,8 +469,6 @@ class EventLogger final {
     return output;
   }
 
-  webrtc::Mutex mutex_;
-  std::vector<TraceEvent> trace_events_ RTC_GUARDED_BY(mutex_);
   rtc::PlatformThread logging_thread_;
   rtc::Event shutdown_event_;
   rtc::ThreadChecker thread_checker_;
@@ -359,7 +509,7 @@ void InternalAddTraceEvent(char phase,
 
   g_event_logger->AddTraceEvent(name, category_enabled, phase, num_args,
                                 arg_names, arg_types, arg_values,
-                                rtc::TimeMicros(), 1, rtc::CurrentThreadId());
+                                rtc::TimeMicros());
 }
 
 }  // namespace
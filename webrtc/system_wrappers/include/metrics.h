@@ -414,6 +414,10 @@ void Enable();
 void GetAndReset(
     std::map<std::string, std::unique_ptr<SampleInfo>>* histograms);
 
+// Gets histograms without clearing their samples, e.g. to export them from
+// several places. Neither this nor GetAndReset() blocks adding samples.
+void GetAll(std::map<std::string, std::unique_ptr<SampleInfo>>* histograms);
+
 // Functions below are mainly for testing.
 
 // Clears all samples.
@@ -9,10 +9,17 @@
 
 #include "system_wrappers/include/metrics.h"
 
+#include <stdint.h>
+
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <memory>
 
 #include "rtc_base/constructor_magic.h"
 #include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/synchronization/yield.h"
 #include "rtc_base/thread_annotations.h"
 
 // Default implementation of histogram methods for WebRTC clients that do not
@@ -27,109 +34,320 @@ namespace {
 // TODO(asapersson): Consider using bucket count (and set up
 // linearly/exponentially spaced buckets) if samples are logged more frequently.
 const int kMaxSampleMapSize = 300;
+// Number of copies of the counts of a histogram. Each thread adds its samples
+// to one of them, so that threads adding samples to the same histogram do not
+// contend on the same cache lines. A copy is only allocated once a thread adds
+// a sample to it.
+const int kNumCountShards = 8;
+// Marks a free slot of a sample table. Samples are clamped to [min - 1, max] so
+// they never take this value when min > INT_MIN + 1.
+const int kEmptySampleSlot = std::numeric_limits<int>::min();
+// Slots of the index used to find the histograms by name without locking, and
+// the maximum number of histograms it holds. Histograms beyond that are only
+// found in the map, under its lock. Must be a power of two.
+const int kHistogramIndexSize = 1024;
+const int kMaxIndexedHistograms = kHistogramIndexSize / 2;
+
+// Returns the shard of the counts the calling thread adds its samples to.
+int CountShard() {
+  static std::atomic<int> next_shard{0};
+  thread_local int shard =
+      next_shard.fetch_add(1, std::memory_order_relaxed) % kNumCountShards;
+  return shard;
+}
+
+// Returns the log2 of the number of slots of a sample table for the samples in
+// [min - 1, max], so that the table is at most two thirds full.
+int SampleTableSizeLog2(int min, int max) {
+  const int64_t num_values = std::min<int64_t>(
+      static_cast<int64_t>(max) - min + 2, kMaxSampleMapSize);
+  int size_log2 = 2;
+  while ((int64_t{1} << size_log2) * 2 < num_values * 3)
+    ++size_log2;
+  return size_log2;
+}
 
+// Histogram that can be added to by any number of threads without locking.
+// The samples are stored in two tables, and are added to the active one. In a
+// table, the distinct sample values are stored with open addressing: a value is
+// given a slot the first time it is added, with a compare-and-swap. The number
+// of events of each value are counted with atomic increments in the slot of the
+// value in the shard of the calling thread, and summed over the shards when
+// read.
+//
+// Resetting makes the other table active and waits for the threads still adding
+// to the previous one, which then is read and cleared, freeing all its slots.
+// Hence no sample is lost and at most |kMaxSampleMapSize| distinct values are
+// stored between two resets. Reading and resetting are serialized by the lock
+// of RtcHistogramMap.
 class RtcHistogram {
  public:
   RtcHistogram(const std::string& name, int min, int max, int bucket_count)
-      : min_(min), max_(max), info_(name, min, max, bucket_count) {
+      : min_(min),
+        max_(max),
+        name_(name),
+        bucket_count_(bucket_count),
+        table_size_log2_(SampleTableSizeLog2(min, max)),
+        table_size_(1 << table_size_log2_) {
     RTC_DCHECK_GT(bucket_count, 0);
+    RTC_DCHECK_GT(min, kEmptySampleSlot + 1);
+    for (SampleTable& table : tables_) {
+      table.samples.reset(new std::atomic<int>[table_size_]);
+      for (int i = 0; i < table_size_; ++i)
+        table.samples[i].store(kEmptySampleSlot, std::memory_order_relaxed);
+      for (auto& shard : table.shards)
+        shard.store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  ~RtcHistogram() {
+    for (SampleTable& table : tables_) {
+      for (auto& shard : table.shards)
+        delete shard.load(std::memory_order_relaxed);
+    }
   }
 
   void Add(int sample) {
     sample = std::min(sample, max_);
     sample = std::max(sample, min_ - 1);  // Underflow bucket.
 
-    MutexLock lock(&mutex_);
-    if (info_.samples.size() == kMaxSampleMapSize &&
-        info_.samples.find(sample) == info_.samples.end()) {
-      return;
+    const int shard_index = CountShard();
+    while (true) {
+      const int table_index = active_table_.load(std::memory_order_seq_cst);
+      SampleTable& table = tables_[table_index];
+      Shard* shard = GetShard(&table, shard_index);
+      // Announce the add before checking that the table is still active, so
+      // that a reset either waits for the add or makes it retry.
+      shard->num_adding.fetch_add(1, std::memory_order_seq_cst);
+      if (active_table_.load(std::memory_order_seq_cst) == table_index) {
+        const int slot = FindOrInsertSlot(&table, sample);
+        if (slot >= 0)
+          shard->counts[slot].fetch_add(1, std::memory_order_relaxed);
+        shard->num_adding.fetch_sub(1, std::memory_order_release);
+        return;
+      }
+      shard->num_adding.fetch_sub(1, std::memory_order_release);
     }
-    ++info_.samples[sample];
   }
 
   // Returns a copy (or nullptr if there are no samples) and clears samples.
-  std::unique_ptr<SampleInfo> GetAndReset() {
-    MutexLock lock(&mutex_);
-    if (info_.samples.empty())
-      return nullptr;
+  std::unique_ptr<SampleInfo> GetAndReset() { return GetSamples(true); }
 
-    SampleInfo* copy =
-        new SampleInfo(info_.name, info_.min, info_.max, info_.bucket_count);
+  // Returns a copy (or nullptr if there are no samples).
+  std::unique_ptr<SampleInfo> Get() { return GetSamples(false); }
 
-    std::swap(info_.samples, copy->samples);
-
-    return std::unique_ptr<SampleInfo>(copy);
-  }
-
-  const std::string& name() const { return info_.name; }
+  const std::string& name() const { return name_; }
 
   // Functions only for testing.
-  void Reset() {
-    MutexLock lock(&mutex_);
-    info_.samples.clear();
-  }
+  void Reset() { GetSamples(true); }
 
   int NumEvents(int sample) const {
-    MutexLock lock(&mutex_);
-    const auto it = info_.samples.find(sample);
-    return (it == info_.samples.end()) ? 0 : it->second;
+    const SampleTable& table = ActiveTable();
+    const int slot = FindSlot(table, sample);
+    return slot < 0 ? 0 : SlotCount(table, slot, false);
   }
 
   int NumSamples() const {
     int num_samples = 0;
-    MutexLock lock(&mutex_);
-    for (const auto& sample : info_.samples) {
+    for (const auto& sample : Samples()) {
       num_samples += sample.second;
     }
     return num_samples;
   }
 
   int MinSample() const {
-    MutexLock lock(&mutex_);
-    return (info_.samples.empty()) ? -1 : info_.samples.begin()->first;
+    const std::map<int, int> samples = Samples();
+    return samples.empty() ? -1 : samples.begin()->first;
   }
 
   std::map<int, int> Samples() const {
-    MutexLock lock(&mutex_);
-    return info_.samples;
+    std::map<int, int> samples;
+    const SampleTable& table = ActiveTable();
+    for (int slot = 0; slot < table_size_; ++slot) {
+      const int sample = table.samples[slot].load(std::memory_order_acquire);
+      if (sample == kEmptySampleSlot)
+        continue;
+      const int count = SlotCount(table, slot, false);
+      if (count > 0)
+        samples[sample] = count;
+    }
+    return samples;
   }
 
  private:
-  mutable Mutex mutex_;
+  // Counts of the sample values of a table added by the threads of a shard.
+  struct Shard {
+    explicit Shard(int table_size) : counts(new std::atomic<int>[table_size]) {
+      for (int i = 0; i < table_size; ++i)
+        counts[i].store(0, std::memory_order_relaxed);
+    }
+
+    // Number of threads of the shard adding a sample to the table.
+    std::atomic<int> num_adding{0};
+    const std::unique_ptr<std::atomic<int>[]> counts;
+  };
+
+  struct SampleTable {
+    std::atomic<int> num_samples{0};
+    std::unique_ptr<std::atomic<int>[]> samples;
+    // Allocated when a thread of the shard first adds a sample.
+    std::atomic<Shard*> shards[kNumCountShards];
+  };
+
+  const SampleTable& ActiveTable() const {
+    return tables_[active_table_.load(std::memory_order_acquire)];
+  }
+
+  Shard* GetShard(SampleTable* table, int shard_index) {
+    std::atomic<Shard*>& shard = table->shards[shard_index];
+    Shard* existing_shard = shard.load(std::memory_order_seq_cst);
+    if (existing_shard)
+      return existing_shard;
+    Shard* new_shard = new Shard(table_size_);
+    if (shard.compare_exchange_strong(existing_shard, new_shard,
+                                      std::memory_order_seq_cst)) {
+      return new_shard;
+    }
+    delete new_shard;
+    return existing_shard;
+  }
+
+  // Fibonacci hashing, spreads consecutive sample values over the table.
+  int HashSlot(int sample) const {
+    return static_cast<int>((static_cast<uint32_t>(sample) * 2654435761u) >>
+                            (32 - table_size_log2_));
+  }
+
+  // Returns the slot of |sample| in |table|, or -1 if it has not been added.
+  int FindSlot(const SampleTable& table, int sample) const {
+    for (int probe = 0, slot = HashSlot(sample); probe < table_size_;
+         ++probe, slot = (slot + 1) & (table_size_ - 1)) {
+      const int slot_sample =
+          table.samples[slot].load(std::memory_order_acquire);
+      if (slot_sample == sample)
+        return slot;
+      if (slot_sample == kEmptySampleSlot)
+        return -1;
+    }
+    return -1;
+  }
+
+  // Returns the slot of |sample| in |table|, giving it a free slot if it has
+  // not been added, or -1 if the table already holds |kMaxSampleMapSize|
+  // values.
+  int FindOrInsertSlot(SampleTable* table, int sample) {
+    for (int probe = 0, slot = HashSlot(sample); probe < table_size_;
+         ++probe, slot = (slot + 1) & (table_size_ - 1)) {
+      int slot_sample = table->samples[slot].load(std::memory_order_acquire);
+      if (slot_sample == sample)
+        return slot;
+      if (slot_sample != kEmptySampleSlot)
+        continue;
+
+      if (table->num_samples.fetch_add(1, std::memory_order_relaxed) >=
+          kMaxSampleMapSize) {
+        table->num_samples.fetch_sub(1, std::memory_order_relaxed);
+        return -1;
+      }
+      if (table->samples[slot].compare_exchange_strong(
+              slot_sample, sample, std::memory_order_acq_rel)) {
+        return slot;
+      }
+      // Another thread took the slot first, possibly for the same value.
+      table->num_samples.fetch_sub(1, std::memory_order_relaxed);
+      if (slot_sample == sample)
+        return slot;
+    }
+    return -1;
+  }
+
+  // Returns the count of |slot| summed over the shards, optionally clearing it.
+  int SlotCount(const SampleTable& table, int slot, bool reset) const {
+    int count = 0;
+    for (const auto& shard : table.shards) {
+      const Shard* shard_counts = shard.load(std::memory_order_acquire);
+      if (!shard_counts)
+        continue;
+      std::atomic<int>& slot_count = shard_counts->counts[slot];
+      count += reset ? slot_count.exchange(0, std::memory_order_relaxed)
+                     : slot_count.load(std::memory_order_relaxed);
+    }
+    return count;
+  }
+
+  std::unique_ptr<SampleInfo> GetSamples(bool reset) {
+    // Only readers, which are serialized, change the active table.
+    const int table_index = active_table_.load(std::memory_order_relaxed);
+    SampleTable& table = tables_[table_index];
+    if (reset) {
+      active_table_.store(1 - table_index, std::memory_order_seq_cst);
+      for (const auto& shard : table.shards) {
+        const Shard* shard_counts = shard.load(std::memory_order_seq_cst);
+        while (shard_counts &&
+               shard_counts->num_adding.load(std::memory_order_seq_cst) > 0) {
+          YieldCurrentThread();
+        }
+      }
+    }
+
+    std::unique_ptr<SampleInfo> info;
+    for (int slot = 0; slot < table_size_; ++slot) {
+      const int sample = table.samples[slot].load(std::memory_order_acquire);
+      if (sample == kEmptySampleSlot)
+        continue;
+      const int count = SlotCount(table, slot, reset);
+      if (reset)
+        table.samples[slot].store(kEmptySampleSlot, std::memory_order_relaxed);
+      if (count == 0)
+        continue;
+      if (!info)
+        info.reset(new SampleInfo(name_, min_, max_, bucket_count_));
+      info->samples[sample] = count;
+    }
+    if (reset)
+      table.num_samples.store(0, std::memory_order_relaxed);
+    return info;
+  }
+
   const int min_;
   const int max_;
-  SampleInfo info_ RTC_GUARDED_BY(mutex_);
+  const std::string name_;
+  const size_t bucket_count_;
+  const int table_size_log2_;
+  const int table_size_;
+  SampleTable tables_[2];
+  // Index of the table samples are added to.
+  std::atomic<int> active_table_{0};
 
   RTC_DISALLOW_COPY_AND_ASSIGN(RtcHistogram);
 };
 
+// Map of the histograms by name. Histograms are created under a lock, but are
+// found without locking through an index of the first |kMaxIndexedHistograms|
+// histograms: an open addressing table of histogram pointers that are never
+// removed, published with release semantics once the histogram is constructed.
 class RtcHistogramMap {
  public:
-  RtcHistogramMap() {}
+  RtcHistogramMap() {
+    for (auto& histogram : index_)
+      histogram.store(nullptr, std::memory_order_relaxed);
+  }
   ~RtcHistogramMap() {}
 
   Histogram* GetCountsHistogram(const std::string& name,
                                 int min,
                                 int max,
                                 int bucket_count) {
-    MutexLock lock(&mutex_);
-    const auto& it = map_.find(name);
-    if (it != map_.end())
-      return reinterpret_cast<Histogram*>(it->second.get());
-
-    RtcHistogram* hist = new RtcHistogram(name, min, max, bucket_count);
-    map_[name].reset(hist);
+    RtcHistogram* hist = Find(name);
+    if (!hist)
+      hist = FindOrCreate(name, min, max, bucket_count);
     return reinterpret_cast<Histogram*>(hist);
   }
 
   Histogram* GetEnumerationHistogram(const std::string& name, int boundary) {
-    MutexLock lock(&mutex_);
-    const auto& it = map_.find(name);
-    if (it != map_.end())
-      return reinterpret_cast<Histogram*>(it->second.get());
-
-    RtcHistogram* hist = new RtcHistogram(name, 1, boundary, boundary + 1);
-    map_[name].reset(hist);
+    RtcHistogram* hist = Find(name);
+    if (!hist)
+      hist = FindOrCreate(name, 1, boundary, boundary + 1);
     return reinterpret_cast<Histogram*>(hist);
   }
 
@@ -143,6 +361,15 @@ class RtcHistogramMap {
     }
   }
 
+  void GetAll(std::map<std::string, std::unique_ptr<SampleInfo>>* histograms) {
+    MutexLock lock(&mutex_);
+    for (const auto& kv : map_) {
+      std::unique_ptr<SampleInfo> info = kv.second->Get();
+      if (info)
+        histograms->insert(std::make_pair(kv.first, std::move(info)));
+    }
+  }
+
   // Functions only for testing.
   void Reset() {
     MutexLock lock(&mutex_);
@@ -175,9 +402,49 @@ class RtcHistogramMap {
   }
 
  private:
+  static size_t IndexSlot(const std::string& name) {
+    return std::hash<std::string>()(name) & (kHistogramIndexSize - 1);
+  }
+
+  // Finds the histogram in the index, without locking.
+  RtcHistogram* Find(const std::string& name) const {
+    for (size_t probe = 0, slot = IndexSlot(name); probe < kHistogramIndexSize;
+         ++probe, slot = (slot + 1) & (kHistogramIndexSize - 1)) {
+      RtcHistogram* hist = index_[slot].load(std::memory_order_acquire);
+      if (!hist)
+        return nullptr;
+      if (hist->name() == name)
+        return hist;
+    }
+    return nullptr;
+  }
+
+  RtcHistogram* FindOrCreate(const std::string& name,
+                             int min,
+                             int max,
+                             int bucket_count) {
+    MutexLock lock(&mutex_);
+    const auto& it = map_.find(name);
+    if (it != map_.end())
+      return it->second.get();
+
+    RtcHistogram* hist = new RtcHistogram(name, min, max, bucket_count);
+    map_[name].reset(hist);
+    if (num_indexed_ < kMaxIndexedHistograms) {
+      size_t slot = IndexSlot(name);
+      while (index_[slot].load(std::memory_order_relaxed))
+        slot = (slot + 1) & (kHistogramIndexSize - 1);
+      index_[slot].store(hist, std::memory_order_release);
+      ++num_indexed_;
+    }
+    return hist;
+  }
+
   mutable Mutex mutex_;
   std::map<std::string, std::unique_ptr<RtcHistogram>> map_
       RTC_GUARDED_BY(mutex_);
+  std::atomic<RtcHistogram*> index_[kHistogramIndexSize];
+  int num_indexed_ RTC_GUARDED_BY(mutex_) = 0;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(RtcHistogramMap);
 };
@@ -298,6 +565,13 @@ void GetAndReset(
     map->GetAndReset(histograms);
 }
 
+void GetAll(std::map<std::string, std::unique_ptr<SampleInfo>>* histograms) {
+  histograms->clear();
+  RtcHistogramMap* map = GetMap();
+  if (map)
+    map->GetAll(histograms);
+}
+
 void Reset() {
   RtcHistogramMap* map = GetMap();
   if (map)